@@ -0,0 +1,791 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * gstalsammapringbuffer.c: ringbuffer writing into mmapped ALSA memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* With the default #GstAudioSink ringbuffer every sample is copied into the
+ * ringbuffer memory by gst_audio_base_sink_render(), then handed to the
+ * ringbuffer thread which copies it again with snd_pcm_writei(). This
+ * ringbuffer has no memory of its own: its commit function does the rate
+ * conversion and channel reordering of gst_audio_ring_buffer_commit()
+ * straight into the areas returned by snd_pcm_mmap_begin() and commits them
+ * to the device from the streaming thread.
+ *
+ * The device buffer takes the role of the ringbuffer memory, segdone counts
+ * the periods handed to the device and the delay is what the device still
+ * has to play, just like with #GstAudioSink. A helper thread checks the
+ * device twice per period, queues silence when the writer is about to
+ * underrun so that the clock keeps running, and wakes up the writer when
+ * it waits for space.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+
+#include "gstalsasink.h"
+#include "gstalsammapringbuffer.h"
+
+#include <gst/audio/gstaudioringbufferprivate.h>
+
+#include <gst/gst-i18n-plugin.h>
+
+#define GST_ALSA_MMAP_RING_BUFFER_GET_COND(buf) (&GST_ALSA_MMAP_RING_BUFFER_CAST (buf)->cond)
+#define GST_ALSA_MMAP_RING_BUFFER_WAIT(buf)     (g_cond_wait (GST_ALSA_MMAP_RING_BUFFER_GET_COND (buf), GST_OBJECT_GET_LOCK (buf)))
+#define GST_ALSA_MMAP_RING_BUFFER_WAIT_UNTIL(buf,end) (g_cond_wait_until (GST_ALSA_MMAP_RING_BUFFER_GET_COND (buf), GST_OBJECT_GET_LOCK (buf), end))
+#define GST_ALSA_MMAP_RING_BUFFER_SIGNAL(buf)   (g_cond_signal (GST_ALSA_MMAP_RING_BUFFER_GET_COND (buf)))
+
+static void gst_alsa_mmap_ring_buffer_finalize (GObject * object);
+
+static gboolean gst_alsa_mmap_ring_buffer_open_device (GstAudioRingBuffer *
+    buf);
+static gboolean gst_alsa_mmap_ring_buffer_close_device (GstAudioRingBuffer *
+    buf);
+static gboolean gst_alsa_mmap_ring_buffer_acquire (GstAudioRingBuffer * buf,
+    GstAudioRingBufferSpec * spec);
+static gboolean gst_alsa_mmap_ring_buffer_release (GstAudioRingBuffer * buf);
+static gboolean gst_alsa_mmap_ring_buffer_start (GstAudioRingBuffer * buf);
+static gboolean gst_alsa_mmap_ring_buffer_stop (GstAudioRingBuffer * buf);
+static guint gst_alsa_mmap_ring_buffer_delay (GstAudioRingBuffer * buf);
+static gboolean gst_alsa_mmap_ring_buffer_activate (GstAudioRingBuffer * buf,
+    gboolean active);
+static guint gst_alsa_mmap_ring_buffer_commit (GstAudioRingBuffer * buf,
+    guint64 * sample, guint8 * data, gint in_samples, gint out_samples,
+    gint * accum);
+
+G_DEFINE_TYPE (GstAlsaMmapRingBuffer, gst_alsa_mmap_ring_buffer,
+    GST_TYPE_AUDIO_RING_BUFFER);
+
+static void
+gst_alsa_mmap_ring_buffer_class_init (GstAlsaMmapRingBufferClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstAudioRingBufferClass *gstringbuffer_class;
+
+  gobject_class = (GObjectClass *) klass;
+  gstringbuffer_class = (GstAudioRingBufferClass *) klass;
+
+  gobject_class->finalize = gst_alsa_mmap_ring_buffer_finalize;
+
+  gstringbuffer_class->open_device =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_open_device);
+  gstringbuffer_class->close_device =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_close_device);
+  gstringbuffer_class->acquire =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_acquire);
+  gstringbuffer_class->release =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_release);
+  gstringbuffer_class->start =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_start);
+  gstringbuffer_class->pause =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_stop);
+  gstringbuffer_class->resume =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_start);
+  gstringbuffer_class->stop = GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_stop);
+  gstringbuffer_class->delay =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_delay);
+  gstringbuffer_class->activate =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_activate);
+  gstringbuffer_class->commit =
+      GST_DEBUG_FUNCPTR (gst_alsa_mmap_ring_buffer_commit);
+}
+
+static void
+gst_alsa_mmap_ring_buffer_init (GstAlsaMmapRingBuffer * ringbuffer)
+{
+  ringbuffer->running = FALSE;
+  ringbuffer->thread = NULL;
+  ringbuffer->committed = 0;
+
+  g_cond_init (&ringbuffer->cond);
+}
+
+static void
+gst_alsa_mmap_ring_buffer_finalize (GObject * object)
+{
+  GstAlsaMmapRingBuffer *ringbuffer = GST_ALSA_MMAP_RING_BUFFER_CAST (object);
+
+  g_cond_clear (&ringbuffer->cond);
+
+  G_OBJECT_CLASS (gst_alsa_mmap_ring_buffer_parent_class)->finalize (object);
+}
+
+/* called with the ALSA lock. Queues @frames frames of silence, returns the
+ * number of frames queued or a negative error */
+static snd_pcm_sframes_t
+queue_silence (GstAlsaMmapRingBuffer * abuf, GstAlsaSink * alsa,
+    snd_pcm_uframes_t frames)
+{
+  const snd_pcm_channel_area_t *areas;
+  snd_pcm_uframes_t offset;
+  snd_pcm_sframes_t res;
+
+  if ((res = snd_pcm_mmap_begin (alsa->handle, &areas, &offset, &frames)) < 0)
+    return res;
+
+  snd_pcm_areas_silence (areas, offset, alsa->channels, frames, alsa->format);
+
+  res = snd_pcm_mmap_commit (alsa->handle, offset, frames);
+  if (res > 0)
+    abuf->committed += res;
+
+  return res;
+}
+
+/* called with the ALSA lock, the number of segments handed to the device */
+static gint
+committed_segments (GstAlsaMmapRingBuffer * abuf)
+{
+  return abuf->committed /
+      GST_AUDIO_RING_BUFFER_CAST (abuf)->samples_per_seg;
+}
+
+/* called without the ALSA lock, advancing may need the object lock which is
+ * taken before the ALSA lock. segdone counts the segments handed to the
+ * device, @segments is the result of committed_segments(). */
+static void
+update_segdone (GstAudioRingBuffer * buf, gint segments)
+{
+  GstAlsaMmapRingBuffer *abuf = GST_ALSA_MMAP_RING_BUFFER_CAST (buf);
+  gint advanced;
+
+  do {
+    advanced = g_atomic_int_get (&abuf->advanced);
+    if (segments - advanced <= 0)
+      return;
+  } while (!g_atomic_int_compare_and_exchange (&abuf->advanced, advanced,
+          segments));
+
+  gst_audio_ring_buffer_advance (buf, segments - advanced);
+}
+
+/* called with the ALSA lock. Underrun and suspend recovery, restarts the
+ * device when we are playing */
+static gint
+xrun_recovery (GstAlsaMmapRingBuffer * abuf, GstAlsaSink * alsa, gint err)
+{
+  GST_WARNING_OBJECT (alsa, "xrun recovery %d: %s", err, snd_strerror (err));
+
+  if (err == -ENODEV)
+    return err;
+
+  if ((err = snd_pcm_recover (alsa->handle, err, 1)) < 0) {
+    GST_WARNING_OBJECT (alsa, "Can't recover: %s", snd_strerror (err));
+    return err;
+  }
+  gst_audio_base_sink_report_device_failure (GST_AUDIO_BASE_SINK (alsa));
+
+  if (g_atomic_int_get (&GST_AUDIO_RING_BUFFER_CAST (abuf)->state) ==
+      GST_AUDIO_RING_BUFFER_STATE_STARTED &&
+      snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED) {
+    snd_pcm_avail_update (alsa->handle);
+    queue_silence (abuf, alsa, alsa->period_size);
+    snd_pcm_start (alsa->handle);
+  }
+
+  return 0;
+}
+
+/* check the device, keep it from running dry */
+static void
+gst_alsa_mmap_ring_buffer_service (GstAlsaMmapRingBuffer * abuf,
+    GstAlsaSink * alsa)
+{
+  snd_pcm_sframes_t avail;
+  gint segments;
+
+  GST_ALSA_SINK_LOCK (alsa);
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (G_UNLIKELY (avail < 0)) {
+    if (xrun_recovery (abuf, alsa, avail) < 0) {
+      GST_ALSA_SINK_UNLOCK (alsa);
+      return;
+    }
+    avail = snd_pcm_avail_update (alsa->handle);
+  }
+
+  /* less than a period left to play, the writer is late. Queue a period of
+   * silence so that the device and the clock keep running, the late samples
+   * will be dropped */
+  if (avail >= 0 && alsa->buffer_size - avail < alsa->period_size) {
+    GST_LOG_OBJECT (alsa, "writer late, queueing silence");
+    queue_silence (abuf, alsa, alsa->period_size);
+  }
+  segments = committed_segments (abuf);
+  GST_ALSA_SINK_UNLOCK (alsa);
+
+  update_segdone (GST_AUDIO_RING_BUFFER_CAST (abuf), segments);
+}
+
+static void
+post_stream_status (GstAudioRingBuffer * buf, GstAlsaSink * alsa,
+    GstStreamStatusType type)
+{
+  GstMessage *message;
+  GValue val = { 0 };
+
+  message = gst_message_new_stream_status (GST_OBJECT_CAST (buf), type,
+      GST_ELEMENT_CAST (alsa));
+  g_value_init (&val, GST_TYPE_G_THREAD);
+  g_value_set_boxed (&val, g_thread_self ());
+  gst_message_set_stream_status_object (message, &val);
+  g_value_unset (&val);
+  gst_element_post_message (GST_ELEMENT_CAST (alsa), message);
+}
+
+static void
+gst_alsa_mmap_ring_buffer_thread_func (GstAudioRingBuffer * buf)
+{
+  GstAlsaMmapRingBuffer *abuf = GST_ALSA_MMAP_RING_BUFFER_CAST (buf);
+  GstAlsaSink *alsa;
+  gint64 interval;
+
+  alsa = GST_ALSA_SINK (GST_OBJECT_PARENT (buf));
+
+  GST_DEBUG_OBJECT (alsa, "enter thread");
+
+  GST_OBJECT_LOCK (abuf);
+  GST_ALSA_MMAP_RING_BUFFER_SIGNAL (buf);
+  GST_OBJECT_UNLOCK (abuf);
+
+  post_stream_status (buf, alsa, GST_STREAM_STATUS_TYPE_ENTER);
+
+  GST_OBJECT_LOCK (abuf);
+  while (abuf->running) {
+    if (g_atomic_int_get (&buf->state) != GST_AUDIO_RING_BUFFER_STATE_STARTED) {
+      GST_DEBUG_OBJECT (alsa, "wait for action");
+      GST_ALSA_MMAP_RING_BUFFER_WAIT (buf);
+      continue;
+    }
+    GST_OBJECT_UNLOCK (abuf);
+
+    gst_alsa_mmap_ring_buffer_service (abuf, alsa);
+
+    /* the device made room, wake up the writer */
+    if (g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0)) {
+      GST_OBJECT_LOCK (buf);
+      GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+      GST_OBJECT_UNLOCK (buf);
+    }
+
+    /* check the device twice per period */
+    interval = gst_util_uint64_scale_int (alsa->period_size, G_USEC_PER_SEC,
+        2 * alsa->rate);
+
+    GST_OBJECT_LOCK (abuf);
+    if (abuf->running)
+      GST_ALSA_MMAP_RING_BUFFER_WAIT_UNTIL (buf,
+          g_get_monotonic_time () + MAX (interval, 1000));
+  }
+  GST_OBJECT_UNLOCK (abuf);
+
+  GST_DEBUG_OBJECT (alsa, "stop running, exit thread");
+  post_stream_status (buf, alsa, GST_STREAM_STATUS_TYPE_LEAVE);
+}
+
+static gboolean
+gst_alsa_mmap_ring_buffer_open_device (GstAudioRingBuffer * buf)
+{
+  GstAudioSink *sink;
+  GstAudioSinkClass *csink;
+
+  sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
+  csink = GST_AUDIO_SINK_GET_CLASS (sink);
+
+  return csink->open (sink);
+}
+
+static gboolean
+gst_alsa_mmap_ring_buffer_close_device (GstAudioRingBuffer * buf)
+{
+  GstAudioSink *sink;
+  GstAudioSinkClass *csink;
+
+  sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
+  csink = GST_AUDIO_SINK_GET_CLASS (sink);
+
+  return csink->close (sink);
+}
+
+static gboolean
+gst_alsa_mmap_ring_buffer_acquire (GstAudioRingBuffer * buf,
+    GstAudioRingBufferSpec * spec)
+{
+  GstAlsaMmapRingBuffer *abuf = GST_ALSA_MMAP_RING_BUFFER_CAST (buf);
+  GstAudioSink *sink;
+  GstAudioSinkClass *csink;
+
+  sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
+  csink = GST_AUDIO_SINK_GET_CLASS (sink);
+
+  if (!csink->prepare (sink, spec))
+    goto could_not_prepare;
+
+  /* the device buffer is the ringbuffer, unlike the audiosink ringbuffer
+   * there is no extra segment queued in the device */
+  spec->seglatency = spec->segtotal;
+
+  /* we don't have memory of our own, the samples go straight to the device */
+  buf->size = spec->segtotal * spec->segsize;
+  buf->memory = NULL;
+
+  /* segdone starts from 0 after acquiring */
+  abuf->committed = 0;
+  g_atomic_int_set (&abuf->advanced, 0);
+
+  return TRUE;
+
+  /* ERRORS */
+could_not_prepare:
+  {
+    GST_DEBUG_OBJECT (sink, "could not prepare device");
+    return FALSE;
+  }
+}
+
+/* function is called with LOCK */
+static gboolean
+gst_alsa_mmap_ring_buffer_release (GstAudioRingBuffer * buf)
+{
+  GstAudioSink *sink;
+  GstAudioSinkClass *csink;
+
+  sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
+  csink = GST_AUDIO_SINK_GET_CLASS (sink);
+
+  buf->size = 0;
+
+  return csink->unprepare (sink);
+}
+
+/* function is called with LOCK */
+static gboolean
+gst_alsa_mmap_ring_buffer_activate (GstAudioRingBuffer * buf, gboolean active)
+{
+  GstAlsaMmapRingBuffer *abuf = GST_ALSA_MMAP_RING_BUFFER_CAST (buf);
+  GError *error = NULL;
+
+  if (active) {
+    abuf->running = TRUE;
+
+    GST_DEBUG_OBJECT (buf, "starting thread");
+
+    abuf->thread = g_thread_try_new ("alsasink-mmap",
+        (GThreadFunc) gst_alsa_mmap_ring_buffer_thread_func, buf, &error);
+
+    if (!abuf->thread || error != NULL)
+      goto thread_failed;
+
+    GST_DEBUG_OBJECT (buf, "waiting for thread");
+    GST_ALSA_MMAP_RING_BUFFER_WAIT (buf);
+    GST_DEBUG_OBJECT (buf, "thread is started");
+  } else {
+    abuf->running = FALSE;
+    GST_ALSA_MMAP_RING_BUFFER_SIGNAL (buf);
+
+    GST_OBJECT_UNLOCK (buf);
+    g_thread_join (abuf->thread);
+    abuf->thread = NULL;
+    GST_OBJECT_LOCK (buf);
+  }
+  return TRUE;
+
+  /* ERRORS */
+thread_failed:
+  {
+    abuf->running = FALSE;
+    if (error)
+      GST_ERROR_OBJECT (buf, "could not create thread %s", error->message);
+    else
+      GST_ERROR_OBJECT (buf, "could not create thread for unknown reason");
+    g_clear_error (&error);
+    return FALSE;
+  }
+}
+
+/* function is called with LOCK */
+static gboolean
+gst_alsa_mmap_ring_buffer_start (GstAudioRingBuffer * buf)
+{
+  GstAlsaSink *alsa;
+  gint err;
+
+  alsa = GST_ALSA_SINK (GST_OBJECT_PARENT (buf));
+
+  GST_ALSA_SINK_LOCK (alsa);
+  if (snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED) {
+    /* an empty device would underrun right away. segdone is updated by the
+     * thread, we can't advance with the object lock held */
+    if (snd_pcm_avail_update (alsa->handle) >=
+        (snd_pcm_sframes_t) alsa->buffer_size)
+      queue_silence (GST_ALSA_MMAP_RING_BUFFER_CAST (buf), alsa,
+          alsa->period_size);
+
+    GST_DEBUG_OBJECT (alsa, "starting device");
+    if ((err = snd_pcm_start (alsa->handle)) < 0)
+      GST_WARNING_OBJECT (alsa, "could not start: %s", snd_strerror (err));
+  }
+  GST_ALSA_SINK_UNLOCK (alsa);
+
+  GST_DEBUG_OBJECT (alsa, "start, sending signal");
+  GST_ALSA_MMAP_RING_BUFFER_SIGNAL (buf);
+
+  return TRUE;
+}
+
+/* function is called with LOCK */
+static gboolean
+gst_alsa_mmap_ring_buffer_stop (GstAudioRingBuffer * buf)
+{
+  GstAudioSink *sink;
+  GstAudioSinkClass *csink;
+
+  sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
+  csink = GST_AUDIO_SINK_GET_CLASS (sink);
+
+  /* drop what is queued in the device */
+  GST_DEBUG_OBJECT (sink, "reset...");
+  csink->reset (sink);
+  GST_DEBUG_OBJECT (sink, "reset done");
+
+  return TRUE;
+}
+
+static guint
+gst_alsa_mmap_ring_buffer_delay (GstAudioRingBuffer * buf)
+{
+  GstAlsaMmapRingBuffer *abuf = GST_ALSA_MMAP_RING_BUFFER_CAST (buf);
+  GstAlsaSink *alsa;
+  snd_pcm_sframes_t delay;
+  gint64 partial;
+
+  alsa = GST_ALSA_SINK (GST_OBJECT_PARENT (buf));
+
+  GST_ALSA_SINK_LOCK (alsa);
+  if (G_UNLIKELY (snd_pcm_delay (alsa->handle, &delay) < 0))
+    delay = 0;
+  /* segdone only counts complete segments, the frames of the partial segment
+   * we already committed are not part of the samples done yet */
+  partial = abuf->committed -
+      (guint64) g_atomic_int_get (&buf->segdone) * buf->samples_per_seg;
+  GST_ALSA_SINK_UNLOCK (alsa);
+
+  return MAX (delay - partial, 0);
+}
+
+/* the device is full, wait until the thread saw it made room. Returns
+ * FALSE when we are flushing or stopped. */
+static gboolean
+gst_alsa_mmap_ring_buffer_wait (GstAudioRingBuffer * buf)
+{
+  /* it must be playing or we wait forever */
+  if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+          GST_AUDIO_RING_BUFFER_STATE_STARTED)) {
+    if (G_UNLIKELY (!g_atomic_int_get (&buf->may_start)))
+      goto no_start;
+
+    GST_DEBUG_OBJECT (buf, "start!");
+    gst_audio_ring_buffer_start (buf);
+  }
+
+  GST_OBJECT_LOCK (buf);
+  if (G_UNLIKELY (buf->flushing))
+    goto flushing;
+
+  if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+          GST_AUDIO_RING_BUFFER_STATE_STARTED))
+    goto not_started;
+
+  if (g_atomic_int_compare_and_exchange (&buf->waiting, 0, 1)) {
+    GST_LOG_OBJECT (buf, "waiting..");
+    GST_AUDIO_RING_BUFFER_WAIT (buf);
+
+    if (G_UNLIKELY (buf->flushing))
+      goto flushing;
+
+    if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+            GST_AUDIO_RING_BUFFER_STATE_STARTED))
+      goto not_started;
+  }
+  GST_OBJECT_UNLOCK (buf);
+
+  return TRUE;
+
+  /* ERRORS */
+no_start:
+  {
+    GST_DEBUG_OBJECT (buf, "not allowed to start");
+    return FALSE;
+  }
+flushing:
+  {
+    g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
+    GST_DEBUG_OBJECT (buf, "flushing");
+    GST_OBJECT_UNLOCK (buf);
+    return FALSE;
+  }
+not_started:
+  {
+    g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
+    GST_DEBUG_OBJECT (buf, "stopped processing");
+    GST_OBJECT_UNLOCK (buf);
+    return FALSE;
+  }
+}
+
+static guint
+gst_alsa_mmap_ring_buffer_commit (GstAudioRingBuffer * buf, guint64 * sample,
+    guint8 * data, gint in_samples, gint out_samples, gint * accum)
+{
+  GstAlsaMmapRingBuffer *abuf = GST_ALSA_MMAP_RING_BUFFER_CAST (buf);
+  GstAlsaSink *alsa;
+  gint channels, bps, bpf, sps;
+  guint8 *data_end;
+  gint *toprocess;
+  gint inr, outr;
+  gboolean reverse;
+  gboolean need_reorder;
+  gint *reorder_map;
+  snd_pcm_sframes_t res = 0;
+
+  alsa = GST_ALSA_SINK (GST_OBJECT_PARENT (buf));
+
+  need_reorder = buf->need_reorder;
+  reorder_map = buf->channel_reorder_map;
+
+  channels = buf->spec.info.channels;
+  bpf = buf->spec.info.bpf;
+  bps = bpf / channels;
+  sps = buf->samples_per_seg;
+
+  reverse = out_samples < 0;
+  out_samples = ABS (out_samples);
+
+  if (in_samples >= out_samples)
+    toprocess = &in_samples;
+  else
+    toprocess = &out_samples;
+
+  inr = in_samples - 1;
+  outr = out_samples - 1;
+
+  /* data_end points to the last sample we have to write, not past it. This is
+   * needed to properly handle reverse playback: it points to the last sample. */
+  data_end = data + (bpf * inr);
+
+  GST_DEBUG_OBJECT (buf, "write %d : %d", in_samples, out_samples);
+
+  while (*toprocess > 0) {
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset = 0, frames;
+    snd_pcm_sframes_t avail;
+    guint8 *d, *d_end, *dest;
+    gint64 pos;
+    gint written, committed, segments;
+    gboolean skip;
+
+    GST_ALSA_SINK_LOCK (alsa);
+
+    avail = snd_pcm_avail_update (alsa->handle);
+    if (G_UNLIKELY (avail < 0)) {
+      res = xrun_recovery (abuf, alsa, avail);
+      GST_ALSA_SINK_UNLOCK (alsa);
+      if (res < 0)
+        goto write_error;
+      continue;
+    }
+
+    /* where the next sample goes in the frames handed to the device */
+    pos = (gint64) * sample + (gint64) buf->segbase * sps;
+
+    if (G_UNLIKELY (pos < (gint64) abuf->committed)) {
+      /* writer too slow, the device already got silence for these samples
+       * and we need to drop them */
+      frames = MIN (abuf->committed - pos, sps);
+      frames = MIN (frames, out_samples);
+      dest = buf->empty_seg;
+      skip = TRUE;
+    } else if (G_UNLIKELY (avail == 0)) {
+      GST_ALSA_SINK_UNLOCK (alsa);
+      if (!gst_alsa_mmap_ring_buffer_wait (buf))
+        goto not_started;
+      continue;
+    } else if (G_UNLIKELY (pos > (gint64) abuf->committed)) {
+      /* gap before our samples, the device plays silence there */
+      res = queue_silence (abuf, alsa, MIN (pos - abuf->committed, avail));
+      segments = committed_segments (abuf);
+      GST_ALSA_SINK_UNLOCK (alsa);
+      if (res < 0)
+        goto write_error;
+      update_segdone (buf, segments);
+      continue;
+    } else {
+      frames = MIN (avail, out_samples);
+      if ((res = snd_pcm_mmap_begin (alsa->handle, &areas, &offset,
+                  &frames)) < 0) {
+        GST_ALSA_SINK_UNLOCK (alsa);
+        goto write_error;
+      }
+      if (G_UNLIKELY (areas[0].step != bpf * 8 || areas[0].first % 8))
+        goto wrong_layout;
+
+      dest = (guint8 *) areas[0].addr + areas[0].first / 8 + offset * bpf;
+      skip = FALSE;
+    }
+
+    d = dest;
+    d_end = d + frames * bpf;
+    written = out_samples;
+
+    GST_LOG_OBJECT (buf, "%s %lu frames @%p", skip ? "drop" : "write",
+        frames, dest);
+
+    if (need_reorder) {
+      if (G_LIKELY (inr == outr && !reverse)) {
+        /* no rate conversion, simply copy samples */
+        FWD_SAMPLES (data, data_end, d, d_end, REORDER_SAMPLES);
+      } else if (!reverse) {
+        if (inr >= outr)
+          /* forward speed up */
+          FWD_UP_SAMPLES (data, data_end, d, d_end, REORDER_SAMPLE);
+        else
+          /* forward slow down */
+          FWD_DOWN_SAMPLES (data, data_end, d, d_end, REORDER_SAMPLE);
+      } else {
+        if (inr >= outr)
+          /* reverse speed up */
+          REV_UP_SAMPLES (data, data_end, d, d_end, REORDER_SAMPLE);
+        else
+          /* reverse slow down */
+          REV_DOWN_SAMPLES (data, data_end, d, d_end, REORDER_SAMPLE);
+      }
+    } else {
+      if (G_LIKELY (inr == outr && !reverse)) {
+        /* no rate conversion, simply copy samples */
+        FWD_SAMPLES (data, data_end, d, d_end, memcpy);
+      } else if (!reverse) {
+        if (inr >= outr)
+          /* forward speed up */
+          FWD_UP_SAMPLES (data, data_end, d, d_end, memcpy);
+        else
+          /* forward slow down */
+          FWD_DOWN_SAMPLES (data, data_end, d, d_end, memcpy);
+      } else {
+        if (inr >= outr)
+          /* reverse speed up */
+          REV_UP_SAMPLES (data, data_end, d, d_end, memcpy);
+        else
+          /* reverse slow down */
+          REV_DOWN_SAMPLES (data, data_end, d, d_end, memcpy);
+      }
+    }
+    written -= out_samples;
+
+    if (!skip) {
+      if (alsa->iec958 && alsa->need_swap) {
+        guint16 *ptr = (guint16 *) dest;
+        gint i;
+
+        for (i = 0; i < written * bpf / 2; i++)
+          ptr[i] = GUINT16_SWAP_LE_BE (ptr[i]);
+      }
+
+      res = snd_pcm_mmap_commit (alsa->handle, offset, written);
+      if (G_UNLIKELY (res < 0)) {
+        GST_DEBUG_OBJECT (buf, "commit error: %s", snd_strerror (res));
+        if (xrun_recovery (abuf, alsa, res) < 0) {
+          GST_ALSA_SINK_UNLOCK (alsa);
+          goto write_error;
+        }
+      } else {
+        committed = res;
+
+        /* after a short commit the other frames are still in the device
+         * memory right after the committed ones, try to hand them over */
+        while (G_UNLIKELY (res > 0 && committed < written)) {
+          snd_pcm_uframes_t roffset;
+
+          GST_DEBUG_OBJECT (buf, "short commit: %d of %d frames", committed,
+              written);
+
+          frames = written - committed;
+          res = snd_pcm_mmap_begin (alsa->handle, &areas, &roffset, &frames);
+          if (res < 0)
+            break;
+          if (roffset != offset + committed) {
+            snd_pcm_mmap_commit (alsa->handle, roffset, 0);
+            break;
+          }
+          res = snd_pcm_mmap_commit (alsa->handle, roffset, frames);
+          if (res > 0)
+            committed += res;
+        }
+        if (G_UNLIKELY (committed < written))
+          GST_WARNING_OBJECT (buf, "device took %d of %d frames, dropping %d",
+              committed, written, written - committed);
+
+        abuf->committed += committed;
+        /* the next samples go right after the ones the device got */
+        written = committed;
+      }
+    }
+    segments = committed_segments (abuf);
+    *sample += written;
+    GST_ALSA_SINK_UNLOCK (alsa);
+
+    update_segdone (buf, segments);
+
+    if (G_UNLIKELY (written == 0))
+      break;
+  }
+  /* we consumed all samples here */
+  data = data_end + bpf;
+
+done:
+  return inr - ((data_end - data) / bpf);
+
+  /* ERRORS */
+not_started:
+  {
+    GST_DEBUG_OBJECT (buf, "stopped processing");
+    goto done;
+  }
+wrong_layout:
+  {
+    GST_ALSA_SINK_UNLOCK (alsa);
+    GST_ELEMENT_ERROR (alsa, RESOURCE, WRITE, (NULL),
+        ("Device buffer is not interleaved"));
+    goto done;
+  }
+write_error:
+  {
+    if (res == -ENODEV) {
+      GST_ELEMENT_ERROR (alsa, RESOURCE, WRITE,
+          (_("Error outputting to audio device. "
+                  "The device has been disconnected.")), (NULL));
+    } else {
+      GST_ELEMENT_ERROR (alsa, RESOURCE, WRITE, (NULL),
+          ("Error writing to device: %s", snd_strerror (res)));
+    }
+    goto done;
+  }
+}
@@ -0,0 +1,69 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * gstalsammapringbuffer.h:
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_ALSA_MMAP_RING_BUFFER_H__
+#define __GST_ALSA_MMAP_RING_BUFFER_H__
+
+#include "gstalsa.h"
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_ALSA_MMAP_RING_BUFFER            (gst_alsa_mmap_ring_buffer_get_type())
+#define GST_ALSA_MMAP_RING_BUFFER(obj)            (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_ALSA_MMAP_RING_BUFFER,GstAlsaMmapRingBuffer))
+#define GST_ALSA_MMAP_RING_BUFFER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_ALSA_MMAP_RING_BUFFER,GstAlsaMmapRingBufferClass))
+#define GST_IS_ALSA_MMAP_RING_BUFFER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_ALSA_MMAP_RING_BUFFER))
+#define GST_IS_ALSA_MMAP_RING_BUFFER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_ALSA_MMAP_RING_BUFFER))
+#define GST_ALSA_MMAP_RING_BUFFER_CAST(obj)       ((GstAlsaMmapRingBuffer *) (obj))
+
+typedef struct _GstAlsaMmapRingBuffer GstAlsaMmapRingBuffer;
+typedef struct _GstAlsaMmapRingBufferClass GstAlsaMmapRingBufferClass;
+
+/**
+ * GstAlsaMmapRingBuffer:
+ *
+ * Ringbuffer that writes the samples committed by #GstAudioBaseSink
+ * directly into the memory mapped buffer of an alsasink device.
+ */
+struct _GstAlsaMmapRingBuffer {
+  GstAudioRingBuffer object;
+
+  /* with LOCK */
+  gboolean running;
+  GThread *thread;
+  GCond cond;
+
+  /* with the ALSA lock of the sink, frames handed to the device, in the
+   * same units as segdone * samples_per_seg */
+  guint64 committed;
+
+  /* ATOMIC, segments passed to gst_audio_ring_buffer_advance() */
+  gint advanced;
+};
+
+struct _GstAlsaMmapRingBufferClass {
+  GstAudioRingBufferClass parent_class;
+};
+
+GType gst_alsa_mmap_ring_buffer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_ALSA_MMAP_RING_BUFFER_H__ */
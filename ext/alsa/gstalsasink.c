@@ -34,6 +34,11 @@
  *
  * Play an Ogg/Vorbis file and output audio via ALSA.
  *
+ * When #GstAlsaSink:mmap is enabled the samples are written directly into
+ * the memory mapped buffer of the device instead of being copied into an
+ * intermediate ringbuffer and written from a separate thread. This saves a
+ * copy of every sample and a thread wakeup per period.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -49,6 +54,7 @@
 
 #include "gstalsa.h"
 #include "gstalsasink.h"
+#include "gstalsammapringbuffer.h"
 #include "gstalsadeviceprobe.h"
 
 #include <gst/audio/gstaudioiec61937.h>
@@ -61,6 +67,7 @@
 #define DEFAULT_DEVICE		"default"
 #define DEFAULT_DEVICE_NAME	""
 #define DEFAULT_CARD_NAME	""
+#define DEFAULT_MMAP		FALSE
 #define SPDIF_PERIOD_SIZE 1536
 #define SPDIF_BUFFER_SIZE 15360
 
@@ -70,6 +77,7 @@ enum
   PROP_DEVICE,
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
+  PROP_MMAP,
   PROP_LAST
 };
 
@@ -99,6 +107,8 @@ static void gst_alsasink_reset (GstAudioSink * asink);
 static gboolean gst_alsasink_acceptcaps (GstAlsaSink * alsa, GstCaps * caps);
 static GstBuffer *gst_alsasink_payload (GstAudioBaseSink * sink,
     GstBuffer * buf);
+static GstAudioRingBuffer *gst_alsasink_create_ringbuffer (GstAudioBaseSink *
+    sink);
 
 static gint output_ref;         /* 0    */
 static snd_output_t *output;    /* NULL */
@@ -175,6 +185,8 @@ gst_alsasink_class_init (GstAlsaSinkClass * klass)
   gstbasesink_class->query = GST_DEBUG_FUNCPTR (gst_alsasink_query);
 
   gstbaseaudiosink_class->payload = GST_DEBUG_FUNCPTR (gst_alsasink_payload);
+  gstbaseaudiosink_class->create_ringbuffer =
+      GST_DEBUG_FUNCPTR (gst_alsasink_create_ringbuffer);
 
   gstaudiosink_class->open = GST_DEBUG_FUNCPTR (gst_alsasink_open);
   gstaudiosink_class->prepare = GST_DEBUG_FUNCPTR (gst_alsasink_prepare);
@@ -198,6 +210,20 @@ gst_alsasink_class_init (GstAlsaSinkClass * klass)
       g_param_spec_string ("card-name", "Card name",
           "Human-readable name of the sound card", DEFAULT_CARD_NAME,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSink:mmap:
+   *
+   * Write the samples directly into the memory mapped buffer of the device.
+   * Takes effect when the ringbuffer is created, in the NULL to READY
+   * state change.
+   *
+   * Since: 1.16
+   */
+  g_object_class_install_property (gobject_class, PROP_MMAP,
+      g_param_spec_boolean ("mmap", "Mmap",
+          "Write samples directly into the memory mapped device buffer",
+          DEFAULT_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -217,6 +243,9 @@ gst_alsasink_set_property (GObject * object, guint prop_id,
         sink->device = g_strdup (DEFAULT_DEVICE);
       }
       break;
+    case PROP_MMAP:
+      sink->mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -245,6 +274,9 @@ gst_alsasink_get_property (GObject * object, guint prop_id,
           gst_alsa_find_card_name (GST_OBJECT_CAST (sink),
               sink->device, SND_PCM_STREAM_PLAYBACK));
       break;
+    case PROP_MMAP:
+      g_value_set_boolean (value, sink->mmap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -259,6 +291,7 @@ gst_alsasink_init (GstAlsaSink * alsasink)
   alsasink->device = g_strdup (DEFAULT_DEVICE);
   alsasink->handle = NULL;
   alsasink->cached_caps = NULL;
+  alsasink->mmap = DEFAULT_MMAP;
   g_mutex_init (&alsasink->alsa_lock);
   g_mutex_init (&alsasink->delay_lock);
 
@@ -630,11 +663,21 @@ set_swparams (GstAlsaSink * alsa)
 
   /* get the current swparams */
   CHECK (snd_pcm_sw_params_current (alsa->handle, params), no_config);
-  /* start the transfer when the buffer is almost full: */
-  /* (buffer_size / avail_min) * avail_min */
-  CHECK (snd_pcm_sw_params_set_start_threshold (alsa->handle, params,
-          (alsa->buffer_size / alsa->period_size) * alsa->period_size),
-      start_threshold);
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+    snd_pcm_uframes_t boundary;
+
+    /* the mmap ringbuffer starts the device itself, writing while
+     * prerolling must not start it */
+    CHECK (snd_pcm_sw_params_get_boundary (params, &boundary), start_threshold);
+    CHECK (snd_pcm_sw_params_set_start_threshold (alsa->handle, params,
+            boundary), start_threshold);
+  } else {
+    /* start the transfer when the buffer is almost full: */
+    /* (buffer_size / avail_min) * avail_min */
+    CHECK (snd_pcm_sw_params_set_start_threshold (alsa->handle, params,
+            (alsa->buffer_size / alsa->period_size) * alsa->period_size),
+        start_threshold);
+  }
 
   /* allow the transfer when at least period_size samples can be processed */
   CHECK (snd_pcm_sw_params_set_avail_min (alsa->handle, params,
@@ -819,7 +862,10 @@ alsasink_parse_spec (GstAlsaSink * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  if (GST_IS_ALSA_MMAP_RING_BUFFER (GST_AUDIO_BASE_SINK (alsa)->ringbuffer))
+    alsa->access = SND_PCM_ACCESS_MMAP_INTERLEAVED;
+  else
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SINK
@@ -1179,3 +1225,19 @@ gst_alsasink_payload (GstAudioBaseSink * sink, GstBuffer * buf)
 
   return gst_buffer_ref (buf);
 }
+
+static GstAudioRingBuffer *
+gst_alsasink_create_ringbuffer (GstAudioBaseSink * sink)
+{
+  GstAlsaSink *alsa = GST_ALSA_SINK (sink);
+  GstAudioRingBuffer *buffer;
+
+  if (!alsa->mmap)
+    return GST_AUDIO_BASE_SINK_CLASS (parent_class)->create_ringbuffer (sink);
+
+  GST_DEBUG_OBJECT (sink, "creating mmap ringbuffer");
+  buffer = g_object_new (GST_TYPE_ALSA_MMAP_RING_BUFFER, NULL);
+  GST_DEBUG_OBJECT (sink, "created ringbuffer @%p", buffer);
+
+  return buffer;
+}
@@ -74,6 +74,8 @@ struct _GstAlsaSink {
 
   GstCaps *cached_caps;
 
+  gboolean mmap;
+
   GMutex alsa_lock;
   GMutex delay_lock;
 };
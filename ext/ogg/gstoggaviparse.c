@@ -38,6 +38,7 @@
 #include <string.h>
 
 #include "gstogg.h"
+#include "gstoggsync.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_ogg_avi_parse_debug);
 #define GST_CAT_DEFAULT gst_ogg_avi_parse_debug
@@ -380,7 +381,7 @@ gst_ogg_avi_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
     ogg_page page;
 
     /* try to swap out a page */
-    ret = ogg_sync_pageout (&ogg->sync, &page);
+    ret = gst_ogg_sync_pageout (&ogg->sync, &page);
     if (ret == 0) {
       GST_DEBUG_OBJECT (ogg, "need more data");
       break;
@@ -45,6 +45,7 @@
 #include <gst/audio/audio.h>
 
 #include "gstoggdemux.h"
+#include "gstoggsync.h"
 
 #define CHUNKSIZE (8500)        /* this is out of vorbisfile */
 
@@ -2687,7 +2688,7 @@ gst_ogg_demux_get_next_page (GstOggDemux * ogg, ogg_page * og,
     if (end_offset > 0 && ogg->offset >= end_offset)
       goto boundary_reached;
 
-    more = ogg_sync_pageseek (&ogg->sync, og);
+    more = gst_ogg_sync_pageseek (&ogg->sync, og);
 
     GST_LOG_OBJECT (ogg, "pageseek gave %ld", more);
 
@@ -4646,7 +4647,7 @@ gst_ogg_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   while (result == GST_FLOW_OK) {
     ogg_page page;
 
-    ret = ogg_sync_pageout (&ogg->sync, &page);
+    ret = gst_ogg_sync_pageout (&ogg->sync, &page);
     if (ret == 0)
       /* need more data */
       break;
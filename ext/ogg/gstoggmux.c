@@ -70,6 +70,8 @@ GST_DEBUG_CATEGORY_STATIC (gst_ogg_mux_debug);
 #define DEFAULT_MAX_PAGE_DELAY  G_GINT64_CONSTANT(500000000)
 #define DEFAULT_MAX_TOLERANCE   G_GINT64_CONSTANT(40000000)
 #define DEFAULT_SKELETON        FALSE
+#define DEFAULT_ZERO_COPY       FALSE
+#define DEFAULT_BUFFER_LIST     FALSE
 
 enum
 {
@@ -77,7 +79,9 @@ enum
   ARG_MAX_DELAY,
   ARG_MAX_PAGE_DELAY,
   ARG_MAX_TOLERANCE,
-  ARG_SKELETON
+  ARG_SKELETON,
+  ARG_ZERO_COPY,
+  ARG_BUFFER_LIST
 };
 
 static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
@@ -187,6 +191,17 @@ gst_ogg_mux_class_init (GstOggMuxClass * klass)
           "Whether to include a Skeleton track",
           DEFAULT_SKELETON,
           (GParamFlags) G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, ARG_ZERO_COPY,
+      g_param_spec_boolean ("zero-copy", "Zero copy",
+          "Reference the input packet memory in output pages instead of "
+          "copying the page data", DEFAULT_ZERO_COPY,
+          (GParamFlags) G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, ARG_BUFFER_LIST,
+      g_param_spec_boolean ("buffer-list", "Buffer List",
+          "Push pages that are ready at the same time as a buffer list",
+          DEFAULT_BUFFER_LIST,
+          (GParamFlags) G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state = gst_ogg_mux_change_state;
 
@@ -229,6 +244,8 @@ gst_ogg_mux_init (GstOggMux * ogg_mux)
   ogg_mux->max_delay = DEFAULT_MAX_DELAY;
   ogg_mux->max_page_delay = DEFAULT_MAX_PAGE_DELAY;
   ogg_mux->max_tolerance = DEFAULT_MAX_TOLERANCE;
+  ogg_mux->zero_copy = DEFAULT_ZERO_COPY;
+  ogg_mux->use_buffer_list = DEFAULT_BUFFER_LIST;
 
   gst_ogg_mux_clear (ogg_mux);
 }
@@ -248,6 +265,17 @@ gst_ogg_mux_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static void
+gst_ogg_mux_clear_payloads (GstOggPadData * oggpad)
+{
+  GstBuffer *buf;
+
+  while ((buf = g_queue_pop_head (&oggpad->payloads)) != NULL)
+    gst_buffer_unref (buf);
+  oggpad->payload_offset = 0;
+  oggpad->payload_size = 0;
+}
+
 static void
 gst_ogg_mux_ogg_pad_destroy_notify (GstCollectData * data)
 {
@@ -255,6 +283,7 @@ gst_ogg_mux_ogg_pad_destroy_notify (GstCollectData * data)
   GstBuffer *buf;
 
   ogg_stream_clear (&oggpad->map.stream);
+  gst_ogg_mux_clear_payloads (oggpad);
   gst_caps_replace (&oggpad->map.caps, NULL);
 
   if (oggpad->pagebuffers) {
@@ -383,6 +412,7 @@ gst_ogg_pad_data_reset (GstOggMux * ogg_mux, GstOggPadData * oggpad)
   oggpad->keyframe_granule = -1;
   ogg_stream_clear (&oggpad->map.stream);
   ogg_stream_init (&oggpad->map.stream, oggpad->map.serialno);
+  gst_ogg_mux_clear_payloads (oggpad);
 
   if (oggpad->pagebuffers) {
     GstBuffer *buf;
@@ -571,6 +601,71 @@ gst_ogg_mux_buffer_from_page (GstOggMux * mux, ogg_page * page, gboolean delta)
   return buffer;
 }
 
+/* Like gst_ogg_mux_buffer_from_page(), but only the page header is copied.
+ * libogg lays out the page body as the concatenation of the packets that
+ * were swapped in, so the body is taken as shared sub-ranges of the queued
+ * packet buffers instead of being copied out of the stream state. */
+static GstBuffer *
+gst_ogg_mux_buffer_from_page_payloads (GstOggMux * mux, GstOggPadData * pad,
+    ogg_page * page, gboolean delta)
+{
+  GstBuffer *buffer;
+  GstMemory *header;
+  gsize pending, left;
+
+  /* the tracked payloads must cover exactly this page and whatever libogg
+   * still holds back for the next one */
+  pending = pad->map.stream.body_fill - pad->map.stream.body_returned;
+  if (G_UNLIKELY (pad->payload_size != pending + page->body_len)) {
+    GST_WARNING_OBJECT (pad->collect.pad, "payloads out of sync (%"
+        G_GSIZE_FORMAT " tracked, %" G_GSIZE_FORMAT " in stream), copying page",
+        pad->payload_size, pending + page->body_len);
+    /* once libogg has nothing buffered we can start tracking again */
+    if (pending == 0)
+      gst_ogg_mux_clear_payloads (pad);
+    return gst_ogg_mux_buffer_from_page (mux, page, delta);
+  }
+
+  buffer = gst_buffer_new ();
+
+  header = gst_allocator_alloc (NULL, page->header_len, NULL);
+  gst_memory_fill (header, 0, page->header, page->header_len);
+  gst_buffer_append_memory (buffer, header);
+
+  left = page->body_len;
+  while (left > 0) {
+    GstBuffer *payload = g_queue_peek_head (&pad->payloads);
+    gsize avail, len;
+
+    avail = gst_buffer_get_size (payload) - pad->payload_offset;
+    len = MIN (avail, left);
+
+    gst_buffer_copy_into (buffer, payload, GST_BUFFER_COPY_MEMORY,
+        pad->payload_offset, len);
+    left -= len;
+    pad->payload_size -= len;
+
+    if (len == avail) {
+      g_queue_pop_head (&pad->payloads);
+      gst_buffer_unref (payload);
+      pad->payload_offset = 0;
+    } else {
+      pad->payload_offset += len;
+    }
+  }
+
+  GST_BUFFER_OFFSET_END (buffer) = ogg_page_granulepos (page);
+  if (delta)
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  GST_LOG_OBJECT (mux, GST_GP_FORMAT
+      " created buffer %p from ogg page with %u memories",
+      GST_GP_CAST (ogg_page_granulepos (page)), buffer,
+      gst_buffer_n_memory (buffer));
+
+  return buffer;
+}
+
 static GstFlowReturn
 gst_ogg_mux_push_buffer (GstOggMux * mux, GstBuffer * buffer,
     GstOggPadData * oggpad)
@@ -589,6 +684,14 @@ gst_ogg_mux_push_buffer (GstOggMux * mux, GstBuffer * buffer,
       mux->last_ts = run_time;
   }
 
+  /* collecting a list in gst_ogg_mux_pad_queue_page() */
+  if (mux->pending_list) {
+    GST_LOG_OBJECT (mux->srcpad, "adding %p to list, last_ts=%"
+        GST_TIME_FORMAT, buffer, GST_TIME_ARGS (mux->last_ts));
+    gst_buffer_list_add (mux->pending_list, buffer);
+    return GST_FLOW_OK;
+  }
+
   GST_LOG_OBJECT (mux->srcpad, "pushing %p, last_ts=%" GST_TIME_FORMAT,
       buffer, GST_TIME_ARGS (mux->last_ts));
 
@@ -718,7 +821,12 @@ gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggPadData * pad,
     ogg_page * page, gboolean delta)
 {
   GstFlowReturn ret;
-  GstBuffer *buffer = gst_ogg_mux_buffer_from_page (mux, page, delta);
+  GstBuffer *buffer;
+
+  if (mux->zero_copy_active)
+    buffer = gst_ogg_mux_buffer_from_page_payloads (mux, pad, page, delta);
+  else
+    buffer = gst_ogg_mux_buffer_from_page (mux, page, delta);
 
   /* take the timestamp of the first packet on this page */
   GST_BUFFER_TIMESTAMP (buffer) = pad->timestamp;
@@ -738,11 +846,27 @@ gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggPadData * pad,
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)),
       g_queue_get_length (pad->pagebuffers));
 
+  if (mux->use_buffer_list)
+    mux->pending_list = gst_buffer_list_new ();
+
   while (gst_ogg_mux_dequeue_page (mux, &ret)) {
     if (ret != GST_FLOW_OK)
       break;
   }
 
+  if (mux->pending_list) {
+    GstBufferList *list = mux->pending_list;
+
+    mux->pending_list = NULL;
+    if (gst_buffer_list_length (list) > 0) {
+      GST_LOG_OBJECT (mux->srcpad, "pushing list of %u pages",
+          gst_buffer_list_length (list));
+      ret = gst_pad_push_list (mux->srcpad, list);
+    } else {
+      gst_buffer_list_unref (list);
+    }
+  }
+
   return ret;
 }
 
@@ -1901,6 +2025,12 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
     gst_buffer_unmap (buf, &map);
     pad->data_pushed = TRUE;
 
+    /* keep the packet around so that the pages can reference its memory */
+    if (ogg_mux->zero_copy_active && packet.bytes > 0) {
+      g_queue_push_tail (&pad->payloads, gst_buffer_ref (buf));
+      pad->payload_size += packet.bytes;
+    }
+
     gp_time = GST_BUFFER_OFFSET (pad->buffer);
     granulepos = GST_BUFFER_OFFSET_END (pad->buffer);
     timestamp = GST_BUFFER_TIMESTAMP (pad->buffer);
@@ -2116,6 +2246,12 @@ gst_ogg_mux_get_property (GObject * object,
     case ARG_SKELETON:
       g_value_set_boolean (value, ogg_mux->use_skeleton);
       break;
+    case ARG_ZERO_COPY:
+      g_value_set_boolean (value, ogg_mux->zero_copy);
+      break;
+    case ARG_BUFFER_LIST:
+      g_value_set_boolean (value, ogg_mux->use_buffer_list);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2143,6 +2279,12 @@ gst_ogg_mux_set_property (GObject * object,
     case ARG_SKELETON:
       ogg_mux->use_skeleton = g_value_get_boolean (value);
       break;
+    case ARG_ZERO_COPY:
+      ogg_mux->zero_copy = g_value_get_boolean (value);
+      break;
+    case ARG_BUFFER_LIST:
+      ogg_mux->use_buffer_list = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2161,6 +2303,7 @@ gst_ogg_mux_init_collectpads (GstCollectPads * collect)
 
     ogg_stream_clear (&oggpad->map.stream);
     ogg_stream_init (&oggpad->map.stream, oggpad->map.serialno);
+    gst_ogg_mux_clear_payloads (oggpad);
     oggpad->packetno = 0;
     oggpad->pageno = 0;
     oggpad->eos = FALSE;
@@ -2189,6 +2332,7 @@ gst_ogg_mux_clear_collectpads (GstCollectPads * collect)
     GstBuffer *buf;
 
     ogg_stream_clear (&oggpad->map.stream);
+    gst_ogg_mux_clear_payloads (oggpad);
 
     while ((buf = g_queue_pop_head (oggpad->pagebuffers)) != NULL) {
       GST_LOG ("flushing buffer : %p", buf);
@@ -2223,6 +2367,7 @@ gst_ogg_mux_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_NULL_TO_READY:
       break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
+      ogg_mux->zero_copy_active = ogg_mux->zero_copy;
       gst_ogg_mux_clear (ogg_mux);
       gst_ogg_mux_init_collectpads (ogg_mux->collect);
       gst_collect_pads_start (ogg_mux->collect);
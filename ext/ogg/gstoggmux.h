@@ -74,6 +74,11 @@ typedef struct
 
   GQueue *pagebuffers;          /* List of pages in buffers ready for pushing */
 
+  GQueue payloads;              /* packet buffers handed to libogg whose data
+                                   has not been put on a page yet (zero-copy) */
+  gsize payload_offset;         /* bytes of the head payload already used */
+  gsize payload_size;           /* payload bytes not yet put on a page */
+
   gboolean new_page;            /* starting a new page */
   gboolean first_delta;         /* was the first packet in the page a delta */
   gboolean prev_delta;          /* was the previous buffer a delta frame */
@@ -131,6 +136,15 @@ struct _GstOggMux
 
   /* whether to create a skeleton track */
   gboolean use_skeleton;
+
+  /* reference packet memory in output pages instead of copying it out of
+   * libogg, latched from the property when going to PAUSED */
+  gboolean zero_copy;
+  gboolean zero_copy_active;
+
+  /* push pages dequeued together as one buffer list */
+  gboolean use_buffer_list;
+  GstBufferList *pending_list;
 };
 
 struct _GstOggMuxClass
@@ -38,6 +38,7 @@
 
 #include "gstogg.h"
 #include "gstoggstream.h"
+#include "gstoggsync.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_ogg_parse_debug);
 #define GST_CAT_DEFAULT gst_ogg_parse_debug
@@ -409,11 +410,12 @@ gst_ogg_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   while (ret != 0 && result == GST_FLOW_OK) {
     ogg_page page;
 
-    /* We use ogg_sync_pageseek() rather than ogg_sync_pageout() so that we can
-     * track how many bytes the ogg layer discarded (in the case of sync errors,
-     * etc.); this allows us to accurately track the current stream offset
+    /* We use gst_ogg_sync_pageseek() rather than gst_ogg_sync_pageout() so
+     * that we can track how many bytes the ogg layer discarded (in the case of
+     * sync errors, etc.); this allows us to accurately track the current stream
+     * offset
      */
-    ret = ogg_sync_pageseek (&ogg->sync, &page);
+    ret = gst_ogg_sync_pageseek (&ogg->sync, &page);
     if (ret == 0) {
       /* need more data, that's fine... */
       break;
@@ -0,0 +1,258 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * gstoggsync.c: fast ogg page synchronisation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Drop-in replacements for ogg_sync_pageseek() and ogg_sync_pageout().
+ *
+ * libogg checks the page CRC one byte at a time and, when it loses sync,
+ * only skips to the next 'O' before returning to the caller, so resyncing
+ * on a damaged stream or after a seek costs one round trip per candidate
+ * byte. Here the capture pattern search looks for the whole "OggS" pattern
+ * 16 positions at a time and the CRC is computed with slicing-by-8 tables.
+ * The ogg_sync_state bookkeeping is kept identical to libogg's so both
+ * implementations can be mixed on the same state. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "gstoggsync.h"
+
+#define OGG_CRC_POLY 0x04c11db7
+
+static guint32 crc_lookup[8][256];
+
+static gpointer
+init_crc_lookup (gpointer data)
+{
+  guint i, k;
+
+  for (i = 0; i < 256; i++) {
+    guint32 r = i << 24;
+
+    for (k = 0; k < 8; k++)
+      r = (r & 0x80000000) ? (r << 1) ^ OGG_CRC_POLY : (r << 1);
+    crc_lookup[0][i] = r;
+  }
+
+  for (i = 0; i < 256; i++) {
+    for (k = 1; k < 8; k++)
+      crc_lookup[k][i] = (crc_lookup[k - 1][i] << 8) ^
+          crc_lookup[0][crc_lookup[k - 1][i] >> 24];
+  }
+
+  return NULL;
+}
+
+static inline guint32
+ogg_crc_update (guint32 crc, const guint8 * data, gsize len)
+{
+  while (len >= 8) {
+    crc ^= GST_READ_UINT32_BE (data);
+    crc = crc_lookup[7][crc >> 24] ^ crc_lookup[6][(crc >> 16) & 0xff] ^
+        crc_lookup[5][(crc >> 8) & 0xff] ^ crc_lookup[4][crc & 0xff] ^
+        crc_lookup[3][data[4]] ^ crc_lookup[2][data[5]] ^
+        crc_lookup[1][data[6]] ^ crc_lookup[0][data[7]];
+    data += 8;
+    len -= 8;
+  }
+
+  while (len--)
+    crc = (crc << 8) ^ crc_lookup[0][(crc >> 24) ^ *data++];
+
+  return crc;
+}
+
+/* CRC of a page as defined by the Ogg spec, with the checksum field in
+ * the header (bytes 22-25) taken as zero */
+guint32
+gst_ogg_page_checksum (const guint8 * header, gsize header_len,
+    const guint8 * body, gsize body_len)
+{
+  static const guint8 zero[4] = { 0, };
+  static GOnce once = G_ONCE_INIT;
+  guint32 crc;
+
+  g_return_val_if_fail (header_len >= 27, 0);
+
+  g_once (&once, init_crc_lookup, NULL);
+
+  crc = ogg_crc_update (0, header, 22);
+  crc = ogg_crc_update (crc, zero, 4);
+  crc = ogg_crc_update (crc, header + 26, header_len - 26);
+  crc = ogg_crc_update (crc, body, body_len);
+
+  return crc;
+}
+
+/* returns a pointer to the first "OggS" in @data, or NULL */
+const guint8 *
+gst_ogg_find_capture_pattern (const guint8 * data, gsize size)
+{
+  const guint8 *end = data + size;
+
+#if defined (__SSE2__)
+  {
+    const __m128i O = _mm_set1_epi8 ('O');
+    const __m128i g = _mm_set1_epi8 ('g');
+    const __m128i S = _mm_set1_epi8 ('S');
+
+    /* each iteration tests the 16 candidate positions data[0..15], which
+     * needs 3 bytes of lookahead */
+    while (end - data >= 19) {
+      __m128i m;
+      guint mask;
+
+      m = _mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) data), O);
+      m = _mm_and_si128 (m,
+          _mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 1)), g));
+      m = _mm_and_si128 (m,
+          _mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 2)), g));
+      m = _mm_and_si128 (m,
+          _mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 3)), S));
+
+      mask = _mm_movemask_epi8 (m);
+      if (mask)
+        return data + g_bit_nth_lsf (mask, -1);
+
+      data += 16;
+    }
+  }
+#endif
+
+  while (end - data >= 4) {
+    data = memchr (data, 'O', end - data - 3);
+    if (data == NULL)
+      return NULL;
+    if (data[1] == 'g' && data[2] == 'g' && data[3] == 'S')
+      return data;
+    data++;
+  }
+
+  return NULL;
+}
+
+/* Same contract as ogg_sync_pageseek():
+ *  -n  skipped n bytes
+ *   0  page not ready, more data needed
+ *   n  page synced at the current location, page length n bytes
+ */
+glong
+gst_ogg_sync_pageseek (ogg_sync_state * oy, ogg_page * og)
+{
+  guint8 *page = oy->data + oy->returned;
+  const guint8 *next;
+  glong bytes = oy->fill - oy->returned;
+  guint32 crc;
+
+  if (oy->storage < 0)
+    return 0;
+
+  if (oy->headerbytes == 0) {
+    gint headerbytes, i;
+
+    if (bytes < 27)
+      return 0;                 /* not enough for a header */
+
+    /* verify capture pattern */
+    if (memcmp (page, "OggS", 4))
+      goto sync_fail;
+
+    headerbytes = page[26] + 27;
+    if (bytes < headerbytes)
+      return 0;                 /* not enough for header + seg table */
+
+    /* count up body length in the segment table */
+    for (i = 0; i < page[26]; i++)
+      oy->bodybytes += page[27 + i];
+    oy->headerbytes = headerbytes;
+  }
+
+  if (oy->bodybytes + oy->headerbytes > bytes)
+    return 0;
+
+  /* the whole test page is buffered, verify the checksum */
+  crc = gst_ogg_page_checksum (page, oy->headerbytes,
+      page + oy->headerbytes, oy->bodybytes);
+  if (crc != GST_READ_UINT32_LE (page + 22))
+    goto sync_fail;
+
+  if (og) {
+    og->header = page;
+    og->header_len = oy->headerbytes;
+    og->body = page + oy->headerbytes;
+    og->body_len = oy->bodybytes;
+  }
+
+  oy->unsynced = 0;
+  oy->returned += (bytes = oy->headerbytes + oy->bodybytes);
+  oy->headerbytes = 0;
+  oy->bodybytes = 0;
+
+  return bytes;
+
+sync_fail:
+  {
+    oy->headerbytes = 0;
+    oy->bodybytes = 0;
+
+    /* skip to the next full capture pattern; when there is none, keep the
+     * last 3 bytes around as they could be the start of one */
+    next = gst_ogg_find_capture_pattern (page + 1, bytes - 1);
+    if (next == NULL)
+      next = page + MAX (1, bytes - 3);
+
+    oy->returned = next - oy->data;
+
+    return -(glong) (next - page);
+  }
+}
+
+/* Same contract as ogg_sync_pageout() */
+gint
+gst_ogg_sync_pageout (ogg_sync_state * oy, ogg_page * og)
+{
+  if (oy->storage < 0)
+    return 0;
+
+  for (;;) {
+    glong ret = gst_ogg_sync_pageseek (oy, og);
+
+    if (ret > 0)
+      return 1;                 /* have a page */
+
+    if (ret == 0)
+      return 0;                 /* need more data */
+
+    /* head did not start a synced page... skipped some bytes */
+    if (!oy->unsynced) {
+      oy->unsynced = 1;
+      return -1;
+    }
+
+    /* loop, keep looking */
+  }
+}
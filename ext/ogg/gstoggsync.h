@@ -0,0 +1,46 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * gstoggsync.h: fast ogg page synchronisation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_OGG_SYNC_H__
+#define __GST_OGG_SYNC_H__
+
+#include <ogg/ogg.h>
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL
+guint32 gst_ogg_page_checksum (const guint8 * header, gsize header_len,
+    const guint8 * body, gsize body_len);
+
+G_GNUC_INTERNAL
+const guint8 * gst_ogg_find_capture_pattern (const guint8 * data, gsize size);
+
+G_GNUC_INTERNAL
+glong gst_ogg_sync_pageseek (ogg_sync_state * oy, ogg_page * og);
+
+G_GNUC_INTERNAL
+gint gst_ogg_sync_pageout (ogg_sync_state * oy, ogg_page * og);
+
+G_END_DECLS
+
+#endif /* __GST_OGG_SYNC_H__ */
@@ -0,0 +1,320 @@
+/* GStreamer memfd allocator
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstmemfdallocator
+ * @title: GstMemfdAllocator
+ * @short_description: Allocator for huge page and NUMA aware shared memory
+ * @see_also: #GstFdAllocator, #GstMemory
+ *
+ * #GstMemfdAllocator allocates memory from an anonymous memfd. The memory is
+ * #GstFdMemory, the fd can be passed to other processes or devices to share
+ * the memory without copying.
+ *
+ * Large allocations, like raw video frames, can be backed by huge pages to
+ * reduce the TLB misses when walking over them, and placed on the NUMA node
+ * of the thread that allocates them, see #GstMemfdAllocatorFlags.
+ *
+ * The memory is mapped once and stays mapped until it is freed.
+ *
+ * Since: 1.16
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstmemfdallocator.h"
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#if defined (HAVE_MMAP) && defined (SYS_memfd_create)
+#define HAVE_MEMFD 1
+#endif
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+
+/* from linux/mempolicy.h */
+#define MEMFD_MPOL_PREFERRED 1
+#define MEMFD_MAX_NUMA_NODES 1024
+
+/* huge page size when /proc/meminfo doesn't tell */
+#define DEFAULT_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+GST_DEBUG_CATEGORY_STATIC (memfd_debug);
+#define GST_CAT_DEFAULT memfd_debug
+
+/* size of an explicit huge page, 0 when none are reserved */
+static gsize huge_page_size;
+
+G_DEFINE_TYPE (GstMemfdAllocator, gst_memfd_allocator, GST_TYPE_FD_ALLOCATOR);
+
+static void
+probe_huge_pages (void)
+{
+  gchar *contents = NULL;
+  gchar *line;
+  guint64 total = 0, size = 0;
+
+  if (g_file_get_contents ("/proc/meminfo", &contents, NULL, NULL)) {
+    if ((line = strstr (contents, "HugePages_Total:")))
+      total = g_ascii_strtoull (line + strlen ("HugePages_Total:"), NULL, 10);
+    if ((line = strstr (contents, "Hugepagesize:")))
+      size = g_ascii_strtoull (line + strlen ("Hugepagesize:"), NULL,
+          10) * 1024;
+    g_free (contents);
+  }
+
+  if (total > 0)
+    huge_page_size = size > 0 ? size : DEFAULT_HUGE_PAGE_SIZE;
+  else
+    huge_page_size = 0;
+
+  GST_DEBUG ("%" G_GUINT64_FORMAT " huge pages of %" G_GSIZE_FORMAT " bytes",
+      total, huge_page_size);
+}
+
+#ifdef HAVE_MEMFD
+static gint
+create_memfd (guint flags)
+{
+  return syscall (SYS_memfd_create, "gst-memfd",
+      MFD_CLOEXEC | MFD_ALLOW_SEALING | flags);
+}
+
+/* prefer the NUMA node of the calling thread for the pages of @data, the
+ * policy is kept by the shared memory object so it also applies to pages
+ * faulted in later through other mappings */
+static void
+bind_to_local_node (gpointer data, gsize size)
+{
+#if defined (SYS_getcpu) && defined (SYS_mbind)
+  unsigned long nodemask[MEMFD_MAX_NUMA_NODES / (8 * sizeof (unsigned long))];
+  unsigned int cpu, node;
+
+  if (syscall (SYS_getcpu, &cpu, &node, NULL) < 0) {
+    GST_DEBUG ("getcpu failed: %s", g_strerror (errno));
+    return;
+  }
+  if (node >= MEMFD_MAX_NUMA_NODES)
+    return;
+
+  memset (nodemask, 0, sizeof (nodemask));
+  nodemask[node / (8 * sizeof (unsigned long))] |=
+      1UL << (node % (8 * sizeof (unsigned long)));
+
+  if (syscall (SYS_mbind, data, size, MEMFD_MPOL_PREFERRED, nodemask,
+          (unsigned long) MEMFD_MAX_NUMA_NODES, 0) < 0)
+    GST_DEBUG ("mbind to node %u failed: %s", node, g_strerror (errno));
+  else
+    GST_LOG ("%p: bound to node %u (cpu %u)", data, node, cpu);
+#endif
+}
+
+/* takes ownership of @fd */
+static GstMemory *
+create_memory (GstMemfdAllocator * self, gint fd, gsize maxsize,
+    gboolean hugetlb)
+{
+  GstMemory *mem;
+  GstMapInfo info;
+
+  if (ftruncate (fd, maxsize) < 0) {
+    GST_WARNING_OBJECT (self, "could not resize memfd to %" G_GSIZE_FORMAT
+        ": %s", maxsize, g_strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  mem = gst_fd_allocator_alloc (GST_ALLOCATOR_CAST (self), fd, maxsize,
+      GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+
+  /* map now so that we fail early when the huge pages can't be reserved and
+   * to set the policies on the mapping. It stays mapped for the lifetime of
+   * the memory. */
+  if (!gst_memory_map (mem, &info, GST_MAP_READWRITE)) {
+    GST_DEBUG_OBJECT (self, "could not map %" G_GSIZE_FORMAT " bytes",
+        maxsize);
+    gst_memory_unref (mem);
+    return NULL;
+  }
+
+#ifdef MADV_HUGEPAGE
+  if (!hugetlb && (self->flags & GST_MEMFD_ALLOCATOR_FLAG_TRANSPARENT_HUGEPAGE))
+    madvise (info.data, maxsize, MADV_HUGEPAGE);
+#endif
+
+  if (self->flags & GST_MEMFD_ALLOCATOR_FLAG_NUMA_LOCAL)
+    bind_to_local_node (info.data, maxsize);
+
+  gst_memory_unmap (mem, &info);
+
+  return mem;
+}
+#endif
+
+static GstMemory *
+gst_memfd_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+#ifdef HAVE_MEMFD
+  GstMemfdAllocator *self = GST_MEMFD_ALLOCATOR_CAST (allocator);
+  GstMemory *mem = NULL;
+  gsize maxsize, page_size;
+  gint fd;
+
+  page_size = sysconf (_SC_PAGESIZE);
+  maxsize = size + params->prefix + params->padding;
+
+  /* the mapping is page aligned */
+  if (params->align >= page_size)
+    GST_WARNING_OBJECT (self, "alignment %" G_GSIZE_FORMAT " bigger than the"
+        " page size", params->align + 1);
+
+  /* only worth it when we fill most of a huge page */
+  if ((self->flags & GST_MEMFD_ALLOCATOR_FLAG_HUGETLB) && huge_page_size > 0
+      && maxsize >= huge_page_size / 2) {
+    if ((fd = create_memfd (MFD_HUGETLB)) >= 0) {
+      mem = create_memory (self, fd, GST_ROUND_UP_N (maxsize, huge_page_size),
+          TRUE);
+    }
+    /* the huge page pool might only be exhausted for now, so the flags are
+     * left alone and the next allocation tries again */
+    if (mem == NULL)
+      GST_INFO_OBJECT (self, "no huge pages available, using normal pages");
+  }
+
+  if (mem == NULL) {
+    if ((fd = create_memfd (0)) < 0)
+      goto create_failed;
+
+    mem = create_memory (self, fd, GST_ROUND_UP_N (maxsize, page_size), FALSE);
+    if (mem == NULL)
+      return NULL;
+  }
+
+  GST_MINI_OBJECT_FLAGS (mem) |= params->flags;
+  gst_memory_resize (mem, params->prefix, size);
+
+  GST_DEBUG_OBJECT (self, "%p: fd %d size %" G_GSIZE_FORMAT " maxsize %"
+      G_GSIZE_FORMAT, mem, gst_fd_memory_get_fd (mem), size, mem->maxsize);
+
+  return mem;
+
+  /* ERRORS */
+create_failed:
+  {
+    GST_ERROR_OBJECT (self, "memfd_create failed: %s", g_strerror (errno));
+    return NULL;
+  }
+#else /* !HAVE_MEMFD */
+  return NULL;
+#endif
+}
+
+static void
+gst_memfd_allocator_class_init (GstMemfdAllocatorClass * klass)
+{
+  GstAllocatorClass *allocator_class;
+
+  allocator_class = (GstAllocatorClass *) klass;
+
+  allocator_class->alloc = gst_memfd_allocator_alloc;
+
+  GST_DEBUG_CATEGORY_INIT (memfd_debug, "memfdallocator", 0,
+      "memfd allocator");
+
+  probe_huge_pages ();
+}
+
+static void
+gst_memfd_allocator_init (GstMemfdAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+
+  alloc->mem_type = GST_ALLOCATOR_MEMFD;
+
+  /* unlike the fd allocator we allocate the memory ourselves */
+  GST_OBJECT_FLAG_UNSET (allocator, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+
+/**
+ * gst_memfd_allocator_new:
+ * @flags: #GstMemfdAllocatorFlags
+ *
+ * Return a new memfd allocator.
+ *
+ * Returns: (transfer full): a new memfd allocator, or NULL if the allocator
+ *    isn't available. Use gst_object_unref() to release the allocator after
+ *    usage
+ *
+ * Since: 1.16
+ */
+GstAllocator *
+gst_memfd_allocator_new (GstMemfdAllocatorFlags flags)
+{
+#ifdef HAVE_MEMFD
+  GstMemfdAllocator *alloc;
+
+  alloc = g_object_new (GST_TYPE_MEMFD_ALLOCATOR, NULL);
+  gst_object_ref_sink (alloc);
+
+  alloc->flags = flags;
+
+  return GST_ALLOCATOR_CAST (alloc);
+#else
+  return NULL;
+#endif
+}
+
+/**
+ * gst_is_memfd_memory:
+ * @mem: the memory to be check
+ *
+ * Check if @mem is memory allocated by a #GstMemfdAllocator.
+ *
+ * Returns: %TRUE if @mem is memfd memory, otherwise %FALSE
+ *
+ * Since: 1.16
+ */
+gboolean
+gst_is_memfd_memory (GstMemory * mem)
+{
+  g_return_val_if_fail (mem != NULL, FALSE);
+
+  return GST_IS_MEMFD_ALLOCATOR (mem->allocator);
+}
@@ -0,0 +1,116 @@
+/* GStreamer memfd allocator
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_MEMFD_ALLOCATOR_H__
+#define __GST_MEMFD_ALLOCATOR_H__
+
+#include <gst/gst.h>
+#include <gst/allocators/gstfdmemory.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstMemfdAllocator GstMemfdAllocator;
+typedef struct _GstMemfdAllocatorClass GstMemfdAllocatorClass;
+
+#define GST_ALLOCATOR_MEMFD "memfd"
+
+#define GST_TYPE_MEMFD_ALLOCATOR              (gst_memfd_allocator_get_type())
+#define GST_IS_MEMFD_ALLOCATOR(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_MEMFD_ALLOCATOR))
+#define GST_IS_MEMFD_ALLOCATOR_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_MEMFD_ALLOCATOR))
+#define GST_MEMFD_ALLOCATOR_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_MEMFD_ALLOCATOR, GstMemfdAllocatorClass))
+#define GST_MEMFD_ALLOCATOR(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_MEMFD_ALLOCATOR, GstMemfdAllocator))
+#define GST_MEMFD_ALLOCATOR_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_MEMFD_ALLOCATOR, GstMemfdAllocatorClass))
+#define GST_MEMFD_ALLOCATOR_CAST(obj)         ((GstMemfdAllocator *)(obj))
+
+/**
+ * GstMemfdAllocatorFlags:
+ * @GST_MEMFD_ALLOCATOR_FLAG_NONE: plain shared memory
+ * @GST_MEMFD_ALLOCATOR_FLAG_HUGETLB: back memory of at least one huge page
+ *        with explicit huge pages (MFD_HUGETLB). Falls back to normal pages
+ *        when no huge pages are reserved.
+ * @GST_MEMFD_ALLOCATOR_FLAG_TRANSPARENT_HUGEPAGE: ask the kernel to back
+ *        the memory with transparent huge pages when it can
+ * @GST_MEMFD_ALLOCATOR_FLAG_NUMA_LOCAL: place the memory on the NUMA node
+ *        of the thread that allocates it
+ *
+ * Flags to control how the memory of a #GstMemfdAllocator is backed.
+ *
+ * Since: 1.16
+ */
+typedef enum {
+  GST_MEMFD_ALLOCATOR_FLAG_NONE = 0,
+  GST_MEMFD_ALLOCATOR_FLAG_HUGETLB = (1 << 0),
+  GST_MEMFD_ALLOCATOR_FLAG_TRANSPARENT_HUGEPAGE = (1 << 1),
+  GST_MEMFD_ALLOCATOR_FLAG_NUMA_LOCAL = (1 << 2),
+} GstMemfdAllocatorFlags;
+
+/**
+ * GST_MEMFD_ALLOCATOR_FLAG_DEFAULT:
+ *
+ * Huge pages when available, local to the NUMA node of the allocating
+ * thread.
+ *
+ * Since: 1.16
+ */
+#define GST_MEMFD_ALLOCATOR_FLAG_DEFAULT (GST_MEMFD_ALLOCATOR_FLAG_HUGETLB | \
+    GST_MEMFD_ALLOCATOR_FLAG_TRANSPARENT_HUGEPAGE | \
+    GST_MEMFD_ALLOCATOR_FLAG_NUMA_LOCAL)
+
+/**
+ * GstMemfdAllocator:
+ *
+ * Allocator for anonymous shared memory backed by a memfd
+ *
+ * Since: 1.16
+ */
+struct _GstMemfdAllocator
+{
+  GstFdAllocator parent;
+
+  /*< private >*/
+  GstMemfdAllocatorFlags flags;
+
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+struct _GstMemfdAllocatorClass
+{
+  GstFdAllocatorClass parent_class;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+
+GST_ALLOCATORS_API
+GType          gst_memfd_allocator_get_type (void);
+
+GST_ALLOCATORS_API
+GstAllocator * gst_memfd_allocator_new (GstMemfdAllocatorFlags flags);
+
+GST_ALLOCATORS_API
+gboolean       gst_is_memfd_memory (GstMemory * mem);
+
+
+#ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstMemfdAllocator, gst_object_unref)
+#endif
+
+G_END_DECLS
+#endif /* __GST_MEMFD_ALLOCATOR_H__ */
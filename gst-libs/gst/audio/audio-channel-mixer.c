@@ -27,6 +27,16 @@
 #include <math.h>
 #include <string.h>
 
+#if defined (__SSE__)
+#include <xmmintrin.h>
+#endif
+#if defined (__AVX__)
+#include <immintrin.h>
+#endif
+#if defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "audio-channel-mixer.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
@@ -54,8 +64,35 @@ ensure_debug_category (void)
 
 #define PRECISION_INT 10
 
-typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer src,
-    gpointer dst, gint samples);
+/* output channels handled by the SIMD kernel for interleaved float */
+#define ROW_WIDTH 8
+
+#if defined (__SSE__) || defined (__ARM_NEON)
+#define HAVE_MIX_ROWS 1
+#endif
+
+typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer in[],
+    gpointer out[], gint samples);
+
+/* how the matrix is applied, decided when the mixer is created */
+typedef enum
+{
+  /* generic loop over the full matrix */
+  MIX_KIND_DENSE,
+  /* each output is a copy of one input or silence: identity, permutation,
+   * channel dropping or adding silent channels */
+  MIX_KIND_SELECT,
+  /* only the non-zero coefficients are applied, e.g. for most standard
+   * down- and upmixes */
+  MIX_KIND_SPARSE
+} MixKind;
+
+typedef struct
+{
+  gint in;
+  gfloat coeff;
+  gint coeff_int;
+} MixTap;
 
 struct _GstAudioChannelMixer
 {
@@ -70,7 +107,27 @@ struct _GstAudioChannelMixer
    * this is matrix * (2^10) as integers */
   gint **matrix_int;
 
+  gboolean in_planar;
+  gboolean out_planar;
+
+  MixKind kind;
+  /* MIX_KIND_SELECT: input channel of each output, -1 for silence */
+  gint *select;
+  /* non-zero coefficients, taps[tap_offset[o]] to taps[tap_offset[o + 1]]
+   * produce output o */
+  MixTap *taps;
+  gint *tap_offset;
+  /* interleaved float with up to ROW_WIDTH outputs: row i holds the
+   * coefficients of input i for all outputs, zero padded */
+  gfloat *rows;
+  /* scratch space for the first sample of each channel, see
+   * setup_channels() */
+  guint8 **in_ptrs;
+  guint8 **out_ptrs;
+
   MixerFunc func;
+  /* the specialised kernels do not work in place */
+  MixerFunc inplace_func;
 };
 
 /**
@@ -95,6 +152,13 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->matrix_int);
   mix->matrix_int = NULL;
 
+  g_free (mix->select);
+  g_free (mix->taps);
+  g_free (mix->tap_offset);
+  g_free (mix->rows);
+  g_free (mix->in_ptrs);
+  g_free (mix->out_ptrs);
+
   g_slice_free (GstAudioChannelMixer, mix);
 }
 
@@ -694,13 +758,53 @@ gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixerFlags flags,
   return matrix;
 }
 
+/* Sets up a pointer to the first sample of each channel and the distance
+ * between two samples of a channel, so that the specialised kernels handle
+ * interleaved and non-interleaved data alike */
+static inline gint
+setup_channels (const gpointer data[], gboolean planar, gint channels,
+    gint bps, guint8 ** ptrs)
+{
+  gint c;
+
+  if (planar) {
+    for (c = 0; c < channels; c++)
+      ptrs[c] = data[c];
+    return 1;
+  }
+
+  for (c = 0; c < channels; c++)
+    ptrs[c] = (guint8 *) data[0] + c * bps;
+  return channels;
+}
+
+static inline gint16
+finish_int16 (gint32 res)
+{
+  /* remove factor from int matrix */
+  res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT;
+  return CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline gint32
+finish_int32 (gint64 res)
+{
+  res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT;
+  return CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+#define finish_float(res) (res)
+#define finish_double(res) (res)
+
 static void
 gst_audio_channel_mixer_mix_int16 (GstAudioChannelMixer * mix,
-    const gint16 * in_data, gint16 * out_data, gint samples)
+    const gpointer src[], gpointer dst[], gint samples)
 {
   gint in, out, n;
   gint32 res;
   gint inchannels, outchannels;
+  const gint16 *in_data = src[0];
+  gint16 *out_data = dst[0];
 
   inchannels = mix->in_channels;
   outchannels = mix->out_channels;
@@ -712,20 +816,20 @@ gst_audio_channel_mixer_mix_int16 (GstAudioChannelMixer * mix,
       for (in = 0; in < inchannels; in++)
         res += in_data[n * inchannels + in] * mix->matrix_int[in][out];
 
-      /* remove factor from int matrix */
-      res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT;
-      out_data[n * outchannels + out] = CLAMP (res, G_MININT16, G_MAXINT16);
+      out_data[n * outchannels + out] = finish_int16 (res);
     }
   }
 }
 
 static void
 gst_audio_channel_mixer_mix_int32 (GstAudioChannelMixer * mix,
-    const gint32 * in_data, gint32 * out_data, gint samples)
+    const gpointer src[], gpointer dst[], gint samples)
 {
   gint in, out, n;
   gint64 res;
   gint inchannels, outchannels;
+  const gint32 *in_data = src[0];
+  gint32 *out_data = dst[0];
 
   inchannels = mix->in_channels;
   outchannels = mix->out_channels;
@@ -737,20 +841,20 @@ gst_audio_channel_mixer_mix_int32 (GstAudioChannelMixer * mix,
       for (in = 0; in < inchannels; in++)
         res += in_data[n * inchannels + in] * (gint64) mix->matrix_int[in][out];
 
-      /* remove factor from int matrix */
-      res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT;
-      out_data[n * outchannels + out] = CLAMP (res, G_MININT32, G_MAXINT32);
+      out_data[n * outchannels + out] = finish_int32 (res);
     }
   }
 }
 
 static void
 gst_audio_channel_mixer_mix_float (GstAudioChannelMixer * mix,
-    const gfloat * in_data, gfloat * out_data, gint samples)
+    const gpointer src[], gpointer dst[], gint samples)
 {
   gint in, out, n;
   gfloat res;
   gint inchannels, outchannels;
+  const gfloat *in_data = src[0];
+  gfloat *out_data = dst[0];
 
   inchannels = mix->in_channels;
   outchannels = mix->out_channels;
@@ -769,11 +873,13 @@ gst_audio_channel_mixer_mix_float (GstAudioChannelMixer * mix,
 
 static void
 gst_audio_channel_mixer_mix_double (GstAudioChannelMixer * mix,
-    const gdouble * in_data, gdouble * out_data, gint samples)
+    const gpointer src[], gpointer dst[], gint samples)
 {
   gint in, out, n;
   gdouble res;
   gint inchannels, outchannels;
+  const gdouble *in_data = src[0];
+  gdouble *out_data = dst[0];
 
   inchannels = mix->in_channels;
   outchannels = mix->out_channels;
@@ -790,6 +896,324 @@ gst_audio_channel_mixer_mix_double (GstAudioChannelMixer * mix,
   }
 }
 
+#define MAKE_SELECT_FUNC(type)                                          \
+static void                                                             \
+gst_audio_channel_mixer_select_##type (GstAudioChannelMixer * mix,      \
+    const gpointer in[], gpointer out[], gint samples)                  \
+{                                                                       \
+  guint8 **ip = mix->in_ptrs, **op = mix->out_ptrs;                    \
+  gint istride, ostride, o, n;                                          \
+                                                                        \
+  istride = setup_channels (in, mix->in_planar, mix->in_channels,       \
+      sizeof (type), ip);                                               \
+  ostride = setup_channels (out, mix->out_planar, mix->out_channels,    \
+      sizeof (type), op);                                               \
+                                                                        \
+  for (o = 0; o < mix->out_channels; o++) {                             \
+    type *d = (type *) op[o];                                           \
+                                                                        \
+    if (mix->select[o] < 0) {                                           \
+      for (n = 0; n < samples; n++)                                     \
+        d[n * ostride] = 0;                                             \
+    } else {                                                            \
+      const type *s = (const type *) ip[mix->select[o]];                \
+                                                                        \
+      if (istride == 1 && ostride == 1) {                               \
+        memcpy (d, s, samples * sizeof (type));                         \
+      } else {                                                          \
+        for (n = 0; n < samples; n++)                                   \
+          d[n * ostride] = s[n * istride];                              \
+      }                                                                 \
+    }                                                                   \
+  }                                                                     \
+}
+
+MAKE_SELECT_FUNC (gint16)
+MAKE_SELECT_FUNC (gint32)
+MAKE_SELECT_FUNC (gfloat)
+MAKE_SELECT_FUNC (gdouble)
+
+/* only applies the taps of each output. For float, non-interleaved input
+ * and output is handled by mix_taps_planar_gfloat() when available */
+#define MAKE_SPARSE_FUNC(type,atype,field,finish,planar_func)           \
+static void                                                             \
+gst_audio_channel_mixer_sparse_##type (GstAudioChannelMixer * mix,      \
+    const gpointer in[], gpointer out[], gint samples)                  \
+{                                                                       \
+  guint8 **ip = mix->in_ptrs, **op = mix->out_ptrs;                    \
+  gint istride, ostride, o, n, k;                                       \
+                                                                        \
+  istride = setup_channels (in, mix->in_planar, mix->in_channels,       \
+      sizeof (type), ip);                                               \
+  ostride = setup_channels (out, mix->out_planar, mix->out_channels,    \
+      sizeof (type), op);                                               \
+                                                                        \
+  for (o = 0; o < mix->out_channels; o++) {                             \
+    const MixTap *t = mix->taps + mix->tap_offset[o];                   \
+    gint n_taps = mix->tap_offset[o + 1] - mix->tap_offset[o];          \
+    type *d = (type *) op[o];                                           \
+                                                                        \
+    n = 0;                                                              \
+    if (istride == 1 && ostride == 1)                                   \
+      n = planar_func (d, (const type **) ip, t, n_taps, samples);      \
+                                                                        \
+    for (; n < samples; n++) {                                          \
+      atype res = 0;                                                    \
+                                                                        \
+      for (k = 0; k < n_taps; k++)                                      \
+        res += ((const type *) ip[t[k].in])[n * istride] *              \
+            (atype) t[k].field;                                         \
+      d[n * ostride] = finish (res);                                    \
+    }                                                                   \
+  }                                                                     \
+}
+
+/* Vectorised over the samples of one non-interleaved output channel.
+ * Returns the number of samples done. */
+static inline gint
+mix_taps_planar_gfloat (gfloat * d, const gfloat ** ip, const MixTap * t,
+    gint n_taps, gint samples)
+{
+  gint n = 0;
+
+#if defined (__AVX__)
+  for (; n + 8 <= samples; n += 8) {
+    __m256 acc = _mm256_setzero_ps ();
+    gint k;
+
+    for (k = 0; k < n_taps; k++)
+      acc = _mm256_add_ps (acc, _mm256_mul_ps (_mm256_loadu_ps (ip[t[k].in] +
+                  n), _mm256_set1_ps (t[k].coeff)));
+    _mm256_storeu_ps (d + n, acc);
+  }
+#endif
+#if defined (__SSE__)
+  for (; n + 4 <= samples; n += 4) {
+    __m128 acc = _mm_setzero_ps ();
+    gint k;
+
+    for (k = 0; k < n_taps; k++)
+      acc = _mm_add_ps (acc, _mm_mul_ps (_mm_loadu_ps (ip[t[k].in] + n),
+              _mm_set1_ps (t[k].coeff)));
+    _mm_storeu_ps (d + n, acc);
+  }
+#elif defined (__ARM_NEON)
+  for (; n + 4 <= samples; n += 4) {
+    float32x4_t acc = vdupq_n_f32 (0.0f);
+    gint k;
+
+    for (k = 0; k < n_taps; k++)
+      acc = vaddq_f32 (acc, vmulq_n_f32 (vld1q_f32 (ip[t[k].in] + n),
+              t[k].coeff));
+    vst1q_f32 (d + n, acc);
+  }
+#endif
+
+  return n;
+}
+
+#define mix_taps_planar_none(d,ip,t,n_taps,samples) 0
+
+MAKE_SPARSE_FUNC (gint16, gint32, coeff_int, finish_int16,
+    mix_taps_planar_none)
+MAKE_SPARSE_FUNC (gint32, gint64, coeff_int, finish_int32,
+    mix_taps_planar_none)
+MAKE_SPARSE_FUNC (gfloat, gfloat, coeff, finish_float, mix_taps_planar_gfloat)
+MAKE_SPARSE_FUNC (gdouble, gdouble, coeff, finish_double,
+    mix_taps_planar_none)
+
+#ifdef HAVE_MIX_ROWS
+/* Interleaved float with up to ROW_WIDTH output channels, which covers
+ * the common downmixes to stereo and 5.1 and the upmixes from them: each
+ * input sample is broadcast and multiplied with the row of its
+ * coefficients, accumulating all outputs of a sample at once. */
+static void
+gst_audio_channel_mixer_rows_gfloat (GstAudioChannelMixer * mix,
+    const gpointer in[], gpointer out[], gint samples)
+{
+  const gfloat *s = in[0];
+  gfloat *d = out[0];
+  const gfloat *rows = mix->rows;
+  gint inch = mix->in_channels, outch = mix->out_channels;
+  gint n, k, full;
+
+  /* the full width stores spill into the next output samples, which are
+   * written afterwards. Samples from here on are stored partially. */
+  full = samples - (ROW_WIDTH + outch - 1) / outch + 1;
+  full = MAX (full, 0);
+
+#if defined (__AVX__)
+  for (n = 0; n < samples; n++, s += inch, d += outch) {
+    __m256 acc = _mm256_setzero_ps ();
+
+    for (k = 0; k < inch; k++)
+      acc = _mm256_add_ps (acc, _mm256_mul_ps (_mm256_set1_ps (s[k]),
+              _mm256_loadu_ps (rows + k * ROW_WIDTH)));
+
+    if (n < full) {
+      _mm256_storeu_ps (d, acc);
+    } else {
+      gfloat tmp[ROW_WIDTH];
+
+      _mm256_storeu_ps (tmp, acc);
+      memcpy (d, tmp, outch * sizeof (gfloat));
+    }
+  }
+#elif defined (__SSE__)
+  for (n = 0; n < samples; n++, s += inch, d += outch) {
+    __m128 lo = _mm_setzero_ps (), hi = _mm_setzero_ps ();
+
+    if (outch <= 4) {
+      for (k = 0; k < inch; k++)
+        lo = _mm_add_ps (lo, _mm_mul_ps (_mm_set1_ps (s[k]),
+                _mm_loadu_ps (rows + k * ROW_WIDTH)));
+    } else {
+      for (k = 0; k < inch; k++) {
+        __m128 x = _mm_set1_ps (s[k]);
+
+        lo = _mm_add_ps (lo, _mm_mul_ps (x,
+                _mm_loadu_ps (rows + k * ROW_WIDTH)));
+        hi = _mm_add_ps (hi, _mm_mul_ps (x,
+                _mm_loadu_ps (rows + k * ROW_WIDTH + 4)));
+      }
+    }
+
+    if (n < full) {
+      _mm_storeu_ps (d, lo);
+      _mm_storeu_ps (d + 4, hi);
+    } else {
+      gfloat tmp[ROW_WIDTH];
+
+      _mm_storeu_ps (tmp, lo);
+      _mm_storeu_ps (tmp + 4, hi);
+      memcpy (d, tmp, outch * sizeof (gfloat));
+    }
+  }
+#elif defined (__ARM_NEON)
+  for (n = 0; n < samples; n++, s += inch, d += outch) {
+    float32x4_t lo = vdupq_n_f32 (0.0f), hi = vdupq_n_f32 (0.0f);
+
+    for (k = 0; k < inch; k++) {
+      lo = vaddq_f32 (lo, vmulq_n_f32 (vld1q_f32 (rows + k * ROW_WIDTH),
+              s[k]));
+      if (outch > 4)
+        hi = vaddq_f32 (hi, vmulq_n_f32 (vld1q_f32 (rows + k * ROW_WIDTH +
+                    4), s[k]));
+    }
+
+    if (n < full) {
+      vst1q_f32 (d, lo);
+      vst1q_f32 (d + 4, hi);
+    } else {
+      gfloat tmp[ROW_WIDTH];
+
+      vst1q_f32 (tmp, lo);
+      vst1q_f32 (tmp + 4, hi);
+      memcpy (d, tmp, outch * sizeof (gfloat));
+    }
+  }
+#endif
+}
+#endif
+
+/* Analyses the matrix and picks the kernel */
+static void
+gst_audio_channel_mixer_setup_func (GstAudioChannelMixer * mix,
+    GstAudioFormat format)
+{
+  gint i, o, n_taps = 0;
+  gboolean select = TRUE;
+
+  mix->taps = g_new (MixTap, mix->in_channels * mix->out_channels);
+  mix->tap_offset = g_new (gint, mix->out_channels + 1);
+  mix->select = g_new (gint, mix->out_channels);
+  mix->in_ptrs = g_new (guint8 *, mix->in_channels);
+  mix->out_ptrs = g_new (guint8 *, mix->out_channels);
+
+  for (o = 0; o < mix->out_channels; o++) {
+    mix->tap_offset[o] = n_taps;
+    mix->select[o] = -1;
+
+    for (i = 0; i < mix->in_channels; i++) {
+      if (mix->matrix[i][o] == 0.0f)
+        continue;
+
+      mix->taps[n_taps].in = i;
+      mix->taps[n_taps].coeff = mix->matrix[i][o];
+      mix->taps[n_taps].coeff_int = mix->matrix_int[i][o];
+      n_taps++;
+
+      if (mix->select[o] != -1 || mix->matrix[i][o] != 1.0f)
+        select = FALSE;
+      mix->select[o] = i;
+    }
+  }
+  mix->tap_offset[o] = n_taps;
+
+  if (select)
+    mix->kind = MIX_KIND_SELECT;
+  else if (mix->in_planar || mix->out_planar
+      || n_taps * 2 <= mix->in_channels * mix->out_channels)
+    mix->kind = MIX_KIND_SPARSE;
+  else
+    mix->kind = MIX_KIND_DENSE;
+
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+      mix->inplace_func = gst_audio_channel_mixer_mix_int16;
+      if (mix->kind == MIX_KIND_SELECT)
+        mix->func = gst_audio_channel_mixer_select_gint16;
+      else if (mix->kind == MIX_KIND_SPARSE)
+        mix->func = gst_audio_channel_mixer_sparse_gint16;
+      else
+        mix->func = gst_audio_channel_mixer_mix_int16;
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      mix->inplace_func = gst_audio_channel_mixer_mix_int32;
+      if (mix->kind == MIX_KIND_SELECT)
+        mix->func = gst_audio_channel_mixer_select_gint32;
+      else if (mix->kind == MIX_KIND_SPARSE)
+        mix->func = gst_audio_channel_mixer_sparse_gint32;
+      else
+        mix->func = gst_audio_channel_mixer_mix_int32;
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      mix->inplace_func = gst_audio_channel_mixer_mix_float;
+      if (mix->kind == MIX_KIND_SELECT)
+        mix->func = gst_audio_channel_mixer_select_gfloat;
+      else if (mix->kind == MIX_KIND_SPARSE)
+        mix->func = gst_audio_channel_mixer_sparse_gfloat;
+      else
+        mix->func = gst_audio_channel_mixer_mix_float;
+#ifdef HAVE_MIX_ROWS
+      if (mix->kind != MIX_KIND_SELECT && !mix->in_planar && !mix->out_planar
+          && mix->out_channels <= ROW_WIDTH) {
+        mix->rows = g_new0 (gfloat, mix->in_channels * ROW_WIDTH);
+        for (i = 0; i < mix->in_channels; i++)
+          for (o = 0; o < mix->out_channels; o++)
+            mix->rows[i * ROW_WIDTH + o] = mix->matrix[i][o];
+        mix->func = gst_audio_channel_mixer_rows_gfloat;
+      }
+#endif
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      mix->inplace_func = gst_audio_channel_mixer_mix_double;
+      if (mix->kind == MIX_KIND_SELECT)
+        mix->func = gst_audio_channel_mixer_select_gdouble;
+      else if (mix->kind == MIX_KIND_SPARSE)
+        mix->func = gst_audio_channel_mixer_sparse_gdouble;
+      else
+        mix->func = gst_audio_channel_mixer_mix_double;
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+
+  GST_DEBUG ("mix kind %d, %d of %d coefficients used%s", mix->kind, n_taps,
+      mix->in_channels * mix->out_channels, mix->rows ? ", simd rows" : "");
+}
+
 /**
  * gst_audio_channel_mixer_new_with_matrix: (skip):
  * @flags: #GstAudioChannelMixerFlags
@@ -824,6 +1248,9 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
   mix = g_slice_new0 (GstAudioChannelMixer);
   mix->in_channels = in_channels;
   mix->out_channels = out_channels;
+  mix->in_planar = ! !(flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN);
+  mix->out_planar =
+      ! !(flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT);
 
   if (!matrix) {
     /* Generate (potentially truncated) identity matrix */
@@ -870,23 +1297,8 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
   }
 #endif
 
-  switch (format) {
-    case GST_AUDIO_FORMAT_S16:
-      mix->func = (MixerFunc) gst_audio_channel_mixer_mix_int16;
-      break;
-    case GST_AUDIO_FORMAT_S32:
-      mix->func = (MixerFunc) gst_audio_channel_mixer_mix_int32;
-      break;
-    case GST_AUDIO_FORMAT_F32:
-      mix->func = (MixerFunc) gst_audio_channel_mixer_mix_float;
-      break;
-    case GST_AUDIO_FORMAT_F64:
-      mix->func = (MixerFunc) gst_audio_channel_mixer_mix_double;
-      break;
-    default:
-      g_assert_not_reached ();
-      break;
-  }
+  gst_audio_channel_mixer_setup_func (mix, format);
+
   return mix;
 }
 
@@ -992,5 +1404,10 @@ gst_audio_channel_mixer_samples (GstAudioChannelMixer * mix,
   g_return_if_fail (mix != NULL);
   g_return_if_fail (mix->matrix != NULL);
 
-  mix->func (mix, in[0], out[0], samples);
+  /* in place mixing is only possible with interleaved samples, sample by
+   * sample */
+  if (G_UNLIKELY (in[0] == out[0] && !mix->in_planar && !mix->out_planar))
+    mix->inplace_func (mix, in, out, samples);
+  else
+    mix->func (mix, in, out, samples);
 }
@@ -30,12 +30,25 @@
 #include <string.h>
 #include <math.h>
 
+#if defined (__SSE4_1__)
+#include <smmintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "gstaudiopack.h"
 #include "audio-quantize.h"
 
 typedef void (*QuantizeFunc) (GstAudioQuantize * quant, const gpointer src,
     gpointer dst, gint count);
 
+/* number of independent xorshift generators used for dither, they are
+ * stepped together so that the generation vectorizes */
+#define RNG_LANES 8
+
 struct _GstAudioQuantize
 {
   GstAudioDitherMethod dither;
@@ -60,6 +73,8 @@ struct _GstAudioQuantize
   /* noise shaping coefficients */
   gpointer coeffs;
   gint n_coeffs;
+  /* per instance random generator state, unused in reference mode */
+  guint32 rng[RNG_LANES];
 
   QuantizeFunc quantize;
 };
@@ -112,32 +127,15 @@ gst_fast_random_int32 (void)
   (- dither + (gst_fast_random_int32 () & ((dither << 1) - 1)))
 
 static void
-setup_dither_buf (GstAudioQuantize * quant, gint samples)
+setup_dither_buf_reference (GstAudioQuantize * quant, gint32 * d, gint len)
 {
-  gboolean need_init = FALSE;
   gint stride = quant->stride;
-  gint i, len = samples * stride;
+  gint i;
   guint shift = quant->shift;
-  guint32 bias;
-  gint32 dither, *d;
-
-  if (quant->dither_size < len) {
-    quant->dither_size = len;
-    quant->dither_buf = g_realloc (quant->dither_buf, len * sizeof (gint32));
-    need_init = TRUE;
-  }
-
-  bias = quant->bias;
-  d = quant->dither_buf;
+  guint32 bias = quant->bias;
+  gint32 dither;
 
   switch (quant->dither) {
-    case GST_AUDIO_DITHER_NONE:
-      if (need_init) {
-        for (i = 0; i < len; i++)
-          d[i] = 0;
-      }
-      break;
-
     case GST_AUDIO_DITHER_RPDF:
       dither = 1 << (shift);
       for (i = 0; i < len; i++)
@@ -162,6 +160,195 @@ setup_dither_buf (GstAudioQuantize * quant, gint samples)
       }
       break;
     }
+    default:
+      break;
+  }
+}
+
+static void
+seed_random (GstAudioQuantize * quant)
+{
+  guint32 x = 0xdeadbeef;
+  gint i;
+
+  /* spread the seed over the lanes, xorshift needs a non-zero state */
+  for (i = 0; i < RNG_LANES; i++) {
+    x = x * 1103515245 + 12345;
+    quant->rng[i] = (x ^ (x >> 16)) | 1;
+  }
+}
+
+/* Fills @d with @len values (r & mask) + offset, r being the output of the
+ * xorshift32 generators. When @accumulate is set, the values are added to
+ * what is already in @d. */
+static void
+generate_dither (GstAudioQuantize * quant, gint32 * d, gint len,
+    guint32 mask, gint32 offset, gboolean accumulate)
+{
+  guint32 *rng = quant->rng;
+  gint i = 0, l;
+
+#if defined (__SSE2__)
+  {
+    __m128i x0, x1, m, o;
+
+    x0 = _mm_loadu_si128 ((const __m128i *) rng);
+    x1 = _mm_loadu_si128 ((const __m128i *) (rng + 4));
+    m = _mm_set1_epi32 (mask);
+    o = _mm_set1_epi32 (offset);
+
+#define XORSHIFT_SSE2(x)                                \
+    x = _mm_xor_si128 (x, _mm_slli_epi32 (x, 13));      \
+    x = _mm_xor_si128 (x, _mm_srli_epi32 (x, 17));      \
+    x = _mm_xor_si128 (x, _mm_slli_epi32 (x, 5));
+
+    for (; i + RNG_LANES <= len; i += RNG_LANES) {
+      __m128i r0, r1;
+
+      XORSHIFT_SSE2 (x0);
+      XORSHIFT_SSE2 (x1);
+      r0 = _mm_add_epi32 (_mm_and_si128 (x0, m), o);
+      r1 = _mm_add_epi32 (_mm_and_si128 (x1, m), o);
+      if (accumulate) {
+        r0 = _mm_add_epi32 (r0, _mm_loadu_si128 ((const __m128i *) (d + i)));
+        r1 = _mm_add_epi32 (r1,
+            _mm_loadu_si128 ((const __m128i *) (d + i + 4)));
+      }
+      _mm_storeu_si128 ((__m128i *) (d + i), r0);
+      _mm_storeu_si128 ((__m128i *) (d + i + 4), r1);
+    }
+#undef XORSHIFT_SSE2
+
+    _mm_storeu_si128 ((__m128i *) rng, x0);
+    _mm_storeu_si128 ((__m128i *) (rng + 4), x1);
+  }
+#elif defined (__ARM_NEON)
+  {
+    uint32x4_t x0, x1, m;
+    int32x4_t o;
+
+    x0 = vld1q_u32 (rng);
+    x1 = vld1q_u32 (rng + 4);
+    m = vdupq_n_u32 (mask);
+    o = vdupq_n_s32 (offset);
+
+#define XORSHIFT_NEON(x)                                \
+    x = veorq_u32 (x, vshlq_n_u32 (x, 13));             \
+    x = veorq_u32 (x, vshrq_n_u32 (x, 17));             \
+    x = veorq_u32 (x, vshlq_n_u32 (x, 5));
+
+    for (; i + RNG_LANES <= len; i += RNG_LANES) {
+      int32x4_t r0, r1;
+
+      XORSHIFT_NEON (x0);
+      XORSHIFT_NEON (x1);
+      r0 = vaddq_s32 (vreinterpretq_s32_u32 (vandq_u32 (x0, m)), o);
+      r1 = vaddq_s32 (vreinterpretq_s32_u32 (vandq_u32 (x1, m)), o);
+      if (accumulate) {
+        r0 = vaddq_s32 (r0, vld1q_s32 (d + i));
+        r1 = vaddq_s32 (r1, vld1q_s32 (d + i + 4));
+      }
+      vst1q_s32 (d + i, r0);
+      vst1q_s32 (d + i + 4, r1);
+    }
+#undef XORSHIFT_NEON
+
+    vst1q_u32 (rng, x0);
+    vst1q_u32 (rng + 4, x1);
+  }
+#endif
+
+  /* remaining values, or everything when there is no SIMD */
+  while (i < len) {
+    for (l = 0; l < RNG_LANES && i < len; l++, i++) {
+      guint32 x = rng[l];
+
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      rng[l] = x;
+
+      if (accumulate)
+        d[i] += (gint32) (x & mask) + offset;
+      else
+        d[i] = (gint32) (x & mask) + offset;
+    }
+  }
+}
+
+static void
+setup_dither_buf_fast (GstAudioQuantize * quant, gint32 * d, gint len)
+{
+  gint stride = quant->stride;
+  guint shift = quant->shift;
+  guint32 bias = quant->bias;
+  gint32 dither;
+  gint i;
+
+  switch (quant->dither) {
+    case GST_AUDIO_DITHER_RPDF:
+      dither = 1 << (shift);
+      generate_dither (quant, d, len, (dither << 1) - 1, bias - dither, FALSE);
+      break;
+
+    case GST_AUDIO_DITHER_TPDF:
+      dither = 1 << (shift - 1);
+      generate_dither (quant, d, len, (dither << 1) - 1,
+          bias - 2 * dither, FALSE);
+      generate_dither (quant, d, len, (dither << 1) - 1, 0, TRUE);
+      break;
+
+    case GST_AUDIO_DITHER_TPDF_HF:
+    {
+      gint32 *last_random = quant->last_random;
+      gint32 tmp[64], *save;
+
+      if (len == 0)
+        break;
+
+      dither = 1 << (shift - 1);
+      generate_dither (quant, d, len, (dither << 1) - 1, -dither, FALSE);
+
+      /* d[i] = bias + r[i] - r[i - stride], done back to front so that it
+       * can run in place */
+      save = stride <= G_N_ELEMENTS (tmp) ? tmp : g_new (gint32, stride);
+      memcpy (save, d + len - stride, stride * sizeof (gint32));
+      for (i = len - 1; i >= stride; i--)
+        d[i] = bias + d[i] - d[i - stride];
+      for (i = 0; i < stride; i++)
+        d[i] = bias + d[i] - last_random[i];
+      memcpy (last_random, save, stride * sizeof (gint32));
+      if (save != tmp)
+        g_free (save);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+static void
+setup_dither_buf (GstAudioQuantize * quant, gint samples)
+{
+  gboolean need_init = FALSE;
+  gint len = samples * quant->stride;
+  gint32 *d;
+
+  if (quant->dither_size < len) {
+    quant->dither_size = len;
+    quant->dither_buf = g_realloc (quant->dither_buf, len * sizeof (gint32));
+    need_init = TRUE;
+  }
+
+  d = quant->dither_buf;
+
+  if (quant->dither == GST_AUDIO_DITHER_NONE) {
+    if (need_init)
+      memset (d, 0, len * sizeof (gint32));
+  } else if (quant->flags & GST_AUDIO_QUANTIZE_FLAG_REFERENCE) {
+    setup_dither_buf_reference (quant, d, len);
+  } else {
+    setup_dither_buf_fast (quant, d, len);
   }
 }
 
@@ -272,6 +459,155 @@ gst_audio_quantize_quantize_int_dither_noise_shape (GstAudioQuantize * quant,
   memmove (e, &e[len], sizeof (gint32) * stride * nc);
 }
 
+/* Saturating add, same result as ADDSS but without branches */
+static inline gint32
+addss (gint32 res, gint32 val)
+{
+  gint64 r = (gint64) res + val;
+  return CLAMP (r, G_MININT32, G_MAXINT32);
+}
+
+/* One step of the noise shaping filter for a single sample, bit-exact with
+ * gst_audio_quantize_quantize_int_dither_noise_shape() */
+static inline void
+noise_shape_one (const gint32 * s, gint32 * d, const gint32 * dith,
+    gint32 * e, const gint32 * c, gint nc, gint stride, guint32 mask)
+{
+  gint32 v, o, err = 0;
+  gint j;
+
+  for (j = 0; j < nc; j++)
+    err -= e[j * stride] * c[j];
+  err = (err + SROUND) >> (SREDUCE);
+  v = addss (*s, err);
+  o = v;
+  v = addss (v, *dith) & mask;
+  e[nc * stride] = (v - o + RROUND) >> REDUCE;
+  *d = v;
+}
+
+#if defined (__SSE2__)
+static inline __m128i
+mullo_epi32 (__m128i a, __m128i b)
+{
+#if defined (__SSE4_1__)
+  return _mm_mullo_epi32 (a, b);
+#else
+  __m128i lo = _mm_mul_epu32 (a, b);
+  __m128i hi = _mm_mul_epu32 (_mm_srli_si128 (a, 4), _mm_srli_si128 (b, 4));
+
+  return _mm_unpacklo_epi32 (_mm_shuffle_epi32 (lo, _MM_SHUFFLE (0, 0, 2, 0)),
+      _mm_shuffle_epi32 (hi, _MM_SHUFFLE (0, 0, 2, 0)));
+#endif
+}
+
+static inline __m128i
+addss_epi32 (__m128i a, __m128i b)
+{
+  __m128i r = _mm_add_epi32 (a, b);
+  __m128i ovf = _mm_srai_epi32 (_mm_and_si128 (_mm_xor_si128 (a, r),
+          _mm_xor_si128 (b, r)), 31);
+  __m128i sat = _mm_xor_si128 (_mm_srai_epi32 (a, 31),
+      _mm_set1_epi32 (G_MAXINT32));
+
+  return _mm_or_si128 (_mm_and_si128 (ovf, sat), _mm_andnot_si128 (ovf, r));
+}
+
+/* filter 4 adjacent channels of the same frame at once */
+static inline void
+noise_shape_four (const gint32 * s, gint32 * d, const gint32 * dith,
+    gint32 * e, const gint32 * c, gint nc, gint stride, guint32 mask)
+{
+  __m128i v, o, err = _mm_setzero_si128 ();
+  gint j;
+
+  for (j = 0; j < nc; j++)
+    err = _mm_sub_epi32 (err,
+        mullo_epi32 (_mm_loadu_si128 ((const __m128i *) (e + j * stride)),
+            _mm_set1_epi32 (c[j])));
+  err = _mm_srai_epi32 (_mm_add_epi32 (err, _mm_set1_epi32 (SROUND)),
+      SREDUCE);
+  v = addss_epi32 (_mm_loadu_si128 ((const __m128i *) s), err);
+  o = v;
+  v = addss_epi32 (v, _mm_loadu_si128 ((const __m128i *) dith));
+  v = _mm_and_si128 (v, _mm_set1_epi32 (mask));
+  _mm_storeu_si128 ((__m128i *) (e + nc * stride),
+      _mm_srai_epi32 (_mm_add_epi32 (_mm_sub_epi32 (v, o),
+              _mm_set1_epi32 (RROUND)), REDUCE));
+  _mm_storeu_si128 ((__m128i *) d, v);
+}
+#define HAVE_NOISE_SHAPE_FOUR 1
+#elif defined (__ARM_NEON)
+static inline void
+noise_shape_four (const gint32 * s, gint32 * d, const gint32 * dith,
+    gint32 * e, const gint32 * c, gint nc, gint stride, guint32 mask)
+{
+  int32x4_t v, o, err = vdupq_n_s32 (0);
+  gint j;
+
+  for (j = 0; j < nc; j++)
+    err = vmlsq_n_s32 (err, vld1q_s32 (e + j * stride), c[j]);
+  err = vshrq_n_s32 (vaddq_s32 (err, vdupq_n_s32 (SROUND)), SREDUCE);
+  v = vqaddq_s32 (vld1q_s32 (s), err);
+  o = v;
+  v = vqaddq_s32 (v, vld1q_s32 (dith));
+  v = vandq_s32 (v, vdupq_n_s32 (mask));
+  vst1q_s32 (e + nc * stride,
+      vshrq_n_s32 (vaddq_s32 (vsubq_s32 (v, o), vdupq_n_s32 (RROUND)),
+          REDUCE));
+  vst1q_s32 (d, v);
+}
+#define HAVE_NOISE_SHAPE_FOUR 1
+#endif
+
+/* Noise shaping with the number of coefficients known at compile time so
+ * that the filter gets unrolled. With 4 or more interleaved channels, the
+ * channels of a frame don't depend on each other and are filtered 4 at a
+ * time. */
+#define MAKE_NOISE_SHAPE_FUNC(nc)                                       \
+static void                                                             \
+gst_audio_quantize_quantize_int_dither_noise_shape_##nc (               \
+    GstAudioQuantize * quant, const gpointer src, gpointer dst,         \
+    gint samples)                                                       \
+{                                                                       \
+  guint32 mask;                                                         \
+  gint i, ch, len, stride;                                              \
+  const gint32 *s = src, *c, *dith;                                     \
+  gint32 *d = dst, *e;                                                  \
+                                                                        \
+  setup_dither_buf (quant, samples);                                    \
+  setup_error_buf (quant, samples, nc);                                 \
+                                                                        \
+  stride = quant->stride;                                               \
+  len = samples * stride;                                               \
+  dith = quant->dither_buf;                                             \
+  e = quant->error_buf;                                                 \
+  c = quant->coeffs;                                                    \
+  mask = ~quant->mask;                                                  \
+                                                                        \
+  for (i = 0; i < len; i += stride) {                                   \
+    ch = 0;                                                             \
+    NOISE_SHAPE_FOUR_LOOP (nc);                                         \
+    for (; ch < stride; ch++)                                           \
+      noise_shape_one (s + i + ch, d + i + ch, dith + i + ch,           \
+          e + i + ch, c, nc, stride, mask);                             \
+  }                                                                     \
+  memmove (e, &e[len], sizeof (gint32) * stride * nc);                  \
+}
+
+#ifdef HAVE_NOISE_SHAPE_FOUR
+#define NOISE_SHAPE_FOUR_LOOP(nc)                                       \
+    for (; ch + 4 <= stride; ch += 4)                                   \
+      noise_shape_four (s + i + ch, d + i + ch, dith + i + ch,          \
+          e + i + ch, c, nc, stride, mask)
+#else
+#define NOISE_SHAPE_FOUR_LOOP(nc)
+#endif
+
+MAKE_NOISE_SHAPE_FUNC (2)
+MAKE_NOISE_SHAPE_FUNC (5)
+MAKE_NOISE_SHAPE_FUNC (8)
+
 #define MAKE_QUANTIZE_FUNC_NAME(name)                                   \
 gst_audio_quantize_quantize_##name
 
@@ -394,6 +730,26 @@ gst_audio_quantize_setup_quantize_func (GstAudioQuantize * quant)
 
   index = 5 * quant->dither + quant->ns;
   quant->quantize = quantize_funcs[index];
+
+  if (quant->flags & GST_AUDIO_QUANTIZE_FLAG_REFERENCE)
+    return;
+
+  switch (quant->n_coeffs) {
+    case 2:
+      quant->quantize =
+          (QuantizeFunc) MAKE_QUANTIZE_FUNC_NAME (int_dither_noise_shape_2);
+      break;
+    case 5:
+      quant->quantize =
+          (QuantizeFunc) MAKE_QUANTIZE_FUNC_NAME (int_dither_noise_shape_5);
+      break;
+    case 8:
+      quant->quantize =
+          (QuantizeFunc) MAKE_QUANTIZE_FUNC_NAME (int_dither_noise_shape_8);
+      break;
+    default:
+      break;
+  }
 }
 
 static gint
@@ -457,6 +813,7 @@ gst_audio_quantize_new (GstAudioDitherMethod dither,
     quant->bias = 0;
   quant->mask = (1U << quant->shift) - 1;
 
+  seed_random (quant);
   gst_audio_quantize_setup_dither (quant);
   gst_audio_quantize_setup_noise_shaping (quant);
   gst_audio_quantize_setup_quantize_func (quant);
@@ -496,6 +853,7 @@ gst_audio_quantize_reset (GstAudioQuantize * quant)
   g_free (quant->error_buf);
   quant->error_buf = NULL;
   quant->error_size = 0;
+  seed_random (quant);
 }
 
 /**
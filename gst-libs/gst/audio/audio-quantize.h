@@ -69,13 +69,17 @@ typedef enum
  * GstAudioQuantizeFlags:
  * @GST_AUDIO_QUANTIZE_FLAG_NONE: no flags
  * @GST_AUDIO_QUANTIZE_FLAG_NON_INTERLEAVED: samples are non-interleaved
+ * @GST_AUDIO_QUANTIZE_FLAG_REFERENCE: use the scalar reference
+ *    implementation with the original shared random number generator.
+ *    This is slower and mostly useful for testing. (Since: 1.16)
  *
  * Extra flags that can be passed to gst_audio_quantize_new()
  */
 typedef enum
 {
   GST_AUDIO_QUANTIZE_FLAG_NONE            = 0,
-  GST_AUDIO_QUANTIZE_FLAG_NON_INTERLEAVED = (1 << 0)
+  GST_AUDIO_QUANTIZE_FLAG_NON_INTERLEAVED = (1 << 0),
+  GST_AUDIO_QUANTIZE_FLAG_REFERENCE       = (1 << 1)
 } GstAudioQuantizeFlags;
 
 
@@ -32,16 +32,45 @@
  * abstraction for DMA based ringbuffers as well as a pure software
  * implementations.
  *
+ * The writer only blocks when the ringbuffer is full. By default it is woken
+ * up again as soon as the reader frees a segment; with small segments this
+ * means a wakeup and lock handoff for every segment.
+ * gst_audio_ring_buffer_set_wakeup_threshold() makes the writer sleep until a
+ * number of segments are free so that it can fill them in one go, and
+ * gst_audio_ring_buffer_set_latency_probe() collects a histogram of the
+ * writer wakeup latencies to tune this.
+ *
+ * Producers that can generate samples in place, such as a
+ * #GstAudioConverter, can use gst_audio_ring_buffer_prepare_write() to get
+ * the next contiguous writable span of the ringbuffer memory instead of
+ * going through gst_audio_ring_buffer_commit() and an intermediate buffer.
+ *
  */
 
 #include <string.h>
 
 #include <gst/audio/audio.h>
 #include "gstaudioringbuffer.h"
+#include "gstaudioringbufferprivate.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_ring_buffer_debug);
 #define GST_CAT_DEFAULT gst_audio_ring_buffer_debug
 
+#define DEFAULT_WAKEUP_THRESHOLD 1
+
+struct _GstAudioRingBufferPrivate
+{
+  /* ATOMIC, number of free segments the waiting writer needs */
+  gint wakeup_threshold;
+  /* ATOMIC, value of segdone at which the waiting writer is woken up */
+  gint wakeup_segdone;
+
+  /* with LOCK */
+  gboolean probe_latency;
+  gint64 signal_time;
+  guint64 latency_histogram[GST_AUDIO_RING_BUFFER_LATENCY_BUCKETS];
+};
+
 static void gst_audio_ring_buffer_dispose (GObject * object);
 static void gst_audio_ring_buffer_finalize (GObject * object);
 
@@ -51,7 +80,7 @@ static guint default_commit (GstAudioRingBuffer * buf, guint64 * sample,
     guint8 * data, gint in_samples, gint out_samples, gint * accum);
 
 /* ringbuffer abstract base class */
-G_DEFINE_ABSTRACT_TYPE (GstAudioRingBuffer, gst_audio_ring_buffer,
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstAudioRingBuffer, gst_audio_ring_buffer,
     GST_TYPE_OBJECT);
 
 static void
@@ -85,6 +114,12 @@ gst_audio_ring_buffer_init (GstAudioRingBuffer * ringbuffer)
   ringbuffer->flushing = TRUE;
   ringbuffer->segbase = 0;
   ringbuffer->segdone = 0;
+
+  ringbuffer->priv = gst_audio_ring_buffer_get_instance_private (ringbuffer);
+  ringbuffer->priv->wakeup_threshold = DEFAULT_WAKEUP_THRESHOLD;
+  ringbuffer->priv->wakeup_segdone = 0;
+  ringbuffer->priv->probe_latency = FALSE;
+  ringbuffer->priv->signal_time = -1;
 }
 
 static void
@@ -1326,8 +1361,33 @@ gst_audio_ring_buffer_clear_all (GstAudioRingBuffer * buf)
 }
 
 
+static void
+record_wakeup_latency (GstAudioRingBuffer * buf)
+{
+  GstAudioRingBufferPrivate *priv = buf->priv;
+  gint64 latency;
+  guint bucket;
+
+  /* only count wakeups from gst_audio_ring_buffer_advance(), not the ones
+   * from state changes or spurious wakeups */
+  if (!priv->probe_latency || priv->signal_time == -1)
+    return;
+
+  latency = g_get_monotonic_time () - priv->signal_time;
+  priv->signal_time = -1;
+
+  bucket = latency > 0 ? g_bit_storage (latency) : 0;
+  bucket = MIN (bucket, GST_AUDIO_RING_BUFFER_LATENCY_BUCKETS - 1);
+  priv->latency_histogram[bucket]++;
+
+  GST_LOG_OBJECT (buf, "writer woke up after %" G_GINT64_FORMAT " us",
+      latency);
+}
+
+/* wait until segdone reached @wakeup_segdone, returns FALSE when the
+ * ringbuffer is not started or flushing */
 static gboolean
-wait_segment (GstAudioRingBuffer * buf)
+wait_segment (GstAudioRingBuffer * buf, gint wakeup_segdone)
 {
   gint segments;
   gboolean wait = TRUE;
@@ -1359,9 +1419,20 @@ wait_segment (GstAudioRingBuffer * buf)
     goto not_started;
 
   if (G_LIKELY (wait)) {
+    g_atomic_int_set (&buf->priv->wakeup_segdone, wakeup_segdone);
+
     if (g_atomic_int_compare_and_exchange (&buf->waiting, 0, 1)) {
-      GST_DEBUG_OBJECT (buf, "waiting..");
+      /* the reader might have gone past the wakeup point before it could see
+       * our waiting flag, don't sleep for another wakeup in that case */
+      if (g_atomic_int_get (&buf->segdone) - wakeup_segdone >= 0 &&
+          g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0)) {
+        GST_OBJECT_UNLOCK (buf);
+        return TRUE;
+      }
+
+      GST_DEBUG_OBJECT (buf, "waiting for segment %d..", wakeup_segdone);
       GST_AUDIO_RING_BUFFER_WAIT (buf);
+      record_wakeup_latency (buf);
 
       if (G_UNLIKELY (buf->flushing))
         goto flushing;
@@ -1397,119 +1468,54 @@ no_start:
   }
 }
 
+/* wait until segment @writeseg can be written. Returns the number of
+ * segments that can be written contiguously from @writeseg on or 0 when the
+ * ringbuffer is not started or flushing. @skip is set when the segment was
+ * already consumed by the reader and should be dropped. */
+static gint
+wait_writable (GstAudioRingBuffer * buf, gint writeseg, gboolean * skip)
+{
+  gint segdone, segtotal, diff, threshold;
 
+  segtotal = buf->spec.segtotal;
 
-#define REORDER_SAMPLE(d, s, l)                 \
-G_STMT_START {                                  \
-  gint i;                                       \
-  for (i = 0; i < channels; i++) {              \
-    memcpy (d + reorder_map[i] * bps, s + i * bps, bps); \
-  }                                             \
-} G_STMT_END
-
-#define REORDER_SAMPLES(d, s, len)              \
-G_STMT_START {                                  \
-  gint i, len_ = len / bpf;                     \
-  guint8 *d_ = d, *s_ = s;                      \
-  for (i = 0; i < len_; i++) {                  \
-    REORDER_SAMPLE(d_, s_, bpf);                \
-    d_ += bpf;                                  \
-    s_ += bpf;                                  \
-  }                                             \
-} G_STMT_END
-
-#define FWD_SAMPLES(s,se,d,de,F)         	\
-G_STMT_START {					\
-  /* no rate conversion */			\
-  guint towrite = MIN (se + bpf - s, de - d);	\
-  /* simple copy */				\
-  if (!skip)					\
-    F (d, s, towrite);			        \
-  in_samples -= towrite / bpf;			\
-  out_samples -= towrite / bpf;			\
-  s += towrite;					\
-  GST_DEBUG ("copy %u bytes", towrite);		\
-} G_STMT_END
-
-/* in_samples >= out_samples, rate > 1.0 */
-#define FWD_UP_SAMPLES(s,se,d,de,F) 	 	\
-G_STMT_START {					\
-  guint8 *sb = s, *db = d;			\
-  while (s <= se && d < de) {			\
-    if (!skip)					\
-      F (d, s, bpf);	       	        	\
-    s += bpf;					\
-    *accum += outr;				\
-    if ((*accum << 1) >= inr) {			\
-      *accum -= inr;				\
-      d += bpf;					\
-    }						\
-  }						\
-  in_samples -= (s - sb)/bpf;			\
-  out_samples -= (d - db)/bpf;			\
-  GST_DEBUG ("fwd_up end %d/%d",*accum,*toprocess);	\
-} G_STMT_END
-
-/* out_samples > in_samples, for rates smaller than 1.0 */
-#define FWD_DOWN_SAMPLES(s,se,d,de,F) 	 	\
-G_STMT_START {					\
-  guint8 *sb = s, *db = d;			\
-  while (s <= se && d < de) {			\
-    if (!skip)					\
-      F (d, s, bpf);	              		\
-    d += bpf;					\
-    *accum += inr;				\
-    if ((*accum << 1) >= outr) {		\
-      *accum -= outr;				\
-      s += bpf;					\
-    }						\
-  }						\
-  in_samples -= (s - sb)/bpf;			\
-  out_samples -= (d - db)/bpf;			\
-  GST_DEBUG ("fwd_down end %d/%d",*accum,*toprocess);	\
-} G_STMT_END
-
-#define REV_UP_SAMPLES(s,se,d,de,F) 	 	\
-G_STMT_START {					\
-  guint8 *sb = se, *db = d;			\
-  while (s <= se && d < de) {			\
-    if (!skip)					\
-      F (d, se, bpf);                  		\
-    se -= bpf;					\
-    *accum += outr;				\
-    while (d < de && (*accum << 1) >= inr) {	\
-      *accum -= inr;				\
-      d += bpf;					\
-    }						\
-  }						\
-  in_samples -= (sb - se)/bpf;			\
-  out_samples -= (d - db)/bpf;			\
-  GST_DEBUG ("rev_up end %d/%d",*accum,*toprocess);	\
-} G_STMT_END
-
-#define REV_DOWN_SAMPLES(s,se,d,de,F) 	 	\
-G_STMT_START {					\
-  guint8 *sb = se, *db = d;			\
-  while (s <= se && d < de) {			\
-    if (!skip)					\
-      F (d, se, bpf);        			\
-    d += bpf;					\
-    *accum += inr;				\
-    while (s <= se && (*accum << 1) >= outr) {	\
-      *accum -= outr;				\
-      se -= bpf;				\
-    }						\
-  }						\
-  in_samples -= (sb - se)/bpf;			\
-  out_samples -= (d - db)/bpf;			\
-  GST_DEBUG ("rev_down end %d/%d",*accum,*toprocess);	\
-} G_STMT_END
+  while (TRUE) {
+    /* get the currently processed segment */
+    segdone = g_atomic_int_get (&buf->segdone) - buf->segbase;
+
+    /* see how far away it is from the write segment */
+    diff = writeseg - segdone;
+
+    GST_DEBUG_OBJECT (buf,
+        "pointer at %d, write to %d, diff %d, segtotal %d, base %d",
+        segdone, writeseg, diff, segtotal, buf->segbase);
+
+    /* segment too far ahead, writer too slow, we need to drop, hopefully
+     * UNLIKELY. We drop one segment at a time until we caught up. */
+    *skip = diff < 0;
+    if (G_UNLIKELY (*skip))
+      return 1;
+
+    /* write segment is within writable range, everything up to the read
+     * pointer is free but the span can't wrap around the end of the
+     * memory. */
+    if (diff < segtotal)
+      return MIN (segtotal - diff, segtotal - (writeseg % segtotal));
+
+    /* else we need to wait for the segment to become writable. Wait until
+     * the configured number of segments are free so that we don't get woken
+     * up for every segment the reader consumes. */
+    threshold = CLAMP (g_atomic_int_get (&buf->priv->wakeup_threshold), 1,
+        segtotal);
+    if (!wait_segment (buf, buf->segbase + writeseg - segtotal + threshold))
+      return 0;
+  }
+}
 
 static guint
 default_commit (GstAudioRingBuffer * buf, guint64 * sample,
     guint8 * data, gint in_samples, gint out_samples, gint * accum)
 {
-  gint segdone;
   gint segsize, segtotal, channels, bps, bpf, sps;
   guint8 *dest, *data_end;
   gint writeseg, sampleoff;
@@ -1555,46 +1561,18 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
 
   /* write out all samples */
   while (*toprocess > 0) {
-    gint avail;
+    gint avail, segs;
     guint8 *d, *d_end;
     gint ws;
     gboolean skip;
 
-    while (TRUE) {
-      gint diff;
-
-      /* get the currently processed segment */
-      segdone = g_atomic_int_get (&buf->segdone) - buf->segbase;
-
-      /* see how far away it is from the write segment */
-      diff = writeseg - segdone;
-
-      GST_DEBUG_OBJECT (buf,
-          "pointer at %d, write to %d-%d, diff %d, segtotal %d, segsize %d, base %d",
-          segdone, writeseg, sampleoff, diff, segtotal, segsize, buf->segbase);
-
-      /* segment too far ahead, writer too slow, we need to drop, hopefully UNLIKELY */
-      if (G_UNLIKELY (diff < 0)) {
-        /* we need to drop one segment at a time, pretend we wrote a segment. */
-        skip = TRUE;
-        break;
-      }
-
-      /* write segment is within writable range, we can break the loop and
-       * start writing the data. */
-      if (diff < segtotal) {
-        skip = FALSE;
-        break;
-      }
-
-      /* else we need to wait for the segment to become writable. */
-      if (!wait_segment (buf))
-        goto not_started;
-    }
+    segs = wait_writable (buf, writeseg, &skip);
+    if (G_UNLIKELY (segs == 0))
+      goto not_started;
 
-    /* we can write now */
+    /* we can write now, fill the complete contiguous free span in one go */
     ws = writeseg % segtotal;
-    avail = MIN (segsize - sampleoff, bpf * out_samples);
+    avail = MIN (segs * segsize - sampleoff, bpf * out_samples);
 
     d = dest + (ws * segsize) + sampleoff;
     d_end = d + avail;
@@ -1645,9 +1623,9 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
       }
     }
 
-    /* for the next iteration we write to the next segment at the beginning. */
-    writeseg++;
-    sampleoff = 0;
+    /* for the next iteration we continue after the span we just wrote */
+    writeseg += (sampleoff + avail) / segsize;
+    sampleoff = (sampleoff + avail) % segsize;
   }
   /* we consumed all samples here */
   data = data_end + bpf;
@@ -1804,7 +1782,7 @@ gst_audio_ring_buffer_read (GstAudioRingBuffer * buf, guint64 sample,
         break;
 
       /* else we need to wait for the segment to become readable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, buf->segbase + readseg + 1))
         goto not_started;
     }
 
@@ -1909,6 +1887,99 @@ gst_audio_ring_buffer_prepare_read (GstAudioRingBuffer * buf, gint * segment,
   return TRUE;
 }
 
+/**
+ * gst_audio_ring_buffer_prepare_write:
+ * @buf: the #GstAudioRingBuffer to write to
+ * @sample: (inout): the sample position to write to
+ * @writeptr: (out) (array length=len):
+ *     the pointer to the memory where samples can be written
+ * @len: (out): the number of samples that can be written
+ *
+ * Get the contiguous span of ringbuffer memory where the samples from
+ * @sample on should be written. This waits until the segment of @sample can
+ * be written, just like gst_audio_ring_buffer_commit(), and the ringbuffer is
+ * started when it is full and allowed to start.
+ *
+ * The span covers all free segments up to the read pointer or the end of the
+ * ringbuffer memory, so @len can be larger than a segment. The caller writes
+ * up to @len samples in the format of the ringbuffer directly to @writeptr,
+ * for example as the output of gst_audio_converter_samples(), and then
+ * continues from @sample plus the number of samples it wrote. The samples
+ * must have been written before the reader reaches them, there is no
+ * separate commit step.
+ *
+ * When the writer fell behind the reader, @sample is moved forward to the
+ * first sample that can still be written and the caller should drop the
+ * samples in between.
+ *
+ * This can't be used when the ringbuffer needs to reorder channels or the
+ * subclass implements its own commit function.
+ *
+ * Returns: FALSE if the buffer is not started, is flushing or can't be
+ * written to directly.
+ *
+ * MT safe.
+ *
+ * Since: 1.16
+ */
+gboolean
+gst_audio_ring_buffer_prepare_write (GstAudioRingBuffer * buf,
+    guint64 * sample, guint8 ** writeptr, guint * len)
+{
+  GstAudioRingBufferClass *rclass;
+  gint segs, writeseg, sampleoff, sps;
+  gboolean skip;
+
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), FALSE);
+  g_return_val_if_fail (buf->memory != NULL, FALSE);
+  g_return_val_if_fail (sample != NULL, FALSE);
+  g_return_val_if_fail (writeptr != NULL, FALSE);
+  g_return_val_if_fail (len != NULL, FALSE);
+
+  rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
+  if (G_UNLIKELY (buf->need_reorder || rclass->commit != default_commit))
+    goto not_direct;
+
+  sps = buf->samples_per_seg;
+  writeseg = *sample / sps;
+  sampleoff = *sample % sps;
+
+  while (TRUE) {
+    segs = wait_writable (buf, writeseg, &skip);
+    if (G_UNLIKELY (segs == 0))
+      goto not_started;
+
+    if (G_LIKELY (!skip))
+      break;
+
+    GST_DEBUG_OBJECT (buf, "dropping late segment %d", writeseg);
+    writeseg++;
+    sampleoff = 0;
+  }
+
+  *sample = ((guint64) writeseg) * sps + sampleoff;
+  *writeptr = buf->memory + (writeseg % buf->spec.segtotal) *
+      buf->spec.segsize + sampleoff * buf->spec.info.bpf;
+  *len = segs * sps - sampleoff;
+
+  GST_LOG_OBJECT (buf, "prepare write of %u samples to segment %d @%p",
+      *len, writeseg, *writeptr);
+
+  return TRUE;
+
+  /* ERRORS */
+not_direct:
+  {
+    GST_DEBUG_OBJECT (buf, "ringbuffer can't be written to directly");
+    return FALSE;
+  }
+not_started:
+  {
+    GST_DEBUG_OBJECT (buf, "stopped processing");
+    return FALSE;
+  }
+}
+
 /**
  * gst_audio_ring_buffer_advance:
  * @buf: the #GstAudioRingBuffer to advance
@@ -1922,10 +1993,20 @@ gst_audio_ring_buffer_prepare_read (GstAudioRingBuffer * buf, gint * segment,
 void
 gst_audio_ring_buffer_advance (GstAudioRingBuffer * buf, guint advance)
 {
+  gint segdone;
+
   g_return_if_fail (GST_IS_AUDIO_RING_BUFFER (buf));
 
   /* update counter */
-  g_atomic_int_add (&buf->segdone, advance);
+  segdone = g_atomic_int_add (&buf->segdone, advance) + advance;
+
+  /* nobody waiting, this is the common case and doesn't need the lock */
+  if (G_LIKELY (!g_atomic_int_get (&buf->waiting)))
+    return;
+
+  /* don't wake up the waiter before it has enough space to work with */
+  if (segdone - g_atomic_int_get (&buf->priv->wakeup_segdone) < 0)
+    return;
 
   /* the lock is already taken when the waiting flag is set,
    * we grab the lock as well to make sure the waiter is actually
@@ -1933,6 +2014,8 @@ gst_audio_ring_buffer_advance (GstAudioRingBuffer * buf, guint advance)
   if (g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0)) {
     GST_OBJECT_LOCK (buf);
     GST_DEBUG_OBJECT (buf, "signal waiter");
+    if (buf->priv->probe_latency)
+      buf->priv->signal_time = g_get_monotonic_time ();
     GST_AUDIO_RING_BUFFER_SIGNAL (buf);
     GST_OBJECT_UNLOCK (buf);
   }
@@ -2100,3 +2183,119 @@ not_acquired:
     goto done;
   }
 }
+
+/**
+ * gst_audio_ring_buffer_set_wakeup_threshold:
+ * @buf: the #GstAudioRingBuffer
+ * @segments: the number of free segments
+ *
+ * Set the number of segments that must be free before a writer that is
+ * waiting for space in a full ringbuffer is woken up again. The default of 1
+ * wakes up the writer for every segment the device consumes. Larger values
+ * reduce the number of wakeups and lock handoffs with small segments at the
+ * cost of a less full ringbuffer. The value is clamped to the number of
+ * segments of the ringbuffer.
+ *
+ * MT safe.
+ *
+ * Since: 1.16
+ */
+void
+gst_audio_ring_buffer_set_wakeup_threshold (GstAudioRingBuffer * buf,
+    gint segments)
+{
+  g_return_if_fail (GST_IS_AUDIO_RING_BUFFER (buf));
+  g_return_if_fail (segments > 0);
+
+  GST_DEBUG_OBJECT (buf, "wakeup threshold %d segments", segments);
+  g_atomic_int_set (&buf->priv->wakeup_threshold, segments);
+}
+
+/**
+ * gst_audio_ring_buffer_get_wakeup_threshold:
+ * @buf: the #GstAudioRingBuffer
+ *
+ * Get the wakeup threshold set with
+ * gst_audio_ring_buffer_set_wakeup_threshold().
+ *
+ * Returns: the number of free segments a waiting writer waits for.
+ *
+ * MT safe.
+ *
+ * Since: 1.16
+ */
+gint
+gst_audio_ring_buffer_get_wakeup_threshold (GstAudioRingBuffer * buf)
+{
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), 0);
+
+  return g_atomic_int_get (&buf->priv->wakeup_threshold);
+}
+
+/**
+ * gst_audio_ring_buffer_set_latency_probe:
+ * @buf: the #GstAudioRingBuffer
+ * @enabled: whether to measure the wakeup latency
+ *
+ * Enable or disable measuring the time between the device signalling free
+ * space with gst_audio_ring_buffer_advance() and the waiting writer
+ * running again. Enabling the probe clears the histogram.
+ *
+ * MT safe.
+ *
+ * Since: 1.16
+ */
+void
+gst_audio_ring_buffer_set_latency_probe (GstAudioRingBuffer * buf,
+    gboolean enabled)
+{
+  g_return_if_fail (GST_IS_AUDIO_RING_BUFFER (buf));
+
+  GST_OBJECT_LOCK (buf);
+  if (enabled && !buf->priv->probe_latency)
+    memset (buf->priv->latency_histogram, 0,
+        sizeof (buf->priv->latency_histogram));
+  buf->priv->probe_latency = enabled;
+  buf->priv->signal_time = -1;
+  GST_OBJECT_UNLOCK (buf);
+}
+
+/**
+ * gst_audio_ring_buffer_get_latency_histogram:
+ * @buf: the #GstAudioRingBuffer
+ * @histogram: (out caller-allocates) (array length=n_buckets): the
+ *     histogram
+ * @n_buckets: the number of entries in @histogram
+ *
+ * Get the histogram of the writer wakeup latencies collected since the probe
+ * was enabled with gst_audio_ring_buffer_set_latency_probe(). Entry 0 counts
+ * the wakeups that took less than 1 microsecond, entry i > 0 the ones that
+ * took between 2^(i-1) and 2^i microseconds. The last entry also counts all
+ * longer wakeups.
+ *
+ * Returns: the number of entries written to @histogram, at most
+ * #GST_AUDIO_RING_BUFFER_LATENCY_BUCKETS.
+ *
+ * MT safe.
+ *
+ * Since: 1.16
+ */
+guint
+gst_audio_ring_buffer_get_latency_histogram (GstAudioRingBuffer * buf,
+    guint64 * histogram, guint n_buckets)
+{
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), 0);
+  g_return_val_if_fail (histogram != NULL || n_buckets == 0, 0);
+
+  n_buckets = MIN (n_buckets, GST_AUDIO_RING_BUFFER_LATENCY_BUCKETS);
+
+  if (n_buckets == 0)
+    return 0;
+
+  GST_OBJECT_LOCK (buf);
+  memcpy (histogram, buf->priv->latency_histogram,
+      n_buckets * sizeof (guint64));
+  GST_OBJECT_UNLOCK (buf);
+
+  return n_buckets;
+}
@@ -40,6 +40,7 @@ G_BEGIN_DECLS
 typedef struct _GstAudioRingBuffer GstAudioRingBuffer;
 typedef struct _GstAudioRingBufferClass GstAudioRingBufferClass;
 typedef struct _GstAudioRingBufferSpec GstAudioRingBufferSpec;
+typedef struct _GstAudioRingBufferPrivate GstAudioRingBufferPrivate;
 
 /**
  * GstAudioRingBufferCallback:
@@ -161,6 +162,16 @@ struct _GstAudioRingBufferSpec
 #define GST_AUDIO_RING_BUFFER_SIGNAL(buf)   (g_cond_signal (GST_AUDIO_RING_BUFFER_GET_COND (buf)))
 #define GST_AUDIO_RING_BUFFER_BROADCAST(buf)(g_cond_broadcast (GST_AUDIO_RING_BUFFER_GET_COND (buf)))
 
+/**
+ * GST_AUDIO_RING_BUFFER_LATENCY_BUCKETS:
+ *
+ * The number of buckets in the wakeup latency histogram, see
+ * gst_audio_ring_buffer_get_latency_histogram().
+ *
+ * Since: 1.16
+ */
+#define GST_AUDIO_RING_BUFFER_LATENCY_BUCKETS 24
+
 /**
  * GstAudioRingBuffer:
  * @cond: used to signal start/stop/pause/resume actions
@@ -213,8 +224,10 @@ struct _GstAudioRingBuffer {
 
   GDestroyNotify              cb_data_notify;
 
+  GstAudioRingBufferPrivate  *priv;
+
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING - 1];
+  gpointer _gst_reserved[GST_PADDING - 2];
 };
 
 /**
@@ -385,9 +398,10 @@ void            gst_audio_ring_buffer_set_timestamp   (GstAudioRingBuffer * buf,
                                                        timestamp);
 
 /* mostly protected */
-/* not yet implemented
-gboolean        gst_audio_ring_buffer_prepare_write   (GstAudioRingBuffer *buf, gint *segment, guint8 **writeptr, gint *len);
-*/
+
+GST_AUDIO_API
+gboolean        gst_audio_ring_buffer_prepare_write   (GstAudioRingBuffer *buf, guint64 *sample,
+                                                       guint8 **writeptr, guint *len);
 
 GST_AUDIO_API
 gboolean        gst_audio_ring_buffer_prepare_read    (GstAudioRingBuffer *buf, gint *segment,
@@ -402,6 +416,21 @@ void            gst_audio_ring_buffer_advance         (GstAudioRingBuffer *buf,
 GST_AUDIO_API
 void            gst_audio_ring_buffer_may_start       (GstAudioRingBuffer *buf, gboolean allowed);
 
+/* writer wakeups */
+
+GST_AUDIO_API
+void            gst_audio_ring_buffer_set_wakeup_threshold (GstAudioRingBuffer *buf, gint segments);
+
+GST_AUDIO_API
+gint            gst_audio_ring_buffer_get_wakeup_threshold (GstAudioRingBuffer *buf);
+
+GST_AUDIO_API
+void            gst_audio_ring_buffer_set_latency_probe    (GstAudioRingBuffer *buf, gboolean enabled);
+
+GST_AUDIO_API
+guint           gst_audio_ring_buffer_get_latency_histogram (GstAudioRingBuffer *buf,
+                                                             guint64 *histogram, guint n_buckets);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstAudioRingBuffer, gst_object_unref)
 #endif
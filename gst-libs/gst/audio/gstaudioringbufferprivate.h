@@ -0,0 +1,141 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GST_AUDIO_RING_BUFFER_PRIVATE_H_
+#define _GST_AUDIO_RING_BUFFER_PRIVATE_H_
+
+#include <string.h>
+#include <gst/gst.h>
+
+/* The sample conversion of gst_audio_ring_buffer_commit(), shared with the
+ * ringbuffers of this module that write straight into device memory. This
+ * header is not installed.
+ *
+ * The macros copy the samples from @s up to the last sample @se into @d up
+ * to @de with the copy function @F, converting the rate when needed. They
+ * use channels, bps, bpf, reorder_map, skip, inr, outr, accum, toprocess,
+ * in_samples and out_samples from the calling function. */
+
+#define REORDER_SAMPLE(d, s, l)                 \
+G_STMT_START {                                  \
+  gint i;                                       \
+  for (i = 0; i < channels; i++) {              \
+    memcpy (d + reorder_map[i] * bps, s + i * bps, bps); \
+  }                                             \
+} G_STMT_END
+
+#define REORDER_SAMPLES(d, s, len)              \
+G_STMT_START {                                  \
+  gint i, len_ = len / bpf;                     \
+  guint8 *d_ = d, *s_ = s;                      \
+  for (i = 0; i < len_; i++) {                  \
+    REORDER_SAMPLE(d_, s_, bpf);                \
+    d_ += bpf;                                  \
+    s_ += bpf;                                  \
+  }                                             \
+} G_STMT_END
+
+#define FWD_SAMPLES(s,se,d,de,F)         	\
+G_STMT_START {					\
+  /* no rate conversion */			\
+  guint towrite = MIN (se + bpf - s, de - d);	\
+  /* simple copy */				\
+  if (!skip)					\
+    F (d, s, towrite);			        \
+  in_samples -= towrite / bpf;			\
+  out_samples -= towrite / bpf;			\
+  s += towrite;					\
+  GST_DEBUG ("copy %u bytes", towrite);		\
+} G_STMT_END
+
+/* in_samples >= out_samples, rate > 1.0 */
+#define FWD_UP_SAMPLES(s,se,d,de,F) 	 	\
+G_STMT_START {					\
+  guint8 *sb = s, *db = d;			\
+  while (s <= se && d < de) {			\
+    if (!skip)					\
+      F (d, s, bpf);	       	        	\
+    s += bpf;					\
+    *accum += outr;				\
+    if ((*accum << 1) >= inr) {			\
+      *accum -= inr;				\
+      d += bpf;					\
+    }						\
+  }						\
+  in_samples -= (s - sb)/bpf;			\
+  out_samples -= (d - db)/bpf;			\
+  GST_DEBUG ("fwd_up end %d/%d",*accum,*toprocess);	\
+} G_STMT_END
+
+/* out_samples > in_samples, for rates smaller than 1.0 */
+#define FWD_DOWN_SAMPLES(s,se,d,de,F) 	 	\
+G_STMT_START {					\
+  guint8 *sb = s, *db = d;			\
+  while (s <= se && d < de) {			\
+    if (!skip)					\
+      F (d, s, bpf);	              		\
+    d += bpf;					\
+    *accum += inr;				\
+    if ((*accum << 1) >= outr) {		\
+      *accum -= outr;				\
+      s += bpf;					\
+    }						\
+  }						\
+  in_samples -= (s - sb)/bpf;			\
+  out_samples -= (d - db)/bpf;			\
+  GST_DEBUG ("fwd_down end %d/%d",*accum,*toprocess);	\
+} G_STMT_END
+
+#define REV_UP_SAMPLES(s,se,d,de,F) 	 	\
+G_STMT_START {					\
+  guint8 *sb = se, *db = d;			\
+  while (s <= se && d < de) {			\
+    if (!skip)					\
+      F (d, se, bpf);                  		\
+    se -= bpf;					\
+    *accum += outr;				\
+    while (d < de && (*accum << 1) >= inr) {	\
+      *accum -= inr;				\
+      d += bpf;					\
+    }						\
+  }						\
+  in_samples -= (sb - se)/bpf;			\
+  out_samples -= (d - db)/bpf;			\
+  GST_DEBUG ("rev_up end %d/%d",*accum,*toprocess);	\
+} G_STMT_END
+
+#define REV_DOWN_SAMPLES(s,se,d,de,F) 	 	\
+G_STMT_START {					\
+  guint8 *sb = se, *db = d;			\
+  while (s <= se && d < de) {			\
+    if (!skip)					\
+      F (d, se, bpf);        			\
+    d += bpf;					\
+    *accum += inr;				\
+    while (s <= se && (*accum << 1) >= outr) {	\
+      *accum -= outr;				\
+      se -= bpf;				\
+    }						\
+  }						\
+  in_samples -= (sb - se)/bpf;			\
+  out_samples -= (d - db)/bpf;			\
+  GST_DEBUG ("rev_down end %d/%d",*accum,*toprocess);	\
+} G_STMT_END
+
+#endif /* _GST_AUDIO_RING_BUFFER_PRIVATE_H_ */
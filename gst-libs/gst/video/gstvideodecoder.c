@@ -89,6 +89,14 @@
  *       should not expect any more data to be arriving, and it should parse and
  *       remaining frames and call gst_video_decoder_have_frame() if possible.
  *
+ *   * Frame threading
+ *
+ *     * Subclasses that can decode independent frames concurrently can call
+ *       gst_video_decoder_set_frame_threads(). @handle_frame is then called
+ *       from a pool of worker threads for up to that many frames at a time,
+ *       and the frames they finish are pushed downstream in the order they
+ *       were handed out.
+ *
  * The subclass is responsible for providing pad template caps for
  * source and sink pads. The pads need to be named "sink" and "src". It also
  * needs to provide information about the ouptput caps, when they are known.
@@ -408,9 +416,51 @@ struct _GstVideoDecoderPrivate
 #endif
   /* change buffer meta like pts, duration */
   gboolean change_buffer_meta;
+
+  /* frame threading */
+  guint frame_threads;          /* OBJECT_LOCK */
+  GThreadPool *frame_pool;
+  /* FrameJob, in dispatch order. The queue itself is only used from the
+   * streaming thread, the jobs are shared with the workers and protected
+   * by frame_jobs_lock */
+  GQueue frame_jobs;
+  GMutex frame_jobs_lock;
+  GCond frame_jobs_cond;
+  /* last flow return of the committed jobs, returned to the workers */
+  GstFlowReturn frame_jobs_ret;
 };
 
+typedef enum
+{
+  FRAME_ACTION_FINISH,
+  FRAME_ACTION_DROP,
+  FRAME_ACTION_RELEASE
+} FrameAction;
+
+typedef struct
+{
+  FrameAction action;
+  GstVideoCodecFrame *frame;
+} FrameJobAction;
+
+/* One handle_frame() call running in a worker thread. The finish, drop and
+ * release calls it makes are recorded and performed by the streaming thread
+ * once all jobs dispatched before it were committed. */
+typedef struct
+{
+  GstVideoDecoder *decoder;
+  GstVideoCodecFrame *frame;
+  guint32 system_frame_number;
+  gboolean done;
+  GstFlowReturn ret;
+  GQueue actions;
+} FrameJob;
+
+/* the job handled by the current thread, if it is a frame worker */
+static GPrivate current_frame_job = G_PRIVATE_INIT (NULL);
+
 #define DEFAULT_CHANGE_BUFFER_META TRUE
+#define DEFAULT_FRAME_THREADS 1
 
 enum
 {
@@ -450,6 +500,8 @@ static gboolean gst_video_decoder_src_query (GstPad * pad, GstObject * parent,
 static void gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     gboolean flush_hard);
 
+static GstFlowReturn gst_video_decoder_drain_frame_jobs (GstVideoDecoder *
+    decoder, gboolean discard);
 static GstFlowReturn gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame);
 
@@ -616,6 +668,12 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
   decoder->priv->max_latency = 0;
   decoder->priv->change_buffer_meta = DEFAULT_CHANGE_BUFFER_META;
 
+  decoder->priv->frame_threads = DEFAULT_FRAME_THREADS;
+  g_queue_init (&decoder->priv->frame_jobs);
+  g_mutex_init (&decoder->priv->frame_jobs_lock);
+  g_cond_init (&decoder->priv->frame_jobs_cond);
+  decoder->priv->frame_jobs_ret = GST_FLOW_OK;
+
   gst_video_decoder_reset (decoder, TRUE, TRUE);
 }
 
@@ -797,6 +855,9 @@ gst_video_decoder_setcaps (GstVideoDecoder * decoder, GstCaps * caps)
   if (G_UNLIKELY (state == NULL))
     goto parse_fail;
 
+  /* frames in flight were decoded with the old format */
+  gst_video_decoder_drain_frame_jobs (decoder, FALSE);
+
   if (decoder_class->set_format)
     ret = decoder_class->set_format (decoder, state);
 
@@ -844,6 +905,13 @@ gst_video_decoder_finalize (GObject * object)
 
   GST_DEBUG_OBJECT (object, "finalize");
 
+  if (decoder->priv->frame_pool) {
+    g_thread_pool_free (decoder->priv->frame_pool, FALSE, TRUE);
+    decoder->priv->frame_pool = NULL;
+  }
+  g_mutex_clear (&decoder->priv->frame_jobs_lock);
+  g_cond_clear (&decoder->priv->frame_jobs_cond);
+
   g_rec_mutex_clear (&decoder->stream_lock);
 
   if (decoder->priv->input_adapter) {
@@ -882,6 +950,10 @@ gst_video_decoder_flush (GstVideoDecoder * dec, gboolean hard)
 
   GST_LOG_OBJECT (dec, "flush hard %d", hard);
 
+  /* wait for the frames in flight, their output is discarded */
+  gst_video_decoder_drain_frame_jobs (dec, TRUE);
+  dec->priv->frame_jobs_ret = GST_FLOW_OK;
+
   /* Inform subclass */
   if (klass->reset) {
     GST_FIXME_OBJECT (dec, "GstVideoDecoder::reset() is deprecated");
@@ -1014,7 +1086,7 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
 {
   GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (dec);
   GstVideoDecoderPrivate *priv = dec->priv;
-  GstFlowReturn ret = GST_FLOW_OK;
+  GstFlowReturn ret = GST_FLOW_OK, drain_ret;
 
   if (dec->input_segment.rate > 0.0 || priv->reverse_decode_keyframe) {
     /* Forward mode, if unpacketized, give the child class
@@ -1023,12 +1095,23 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
       ret = gst_video_decoder_parse_available (dec, TRUE, FALSE);
     }
 
+    /* everything handed to frame threads has to be out before the
+     * subclass drains, the first error is returned */
+    drain_ret = gst_video_decoder_drain_frame_jobs (dec, FALSE);
+    if (ret == GST_FLOW_OK)
+      ret = drain_ret;
+
     if (at_eos) {
-      if (decoder_class->finish)
-        ret = decoder_class->finish (dec);
+      if (decoder_class->finish) {
+        drain_ret = decoder_class->finish (dec);
+        if (ret == GST_FLOW_OK)
+          ret = drain_ret;
+      }
     } else {
       if (decoder_class->drain) {
-        ret = decoder_class->drain (dec);
+        drain_ret = decoder_class->drain (dec);
+        if (ret == GST_FLOW_OK)
+          ret = drain_ret;
       } else {
         GST_FIXME_OBJECT (dec, "Sub-class should implement drain()");
       }
@@ -1798,6 +1881,16 @@ gst_video_decoder_src_query_default (GstVideoDecoder * dec, GstQuery * query)
           max_latency = GST_CLOCK_TIME_NONE;
         else
           max_latency += dec->priv->max_latency;
+
+        /* with frame threads, up to that many frames are held back */
+        if (dec->priv->frame_threads > 1) {
+          GstClockTime threads_latency =
+              dec->priv->frame_threads * dec->priv->qos_frame_duration;
+
+          min_latency += threads_latency;
+          if (max_latency != GST_CLOCK_TIME_NONE)
+            max_latency += threads_latency;
+        }
         GST_OBJECT_UNLOCK (dec);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -2612,6 +2705,17 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      /* the streaming thread is stopped, let the workers finish before the
+       * subclass tears down its state */
+      GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+      gst_video_decoder_drain_frame_jobs (decoder, TRUE);
+      if (decoder->priv->frame_pool) {
+        g_thread_pool_free (decoder->priv->frame_pool, FALSE, TRUE);
+        decoder->priv->frame_pool = NULL;
+      }
+      decoder->priv->frame_jobs_ret = GST_FLOW_OK;
+      GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
       if (decoder_class->stop)
         stopped = decoder_class->stop (decoder);
 
@@ -2908,6 +3012,35 @@ no_output_buffer:
   }
 }
 
+/* When called from a frame thread, records @action on @frame for the
+ * streaming thread and returns %TRUE */
+static gboolean
+gst_video_decoder_defer_frame_action (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, FrameAction action, GstFlowReturn * ret)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  FrameJob *job = g_private_get (&current_frame_job);
+  FrameJobAction *act;
+
+  if (G_LIKELY (job == NULL || job->decoder != decoder))
+    return FALSE;
+
+  GST_LOG_OBJECT (decoder, "deferring action %d on frame %p (#%d)", action,
+      frame, frame->system_frame_number);
+
+  act = g_slice_new (FrameJobAction);
+  act->action = action;
+  act->frame = frame;
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  g_queue_push_tail (&job->actions, act);
+  if (ret)
+    *ret = priv->frame_jobs_ret;
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  return TRUE;
+}
+
 /**
  * gst_video_decoder_release_frame:
  * @dec: a #GstVideoDecoder
@@ -2925,6 +3058,10 @@ gst_video_decoder_release_frame (GstVideoDecoder * dec,
 {
   GList *link;
 
+  if (gst_video_decoder_defer_frame_action (dec, frame, FRAME_ACTION_RELEASE,
+          NULL))
+    return;
+
   /* unref once from the list */
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
   link = g_list_find (dec->priv->frames, frame);
@@ -2961,6 +3098,11 @@ gst_video_decoder_drop_frame (GstVideoDecoder * dec, GstVideoCodecFrame * frame)
   GstSegment *segment;
   GstMessage *qos_msg;
   gdouble proportion;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (gst_video_decoder_defer_frame_action (dec, frame, FRAME_ACTION_DROP,
+          &ret))
+    return ret;
 
   GST_LOG_OBJECT (dec, "drop frame %p", frame);
 
@@ -3085,6 +3227,10 @@ gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
   GstBuffer *output_buffer;
   gboolean needs_reconfigure = FALSE;
 
+  if (gst_video_decoder_defer_frame_action (decoder, frame,
+          FRAME_ACTION_FINISH, &ret))
+    return ret;
+
   GST_LOG_OBJECT (decoder, "finish frame %p", frame);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
@@ -3473,6 +3619,187 @@ gst_video_decoder_have_frame (GstVideoDecoder * decoder)
   return ret;
 }
 
+static void
+gst_video_decoder_frame_job_func (FrameJob * job, GstVideoDecoder * decoder)
+{
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (decoder, "handling frame #%u", job->system_frame_number);
+
+  g_private_set (&current_frame_job, job);
+  ret = decoder_class->handle_frame (decoder, job->frame);
+  g_private_set (&current_frame_job, NULL);
+
+  if (ret != GST_FLOW_OK)
+    GST_DEBUG_OBJECT (decoder, "frame #%u flow %s", job->system_frame_number,
+        gst_flow_get_name (ret));
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  job->frame = NULL;
+  job->ret = ret;
+  job->done = TRUE;
+  g_cond_broadcast (&priv->frame_jobs_cond);
+  g_mutex_unlock (&priv->frame_jobs_lock);
+}
+
+/* Performs the calls the subclass made from a finished job, with the
+ * STREAM_LOCK. With @discard, decoded frames are released instead of
+ * pushed. */
+static GstFlowReturn
+gst_video_decoder_commit_frame_job (GstVideoDecoder * decoder, FrameJob * job,
+    gboolean discard)
+{
+  GstFlowReturn ret = job->ret, res;
+  FrameJobAction *act;
+
+  GST_LOG_OBJECT (decoder, "committing frame #%u, %u actions",
+      job->system_frame_number, job->actions.length);
+
+  while ((act = g_queue_pop_head (&job->actions))) {
+    if (discard || act->action == FRAME_ACTION_RELEASE) {
+      gst_video_decoder_release_frame (decoder, act->frame);
+      res = GST_FLOW_OK;
+    } else if (act->action == FRAME_ACTION_DROP) {
+      res = gst_video_decoder_drop_frame (decoder, act->frame);
+    } else {
+      res = gst_video_decoder_finish_frame (decoder, act->frame);
+    }
+
+    if (ret == GST_FLOW_OK)
+      ret = res;
+
+    g_slice_free (FrameJobAction, act);
+  }
+  g_slice_free (FrameJob, job);
+
+  return ret;
+}
+
+/* Must be called holding the GST_VIDEO_DECODER_STREAM_LOCK. Commits the
+ * finished jobs at the head of the queue, waiting until fewer than
+ * @max_jobs are left in flight. The workers never take the STREAM_LOCK,
+ * so waiting for them here is safe. */
+static GstFlowReturn
+gst_video_decoder_commit_frame_jobs (GstVideoDecoder * decoder,
+    guint max_jobs, gboolean discard)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret = GST_FLOW_OK, res;
+  FrameJob *job;
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  while ((job = g_queue_peek_head (&priv->frame_jobs))) {
+    if (!job->done) {
+      if (priv->frame_jobs.length < max_jobs)
+        break;
+      GST_LOG_OBJECT (decoder, "waiting for frame #%u",
+          job->system_frame_number);
+      g_cond_wait (&priv->frame_jobs_cond, &priv->frame_jobs_lock);
+      continue;
+    }
+    g_queue_pop_head (&priv->frame_jobs);
+    g_mutex_unlock (&priv->frame_jobs_lock);
+
+    res = gst_video_decoder_commit_frame_job (decoder, job, discard);
+    if (ret == GST_FLOW_OK)
+      ret = res;
+
+    g_mutex_lock (&priv->frame_jobs_lock);
+    if (res != GST_FLOW_OK)
+      priv->frame_jobs_ret = res;
+  }
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  return ret;
+}
+
+/* Must be called holding the GST_VIDEO_DECODER_STREAM_LOCK. Waits for all
+ * frames in flight and commits them. */
+static GstFlowReturn
+gst_video_decoder_drain_frame_jobs (GstVideoDecoder * decoder,
+    gboolean discard)
+{
+  if (G_LIKELY (g_queue_is_empty (&decoder->priv->frame_jobs)))
+    return GST_FLOW_OK;
+
+  GST_DEBUG_OBJECT (decoder, "draining %u frame jobs, discard %d",
+      decoder->priv->frame_jobs.length, discard);
+
+  return gst_video_decoder_commit_frame_jobs (decoder, 0, discard);
+}
+
+/* Returns the number of frame threads to use for @frame, 0 if it has to be
+ * handled in the streaming thread */
+static guint
+gst_video_decoder_get_frame_threads_for (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GError *err = NULL;
+  guint n_threads;
+
+  GST_OBJECT_LOCK (decoder);
+  n_threads = priv->frame_threads;
+  GST_OBJECT_UNLOCK (decoder);
+
+  /* reverse playback relies on the decode and output queues being filled
+   * from this thread */
+  if (n_threads <= 1 || decoder->input_segment.rate < 0.0)
+    return 0;
+
+  if (decoder_class->serialize_frame
+      && decoder_class->serialize_frame (decoder, frame))
+    return 0;
+
+  if (priv->frame_pool == NULL) {
+    priv->frame_pool =
+        g_thread_pool_new ((GFunc) gst_video_decoder_frame_job_func, decoder,
+        n_threads, FALSE, &err);
+    if (priv->frame_pool == NULL) {
+      GST_WARNING_OBJECT (decoder, "failed to create frame threads: %s",
+          err->message);
+      g_clear_error (&err);
+      return 0;
+    }
+  } else if (g_thread_pool_get_max_threads (priv->frame_pool) != n_threads) {
+    g_thread_pool_set_max_threads (priv->frame_pool, n_threads, NULL);
+  }
+
+  return n_threads;
+}
+
+static GstFlowReturn
+gst_video_decoder_dispatch_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, guint n_threads)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+  FrameJob *job;
+
+  /* make room, this also pushes out whatever got finished meanwhile */
+  ret = gst_video_decoder_commit_frame_jobs (decoder, n_threads, FALSE);
+
+  job = g_slice_new0 (FrameJob);
+  job->decoder = decoder;
+  job->frame = frame;
+  job->system_frame_number = frame->system_frame_number;
+  g_queue_init (&job->actions);
+
+  GST_LOG_OBJECT (decoder, "dispatching frame #%u, %u in flight",
+      job->system_frame_number, priv->frame_jobs.length);
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  g_queue_push_tail (&priv->frame_jobs, job);
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  g_thread_pool_push (priv->frame_pool, job, NULL);
+
+  return ret;
+}
+
 /* Pass the frame in priv->current_frame through the
  * handle_frame() callback for decoding and passing to gvd_finish_frame(),
  * or dropping by passing to gvd_drop_frame() */
@@ -3482,7 +3809,8 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
 {
   GstVideoDecoderPrivate *priv = decoder->priv;
   GstVideoDecoderClass *decoder_class;
-  GstFlowReturn ret = GST_FLOW_OK;
+  GstFlowReturn ret = GST_FLOW_OK, flow;
+  guint n_threads;
 
   decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
 
@@ -3530,10 +3858,19 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
       gst_segment_to_running_time (&decoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
+  n_threads = gst_video_decoder_get_frame_threads_for (decoder, frame);
+  if (n_threads > 0)
+    return gst_video_decoder_dispatch_frame (decoder, frame, n_threads);
+
+  /* handled here, after everything that is still in flight */
+  flow = gst_video_decoder_drain_frame_jobs (decoder, FALSE);
+
   /* do something with frame */
   ret = decoder_class->handle_frame (decoder, frame);
   if (ret != GST_FLOW_OK)
     GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
+  else
+    ret = flow;
 
   /* the frame has either been added to parse_gather or sent to
      handle frame so there is no need to unref it */
@@ -3814,7 +4151,7 @@ gst_video_decoder_negotiate_pool (GstVideoDecoder * decoder, GstCaps * caps)
 {
   GstVideoDecoderClass *klass;
   GstQuery *query = NULL;
-  GstBufferPool *pool = NULL;
+  GstBufferPool *pool = NULL, *old_pool;
   GstAllocator *allocator;
   GstAllocationParams params;
   gboolean ret = TRUE;
@@ -3861,22 +4198,26 @@ gst_video_decoder_negotiate_pool (GstVideoDecoder * decoder, GstCaps * caps)
   decoder->priv->allocator = allocator;
   decoder->priv->params = params;
 
-  if (decoder->priv->pool) {
+  /* activate before the frame threads can see it */
+  GST_DEBUG_OBJECT (decoder, "activate pool %" GST_PTR_FORMAT, pool);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  /* frame threads pick up the pool with the OBJECT_LOCK */
+  GST_OBJECT_LOCK (decoder);
+  old_pool = decoder->priv->pool;
+  decoder->priv->pool = pool;
+  GST_OBJECT_UNLOCK (decoder);
+
+  if (old_pool) {
     /* do not set the bufferpool to inactive here, it will be done
      * on its finalize function. As videodecoder do late renegotiation
      * it might happen that some element downstream is already using this
      * same bufferpool and deactivating it will make it fail.
      * Happens when a downstream element changes from passthrough to
      * non-passthrough and gets this same bufferpool to use */
-    GST_DEBUG_OBJECT (decoder, "unref pool %" GST_PTR_FORMAT,
-        decoder->priv->pool);
-    gst_object_unref (decoder->priv->pool);
+    GST_DEBUG_OBJECT (decoder, "unref pool %" GST_PTR_FORMAT, old_pool);
+    gst_object_unref (old_pool);
   }
-  decoder->priv->pool = pool;
-
-  /* and activate */
-  GST_DEBUG_OBJECT (decoder, "activate pool %" GST_PTR_FORMAT, pool);
-  gst_buffer_pool_set_active (pool, TRUE);
 
 done:
   if (query)
@@ -4026,6 +4367,55 @@ gst_video_decoder_negotiate (GstVideoDecoder * decoder)
   return ret;
 }
 
+/* Allocation from a frame thread. The STREAM_LOCK is held by the streaming
+ * thread while it waits for the frame threads, so only the current pool is
+ * used here and negotiation is left to the streaming thread.
+ * Finished but not yet pushed frames hold buffers of the pool, and the
+ * streaming thread waits for this frame before pushing them, so the pool
+ * must not be waited on either: a bounded pool would never get a buffer
+ * back. */
+static GstFlowReturn
+gst_video_decoder_allocate_in_frame_thread (GstVideoDecoder * decoder,
+    GstBufferPoolAcquireParams * params, GstBuffer ** buffer)
+{
+  GstBufferPoolAcquireParams dontwait = { 0, };
+  GstBufferPool *pool = NULL;
+  GstFlowReturn flow = GST_FLOW_NOT_NEGOTIATED;
+  gsize size = 0;
+
+  GST_OBJECT_LOCK (decoder);
+  if (decoder->priv->output_state) {
+    size = GST_VIDEO_INFO_SIZE (&decoder->priv->output_state->info);
+    if (!decoder->priv->output_state_changed && decoder->priv->pool)
+      pool = gst_object_ref (decoder->priv->pool);
+  }
+  GST_OBJECT_UNLOCK (decoder);
+
+  if (pool) {
+    if (params)
+      dontwait = *params;
+    dontwait.flags |= GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+
+    flow = gst_buffer_pool_acquire_buffer (pool, buffer, &dontwait);
+    gst_object_unref (pool);
+    if (flow == GST_FLOW_OK)
+      return flow;
+    /* the pool might be exhausted, or just have been replaced by the
+     * streaming thread */
+    GST_INFO_OBJECT (decoder, "couldn't allocate output buffer, flow %s",
+        gst_flow_get_name (flow));
+  }
+
+  if (size == 0)
+    return flow;
+
+  GST_LOG_OBJECT (decoder, "fallback allocation of %" G_GSIZE_FORMAT
+      " bytes in frame thread", size);
+  *buffer = gst_buffer_new_allocate (NULL, size, NULL);
+
+  return *buffer ? GST_FLOW_OK : GST_FLOW_ERROR;
+}
+
 /**
  * gst_video_decoder_allocate_output_buffer:
  * @decoder: a #GstVideoDecoder
@@ -4048,6 +4438,11 @@ gst_video_decoder_allocate_output_buffer (GstVideoDecoder * decoder)
 
   GST_DEBUG ("alloc src buffer");
 
+  if (g_private_get (&current_frame_job)) {
+    gst_video_decoder_allocate_in_frame_thread (decoder, NULL, &buffer);
+    return buffer;
+  }
+
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
   needs_reconfigure = gst_pad_check_reconfigure (decoder->srcpad);
   if (G_UNLIKELY (!decoder->priv->output_state
@@ -4139,6 +4534,10 @@ gst_video_decoder_allocate_output_frame_with_params (GstVideoDecoder *
   g_return_val_if_fail (decoder->priv->output_state, GST_FLOW_NOT_NEGOTIATED);
   g_return_val_if_fail (frame->output_buffer == NULL, GST_FLOW_ERROR);
 
+  if (g_private_get (&current_frame_job))
+    return gst_video_decoder_allocate_in_frame_thread (decoder, params,
+        &frame->output_buffer);
+
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
 
   state = decoder->priv->output_state;
@@ -4394,6 +4793,76 @@ gst_video_decoder_get_estimate_rate (GstVideoDecoder * dec)
   return dec->priv->do_estimate_rate;
 }
 
+/**
+ * gst_video_decoder_set_frame_threads:
+ * @decoder: a #GstVideoDecoder
+ * @n_threads: number of frames to decode in parallel, 0 for one per CPU
+ *
+ * Lets #GstVideoDecoder sub-classes have #GstVideoDecoderClass.handle_frame()
+ * called from up to @n_threads worker threads, so that independent frames
+ * are decoded in parallel. Output is still pushed in decoding order from the
+ * streaming thread, which means a decoded frame might only be pushed when
+ * the next input buffer arrives or the decoder is drained.
+ *
+ * A sub-class enabling this must be able to decode the frames concurrently
+ * and must not use the STREAM_LOCK from handle_frame. From the worker threads
+ * only gst_video_decoder_finish_frame(), gst_video_decoder_drop_frame(),
+ * gst_video_decoder_release_frame(), gst_video_decoder_allocate_output_frame(),
+ * gst_video_decoder_allocate_output_buffer(),
+ * gst_video_decoder_get_output_state(),
+ * gst_video_decoder_get_max_decode_time() and
+ * gst_video_decoder_get_qos_proportion() may be called. Frames that depend on
+ * decoder state can be kept in the streaming thread by implementing
+ * #GstVideoDecoderClass.serialize_frame(). Reverse playback always uses the
+ * streaming thread.
+ *
+ * The additional latency of @n_threads frames is reported in the latency
+ * query.
+ *
+ * Since: 1.16
+ */
+void
+gst_video_decoder_set_frame_threads (GstVideoDecoder * decoder,
+    guint n_threads)
+{
+  g_return_if_fail (GST_IS_VIDEO_DECODER (decoder));
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  GST_DEBUG_OBJECT (decoder, "using %u frame threads", n_threads);
+
+  GST_OBJECT_LOCK (decoder);
+  decoder->priv->frame_threads = n_threads;
+  GST_OBJECT_UNLOCK (decoder);
+
+  gst_element_post_message (GST_ELEMENT_CAST (decoder),
+      gst_message_new_latency (GST_OBJECT_CAST (decoder)));
+}
+
+/**
+ * gst_video_decoder_get_frame_threads:
+ * @decoder: a #GstVideoDecoder
+ *
+ * Returns: the number of frames decoded in parallel, as set with
+ *     gst_video_decoder_set_frame_threads()
+ *
+ * Since: 1.16
+ */
+guint
+gst_video_decoder_get_frame_threads (GstVideoDecoder * decoder)
+{
+  guint n_threads;
+
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), 1);
+
+  GST_OBJECT_LOCK (decoder);
+  n_threads = decoder->priv->frame_threads;
+  GST_OBJECT_UNLOCK (decoder);
+
+  return n_threads;
+}
+
 /**
  * gst_video_decoder_set_latency:
  * @decoder: a #GstVideoDecoder
@@ -214,7 +214,10 @@ struct _GstVideoDecoder
  * @reset:          Optional.
  *                  Allows subclass (decoder) to perform post-seek semantics reset.
  *                  Deprecated.
- * @handle_frame:   Provides input data frame to subclass.
+ * @handle_frame:   Provides input data frame to subclass. When frame threading
+ *                  is enabled with gst_video_decoder_set_frame_threads(), this
+ *                  is called from a worker thread, see there for what it may
+ *                  do then.
  * @finish:         Optional.
  *                  Called to request subclass to dispatch any pending remaining
  *                  data at EOS. Sub-classes can refuse to decode new data after.
@@ -272,6 +275,12 @@ struct _GstVideoDecoder
  *                  tags and meta with only the "video" tag. subclasses can
  *                  implement this method and return %TRUE if the metadata is to be
  *                  copied. Since 1.6
+ * @serialize_frame: Optional. Only used when frame threading is enabled.
+ *                  Called from the streaming thread before @frame is handed
+ *                  to a worker. Return %TRUE to have @frame handled in the
+ *                  streaming thread instead, after all earlier frames are
+ *                  finished, e.g. for stream headers or frames that change
+ *                  the output state. Since 1.16
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum @handle_frame needs to be overridden, and @set_format
@@ -337,8 +346,11 @@ struct _GstVideoDecoderClass
                                    GstVideoCodecFrame *frame,
                                    GstMeta * meta);
 
+  gboolean      (*serialize_frame) (GstVideoDecoder *decoder,
+                                    GstVideoCodecFrame *frame);
+
   /*< private >*/
-  gpointer padding[GST_PADDING_LARGE-6];
+  gpointer padding[GST_PADDING_LARGE-7];
 };
 
 GST_VIDEO_API
@@ -380,6 +392,13 @@ void     gst_video_decoder_set_needs_format (GstVideoDecoder * dec,
 GST_VIDEO_API
 gboolean gst_video_decoder_get_needs_format (GstVideoDecoder * dec);
 
+GST_VIDEO_API
+void     gst_video_decoder_set_frame_threads (GstVideoDecoder * decoder,
+                                              guint n_threads);
+
+GST_VIDEO_API
+guint    gst_video_decoder_get_frame_threads (GstVideoDecoder * decoder);
+
 GST_VIDEO_API
 void     gst_video_decoder_set_latency (GstVideoDecoder *decoder,
 					GstClockTime min_latency,
@@ -62,6 +62,12 @@
  *       Sink events will be passed to subclass if @event callback has been
  *       provided.
  *
+ *     * Subclasses that can encode several frames concurrently can enable
+ *       frame threading with gst_video_encoder_set_frame_threads(). Up to
+ *       the configured number of frames are then in flight, their
+ *       @handle_frame being called from worker threads, while the encoded
+ *       frames are still pushed downstream in input order.
+ *
  * ## Shutdown phase
  *
  *   * GstVideoEncoder class calls @stop to inform the subclass that data
@@ -114,6 +120,7 @@ GST_DEBUG_CATEGORY (videoencoder_debug);
 /* properties */
 
 #define DEFAULT_QOS                 FALSE
+#define DEFAULT_FRAME_THREADS       1
 
 enum
 {
@@ -175,8 +182,36 @@ struct _GstVideoEncoderPrivate
   /* qos messages: frames dropped/processed */
   guint dropped;
   guint processed;
+
+  /* frame threading */
+  guint frame_threads;          /* OBJECT_LOCK */
+  guint max_frames_in_flight;   /* OBJECT_LOCK */
+  GThreadPool *frame_pool;
+  /* FrameJobs in input order, only popped by the streaming thread. The
+   * queue and the jobs' done/ret/finished fields are protected by
+   * frame_jobs_lock */
+  GQueue frame_jobs;
+  GMutex frame_jobs_lock;
+  GCond frame_jobs_cond;
+  /* first error when committing the jobs, returned to the workers */
+  GstFlowReturn frame_jobs_ret;
 };
 
+/* A frame handed to a worker thread. gst_video_encoder_finish_frame() calls
+ * made from the worker are recorded in @finished and done by the streaming
+ * thread once the job is committed. */
+typedef struct
+{
+  GstVideoEncoder *encoder;
+  GstVideoCodecFrame *frame;
+  guint32 system_frame_number;
+  gboolean done;
+  GstFlowReturn ret;
+  GQueue finished;
+} FrameJob;
+
+static GPrivate current_frame_job = G_PRIVATE_INIT (NULL);
+
 typedef struct _ForcedKeyUnitEvent ForcedKeyUnitEvent;
 struct _ForcedKeyUnitEvent
 {
@@ -252,6 +287,12 @@ static gboolean gst_video_encoder_sink_query_default (GstVideoEncoder * encoder,
 static gboolean gst_video_encoder_src_query_default (GstVideoEncoder * encoder,
     GstQuery * query);
 
+static GstFlowReturn gst_video_encoder_drain_frame_jobs (GstVideoEncoder *
+    encoder, gboolean discard);
+static void gst_video_encoder_stop_frame_jobs (GstVideoEncoder * encoder);
+static void gst_video_encoder_release_frame (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame);
+
 static gboolean gst_video_encoder_transform_meta_default (GstVideoEncoder *
     encoder, GstVideoCodecFrame * frame, GstMeta * meta);
 
@@ -538,6 +579,13 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
   priv->min_pts = GST_CLOCK_TIME_NONE;
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
 
+  priv->frame_threads = DEFAULT_FRAME_THREADS;
+  priv->max_frames_in_flight = DEFAULT_FRAME_THREADS;
+  g_queue_init (&priv->frame_jobs);
+  g_mutex_init (&priv->frame_jobs_lock);
+  g_cond_init (&priv->frame_jobs_cond);
+  priv->frame_jobs_ret = GST_FLOW_OK;
+
   gst_video_encoder_reset (encoder, TRUE);
 }
 
@@ -664,6 +712,9 @@ gst_video_encoder_setcaps (GstVideoEncoder * encoder, GstCaps * caps)
     goto caps_not_changed;
   }
 
+  /* frames in flight were submitted for the previous configuration */
+  gst_video_encoder_drain_frame_jobs (encoder, FALSE);
+
   if (encoder_class->reset) {
     GST_FIXME_OBJECT (encoder, "GstVideoEncoder::reset() is deprecated");
     encoder_class->reset (encoder, TRUE);
@@ -921,6 +972,13 @@ gst_video_encoder_finalize (GObject * object)
     encoder->priv->allocator = NULL;
   }
 
+  if (encoder->priv->frame_pool) {
+    g_thread_pool_free (encoder->priv->frame_pool, FALSE, TRUE);
+    encoder->priv->frame_pool = NULL;
+  }
+  g_mutex_clear (&encoder->priv->frame_jobs_lock);
+  g_cond_clear (&encoder->priv->frame_jobs_cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1034,10 +1092,13 @@ gst_video_encoder_sink_event_default (GstVideoEncoder * encoder,
 
       GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
 
+      flow_ret = gst_video_encoder_drain_frame_jobs (encoder, FALSE);
+
       if (encoder_class->finish) {
-        flow_ret = encoder_class->finish (encoder);
-      } else {
-        flow_ret = GST_FLOW_OK;
+        GstFlowReturn finish_ret = encoder_class->finish (encoder);
+
+        if (flow_ret == GST_FLOW_OK)
+          flow_ret = finish_ret;
       }
 
       if (encoder->priv->current_frame_events) {
@@ -1160,6 +1221,8 @@ gst_video_encoder_sink_event_default (GstVideoEncoder * encoder,
     }
     case GST_EVENT_FLUSH_STOP:{
       GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+      gst_video_encoder_drain_frame_jobs (encoder, TRUE);
+      encoder->priv->frame_jobs_ret = GST_FLOW_OK;
       gst_video_encoder_flush (encoder);
       gst_segment_init (&encoder->input_segment, GST_FORMAT_TIME);
       gst_segment_init (&encoder->output_segment, GST_FORMAT_TIME);
@@ -1364,6 +1427,16 @@ gst_video_encoder_src_query_default (GstVideoEncoder * enc, GstQuery * query)
           max_latency = GST_CLOCK_TIME_NONE;
         else
           max_latency += enc->priv->max_latency;
+        /* frames in flight are only pushed once the following frames
+         * came in */
+        if (priv->frame_threads > 1) {
+          GstClockTime in_flight =
+              priv->max_frames_in_flight * priv->qos_frame_duration;
+
+          min_latency += in_flight;
+          if (max_latency != GST_CLOCK_TIME_NONE)
+            max_latency += in_flight;
+        }
         GST_OBJECT_UNLOCK (enc);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -1429,6 +1502,194 @@ gst_video_encoder_new_frame (GstVideoEncoder * encoder, GstBuffer * buf,
   return frame;
 }
 
+static void
+gst_video_encoder_frame_job_func (FrameJob * job, GstVideoEncoder * encoder)
+{
+  GstVideoEncoderClass *klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (encoder, "handling frame #%u", job->system_frame_number);
+
+  g_private_set (&current_frame_job, job);
+  ret = klass->handle_frame (encoder, job->frame);
+  g_private_set (&current_frame_job, NULL);
+
+  if (ret != GST_FLOW_OK)
+    GST_DEBUG_OBJECT (encoder, "frame #%u flow %s", job->system_frame_number,
+        gst_flow_get_name (ret));
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  job->frame = NULL;
+  job->ret = ret;
+  job->done = TRUE;
+  g_cond_broadcast (&priv->frame_jobs_cond);
+  g_mutex_unlock (&priv->frame_jobs_lock);
+}
+
+/* Finishes the frames of a done job with the STREAM_LOCK. With @discard
+ * they are released instead. */
+static GstFlowReturn
+gst_video_encoder_commit_frame_job (GstVideoEncoder * encoder, FrameJob * job,
+    gboolean discard)
+{
+  GstFlowReturn ret = job->ret, res;
+  GstVideoCodecFrame *frame;
+
+  GST_LOG_OBJECT (encoder, "committing frame #%u, %u finished",
+      job->system_frame_number, job->finished.length);
+
+  while ((frame = g_queue_pop_head (&job->finished))) {
+    if (discard) {
+      gst_video_encoder_release_frame (encoder, frame);
+      continue;
+    }
+
+    res = gst_video_encoder_finish_frame (encoder, frame);
+    if (ret == GST_FLOW_OK)
+      ret = res;
+  }
+  g_slice_free (FrameJob, job);
+
+  return ret;
+}
+
+/* Must be called holding the GST_VIDEO_ENCODER_STREAM_LOCK. Commits the
+ * done jobs at the head of the queue, waiting until fewer than @max_jobs
+ * are left in flight. The workers never take the STREAM_LOCK, so waiting
+ * for them here is safe. */
+static GstFlowReturn
+gst_video_encoder_commit_frame_jobs (GstVideoEncoder * encoder,
+    guint max_jobs, gboolean discard)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret = GST_FLOW_OK, res;
+  FrameJob *job;
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  while ((job = g_queue_peek_head (&priv->frame_jobs))) {
+    if (!job->done) {
+      if (priv->frame_jobs.length < max_jobs)
+        break;
+      GST_LOG_OBJECT (encoder, "waiting for frame #%u",
+          job->system_frame_number);
+      g_cond_wait (&priv->frame_jobs_cond, &priv->frame_jobs_lock);
+      continue;
+    }
+    g_queue_pop_head (&priv->frame_jobs);
+    g_mutex_unlock (&priv->frame_jobs_lock);
+
+    res = gst_video_encoder_commit_frame_job (encoder, job, discard);
+    if (ret == GST_FLOW_OK)
+      ret = res;
+
+    g_mutex_lock (&priv->frame_jobs_lock);
+    if (res != GST_FLOW_OK)
+      priv->frame_jobs_ret = res;
+  }
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  return ret;
+}
+
+/* Must be called holding the GST_VIDEO_ENCODER_STREAM_LOCK. Waits for all
+ * frames in flight and commits them. */
+static GstFlowReturn
+gst_video_encoder_drain_frame_jobs (GstVideoEncoder * encoder,
+    gboolean discard)
+{
+  if (G_LIKELY (g_queue_is_empty (&encoder->priv->frame_jobs)))
+    return GST_FLOW_OK;
+
+  GST_DEBUG_OBJECT (encoder, "draining %u frame jobs, discard %d",
+      encoder->priv->frame_jobs.length, discard);
+
+  return gst_video_encoder_commit_frame_jobs (encoder, 0, discard);
+}
+
+/* Discards all frames in flight and shuts down the worker threads */
+static void
+gst_video_encoder_stop_frame_jobs (GstVideoEncoder * encoder)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+  gst_video_encoder_drain_frame_jobs (encoder, TRUE);
+  if (priv->frame_pool) {
+    g_thread_pool_free (priv->frame_pool, FALSE, TRUE);
+    priv->frame_pool = NULL;
+  }
+  priv->frame_jobs_ret = GST_FLOW_OK;
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+}
+
+/* Returns the number of frames that may be in flight when dispatching
+ * @frame, 0 if it has to be handled in the streaming thread */
+static guint
+gst_video_encoder_get_frame_threads_for (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderClass *klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GError *err = NULL;
+  guint n_threads, max_in_flight;
+
+  GST_OBJECT_LOCK (encoder);
+  n_threads = priv->frame_threads;
+  max_in_flight = priv->max_frames_in_flight;
+  GST_OBJECT_UNLOCK (encoder);
+
+  if (n_threads <= 1)
+    return 0;
+
+  if (klass->serialize_frame && klass->serialize_frame (encoder, frame))
+    return 0;
+
+  if (priv->frame_pool == NULL) {
+    priv->frame_pool =
+        g_thread_pool_new ((GFunc) gst_video_encoder_frame_job_func, encoder,
+        n_threads, FALSE, &err);
+    if (priv->frame_pool == NULL) {
+      GST_WARNING_OBJECT (encoder, "failed to create frame threads: %s",
+          err->message);
+      g_clear_error (&err);
+      return 0;
+    }
+  } else if (g_thread_pool_get_max_threads (priv->frame_pool) != n_threads) {
+    g_thread_pool_set_max_threads (priv->frame_pool, n_threads, NULL);
+  }
+
+  return max_in_flight;
+}
+
+static GstFlowReturn
+gst_video_encoder_dispatch_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame, guint max_in_flight)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret;
+  FrameJob *job;
+
+  /* make room, this also pushes out whatever got encoded meanwhile */
+  ret = gst_video_encoder_commit_frame_jobs (encoder, max_in_flight, FALSE);
+
+  job = g_slice_new0 (FrameJob);
+  job->encoder = encoder;
+  job->frame = frame;
+  job->system_frame_number = frame->system_frame_number;
+  g_queue_init (&job->finished);
+
+  GST_LOG_OBJECT (encoder, "dispatching frame #%u, %u in flight",
+      job->system_frame_number, priv->frame_jobs.length);
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  g_queue_push_tail (&priv->frame_jobs, job);
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  g_thread_pool_push (priv->frame_pool, job, NULL);
+
+  return ret;
+}
 
 static GstFlowReturn
 gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
@@ -1438,8 +1699,9 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GstVideoEncoderClass *klass;
   GstVideoCodecFrame *frame;
   GstClockTime pts, duration;
-  GstFlowReturn ret = GST_FLOW_OK;
+  GstFlowReturn ret = GST_FLOW_OK, flow;
   guint64 start, stop, cstart, cstop;
+  guint n_in_flight;
 
   encoder = GST_VIDEO_ENCODER (parent);
   priv = encoder->priv;
@@ -1552,7 +1814,18 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       gst_segment_to_running_time (&encoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
+  n_in_flight = gst_video_encoder_get_frame_threads_for (encoder, frame);
+  if (n_in_flight > 0) {
+    ret = gst_video_encoder_dispatch_frame (encoder, frame, n_in_flight);
+    goto done;
+  }
+
+  /* handled here, after everything that is still in flight */
+  flow = gst_video_encoder_drain_frame_jobs (encoder, FALSE);
+
   ret = klass->handle_frame (encoder, frame);
+  if (ret == GST_FLOW_OK)
+    ret = flow;
 
 done:
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
@@ -1604,6 +1877,8 @@ gst_video_encoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      gst_video_encoder_stop_frame_jobs (encoder);
+
       if (encoder_class->stop)
         stopped = encoder_class->stop (encoder);
 
@@ -1788,10 +2063,13 @@ gst_video_encoder_negotiate_default (GstVideoEncoder * encoder)
     gst_allocation_params_init (&params);
   }
 
+  /* frame threads read these without the STREAM_LOCK */
+  GST_OBJECT_LOCK (encoder);
   if (encoder->priv->allocator)
     gst_object_unref (encoder->priv->allocator);
   encoder->priv->allocator = allocator;
   encoder->priv->params = params;
+  GST_OBJECT_UNLOCK (encoder);
 
 done:
   if (query)
@@ -1852,6 +2130,36 @@ gst_video_encoder_negotiate (GstVideoEncoder * encoder)
   return ret;
 }
 
+/* Allocation from a frame thread. The STREAM_LOCK is held by the streaming
+ * thread while it waits for the frame threads, so negotiation is left to
+ * the streaming thread and the current allocator is used. */
+static GstBuffer *
+gst_video_encoder_allocate_in_frame_thread (GstVideoEncoder * encoder,
+    gsize size)
+{
+  GstAllocator *allocator;
+  GstAllocationParams params;
+  GstBuffer *buffer;
+
+  GST_OBJECT_LOCK (encoder);
+  allocator = encoder->priv->allocator ?
+      gst_object_ref (encoder->priv->allocator) : NULL;
+  params = encoder->priv->params;
+  GST_OBJECT_UNLOCK (encoder);
+
+  GST_LOG_OBJECT (encoder, "alloc buffer size %" G_GSIZE_FORMAT
+      " in frame thread", size);
+
+  buffer = gst_buffer_new_allocate (allocator, size, &params);
+  if (allocator)
+    gst_object_unref (allocator);
+
+  if (!buffer)
+    buffer = gst_buffer_new_allocate (NULL, size, NULL);
+
+  return buffer;
+}
+
 /**
  * gst_video_encoder_allocate_output_buffer:
  * @encoder: a #GstVideoEncoder
@@ -1872,6 +2180,9 @@ gst_video_encoder_allocate_output_buffer (GstVideoEncoder * encoder, gsize size)
 
   GST_DEBUG ("alloc src buffer");
 
+  if (g_private_get (&current_frame_job))
+    return gst_video_encoder_allocate_in_frame_thread (encoder, size);
+
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
   needs_reconfigure = gst_pad_check_reconfigure (encoder->srcpad);
   if (G_UNLIKELY (encoder->priv->output_state_changed
@@ -1926,6 +2237,12 @@ gst_video_encoder_allocate_output_frame (GstVideoEncoder *
 
   g_return_val_if_fail (frame->output_buffer == NULL, GST_FLOW_ERROR);
 
+  if (g_private_get (&current_frame_job)) {
+    frame->output_buffer =
+        gst_video_encoder_allocate_in_frame_thread (encoder, size);
+    return frame->output_buffer ? GST_FLOW_OK : GST_FLOW_ERROR;
+  }
+
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
   needs_reconfigure = gst_pad_check_reconfigure (encoder->srcpad);
   if (G_UNLIKELY (encoder->priv->output_state_changed
@@ -2056,6 +2373,29 @@ gst_video_encoder_drop_frame (GstVideoEncoder * enc, GstVideoCodecFrame * frame)
   gst_element_post_message (GST_ELEMENT_CAST (enc), qos_msg);
 }
 
+/* When called from a frame thread, records @frame to be finished by the
+ * streaming thread and returns %TRUE */
+static gboolean
+gst_video_encoder_defer_finish_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame, GstFlowReturn * ret)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  FrameJob *job = g_private_get (&current_frame_job);
+
+  if (G_LIKELY (job == NULL || job->encoder != encoder))
+    return FALSE;
+
+  GST_LOG_OBJECT (encoder, "deferring finish of frame %p (#%u)", frame,
+      frame->system_frame_number);
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  g_queue_push_tail (&job->finished, frame);
+  *ret = priv->frame_jobs_ret;
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  return TRUE;
+}
+
 /**
  * gst_video_encoder_finish_frame:
  * @encoder: a #GstVideoEncoder
@@ -2088,6 +2428,9 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
 
   encoder_class = GST_VIDEO_ENCODER_GET_CLASS (encoder);
 
+  if (gst_video_encoder_defer_finish_frame (encoder, frame, &ret))
+    return ret;
+
   GST_LOG_OBJECT (encoder,
       "finish frame fpn %d", frame->presentation_frame_number);
 
@@ -2433,6 +2776,89 @@ gst_video_encoder_set_output_state (GstVideoEncoder * encoder, GstCaps * caps,
   return state;
 }
 
+/**
+ * gst_video_encoder_set_frame_threads:
+ * @encoder: a #GstVideoEncoder
+ * @n_threads: number of frames to encode in parallel, 0 for one per CPU
+ * @max_frames_in_flight: maximum number of frames handed to the worker
+ *     threads and not yet pushed, 0 for @n_threads
+ *
+ * Lets #GstVideoEncoder sub-classes have #GstVideoEncoderClass.handle_frame()
+ * called from up to @n_threads worker threads, so that frames, or slices
+ * and tiles of them encoded independently by the sub-class, are processed
+ * in parallel. At most @max_frames_in_flight frames are queued for or
+ * handled by the workers at any time; the streaming thread blocks until the
+ * oldest one is done before accepting more. A window larger than
+ * @n_threads keeps the workers busy when the encoding time varies between
+ * frames, at the cost of more latency.
+ *
+ * The encoded frames are still pushed in input order from the streaming
+ * thread, which means an encoded frame might only be pushed when a later
+ * input frame arrives or the encoder is drained.
+ *
+ * A sub-class enabling this must be able to encode the frames concurrently
+ * and must not use the STREAM_LOCK from handle_frame. From the worker threads
+ * only gst_video_encoder_finish_frame(),
+ * gst_video_encoder_allocate_output_frame(),
+ * gst_video_encoder_allocate_output_buffer() and
+ * gst_video_encoder_get_max_encode_time() may be called. Frames that need
+ * the encoder state of all previous frames can be kept in the streaming
+ * thread by implementing #GstVideoEncoderClass.serialize_frame().
+ *
+ * The additional latency of @max_frames_in_flight frames is reported in the
+ * latency query.
+ *
+ * Since: 1.16
+ */
+void
+gst_video_encoder_set_frame_threads (GstVideoEncoder * encoder,
+    guint n_threads, guint max_frames_in_flight)
+{
+  g_return_if_fail (GST_IS_VIDEO_ENCODER (encoder));
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  if (max_frames_in_flight < n_threads)
+    max_frames_in_flight = n_threads;
+
+  GST_DEBUG_OBJECT (encoder, "using %u frame threads, %u frames in flight",
+      n_threads, max_frames_in_flight);
+
+  GST_OBJECT_LOCK (encoder);
+  encoder->priv->frame_threads = n_threads;
+  encoder->priv->max_frames_in_flight = max_frames_in_flight;
+  GST_OBJECT_UNLOCK (encoder);
+
+  gst_element_post_message (GST_ELEMENT_CAST (encoder),
+      gst_message_new_latency (GST_OBJECT_CAST (encoder)));
+}
+
+/**
+ * gst_video_encoder_get_frame_threads:
+ * @encoder: a #GstVideoEncoder
+ * @n_threads: (out) (allow-none): address of variable in which to store the
+ *     number of frame threads, or %NULL
+ * @max_frames_in_flight: (out) (allow-none): address of variable in which to
+ *     store the maximum number of frames in flight, or %NULL
+ *
+ * Query the configuration set with gst_video_encoder_set_frame_threads().
+ *
+ * Since: 1.16
+ */
+void
+gst_video_encoder_get_frame_threads (GstVideoEncoder * encoder,
+    guint * n_threads, guint * max_frames_in_flight)
+{
+  g_return_if_fail (GST_IS_VIDEO_ENCODER (encoder));
+
+  GST_OBJECT_LOCK (encoder);
+  if (n_threads)
+    *n_threads = encoder->priv->frame_threads;
+  if (max_frames_in_flight)
+    *max_frames_in_flight = encoder->priv->max_frames_in_flight;
+  GST_OBJECT_UNLOCK (encoder);
+}
+
 /**
  * gst_video_encoder_set_latency:
  * @encoder: a #GstVideoEncoder
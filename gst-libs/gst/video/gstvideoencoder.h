@@ -174,7 +174,10 @@ struct _GstVideoEncoder
  *                  Notifies subclass of incoming data format.
  *                  GstVideoCodecState fields have already been
  *                  set according to provided caps.
- * @handle_frame:   Provides input frame to subclass.
+ * @handle_frame:   Provides input frame to subclass. When frame threading
+ *                  is enabled with gst_video_encoder_set_frame_threads(), this
+ *                  is called from a worker thread, see there for what it may
+ *                  do then.
  * @reset:          Optional.
  *                  Allows subclass (encoder) to perform post-seek semantics reset.
  *                  Deprecated.
@@ -234,6 +237,12 @@ struct _GstVideoEncoder
  *                  tags and meta with only the "video" tag. subclasses can
  *                  implement this method and return %TRUE if the metadata is to be
  *                  copied. Since 1.6
+ * @serialize_frame: Optional. Only used when frame threading is enabled.
+ *                  Called from the streaming thread before @frame is handed
+ *                  to a worker. Return %TRUE to have @frame handled in the
+ *                  streaming thread instead, after all earlier frames are
+ *                  finished, e.g. for frames that reconfigure the encoder.
+ *                  Since 1.16
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum @handle_frame needs to be overridden, and @set_format
@@ -295,8 +304,11 @@ struct _GstVideoEncoderClass
                                    GstVideoCodecFrame *frame,
                                    GstMeta * meta);
 
+  gboolean      (*serialize_frame) (GstVideoEncoder *encoder,
+                                    GstVideoCodecFrame *frame);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE-4];
+  gpointer       _gst_reserved[GST_PADDING_LARGE-5];
 };
 
 GST_VIDEO_API
@@ -351,6 +363,16 @@ void		     gst_video_encoder_get_latency (GstVideoEncoder *encoder,
 						    GstClockTime *min_latency,
 						    GstClockTime *max_latency);
 
+GST_VIDEO_API
+void                 gst_video_encoder_set_frame_threads (GstVideoEncoder *encoder,
+                                                          guint n_threads,
+                                                          guint max_frames_in_flight);
+
+GST_VIDEO_API
+void                 gst_video_encoder_get_frame_threads (GstVideoEncoder *encoder,
+                                                          guint *n_threads,
+                                                          guint *max_frames_in_flight);
+
 GST_VIDEO_API
 void                 gst_video_encoder_set_headers (GstVideoEncoder *encoder,
 						    GList *headers);
@@ -19,6 +19,7 @@
 
 #include "gst/video/gstvideometa.h"
 #include "gst/video/gstvideopool.h"
+#include "gst/allocators/gstmemfdallocator.h"
 
 
 GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
@@ -113,7 +114,8 @@ static const gchar **
 video_buffer_pool_get_options (GstBufferPool * pool)
 {
   static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META,
-    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, NULL
+    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, GST_BUFFER_POOL_OPTION_VIDEO_MEMFD,
+    NULL
   };
   return options;
 }
@@ -147,6 +149,27 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
   if (!gst_buffer_pool_config_get_allocator (config, &allocator, &params))
     goto wrong_config;
 
+  if (allocator == NULL && gst_buffer_pool_config_has_option (config,
+          GST_BUFFER_POOL_OPTION_VIDEO_MEMFD)) {
+    GstAllocator *memfd;
+
+    /* keep the allocator of the previous config */
+    if (priv->allocator && GST_IS_MEMFD_ALLOCATOR (priv->allocator))
+      memfd = gst_object_ref (priv->allocator);
+    else
+      memfd = gst_memfd_allocator_new (GST_MEMFD_ALLOCATOR_FLAG_DEFAULT);
+
+    if (memfd) {
+      GST_DEBUG_OBJECT (pool, "using memfd allocator %" GST_PTR_FORMAT, memfd);
+      gst_buffer_pool_config_set_allocator (config, memfd, &params);
+      gst_object_unref (memfd);
+      /* the config keeps a ref */
+      allocator = memfd;
+    } else {
+      GST_WARNING_OBJECT (pool, "memfd allocator not available");
+    }
+  }
+
   width = info.width;
   height = info.height;
 
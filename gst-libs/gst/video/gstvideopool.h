@@ -45,6 +45,18 @@ G_BEGIN_DECLS
  */
 #define GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT "GstBufferPoolOptionVideoAlignment"
 
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_MEMFD:
+ *
+ * A bufferpool option to allocate the frames from a #GstMemfdAllocator when
+ * no allocator is configured. The frames are backed by huge pages when the
+ * system has them, placed on the NUMA node of the thread that allocates them
+ * and are fd memory that can be shared without copying.
+ *
+ * Since: 1.16
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_MEMFD "GstBufferPoolOptionVideoMemfd"
+
 /* setting a bufferpool config */
 
 GST_VIDEO_API
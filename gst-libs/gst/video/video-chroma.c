@@ -24,6 +24,13 @@
 #include <string.h>
 #include <stdio.h>
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "video-orc.h"
 #include "video-format.h"
 
@@ -366,7 +373,57 @@ MAKE_UPSAMPLE_V2 (u16, guint16);
 MAKE_UPSAMPLE_V2 (u8, guint8);
 MAKE_UPSAMPLE_VI2 (u16, guint16);
 MAKE_UPSAMPLE_VI2 (u8, guint8);
+#if defined (__SSE2__)
+static void
+video_chroma_down_h2_u16 (GstVideoChromaResample * resample,
+    gpointer pixels, gint width)
+{
+  guint16 *p = pixels;
+  gint i;
+  const __m128i mask = _mm_set_epi32 (0, 0, -1, 0);
+
+  /* FILT_1_1 is what _mm_avg_epu16() computes, only U and V of the even
+   * pixel of each pair are replaced */
+  for (i = 0; i < width - 1; i += 2) {
+    __m128i x, avg;
+
+    x = _mm_loadu_si128 ((const __m128i *) (p + i * 4));
+    avg = _mm_avg_epu16 (x, _mm_srli_si128 (x, 8));
+    x = _mm_or_si128 (_mm_and_si128 (mask, avg), _mm_andnot_si128 (mask, x));
+    _mm_storel_epi64 ((__m128i *) (p + i * 4), x);
+  }
+}
+#elif defined (__ARM_NEON)
+static void
+video_chroma_down_h2_u16 (GstVideoChromaResample * resample,
+    gpointer pixels, gint width)
+{
+  guint16 *p = pixels;
+  gint i;
+
+  for (i = 0; i < width - 7; i += 8) {
+    uint16x8x4_t x;
+    uint16x8x2_t u, v;
+
+    x = vld4q_u16 (p + i * 4);
+    u = vuzpq_u16 (x.val[2], x.val[2]);
+    v = vuzpq_u16 (x.val[3], x.val[3]);
+    /* even pixels get the average, odd pixels are kept */
+    x.val[2] = vzipq_u16 (vrhaddq_u16 (u.val[0], u.val[1]), u.val[1]).val[0];
+    x.val[3] = vzipq_u16 (vrhaddq_u16 (v.val[0], v.val[1]), v.val[1]).val[0];
+    vst4q_u16 (p + i * 4, x);
+  }
+  for (; i < width - 1; i += 2) {
+    guint16 tr0 = PR (i), tr1 = PR (i + 1);
+    guint16 tb0 = PB (i), tb1 = PB (i + 1);
+
+    PR (i) = FILT_1_1 (tr0, tr1);
+    PB (i) = FILT_1_1 (tb0, tb1);
+  }
+}
+#else
 MAKE_DOWNSAMPLE_H2 (u16, guint16);
+#endif
 MAKE_DOWNSAMPLE_H2_ORC (u8, guint8);
 MAKE_DOWNSAMPLE_V2 (u16, guint16);
 MAKE_DOWNSAMPLE_V2 (u8, guint8);
@@ -22,20 +22,21 @@
 #include "config.h"
 #endif
 
-#if 0
-#ifdef HAVE_PTHREAD
-#define _GNU_SOURCE
-#include <pthread.h>
-#endif
-#endif
-
 #include "video-converter.h"
 
 #include <glib.h>
 #include <string.h>
 #include <math.h>
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "video-orc.h"
+#include "gstvideoutilsprivate.h"
 
 /**
  * SECTION:videoconverter
@@ -115,199 +116,6 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-typedef struct _GstParallelizedTaskThread GstParallelizedTaskThread;
-
-struct _GstParallelizedTaskThread
-{
-  GstParallelizedTaskRunner *runner;
-  guint idx;
-  GThread *thread;
-};
-
-struct _GstParallelizedTaskRunner
-{
-  guint n_threads;
-
-  GstParallelizedTaskThread *threads;
-
-  GstParallelizedTaskFunc func;
-  gpointer *task_data;
-
-  GMutex lock;
-  GCond cond_todo, cond_done;
-  gint n_todo, n_done;
-  gboolean quit;
-};
-
-static gpointer
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskThread *self = data;
-
-#if 0
-#ifdef HAVE_PTHREAD
-  {
-    pthread_t thread = pthread_self ();
-    cpu_set_t cpuset;
-    int r;
-
-    CPU_ZERO (&cpuset);
-    CPU_SET (self->idx, &cpuset);
-    if ((r = pthread_setaffinity_np (thread, sizeof (cpuset), &cpuset)) != 0)
-      GST_ERROR ("Failed to set thread affinity for thread %d: %s", self->idx,
-          g_strerror (r));
-  }
-#endif
-#endif
-
-  g_mutex_lock (&self->runner->lock);
-  self->runner->n_done++;
-  if (self->runner->n_done == self->runner->n_threads - 1)
-    g_cond_signal (&self->runner->cond_done);
-
-  do {
-    gint idx;
-
-    while (self->runner->n_todo == -1 && !self->runner->quit)
-      g_cond_wait (&self->runner->cond_todo, &self->runner->lock);
-
-    if (self->runner->quit)
-      break;
-
-    idx = self->runner->n_todo--;
-    g_assert (self->runner->n_todo >= -1);
-    g_mutex_unlock (&self->runner->lock);
-
-    g_assert (self->runner->func != NULL);
-
-    self->runner->func (self->runner->task_data[idx]);
-
-    g_mutex_lock (&self->runner->lock);
-    self->runner->n_done++;
-    if (self->runner->n_done == self->runner->n_threads - 1)
-      g_cond_signal (&self->runner->cond_done);
-  } while (TRUE);
-
-  g_mutex_unlock (&self->runner->lock);
-
-  return NULL;
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  guint i;
-
-  g_mutex_lock (&self->lock);
-  self->quit = TRUE;
-  g_cond_broadcast (&self->cond_todo);
-  g_mutex_unlock (&self->lock);
-
-  for (i = 1; i < self->n_threads; i++) {
-    if (!self->threads[i].thread)
-      continue;
-
-    g_thread_join (self->threads[i].thread);
-  }
-
-  g_mutex_clear (&self->lock);
-  g_cond_clear (&self->cond_todo);
-  g_cond_clear (&self->cond_done);
-  g_free (self->threads);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads)
-{
-  GstParallelizedTaskRunner *self;
-  guint i;
-  GError *err = NULL;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-  self->n_threads = n_threads;
-  self->threads = g_new0 (GstParallelizedTaskThread, n_threads);
-
-  self->quit = FALSE;
-  self->n_todo = -1;
-  self->n_done = 0;
-  g_mutex_init (&self->lock);
-  g_cond_init (&self->cond_todo);
-  g_cond_init (&self->cond_done);
-
-  /* Set when scheduling a job */
-  self->func = NULL;
-  self->task_data = NULL;
-
-  for (i = 0; i < n_threads; i++) {
-    self->threads[i].runner = self;
-    self->threads[i].idx = i;
-
-    /* First thread is the one calling run() */
-    if (i > 0) {
-      self->threads[i].thread =
-          g_thread_try_new ("videoconvert", gst_parallelized_task_thread_func,
-          &self->threads[i], &err);
-      if (!self->threads[i].thread)
-        goto error;
-    }
-  }
-
-  g_mutex_lock (&self->lock);
-  while (self->n_done < self->n_threads - 1)
-    g_cond_wait (&self->cond_done, &self->lock);
-  self->n_done = 0;
-  g_mutex_unlock (&self->lock);
-
-  return self;
-
-error:
-  {
-    GST_ERROR ("Failed to start thread %u: %s", i, err->message);
-    g_clear_error (&err);
-
-    gst_parallelized_task_runner_free (self);
-    return NULL;
-  }
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  self->func = func;
-  self->task_data = task_data;
-
-  if (n_threads > 1) {
-    g_mutex_lock (&self->lock);
-    self->n_todo = self->n_threads - 2;
-    self->n_done = 0;
-    g_cond_broadcast (&self->cond_todo);
-    g_mutex_unlock (&self->lock);
-  }
-
-  self->func (self->task_data[self->n_threads - 1]);
-
-  if (n_threads > 1) {
-    g_mutex_lock (&self->lock);
-    while (self->n_done < self->n_threads - 1)
-      g_cond_wait (&self->cond_done, &self->lock);
-    self->n_done = 0;
-    g_mutex_unlock (&self->lock);
-  }
-
-  self->func = NULL;
-  self->task_data = NULL;
-}
-
 typedef struct _GstLineCache GstLineCache;
 
 #define SCALE    (8)
@@ -335,7 +143,8 @@ typedef struct _GammaData GammaData;
 
 struct _GammaData
 {
-  gpointer gamma_table;
+  /* shared, see get_gamma_table() */
+  gconstpointer gamma_table;
   gint width;
   void (*gamma_func) (GammaData * data, gpointer dest, gpointer src);
 };
@@ -448,6 +257,8 @@ struct _GstVideoConverter
 
   /* gamma encode */
   GammaData gamma_enc;
+  /* everything from to R'G'B' to to Y'CbCr is done in one line pass */
+  gboolean fuse_gamma;
   /* to Y'CbCr */
   GstLineCache **to_YUV_lines;
   MatrixData to_YUV_matrix;
@@ -667,6 +478,8 @@ static gboolean do_alpha_lines (GstLineCache * cache, gint idx, gint out_line,
     gint in_line, gpointer user_data);
 static gboolean do_convert_to_YUV_lines (GstLineCache * cache, gint idx,
     gint out_line, gint in_line, gpointer user_data);
+static gboolean do_convert_gamma_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
 static gboolean do_upsample_lines (GstLineCache * cache, gint idx,
     gint out_line, gint in_line, gpointer user_data);
 static gboolean do_vscale_lines (GstLineCache * cache, gint idx, gint out_line,
@@ -1333,6 +1146,173 @@ video_converter_matrix16 (MatrixData * data, gpointer pixels)
   }
 }
 
+#if defined (__SSE2__) || defined (__ARM_NEON)
+/* ORC_CODE=backup makes ORC run its C code, the intrinsics below follow it
+ * so that their output can be checked against the C code */
+static gboolean
+use_simd_matrix16 (void)
+{
+  const gchar *code = g_getenv ("ORC_CODE");
+
+  return code == NULL || strstr (code, "backup") == NULL;
+}
+#endif
+
+#if defined (__SSE2__)
+/* The components are made signed by flipping their top bit so that they can
+ * be multiplied with _mm_madd_epi16(), the offsets in orc_p1..orc_p3
+ * compensate for that. Only usable when the coefficients fit in 16 bits and
+ * the sums can't overflow, see prepare_matrix16_sse2(). */
+static void
+video_converter_matrix16_sse2 (MatrixData * data, gpointer pixels)
+{
+  guint16 *p = pixels;
+  gint i, width = data->width;
+  const __m128i sign = _mm_set1_epi16 ((gshort) 0x8000);
+  const __m128i bias = _mm_set1_epi32 (32768);
+  const __m128i amask = _mm_set_epi32 (0, 0xffff, 0, 0xffff);
+  const __m128i cy = _mm_set_epi16 (data->im[0][2], data->im[0][1],
+      data->im[0][0], 0, data->im[0][2], data->im[0][1], data->im[0][0], 0);
+  const __m128i cu = _mm_set_epi16 (data->im[1][2], data->im[1][1],
+      data->im[1][0], 0, data->im[1][2], data->im[1][1], data->im[1][0], 0);
+  const __m128i cv = _mm_set_epi16 (data->im[2][2], data->im[2][1],
+      data->im[2][0], 0, data->im[2][2], data->im[2][1], data->im[2][0], 0);
+  const __m128i oy = _mm_set1_epi32 ((gint32) data->orc_p1);
+  const __m128i ou = _mm_set1_epi32 ((gint32) data->orc_p2);
+  const __m128i ov = _mm_set1_epi32 ((gint32) data->orc_p3);
+
+  for (i = 0; i < width - 1; i += 2) {
+    __m128i x, s, y, u, v, a, ay, uv;
+
+    x = _mm_loadu_si128 ((const __m128i *) (p + i * 4));
+    s = _mm_xor_si128 (x, sign);
+
+    /* per pixel: two partial sums in the even and odd 32 bit lanes */
+    y = _mm_madd_epi16 (s, cy);
+    u = _mm_madd_epi16 (s, cu);
+    v = _mm_madd_epi16 (s, cv);
+    y = _mm_add_epi32 (y, _mm_srli_epi64 (y, 32));
+    u = _mm_add_epi32 (u, _mm_srli_epi64 (u, 32));
+    v = _mm_add_epi32 (v, _mm_srli_epi64 (v, 32));
+    y = _mm_srai_epi32 (_mm_add_epi32 (y, oy), SCALE);
+    u = _mm_srai_epi32 (_mm_add_epi32 (u, ou), SCALE);
+    v = _mm_srai_epi32 (_mm_add_epi32 (v, ov), SCALE);
+
+    /* gather lanes 0 and 2 of everything and rebuild A, Y, U, V */
+    a = _mm_shuffle_epi32 (_mm_and_si128 (x, amask), _MM_SHUFFLE (3, 1, 2, 0));
+    y = _mm_shuffle_epi32 (y, _MM_SHUFFLE (3, 1, 2, 0));
+    u = _mm_shuffle_epi32 (u, _MM_SHUFFLE (3, 1, 2, 0));
+    v = _mm_shuffle_epi32 (v, _MM_SHUFFLE (3, 1, 2, 0));
+    ay = _mm_unpacklo_epi32 (a, y);
+    uv = _mm_unpacklo_epi32 (u, v);
+
+    /* there is no unsigned saturating pack in SSE2, pack signed around
+     * 32768 instead, which clamps to 0..65535 the same way */
+    x = _mm_packs_epi32 (_mm_sub_epi32 (_mm_unpacklo_epi64 (ay, uv), bias),
+        _mm_sub_epi32 (_mm_unpackhi_epi64 (ay, uv), bias));
+    _mm_storeu_si128 ((__m128i *) (p + i * 4), _mm_xor_si128 (x, sign));
+  }
+  if (i < width) {
+    gint r, g, b, y, u, v;
+
+    r = p[i * 4 + 1];
+    g = p[i * 4 + 2];
+    b = p[i * 4 + 3];
+
+    y = (data->im[0][0] * r + data->im[0][1] * g +
+        data->im[0][2] * b + data->im[0][3]) >> SCALE;
+    u = (data->im[1][0] * r + data->im[1][1] * g +
+        data->im[1][2] * b + data->im[1][3]) >> SCALE;
+    v = (data->im[2][0] * r + data->im[2][1] * g +
+        data->im[2][2] * b + data->im[2][3]) >> SCALE;
+
+    p[i * 4 + 1] = CLAMP (y, 0, 65535);
+    p[i * 4 + 2] = CLAMP (u, 0, 65535);
+    p[i * 4 + 3] = CLAMP (v, 0, 65535);
+  }
+}
+
+static gboolean
+prepare_matrix16_sse2 (MatrixData * data)
+{
+  gint i, j;
+  gint64 offset, max;
+  guint64 *off[3];
+
+  off[0] = &data->orc_p1;
+  off[1] = &data->orc_p2;
+  off[2] = &data->orc_p3;
+
+  for (i = 0; i < 3; i++) {
+    offset = data->im[i][3];
+    max = 0;
+    for (j = 0; j < 3; j++) {
+      if (data->im[i][j] < -32768 || data->im[i][j] > 32767)
+        return FALSE;
+      offset += (gint64) data->im[i][j] * 32768;
+      max += (gint64) ABS (data->im[i][j]) * 32768;
+    }
+    max += ABS (offset);
+    if (max > G_MAXINT32)
+      return FALSE;
+    *off[i] = (guint64) offset;
+  }
+  return TRUE;
+}
+#elif defined (__ARM_NEON)
+static void
+video_converter_matrix16_neon (MatrixData * data, gpointer pixels)
+{
+  guint16 *p = pixels;
+  gint i, j, width = data->width;
+  const int32x4_t oy = vdupq_n_s32 (data->im[0][3]);
+  const int32x4_t ou = vdupq_n_s32 (data->im[1][3]);
+  const int32x4_t ov = vdupq_n_s32 (data->im[2][3]);
+
+  for (i = 0; i < width - 7; i += 8) {
+    uint16x8x4_t x;
+    int32x4_t r[2], g[2], b[2], y[2], u[2], v[2];
+
+    x = vld4q_u16 (p + i * 4);
+
+    r[0] = vreinterpretq_s32_u32 (vmovl_u16 (vget_low_u16 (x.val[1])));
+    r[1] = vreinterpretq_s32_u32 (vmovl_u16 (vget_high_u16 (x.val[1])));
+    g[0] = vreinterpretq_s32_u32 (vmovl_u16 (vget_low_u16 (x.val[2])));
+    g[1] = vreinterpretq_s32_u32 (vmovl_u16 (vget_high_u16 (x.val[2])));
+    b[0] = vreinterpretq_s32_u32 (vmovl_u16 (vget_low_u16 (x.val[3])));
+    b[1] = vreinterpretq_s32_u32 (vmovl_u16 (vget_high_u16 (x.val[3])));
+
+    for (j = 0; j < 2; j++) {
+      y[j] = vmlaq_n_s32 (oy, r[j], data->im[0][0]);
+      y[j] = vmlaq_n_s32 (y[j], g[j], data->im[0][1]);
+      y[j] = vmlaq_n_s32 (y[j], b[j], data->im[0][2]);
+      u[j] = vmlaq_n_s32 (ou, r[j], data->im[1][0]);
+      u[j] = vmlaq_n_s32 (u[j], g[j], data->im[1][1]);
+      u[j] = vmlaq_n_s32 (u[j], b[j], data->im[1][2]);
+      v[j] = vmlaq_n_s32 (ov, r[j], data->im[2][0]);
+      v[j] = vmlaq_n_s32 (v[j], g[j], data->im[2][1]);
+      v[j] = vmlaq_n_s32 (v[j], b[j], data->im[2][2]);
+    }
+
+    /* shift and clamp to 0..65535 in one go */
+    x.val[1] = vcombine_u16 (vqshrun_n_s32 (y[0], SCALE),
+        vqshrun_n_s32 (y[1], SCALE));
+    x.val[2] = vcombine_u16 (vqshrun_n_s32 (u[0], SCALE),
+        vqshrun_n_s32 (u[1], SCALE));
+    x.val[3] = vcombine_u16 (vqshrun_n_s32 (v[0], SCALE),
+        vqshrun_n_s32 (v[1], SCALE));
+
+    vst4q_u16 (p + i * 4, x);
+  }
+  if (i < width) {
+    MatrixData rest = *data;
+
+    rest.width = width - i;
+    video_converter_matrix16 (&rest, p + i * 4);
+  }
+}
+#endif
+
 
 static void
 prepare_matrix (GstVideoConverter * convert, MatrixData * data)
@@ -1378,6 +1358,19 @@ prepare_matrix (GstVideoConverter * convert, MatrixData * data)
           (((guint64) (guint16) a13) << 32) | (((guint64) (guint16) a03) << 16);
     }
   } else {
+#if defined (__SSE2__)
+    if (use_simd_matrix16 () && prepare_matrix16_sse2 (data)) {
+      GST_DEBUG ("use 16bit SSE2 matrix");
+      data->matrix_func = video_converter_matrix16_sse2;
+      return;
+    }
+#elif defined (__ARM_NEON)
+    if (use_simd_matrix16 ()) {
+      GST_DEBUG ("use 16bit NEON matrix");
+      data->matrix_func = video_converter_matrix16_neon;
+      return;
+    }
+#endif
     GST_DEBUG ("use 16bit matrix");
     data->matrix_func = video_converter_matrix16;
   }
@@ -1462,7 +1455,7 @@ gamma_convert_u8_u16 (GammaData * data, gpointer dest, gpointer src)
   gint i;
   guint8 *s = src;
   guint16 *d = dest;
-  guint16 *table = data->gamma_table;
+  const guint16 *table = data->gamma_table;
   gint width = data->width * 4;
 
   for (i = 0; i < width; i += 4) {
@@ -1479,7 +1472,7 @@ gamma_convert_u16_u8 (GammaData * data, gpointer dest, gpointer src)
   gint i;
   guint16 *s = src;
   guint8 *d = dest;
-  guint8 *table = data->gamma_table;
+  const guint8 *table = data->gamma_table;
   gint width = data->width * 4;
 
   for (i = 0; i < width; i += 4) {
@@ -1496,7 +1489,7 @@ gamma_convert_u16_u16 (GammaData * data, gpointer dest, gpointer src)
   gint i;
   guint16 *s = src;
   guint16 *d = dest;
-  guint16 *table = data->gamma_table;
+  const guint16 *table = data->gamma_table;
   gint width = data->width * 4;
 
   for (i = 0; i < width; i += 4) {
@@ -1507,31 +1500,90 @@ gamma_convert_u16_u16 (GammaData * data, gpointer dest, gpointer src)
   }
 }
 
+static void
+gamma_convert_u8_u8 (GammaData * data, gpointer dest, gpointer src)
+{
+  gint i;
+  guint8 *s = src;
+  guint8 *d = dest;
+  const guint8 *table = data->gamma_table;
+  gint width = data->width * 4;
+
+  for (i = 0; i < width; i += 4) {
+    d[i + 0] = s[i];
+    d[i + 1] = table[s[i + 1]];
+    d[i + 2] = table[s[i + 2]];
+    d[i + 3] = table[s[i + 3]];
+  }
+}
+
+/* The tables only depend on the transfer functions and the depths, they are
+ * made once and shared by all converters. A table from @in_func to @out_func
+ * decodes and encodes in one lookup, GST_VIDEO_TRANSFER_GAMMA10 is linear so
+ * it gives the decode-only and encode-only tables. */
+static GHashTable *gamma_tables;
+static GMutex gamma_tables_lock;
+
+static gconstpointer
+get_gamma_table (GstVideoTransferFunction in_func,
+    GstVideoTransferFunction out_func, gint in_bits, gint out_bits)
+{
+  gpointer table;
+  guint key;
+
+  key = (in_func << 16) | (out_func << 8) | ((in_bits == 16) << 1) |
+      (out_bits == 16);
+
+  g_mutex_lock (&gamma_tables_lock);
+  if (gamma_tables == NULL)
+    gamma_tables = g_hash_table_new (NULL, NULL);
+
+  table = g_hash_table_lookup (gamma_tables, GUINT_TO_POINTER (key));
+  if (table == NULL) {
+    gint i, n_in = in_bits == 16 ? 65536 : 256;
+    gdouble in_max = n_in - 1, val;
+
+    GST_DEBUG ("making gamma table %d -> %d, %d -> %d bits", in_func,
+        out_func, in_bits, out_bits);
+
+    if (out_bits == 16) {
+      guint16 *t = table = g_malloc (sizeof (guint16) * n_in);
+
+      for (i = 0; i < n_in; i++) {
+        val = gst_video_color_transfer_decode (in_func, i / in_max);
+        t[i] = rint (gst_video_color_transfer_encode (out_func, val) * 65535.0);
+      }
+    } else {
+      guint8 *t = table = g_malloc (sizeof (guint8) * n_in);
+
+      for (i = 0; i < n_in; i++) {
+        val = gst_video_color_transfer_decode (in_func, i / in_max);
+        t[i] = rint (gst_video_color_transfer_encode (out_func, val) * 255.0);
+      }
+    }
+    g_hash_table_insert (gamma_tables, GUINT_TO_POINTER (key), table);
+  }
+  g_mutex_unlock (&gamma_tables_lock);
+
+  return table;
+}
+
 static void
 setup_gamma_decode (GstVideoConverter * convert)
 {
   GstVideoTransferFunction func;
-  guint16 *t;
-  gint i;
 
   func = convert->in_info.colorimetry.transfer;
 
   convert->gamma_dec.width = convert->current_width;
+  convert->gamma_dec.gamma_table = get_gamma_table (func,
+      GST_VIDEO_TRANSFER_GAMMA10, convert->current_bits, 16);
   if (convert->current_bits == 8) {
     GST_DEBUG ("gamma decode 8->16: %d", func);
     convert->gamma_dec.gamma_func = gamma_convert_u8_u16;
-    t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 256);
-
-    for (i = 0; i < 256; i++)
-      t[i] = rint (gst_video_color_transfer_decode (func, i / 255.0) * 65535.0);
   } else {
     GST_DEBUG ("gamma decode 16->16: %d", func);
     convert->gamma_dec.gamma_func = gamma_convert_u16_u16;
-    t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 65536);
-
-    for (i = 0; i < 65536; i++)
-      t[i] =
-          rint (gst_video_color_transfer_decode (func, i / 65535.0) * 65535.0);
   }
   convert->current_bits = 16;
   convert->current_pstride = 8;
@@ -1542,31 +1594,93 @@ static void
 setup_gamma_encode (GstVideoConverter * convert, gint target_bits)
 {
   GstVideoTransferFunction func;
-  gint i;
 
   func = convert->out_info.colorimetry.transfer;
 
   convert->gamma_enc.width = convert->current_width;
+  convert->gamma_enc.gamma_table = get_gamma_table (GST_VIDEO_TRANSFER_GAMMA10,
+      func, 16, target_bits);
   if (target_bits == 8) {
-    guint8 *t;
-
     GST_DEBUG ("gamma encode 16->8: %d", func);
     convert->gamma_enc.gamma_func = gamma_convert_u16_u8;
-    t = convert->gamma_enc.gamma_table = g_malloc (sizeof (guint8) * 65536);
-
-    for (i = 0; i < 65536; i++)
-      t[i] = rint (gst_video_color_transfer_encode (func, i / 65535.0) * 255.0);
   } else {
-    guint16 *t;
-
     GST_DEBUG ("gamma encode 16->16: %d", func);
     convert->gamma_enc.gamma_func = gamma_convert_u16_u16;
-    t = convert->gamma_enc.gamma_table = g_malloc (sizeof (guint16) * 65536);
+  }
+}
+
+/* decode and encode with one table when there is nothing to do on the linear
+ * values in between */
+static void
+setup_gamma_remap (GstVideoConverter * convert, gint target_bits)
+{
+  GstVideoTransferFunction in_func, out_func;
 
-    for (i = 0; i < 65536; i++)
-      t[i] =
-          rint (gst_video_color_transfer_encode (func, i / 65535.0) * 65535.0);
+  in_func = convert->in_info.colorimetry.transfer;
+  out_func = convert->out_info.colorimetry.transfer;
+
+  GST_DEBUG ("gamma remap %d->%d: %d -> %d", convert->current_bits,
+      target_bits, in_func, out_func);
+
+  convert->gamma_dec.width = convert->current_width;
+  convert->gamma_dec.gamma_table = get_gamma_table (in_func, out_func,
+      convert->current_bits, target_bits);
+  if (convert->current_bits == 8) {
+    if (target_bits == 8)
+      convert->gamma_dec.gamma_func = gamma_convert_u8_u8;
+    else
+      convert->gamma_dec.gamma_func = gamma_convert_u8_u16;
+  } else {
+    if (target_bits == 8)
+      convert->gamma_dec.gamma_func = gamma_convert_u16_u8;
+    else
+      convert->gamma_dec.gamma_func = gamma_convert_u16_u16;
   }
+  convert->gamma_enc.gamma_func = NULL;
+}
+
+static void
+setup_to_RGB_matrix (GstVideoConverter * convert)
+{
+  gint scale;
+
+  if (convert->unpack_rgb)
+    return;
+
+  color_matrix_set_identity (&convert->to_RGB_matrix);
+  compute_matrix_to_RGB (convert, &convert->to_RGB_matrix);
+
+  /* matrix is in 0..1 range, scale to current bits */
+  GST_DEBUG ("chain RGB convert");
+  scale = 1 << convert->current_bits;
+  color_matrix_scale_components (&convert->to_RGB_matrix,
+      (float) scale, (float) scale, (float) scale);
+
+  prepare_matrix (convert, &convert->to_RGB_matrix);
+
+  if (convert->current_bits == 8)
+    convert->current_format = GST_VIDEO_FORMAT_ARGB;
+  else
+    convert->current_format = GST_VIDEO_FORMAT_ARGB64;
+}
+
+static void
+setup_to_YUV_matrix (GstVideoConverter * convert)
+{
+  gint scale;
+
+  if (convert->pack_rgb)
+    return;
+
+  color_matrix_set_identity (&convert->to_YUV_matrix);
+  compute_matrix_to_YUV (convert, &convert->to_YUV_matrix, FALSE);
+
+  /* matrix is in 0..255 range, scale to pack bits */
+  GST_DEBUG ("chain YUV convert");
+  scale = 1 << convert->pack_bits;
+  color_matrix_scale_components (&convert->to_YUV_matrix,
+      1 / (float) scale, 1 / (float) scale, 1 / (float) scale);
+  prepare_matrix (convert, &convert->to_YUV_matrix);
 }
 
 static GstLineCache *
@@ -1577,26 +1691,9 @@ chain_convert_to_RGB (GstVideoConverter * convert, GstLineCache * prev,
 
   do_gamma = CHECK_GAMMA_REMAP (convert);
 
-  if (do_gamma) {
-    gint scale;
-
-    if (!convert->unpack_rgb) {
-      color_matrix_set_identity (&convert->to_RGB_matrix);
-      compute_matrix_to_RGB (convert, &convert->to_RGB_matrix);
-
-      /* matrix is in 0..1 range, scale to current bits */
-      GST_DEBUG ("chain RGB convert");
-      scale = 1 << convert->current_bits;
-      color_matrix_scale_components (&convert->to_RGB_matrix,
-          (float) scale, (float) scale, (float) scale);
-
-      prepare_matrix (convert, &convert->to_RGB_matrix);
-
-      if (convert->current_bits == 8)
-        convert->current_format = GST_VIDEO_FORMAT_ARGB;
-      else
-        convert->current_format = GST_VIDEO_FORMAT_ARGB64;
-    }
+  /* when fused, chain_convert_gamma() does all of this */
+  if (do_gamma && !convert->fuse_gamma) {
+    setup_to_RGB_matrix (convert);
 
     prev = convert->to_RGB_lines[idx] = gst_line_cache_new (prev);
     prev->write_input = TRUE;
@@ -1821,7 +1918,7 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev, gint idx)
     convert->current_pstride = convert->current_bits >> 1;
   } else {
     /* we did gamma, just do colorspace conversion if needed */
-    if (same_primaries) {
+    if (same_primaries || convert->fuse_gamma) {
       do_conversion = FALSE;
     } else {
       prepare_matrix (convert, &convert->convert_matrix);
@@ -1929,6 +2026,54 @@ chain_alpha (GstVideoConverter * convert, GstLineCache * prev, gint idx)
   return prev;
 }
 
+/* Without scaling and premultiplied alpha there is nothing between the
+ * conversion to R'G'B' and the conversion back to Y'CbCr, do them and the
+ * gamma conversion in one pass over the line while it is in the cache. The
+ * line can be the destination line, so the linear values can only be kept
+ * in it when they have the output depth, see video_converter_new(). */
+static GstLineCache *
+chain_convert_gamma (GstVideoConverter * convert, GstLineCache * prev,
+    gint idx)
+{
+  gboolean same_primaries;
+
+  if (CHECK_PRIMARIES_NONE (convert)) {
+    same_primaries = TRUE;
+  } else {
+    same_primaries =
+        convert->in_info.colorimetry.primaries ==
+        convert->out_info.colorimetry.primaries;
+  }
+
+  setup_to_RGB_matrix (convert);
+
+  if (same_primaries) {
+    setup_gamma_remap (convert, convert->pack_bits);
+  } else {
+    GST_DEBUG ("chain gamma decode");
+    setup_gamma_decode (convert);
+    prepare_matrix (convert, &convert->convert_matrix);
+    GST_DEBUG ("chain gamma encode");
+    setup_gamma_encode (convert, convert->pack_bits);
+  }
+
+  convert->current_bits = convert->pack_bits;
+  convert->current_pstride = convert->current_bits >> 1;
+
+  setup_to_YUV_matrix (convert);
+  convert->current_format = convert->pack_format;
+
+  prev = convert->to_YUV_lines[idx] = gst_line_cache_new (prev);
+  prev->write_input = TRUE;
+  prev->pass_alloc = FALSE;
+  prev->n_lines = 1;
+  prev->stride = convert->current_pstride * convert->current_width;
+  gst_line_cache_set_need_line_func (prev,
+      do_convert_gamma_lines, idx, convert, NULL);
+
+  return prev;
+}
+
 static GstLineCache *
 chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev,
     gint idx)
@@ -1937,26 +2082,16 @@ chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev,
 
   do_gamma = CHECK_GAMMA_REMAP (convert);
 
-  if (do_gamma) {
-    gint scale;
-
+  if (do_gamma && convert->fuse_gamma) {
+    prev = chain_convert_gamma (convert, prev, idx);
+  } else if (do_gamma) {
     GST_DEBUG ("chain gamma encode");
     setup_gamma_encode (convert, convert->pack_bits);
 
     convert->current_bits = convert->pack_bits;
     convert->current_pstride = convert->current_bits >> 1;
 
-    if (!convert->pack_rgb) {
-      color_matrix_set_identity (&convert->to_YUV_matrix);
-      compute_matrix_to_YUV (convert, &convert->to_YUV_matrix, FALSE);
-
-      /* matrix is in 0..255 range, scale to pack bits */
-      GST_DEBUG ("chain YUV convert");
-      scale = 1 << convert->pack_bits;
-      color_matrix_scale_components (&convert->to_YUV_matrix,
-          1 / (float) scale, 1 / (float) scale, 1 / (float) scale);
-      prepare_matrix (convert, &convert->to_YUV_matrix);
-    }
+    setup_to_YUV_matrix (convert);
     convert->current_format = convert->pack_format;
 
     prev = convert->to_YUV_lines[idx] = gst_line_cache_new (prev);
@@ -2397,6 +2532,16 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
   convert->dither_lines = g_new0 (GstLineCache *, n_threads);
   convert->dither = g_new0 (GstVideoDither *, n_threads);
 
+  /* see chain_convert_gamma(), with other primaries the linear values need
+   * 16 bits in the line */
+  convert->fuse_gamma = CHECK_GAMMA_REMAP (convert)
+      && convert->in_width == convert->out_width
+      && convert->in_height == convert->out_height
+      && !(convert->alpha_mode & ALPHA_MODE_MULT)
+      && (convert->pack_bits == 16 || CHECK_PRIMARIES_NONE (convert)
+      || in_info->colorimetry.primaries == out_info->colorimetry.primaries);
+  GST_DEBUG ("fuse gamma %d", convert->fuse_gamma);
+
   for (i = 0; i < n_threads; i++) {
     convert->current_format = GST_VIDEO_INFO_FORMAT (in_info);
     convert->current_width = convert->in_width;
@@ -2531,9 +2676,6 @@ gst_video_converter_free (GstVideoConverter * convert)
   g_free (convert->dither_lines);
   g_free (convert->dither);
 
-  g_free (convert->gamma_dec.gamma_table);
-  g_free (convert->gamma_enc.gamma_table);
-
   if (convert->tmpline) {
     for (i = 0; i < convert->conversion_runner->n_threads; i++)
       g_free (convert->tmpline[i]);
@@ -3000,6 +3142,40 @@ do_convert_to_YUV_lines (GstLineCache * cache, gint idx, gint out_line,
   return TRUE;
 }
 
+static gboolean
+do_convert_gamma_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
+{
+  GstVideoConverter *convert = user_data;
+  gpointer *lines, destline;
+
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
+
+  if (convert->to_RGB_matrix.matrix_func) {
+    GST_DEBUG ("to RGB line %d %p", in_line, lines[0]);
+    convert->to_RGB_matrix.matrix_func (&convert->to_RGB_matrix, lines[0]);
+  }
+
+  destline = gst_line_cache_alloc_line (cache, out_line);
+  GST_DEBUG ("gamma line %d %p->%p", in_line, lines[0], destline);
+  convert->gamma_dec.gamma_func (&convert->gamma_dec, destline, lines[0]);
+
+  if (convert->gamma_enc.gamma_func) {
+    if (convert->convert_matrix.matrix_func)
+      convert->convert_matrix.matrix_func (&convert->convert_matrix, destline);
+    /* in place, the encoded samples are never bigger than the linear ones */
+    convert->gamma_enc.gamma_func (&convert->gamma_enc, destline, destline);
+  }
+
+  if (convert->to_YUV_matrix.matrix_func) {
+    GST_DEBUG ("to YUV line %d %p", in_line, destline);
+    convert->to_YUV_matrix.matrix_func (&convert->to_YUV_matrix, destline);
+  }
+  gst_line_cache_add_line (cache, in_line, destline);
+
+  return TRUE;
+}
+
 static gboolean
 do_downsample_lines (GstLineCache * cache, gint idx, gint out_line,
     gint in_line, gpointer user_data)
@@ -5789,6 +5965,264 @@ convert_scale_planes (GstVideoConverter * convert,
   convert_fill_border (convert, dest);
 }
 
+/* 8 <-> 16 bit conversion of the samples of 4:2:0 formats with the same
+ * plane layout, P010_10LE <-> NV12 and I420_10LE <-> I420. The values are
+ * the same the generic path gives: when expanding the 8 bits are replicated
+ * into the low bits like the unpack functions do, when reducing the samples
+ * are expanded to 16 bits, get the ordered dither offset of the pixel added
+ * like GST_VIDEO_DITHER_BAYER does and are truncated. The chroma samples use
+ * the offset of their first luma pixel. */
+typedef struct
+{
+  const guint8 *s;
+  guint8 *d;
+  gint sstride, dstride;
+  gint width, height;
+  gint y;
+  gint shift;
+  guint16 mask;
+  gint pstride, xsub, ysub;
+  gboolean dither;
+} FConvertDepthTask;
+
+/* @shift is the left shift that puts the 10 bits of the samples in the high
+ * bits, @dither has the dither offsets of 16 samples, or 32 when a pixel has
+ * 2 samples, it is indexed modulo @period */
+static void
+convert_depth_line_u16_u8 (guint8 * d, const guint8 * s, gint shift,
+    const guint16 * dither, gint period, gint width)
+{
+  gint i = 0;
+  guint v;
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+#if defined (__SSE2__)
+  {
+    const __m128i count = _mm_cvtsi32_si128 (shift);
+
+    for (; i < width - 15; i += 16) {
+      const guint16 *o = dither + (i % period);
+      __m128i a, b;
+
+      a = _mm_sll_epi16 (_mm_loadu_si128 ((const __m128i *) (s + i * 2)),
+          count);
+      b = _mm_sll_epi16 (_mm_loadu_si128 ((const __m128i *) (s + i * 2 +
+                  16)), count);
+      a = _mm_or_si128 (a, _mm_srli_epi16 (a, 10));
+      b = _mm_or_si128 (b, _mm_srli_epi16 (b, 10));
+      a = _mm_adds_epu16 (a, _mm_loadu_si128 ((const __m128i *) o));
+      b = _mm_adds_epu16 (b, _mm_loadu_si128 ((const __m128i *) (o + 8)));
+      a = _mm_srli_epi16 (a, 8);
+      b = _mm_srli_epi16 (b, 8);
+      _mm_storeu_si128 ((__m128i *) (d + i), _mm_packus_epi16 (a, b));
+    }
+  }
+#elif defined (__ARM_NEON)
+  {
+    const int16x8_t count = vdupq_n_s16 (shift);
+
+    for (; i < width - 15; i += 16) {
+      const guint16 *o = dither + (i % period);
+      uint16x8_t a, b;
+
+      a = vshlq_u16 (vld1q_u16 ((const guint16 *) (s + i * 2)), count);
+      b = vshlq_u16 (vld1q_u16 ((const guint16 *) (s + i * 2 + 16)), count);
+      a = vorrq_u16 (a, vshrq_n_u16 (a, 10));
+      b = vorrq_u16 (b, vshrq_n_u16 (b, 10));
+      a = vqaddq_u16 (a, vld1q_u16 (o));
+      b = vqaddq_u16 (b, vld1q_u16 (o + 8));
+      vst1q_u8 (d + i, vcombine_u8 (vshrn_n_u16 (a, 8), vshrn_n_u16 (b, 8)));
+    }
+  }
+#endif
+#endif
+  for (; i < width; i++) {
+    v = (GST_READ_UINT16_LE (s + i * 2) << shift) & 0xffff;
+    v |= v >> 10;
+    d[i] = MIN (v + dither[i % period], 65535) >> 8;
+  }
+}
+
+static void
+convert_depth_line_u8_u16 (guint8 * d, const guint8 * s, gint shift,
+    guint16 mask, gint width)
+{
+  gint i = 0;
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+#if defined (__SSE2__)
+  {
+    const __m128i m = _mm_set1_epi16 ((gshort) mask);
+    const __m128i count = _mm_cvtsi32_si128 (shift);
+
+    for (; i < width - 15; i += 16) {
+      __m128i x, a, b;
+
+      /* interleaving a byte with itself gives (v << 8) | v */
+      x = _mm_loadu_si128 ((const __m128i *) (s + i));
+      a = _mm_and_si128 (_mm_srl_epi16 (_mm_unpacklo_epi8 (x, x), count), m);
+      b = _mm_and_si128 (_mm_srl_epi16 (_mm_unpackhi_epi8 (x, x), count), m);
+      _mm_storeu_si128 ((__m128i *) (d + i * 2), a);
+      _mm_storeu_si128 ((__m128i *) (d + i * 2 + 16), b);
+    }
+  }
+#elif defined (__ARM_NEON)
+  {
+    const uint16x8_t m = vdupq_n_u16 (mask);
+    const int16x8_t count = vdupq_n_s16 (-shift);
+
+    for (; i < width - 15; i += 16) {
+      uint8x16_t x;
+      uint16x8_t a, b;
+
+      x = vld1q_u8 (s + i);
+      a = vorrq_u16 (vshll_n_u8 (vget_low_u8 (x), 8),
+          vmovl_u8 (vget_low_u8 (x)));
+      b = vorrq_u16 (vshll_n_u8 (vget_high_u8 (x), 8),
+          vmovl_u8 (vget_high_u8 (x)));
+      vst1q_u16 ((guint16 *) (d + i * 2), vandq_u16 (vshlq_u16 (a, count), m));
+      vst1q_u16 ((guint16 *) (d + i * 2 + 16),
+          vandq_u16 (vshlq_u16 (b, count), m));
+    }
+  }
+#endif
+#endif
+  for (; i < width; i++)
+    GST_WRITE_UINT16_LE (d + i * 2, (((s[i] << 8) | s[i]) >> shift) & mask);
+}
+
+static void
+convert_depth_u16_u8_task (FConvertDepthTask * task)
+{
+  guint16 dither[32];
+  gint j, k, period;
+
+  period = 16 * task->pstride;
+  memset (dither, 0, sizeof (dither));
+
+  for (j = 0; j < task->height; j++) {
+    if (task->dither) {
+      for (k = 0; k < period; k++)
+        dither[k] = __gst_video_dither_bayer_map[((task->y + j) <<
+                task->ysub) & 15][((k / task->pstride) << task->xsub) & 15];
+    }
+    convert_depth_line_u16_u8 (task->d + j * task->dstride,
+        task->s + j * task->sstride, task->shift, dither, period,
+        task->width);
+  }
+}
+
+static void
+convert_depth_u8_u16_task (FConvertDepthTask * task)
+{
+  gint j;
+
+  for (j = 0; j < task->height; j++)
+    convert_depth_line_u8_u16 (task->d + j * task->dstride,
+        task->s + j * task->sstride, task->shift, task->mask, task->width);
+}
+
+static void
+convert_depth_planes (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest, gboolean to_8bit, gint shift, guint16 mask)
+{
+  const GstVideoFormatInfo *in_finfo, *out_finfo, *finfo8;
+  FConvertDepthTask *tasks;
+  FConvertDepthTask **tasks_p;
+  gint n_threads, lines_per_thread;
+  gint i, k, n_planes;
+
+  in_finfo = convert->in_info.finfo;
+  out_finfo = convert->out_info.finfo;
+  finfo8 = to_8bit ? out_finfo : in_finfo;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = g_newa (FConvertDepthTask, n_threads);
+  tasks_p = g_newa (FConvertDepthTask *, n_threads);
+
+  /* the planes have the same layout in both formats and plane k starts with
+   * component k, only the sample size differs */
+  n_planes = GST_VIDEO_FRAME_N_PLANES (dest);
+  for (k = 0; k < n_planes; k++) {
+    const guint8 *s;
+    guint8 *d;
+    gint width, height;
+
+    width = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo8, k, convert->in_width) *
+        GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo8, k);
+    height = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo8, k, convert->in_height);
+
+    s = FRAME_GET_PLANE_LINE (src, k,
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (in_finfo, k, convert->in_y));
+    s += GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, k, convert->in_x) *
+        GST_VIDEO_FORMAT_INFO_PSTRIDE (in_finfo, k);
+    d = FRAME_GET_PLANE_LINE (dest, k,
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (out_finfo, k, convert->out_y));
+    d += GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo, k, convert->out_x) *
+        GST_VIDEO_FORMAT_INFO_PSTRIDE (out_finfo, k);
+
+    lines_per_thread = (height + n_threads - 1) / n_threads;
+
+    for (i = 0; i < n_threads; i++) {
+      tasks[i].sstride = FRAME_GET_PLANE_STRIDE (src, k);
+      tasks[i].dstride = FRAME_GET_PLANE_STRIDE (dest, k);
+      tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+      tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
+
+      tasks[i].width = width;
+      tasks[i].height = (i + 1) * lines_per_thread;
+      tasks[i].height = MIN (tasks[i].height, height);
+      tasks[i].height -= i * lines_per_thread;
+      tasks[i].height = MAX (tasks[i].height, 0);
+
+      tasks[i].y = i * lines_per_thread;
+      tasks[i].shift = shift;
+      tasks[i].mask = mask;
+      tasks[i].pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo8, k);
+      tasks[i].xsub = GST_VIDEO_FORMAT_INFO_W_SUB (finfo8, k);
+      tasks[i].ysub = GST_VIDEO_FORMAT_INFO_H_SUB (finfo8, k);
+      tasks[i].dither =
+          GET_OPT_DITHER_METHOD (convert) == GST_VIDEO_DITHER_BAYER;
+
+      tasks_p[i] = &tasks[i];
+    }
+
+    gst_parallelized_task_runner_run (convert->conversion_runner,
+        (GstParallelizedTaskFunc) (to_8bit ? convert_depth_u16_u8_task :
+            convert_depth_u8_u16_task), (gpointer) tasks_p);
+  }
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_P010_10LE_NV12 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_depth_planes (convert, src, dest, TRUE, 0, 0);
+}
+
+static void
+convert_NV12_P010_10LE (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_depth_planes (convert, src, dest, FALSE, 0, 0xffc0);
+}
+
+static void
+convert_I420_10LE_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_depth_planes (convert, src, dest, TRUE, 6, 0);
+}
+
+static void
+convert_I420_I420_10LE (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_depth_planes (convert, src, dest, FALSE, 6, 0x3ff);
+}
+
 static GstVideoFormat
 get_scale_format (GstVideoFormat format, gint plane)
 {
@@ -6498,6 +6932,16 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_NV24, GST_VIDEO_FORMAT_NV24, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 
+  /* 10 bits <-> 8 bits */
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_P010_10LE_NV12},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_P010_10LE, TRUE, FALSE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_P010_10LE},
+  {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_I420, TRUE, FALSE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_10LE_I420},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_I420_10LE, TRUE, FALSE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_I420_10LE},
+
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
   {GST_VIDEO_FORMAT_AYUV, GST_VIDEO_FORMAT_ARGB, TRUE, TRUE, TRUE, TRUE, TRUE,
       TRUE, FALSE, FALSE, 0, 0, convert_AYUV_ARGB},
@@ -6637,7 +7081,7 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
   GstVideoFormat in_format, out_format;
   GstVideoTransferFunction in_transf, out_transf;
   gboolean interlaced, same_matrix, same_primaries, same_size, crop, border;
-  gboolean need_copy, need_set, need_mult;
+  gboolean need_copy, need_set, need_mult, need_dither;
   gint width, height;
 
   width = GST_VIDEO_INFO_WIDTH (&convert->in_info);
@@ -6664,6 +7108,12 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
   in_format = GST_VIDEO_INFO_FORMAT (&convert->in_info);
   out_format = GST_VIDEO_INFO_FORMAT (&convert->out_info);
 
+  /* the fastpaths that reduce the depth only do the ordered dither */
+  need_dither = GET_OPT_DITHER_METHOD (convert) != GST_VIDEO_DITHER_NONE &&
+      GET_OPT_DITHER_METHOD (convert) != GST_VIDEO_DITHER_BAYER &&
+      GST_VIDEO_INFO_COMP_DEPTH (&convert->out_info, 0) <
+      GST_VIDEO_INFO_COMP_DEPTH (&convert->in_info, 0);
+
   if (CHECK_MATRIX_NONE (convert)) {
     same_matrix = TRUE;
   } else {
@@ -6696,7 +7146,7 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
 
   for (i = 0; i < sizeof (transforms) / sizeof (transforms[0]); i++) {
     if (transforms[i].in_format == in_format &&
-        transforms[i].out_format == out_format &&
+        transforms[i].out_format == out_format && !need_dither &&
         (transforms[i].keeps_interlaced || !interlaced) &&
         (transforms[i].needs_color_matrix || (same_matrix && same_primaries))
         && (!transforms[i].keeps_size || same_size)
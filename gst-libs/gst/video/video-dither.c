@@ -21,6 +21,7 @@
 
 #include "video-dither.h"
 #include "video-orc.h"
+#include "gstvideoutilsprivate.h"
 
 /**
  * SECTION:gstvideodither
@@ -228,7 +229,7 @@ dither_sierra_lite_u16 (GstVideoDither * dither, gpointer pixels, guint x,
   }
 }
 
-static const guint16 bayer_map[16][16] = {
+const guint16 __gst_video_dither_bayer_map[16][16] = {
   {0, 128, 32, 160, 8, 136, 40, 168, 2, 130, 34, 162, 10, 138, 42, 170},
   {192, 64, 224, 96, 200, 72, 232, 104, 194, 66, 226, 98, 202, 74, 234, 106},
   {48, 176, 16, 144, 56, 184, 24, 152, 50, 178, 18, 146, 58, 186, 26, 154},
@@ -318,7 +319,7 @@ setup_bayer (GstVideoDither * dither)
       guint8 *p = (guint8 *) dither->errors + (n_comp * width * i), v;
       for (j = 0; j < width; j++) {
         for (k = 0; k < n_comp; k++) {
-          v = bayer_map[i & 15][j & 15];
+          v = __gst_video_dither_bayer_map[i & 15][j & 15];
           if (shift[k] < 8)
             v = v >> (8 - shift[k]);
           p[n_comp * j + k] = v;
@@ -330,7 +331,7 @@ setup_bayer (GstVideoDither * dither)
       guint16 *p = (guint16 *) dither->errors + (n_comp * width * i), v;
       for (j = 0; j < width; j++) {
         for (k = 0; k < n_comp; k++) {
-          v = bayer_map[i & 15][j & 15];
+          v = __gst_video_dither_bayer_map[i & 15][j & 15];
           if (shift[k] < 8)
             v = v >> (8 - shift[k]);
           p[n_comp * j + k] = v;
@@ -26,10 +26,15 @@
 #include <string.h>
 #include <stdio.h>
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <gst/video/video.h>
 #include "video-frame.h"
 #include "video-tile.h"
 #include "gstvideometa.h"
+#include "gstvideoutilsprivate.h"
 
 #define CAT_PERFORMANCE video_frame_get_perf_category()
 
@@ -272,6 +277,220 @@ gst_video_frame_unmap (GstVideoFrame * frame)
     gst_buffer_unref (frame->buffer);
 }
 
+/**
+ * gst_video_frame_crop:
+ * @frame: a mapped #GstVideoFrame
+ * @x: the left edge of the region
+ * @y: the top edge of the region
+ * @width: the width of the region
+ * @height: the height of the region
+ *
+ * Restrict @frame to the region of @width by @height pixels at @x, @y
+ * without copying anything. The plane pointers of @frame are moved to the
+ * first pixel of the region and the size of @frame is set to the size of the
+ * region, the strides are kept. @frame is unmapped as usual afterwards.
+ *
+ * This is used to apply a #GstVideoCropMeta to a frame that was mapped with
+ * the size of its #GstVideoMeta.
+ *
+ * The region must be inside @frame and @x and @y must be multiples of the
+ * subsampling of the format. Tiled formats and formats that pack pixels in
+ * groups of bits can't be cropped this way.
+ *
+ * Returns: %TRUE if @frame was cropped, %FALSE if the region can't be
+ *   selected by moving the plane pointers, @frame is unchanged then.
+ *
+ * Since: 1.16
+ */
+gboolean
+gst_video_frame_crop (GstVideoFrame * frame, guint x, guint y, guint width,
+    guint height)
+{
+  const GstVideoFormatInfo *finfo;
+  GstVideoInfo *info;
+  gssize offset[GST_VIDEO_MAX_PLANES];
+  gboolean has_offset[GST_VIDEO_MAX_PLANES] = { FALSE, };
+  guint i;
+
+  g_return_val_if_fail (frame != NULL, FALSE);
+  g_return_val_if_fail (width > 0 && height > 0, FALSE);
+
+  info = &frame->info;
+  finfo = info->finfo;
+
+  if (width > GST_VIDEO_INFO_WIDTH (info)
+      || x > GST_VIDEO_INFO_WIDTH (info) - width
+      || height > GST_VIDEO_INFO_HEIGHT (info)
+      || y > GST_VIDEO_INFO_HEIGHT (info) - height)
+    goto outside;
+
+  if (GST_VIDEO_FORMAT_INFO_IS_TILED (finfo))
+    goto not_possible;
+
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    guint plane = GST_VIDEO_FORMAT_INFO_PLANE (finfo, i);
+    gint pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, i);
+    gint ws = GST_VIDEO_FORMAT_INFO_W_SUB (finfo, i);
+    gint hs = GST_VIDEO_FORMAT_INFO_H_SUB (finfo, i);
+    gssize off;
+
+    /* moving interlaced frames by an odd number of lines would swap the
+     * fields */
+    if (GST_VIDEO_INFO_IS_INTERLACED (info))
+      hs++;
+
+    if (pstride <= 0 || (x & ((1 << ws) - 1)) || (y & ((1 << hs) - 1)))
+      goto not_possible;
+
+    off = (gssize) GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i, y) *
+        GST_VIDEO_INFO_PLANE_STRIDE (info, plane) +
+        GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, i, x) * pstride;
+
+    /* the components that share a plane must agree on where the region
+     * starts, this is true for all the formats with pixel groups */
+    if (has_offset[plane] && offset[plane] != off)
+      goto not_possible;
+
+    offset[plane] = off;
+    has_offset[plane] = TRUE;
+  }
+
+  for (i = 0; i < GST_VIDEO_MAX_PLANES; i++) {
+    if (!has_offset[i])
+      continue;
+
+    frame->data[i] = (guint8 *) frame->data[i] + offset[i];
+    info->offset[i] += offset[i];
+  }
+  info->width = width;
+  info->height = height;
+
+  return TRUE;
+
+  /* ERRORS */
+outside:
+  {
+    GST_DEBUG ("region %ux%u at %u,%u is outside of the %dx%d frame", width,
+        height, x, y, GST_VIDEO_INFO_WIDTH (info),
+        GST_VIDEO_INFO_HEIGHT (info));
+    return FALSE;
+  }
+not_possible:
+  {
+    GST_DEBUG ("can't crop %s frame to region %ux%u at %u,%u",
+        GST_VIDEO_INFO_NAME (info), width, height, x, y);
+    return FALSE;
+  }
+}
+
+/* planes at least this big are written with non-temporal stores. They don't
+ * fit in the cache of the consumer anyway and streaming them keeps the rest
+ * of its working set cached. */
+#define COPY_STREAM_THRESHOLD (4 * 1024 * 1024)
+/* planes at least this big, like the luma of 8K frames, are copied in bands
+ * by several threads */
+#define COPY_BANDS_THRESHOLD (16 * 1024 * 1024)
+#define COPY_MAX_BANDS 4
+
+typedef struct
+{
+  guint8 *dp;
+  const guint8 *sp;
+  gint ds, ss;
+  guint w, h;
+  gboolean stream;
+} CopyRows;
+
+static GstParallelizedTaskRunner *copy_runner;
+static GMutex copy_runner_lock;
+
+/* shared by all frame copies, NULL when we have a single cpu */
+static GstParallelizedTaskRunner *
+get_copy_runner (void)
+{
+  static gsize init = 0;
+
+  if (g_once_init_enter (&init)) {
+    guint n_threads = MIN (g_get_num_processors (), COPY_MAX_BANDS);
+
+    if (n_threads > 1)
+      copy_runner = gst_parallelized_task_runner_new (n_threads);
+
+    g_once_init_leave (&init, 1);
+  }
+  return copy_runner;
+}
+
+static void
+copy_stream (guint8 * dp, const guint8 * sp, gsize n)
+{
+#if defined (__SSE2__)
+  gsize head;
+
+  /* the stores must be aligned, the loads don't need to be */
+  head = (16 - ((guintptr) dp & 15)) & 15;
+  if (n < head + 64) {
+    memcpy (dp, sp, n);
+    return;
+  }
+  memcpy (dp, sp, head);
+  dp += head;
+  sp += head;
+  n -= head;
+
+  while (n >= 64) {
+    __m128i a, b, c, d;
+
+    a = _mm_loadu_si128 ((const __m128i *) (sp + 0));
+    b = _mm_loadu_si128 ((const __m128i *) (sp + 16));
+    c = _mm_loadu_si128 ((const __m128i *) (sp + 32));
+    d = _mm_loadu_si128 ((const __m128i *) (sp + 48));
+    _mm_stream_si128 ((__m128i *) (dp + 0), a);
+    _mm_stream_si128 ((__m128i *) (dp + 16), b);
+    _mm_stream_si128 ((__m128i *) (dp + 32), c);
+    _mm_stream_si128 ((__m128i *) (dp + 48), d);
+    dp += 64;
+    sp += 64;
+    n -= 64;
+  }
+#endif
+  memcpy (dp, sp, n);
+}
+
+static void
+copy_rows (CopyRows * rows)
+{
+  guint8 *dp = rows->dp;
+  const guint8 *sp = rows->sp;
+  guint j;
+
+  /* without padding the rows are one block */
+  if (rows->ds == rows->ss && rows->ds > 0 && rows->w == (guint) rows->ds) {
+    if (rows->stream)
+      copy_stream (dp, sp, (gsize) rows->w * rows->h);
+    else
+      memcpy (dp, sp, (gsize) rows->w * rows->h);
+  } else if (rows->stream) {
+    for (j = 0; j < rows->h; j++) {
+      copy_stream (dp, sp, rows->w);
+      dp += rows->ds;
+      sp += rows->ss;
+    }
+  } else {
+    for (j = 0; j < rows->h; j++) {
+      memcpy (dp, sp, rows->w);
+      dp += rows->ds;
+      sp += rows->ss;
+    }
+  }
+
+#if defined (__SSE2__)
+  /* make the streamed data visible to the other threads */
+  if (rows->stream)
+    _mm_sfence ();
+#endif
+}
+
 /**
  * gst_video_frame_copy_plane:
  * @dest: a #GstVideoFrame
@@ -280,6 +499,10 @@ gst_video_frame_unmap (GstVideoFrame * frame)
  *
  * Copy the plane with index @plane from @src to @dest.
  *
+ * Large planes are written with non-temporal stores, so that copying them
+ * doesn't evict the cached data of the calling thread, and the largest ones
+ * are copied in bands by several threads.
+ *
  * Returns: TRUE if the contents could be copied.
  */
 gboolean
@@ -368,14 +591,46 @@ gst_video_frame_copy_plane (GstVideoFrame * dest, const GstVideoFrame * src,
       }
     }
   } else {
-    guint j;
-
-    GST_CAT_DEBUG (CAT_PERFORMANCE, "copy plane %d, w:%d h:%d ", plane, w, h);
-
-    for (j = 0; j < h; j++) {
-      memcpy (dp, sp, w);
-      dp += ds;
-      sp += ss;
+    CopyRows rows;
+    GstParallelizedTaskRunner *runner;
+    gsize size;
+
+    size = (gsize) w * h;
+
+    rows.dp = dp;
+    rows.sp = sp;
+    rows.ds = ds;
+    rows.ss = ss;
+    rows.w = w;
+    rows.h = h;
+    rows.stream = size >= COPY_STREAM_THRESHOLD;
+
+    GST_CAT_DEBUG (CAT_PERFORMANCE, "copy plane %d, w:%d h:%d%s", plane, w, h,
+        rows.stream ? " streaming" : "");
+
+    /* the runner does one copy at a time, when it is busy we copy here */
+    if (size >= COPY_BANDS_THRESHOLD && (runner = get_copy_runner ())
+        && g_mutex_trylock (&copy_runner_lock)) {
+      CopyRows bands[COPY_MAX_BANDS];
+      gpointer tasks[COPY_MAX_BANDS];
+      guint i, n_bands, start, end;
+
+      n_bands = runner->n_threads;
+      for (i = 0; i < n_bands; i++) {
+        start = (h * i) / n_bands;
+        end = (h * (i + 1)) / n_bands;
+
+        bands[i] = rows;
+        bands[i].dp = dp + (gint) start * ds;
+        bands[i].sp = sp + (gint) start * ss;
+        bands[i].h = end - start;
+        tasks[i] = &bands[i];
+      }
+      gst_parallelized_task_runner_run (runner,
+          (GstParallelizedTaskFunc) copy_rows, tasks);
+      g_mutex_unlock (&copy_runner_lock);
+    } else {
+      copy_rows (&rows);
     }
   }
 
@@ -95,6 +95,10 @@ gboolean    gst_video_frame_map_id        (GstVideoFrame *frame, GstVideoInfo *i
 GST_VIDEO_API
 void        gst_video_frame_unmap         (GstVideoFrame *frame);
 
+GST_VIDEO_API
+gboolean    gst_video_frame_crop          (GstVideoFrame *frame, guint x, guint y,
+                                           guint width, guint height);
+
 GST_VIDEO_API
 gboolean    gst_video_frame_copy          (GstVideoFrame *dest, const GstVideoFrame *src);
 
@@ -27,6 +27,13 @@
 
 #include <gst/base/gsttypefindhelper.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (gst_gio_base_src_debug);
 #define GST_CAT_DEFAULT gst_gio_base_src_debug
 
@@ -35,10 +42,29 @@ static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+enum
+{
+  PROP_0,
+  PROP_READ_AHEAD
+};
+
+#define DEFAULT_READ_AHEAD 0
+
+/* size of the individual reads done by the read-ahead thread */
+#define READ_AHEAD_CHUNK_SIZE (64 * 1024)
+/* number of back-to-back creates after which read-ahead kicks in */
+#define READ_AHEAD_SEQUENTIAL_THRESHOLD 2
+
+#define READ_AHEAD_STATS_NAME "GstGioReadAheadStats"
+
 #define gst_gio_base_src_parent_class parent_class
 G_DEFINE_TYPE (GstGioBaseSrc, gst_gio_base_src, GST_TYPE_BASE_SRC);
 
 static void gst_gio_base_src_finalize (GObject * object);
+static void gst_gio_base_src_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_gio_base_src_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean gst_gio_base_src_start (GstBaseSrc * base_src);
 static gboolean gst_gio_base_src_stop (GstBaseSrc * base_src);
@@ -63,6 +89,27 @@ gst_gio_base_src_class_init (GstGioBaseSrcClass * klass)
       "GIO base source");
 
   gobject_class->finalize = gst_gio_base_src_finalize;
+  gobject_class->set_property = gst_gio_base_src_set_property;
+  gobject_class->get_property = gst_gio_base_src_get_property;
+
+  /**
+   * GstGioBaseSrc:read-ahead:
+   *
+   * Size in bytes of the window a background thread keeps filled ahead of
+   * the current read position once sequential access is detected, or 0 to
+   * read synchronously. Useful for slow or high-latency storage.
+   *
+   * Hit statistics can be retrieved with a custom query whose structure is
+   * named "GstGioReadAheadStats"; the element fills in the "hits", "misses"
+   * (#guint64), "prefetched-bytes" (#guint64) and "hit-rate" (#gdouble)
+   * fields.
+   */
+  g_object_class_install_property (gobject_class, PROP_READ_AHEAD,
+      g_param_spec_uint ("read-ahead", "Read ahead",
+          "Bytes to read ahead in the background on sequential access "
+          "(0 = disabled)", 0, G_MAXINT, DEFAULT_READ_AHEAD,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (gstelement_class, &src_factory);
 
@@ -82,6 +129,11 @@ static void
 gst_gio_base_src_init (GstGioBaseSrc * src)
 {
   src->cancel = g_cancellable_new ();
+  src->read_ahead = DEFAULT_READ_AHEAD;
+
+  g_mutex_init (&src->ra_lock);
+  g_cond_init (&src->ra_cond);
+  g_queue_init (&src->ra_buffers);
 }
 
 static void
@@ -104,9 +156,390 @@ gst_gio_base_src_finalize (GObject * object)
     src->cache = NULL;
   }
 
+  if (src->mapped) {
+    g_mapped_file_unref (src->mapped);
+    src->mapped = NULL;
+  }
+
+  g_mutex_clear (&src->ra_lock);
+  g_cond_clear (&src->ra_cond);
+
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (object));
 }
 
+static void
+gst_gio_base_src_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstGioBaseSrc *src = GST_GIO_BASE_SRC (object);
+
+  switch (prop_id) {
+    case PROP_READ_AHEAD:
+      src->read_ahead = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_gio_base_src_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstGioBaseSrc *src = GST_GIO_BASE_SRC (object);
+
+  switch (prop_id) {
+    case PROP_READ_AHEAD:
+      g_value_set_uint (value, src->read_ahead);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* drops all prefetched data; called with ra_lock */
+static void
+gst_gio_base_src_read_ahead_flush (GstGioBaseSrc * src, guint64 offset)
+{
+  GstBuffer *buf;
+
+  while ((buf = g_queue_pop_head (&src->ra_buffers)))
+    gst_buffer_unref (buf);
+
+  src->ra_start = src->ra_end = offset;
+  src->ra_eos = FALSE;
+  src->ra_error = FALSE;
+  src->ra_generation++;
+}
+
+static gpointer
+gst_gio_base_src_read_ahead_loop (GstGioBaseSrc * src)
+{
+  g_mutex_lock (&src->ra_lock);
+  while (src->ra_running) {
+    GstBuffer *buf;
+    GstMemory *mem;
+    GstMapInfo map;
+    GCancellable *cancel;
+    GError *err = NULL;
+    guint64 offset;
+    gsize chunk, read = 0;
+    gssize res = 0;
+    guint generation;
+
+    /* only prefetch while the access is sequential and the window isn't
+     * full yet */
+    if (src->ra_busy || src->ra_eos || src->ra_error || src->ra_flushing ||
+        src->ra_sequential < READ_AHEAD_SEQUENTIAL_THRESHOLD ||
+        src->ra_end - src->ra_next >= src->read_ahead) {
+      g_cond_wait (&src->ra_cond, &src->ra_lock);
+      continue;
+    }
+
+    offset = src->ra_end;
+    chunk = MIN (READ_AHEAD_CHUNK_SIZE,
+        src->read_ahead - (src->ra_end - src->ra_next));
+    generation = src->ra_generation;
+    cancel = g_object_ref (src->ra_cancel);
+    src->ra_busy = TRUE;
+    g_mutex_unlock (&src->ra_lock);
+
+    mem = gst_allocator_alloc (NULL, chunk, NULL);
+    gst_memory_map (mem, &map, GST_MAP_WRITE);
+
+    if (offset != src->position) {
+      if (g_seekable_seek (G_SEEKABLE (src->stream), offset, G_SEEK_SET,
+              cancel, &err))
+        src->position = offset;
+      else
+        res = -1;
+    }
+
+    while (res >= 0 && read < chunk &&
+        (res = g_input_stream_read (src->stream, map.data + read,
+                chunk - read, cancel, &err)) > 0) {
+      read += res;
+      src->position += res;
+    }
+    gst_memory_unmap (mem, &map);
+    g_object_unref (cancel);
+
+    if (err) {
+      /* leave reporting errors to the synchronous path */
+      GST_DEBUG_OBJECT (src, "read-ahead at %" G_GUINT64_FORMAT " failed: %s",
+          offset, err->message);
+      g_clear_error (&err);
+    }
+
+    g_mutex_lock (&src->ra_lock);
+    src->ra_busy = FALSE;
+
+    /* only a clean end of stream is EOS; after an error create() reads
+     * synchronously past the prefetched data and reports the error */
+    if (generation == src->ra_generation) {
+      if (res < 0)
+        src->ra_error = TRUE;
+      else if (read < chunk)
+        src->ra_eos = TRUE;
+    }
+
+    if (generation != src->ra_generation || read == 0) {
+      gst_memory_unref (mem);
+    } else {
+      gst_memory_resize (mem, 0, read);
+      buf = gst_buffer_new ();
+      gst_buffer_append_memory (buf, mem);
+      GST_BUFFER_OFFSET (buf) = offset;
+      GST_BUFFER_OFFSET_END (buf) = offset + read;
+      g_queue_push_tail (&src->ra_buffers, buf);
+      src->ra_end += read;
+      src->ra_prefetched += read;
+
+      GST_LOG_OBJECT (src, "prefetched %" G_GSIZE_FORMAT " bytes at %"
+          G_GUINT64_FORMAT, read, offset);
+    }
+    g_cond_broadcast (&src->ra_cond);
+  }
+  g_mutex_unlock (&src->ra_lock);
+
+  return NULL;
+}
+
+static void
+gst_gio_base_src_read_ahead_start (GstGioBaseSrc * src)
+{
+  GError *err = NULL;
+
+  src->ra_hits = src->ra_misses = src->ra_prefetched = 0;
+  src->ra_sequential = 0;
+  src->ra_next = src->position;
+  src->ra_busy = FALSE;
+  src->ra_flushing = FALSE;
+  gst_gio_base_src_read_ahead_flush (src, src->position);
+
+  if (src->read_ahead == 0 || src->mapped)
+    return;
+
+  /* prefetching seeks the stream, which e.g. giostreamsrc streams might not
+   * support */
+  if (!GST_GIO_STREAM_IS_SEEKABLE (src->stream)) {
+    GST_DEBUG_OBJECT (src, "stream not seekable, not reading ahead");
+    return;
+  }
+
+  src->ra_cancel = g_cancellable_new ();
+  src->ra_running = TRUE;
+  src->ra_thread = g_thread_try_new ("giosrc-readahead",
+      (GThreadFunc) gst_gio_base_src_read_ahead_loop, src, &err);
+  if (src->ra_thread == NULL) {
+    GST_WARNING_OBJECT (src, "failed to start read-ahead thread: %s",
+        err->message);
+    g_clear_error (&err);
+    src->ra_running = FALSE;
+    g_clear_object (&src->ra_cancel);
+  }
+}
+
+static void
+gst_gio_base_src_read_ahead_stop (GstGioBaseSrc * src)
+{
+  if (src->ra_thread) {
+    g_mutex_lock (&src->ra_lock);
+    src->ra_running = FALSE;
+    g_cancellable_cancel (src->ra_cancel);
+    g_cond_broadcast (&src->ra_cond);
+    g_mutex_unlock (&src->ra_lock);
+
+    g_thread_join (src->ra_thread);
+    src->ra_thread = NULL;
+    g_mutex_lock (&src->ra_lock);
+    g_clear_object (&src->ra_cancel);
+    g_mutex_unlock (&src->ra_lock);
+
+    GST_DEBUG_OBJECT (src, "read-ahead stats: %" G_GUINT64_FORMAT " hits, %"
+        G_GUINT64_FORMAT " misses, %" G_GUINT64_FORMAT " bytes prefetched",
+        src->ra_hits, src->ra_misses, src->ra_prefetched);
+  }
+
+  g_mutex_lock (&src->ra_lock);
+  gst_gio_base_src_read_ahead_flush (src, 0);
+  g_mutex_unlock (&src->ra_lock);
+}
+
+/* Tries to serve the range from prefetched data. On a miss the prefetched
+ * data is dropped, ownership of the stream is taken and FALSE is returned;
+ * the caller then reads synchronously and calls
+ * gst_gio_base_src_read_ahead_release(). */
+static gboolean
+gst_gio_base_src_read_ahead_get (GstGioBaseSrc * src, guint64 offset,
+    guint size, GstBuffer ** buf_return)
+{
+  GstBuffer *buf;
+  guint64 end;
+  GList *l;
+
+  g_mutex_lock (&src->ra_lock);
+
+  if (offset == src->ra_next) {
+    if (src->ra_sequential < READ_AHEAD_SEQUENTIAL_THRESHOLD)
+      src->ra_sequential++;
+  } else {
+    src->ra_sequential = 0;
+  }
+
+  /* data we're waiting for might be read right now */
+  while (src->ra_busy && offset >= src->ra_start && offset <= src->ra_end &&
+      offset + size > src->ra_end && !src->ra_eos)
+    g_cond_wait (&src->ra_cond, &src->ra_lock);
+
+  if (offset < src->ra_start || offset >= src->ra_end ||
+      (offset + size > src->ra_end && !src->ra_eos))
+    goto miss;
+
+  end = MIN (offset + size, src->ra_end);
+  buf = gst_buffer_new ();
+  for (l = src->ra_buffers.head; l; l = l->next) {
+    GstBuffer *cached = l->data;
+    guint64 start, stop;
+
+    start = MAX (offset, GST_BUFFER_OFFSET (cached));
+    stop = MIN (end, GST_BUFFER_OFFSET_END (cached));
+    if (start < stop)
+      gst_buffer_copy_into (buf, cached, GST_BUFFER_COPY_MEMORY,
+          start - GST_BUFFER_OFFSET (cached), stop - start);
+  }
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = end;
+
+  /* the consumer moved on, release what is behind it */
+  while ((l = src->ra_buffers.head) &&
+      GST_BUFFER_OFFSET_END (GST_BUFFER (l->data)) <= offset) {
+    src->ra_start = GST_BUFFER_OFFSET_END (GST_BUFFER (l->data));
+    gst_buffer_unref (g_queue_pop_head (&src->ra_buffers));
+  }
+
+  src->ra_hits++;
+  src->ra_next = end;
+  g_cond_broadcast (&src->ra_cond);
+  g_mutex_unlock (&src->ra_lock);
+
+  GST_LOG_OBJECT (src, "read-ahead hit: offset %" G_GUINT64_FORMAT
+      " length %" G_GUINT64_FORMAT, offset, end - offset);
+
+  *buf_return = buf;
+  return TRUE;
+
+miss:
+  src->ra_misses++;
+  while (src->ra_busy)
+    g_cond_wait (&src->ra_cond, &src->ra_lock);
+  gst_gio_base_src_read_ahead_flush (src, offset);
+  src->ra_busy = TRUE;
+  g_mutex_unlock (&src->ra_lock);
+
+  GST_LOG_OBJECT (src, "read-ahead miss: offset %" G_GUINT64_FORMAT
+      " length %u", offset, size);
+
+  return FALSE;
+}
+
+static void
+gst_gio_base_src_read_ahead_release (GstGioBaseSrc * src, guint64 next)
+{
+  g_mutex_lock (&src->ra_lock);
+  src->ra_busy = FALSE;
+  src->ra_next = next;
+  gst_gio_base_src_read_ahead_flush (src, next);
+  g_cond_broadcast (&src->ra_cond);
+  g_mutex_unlock (&src->ra_lock);
+}
+
+/* Maps @path (which is freed) read-only so that create() can hand out
+ * buffers pointing into the page cache instead of copying with
+ * g_input_stream_read(). Reads past the mapped size, e.g. because the file
+ * grew, still go through the stream. */
+static void
+gst_gio_base_src_map_file (GstGioBaseSrc * src, gchar * path)
+{
+  GError *err = NULL;
+
+  if (path == NULL) {
+    GST_DEBUG_OBJECT (src, "not a local file, not mapping");
+    return;
+  }
+
+  src->mapped = g_mapped_file_new (path, FALSE, &err);
+  if (src->mapped == NULL) {
+    GST_WARNING_OBJECT (src, "failed to map %s: %s", path, err->message);
+    g_clear_error (&err);
+  } else if (g_mapped_file_get_length (src->mapped) == 0) {
+    GST_DEBUG_OBJECT (src, "empty file, not mapping");
+    g_mapped_file_unref (src->mapped);
+    src->mapped = NULL;
+  } else {
+    src->mapped_size = g_mapped_file_get_length (src->mapped);
+    src->mapped_next = 0;
+    src->mapped_sequential = 0;
+#ifdef MADV_NORMAL
+    src->mapped_advice = MADV_NORMAL;
+#endif
+    GST_DEBUG_OBJECT (src, "mapped %s, %" G_GUINT64_FORMAT " bytes", path,
+        src->mapped_size);
+  }
+
+  g_free (path);
+}
+
+/* number of back-to-back reads after which the access is considered
+ * sequential */
+#define MMAP_SEQUENTIAL_THRESHOLD 2
+/* minimum amount to prefetch ahead of sequential reads */
+#define MMAP_WILLNEED_SIZE (1024 * 1024)
+
+static void
+gst_gio_base_src_advise (GstGioBaseSrc * src, guint64 offset, guint size)
+{
+#if defined (HAVE_MMAP) && defined (MADV_SEQUENTIAL)
+  guint8 *data = (guint8 *) g_mapped_file_get_contents (src->mapped);
+  gint advice;
+
+  if (offset == src->mapped_next) {
+    if (src->mapped_sequential < MMAP_SEQUENTIAL_THRESHOLD)
+      src->mapped_sequential++;
+  } else {
+    src->mapped_sequential = 0;
+  }
+
+  if (src->mapped_sequential >= MMAP_SEQUENTIAL_THRESHOLD)
+    advice = MADV_SEQUENTIAL;
+  else if (offset != src->mapped_next)
+    advice = MADV_RANDOM;
+  else
+    advice = src->mapped_advice;
+
+  if (advice != src->mapped_advice) {
+    GST_LOG_OBJECT (src, "switching to %s access advice",
+        advice == MADV_SEQUENTIAL ? "sequential" : "random");
+    if (madvise (data, src->mapped_size, advice) == 0)
+      src->mapped_advice = advice;
+  }
+
+  /* ask the kernel to start reading the following data already */
+  if (advice == MADV_SEQUENTIAL && offset + size < src->mapped_size) {
+    guint64 page_mask = sysconf (_SC_PAGESIZE) - 1;
+    guint64 start = (offset + size) & ~page_mask;
+    guint64 len = MIN (MAX (MMAP_WILLNEED_SIZE, 4 * (guint64) size),
+        src->mapped_size - start);
+
+    madvise (data + start, len, MADV_WILLNEED);
+  }
+#endif
+
+  src->mapped_next = offset + size;
+}
+
 static gboolean
 gst_gio_base_src_start (GstBaseSrc * base_src)
 {
@@ -130,6 +563,11 @@ gst_gio_base_src_start (GstBaseSrc * base_src)
   if (G_IS_SEEKABLE (src->stream))
     src->position = g_seekable_tell (G_SEEKABLE (src->stream));
 
+  if (src->use_mmap && gbsrc_class->get_local_path)
+    gst_gio_base_src_map_file (src, gbsrc_class->get_local_path (src));
+
+  gst_gio_base_src_read_ahead_start (src);
+
   GST_DEBUG_OBJECT (src, "started source");
 
   return TRUE;
@@ -143,6 +581,8 @@ gst_gio_base_src_stop (GstBaseSrc * base_src)
   gboolean success;
   GError *err = NULL;
 
+  gst_gio_base_src_read_ahead_stop (src);
+
   if (klass->close_on_stop && G_IS_INPUT_STREAM (src->stream)) {
     GST_DEBUG_OBJECT (src, "closing stream");
 
@@ -168,14 +608,19 @@ gst_gio_base_src_stop (GstBaseSrc * base_src)
     src->stream = NULL;
   }
 
+  /* buffers still pointing into the mapping keep it alive */
+  if (src->mapped) {
+    g_mapped_file_unref (src->mapped);
+    src->mapped = NULL;
+  }
+
   return TRUE;
 }
 
+/* must be called with the stream claimed from the read-ahead thread */
 static gboolean
-gst_gio_base_src_get_size (GstBaseSrc * base_src, guint64 * size)
+gst_gio_base_src_query_size (GstGioBaseSrc * src, guint64 * size)
 {
-  GstGioBaseSrc *src = GST_GIO_BASE_SRC (base_src);
-
   if (G_IS_FILE_INPUT_STREAM (src->stream)) {
     GFileInfo *info;
     GError *err = NULL;
@@ -253,6 +698,30 @@ gst_gio_base_src_get_size (GstBaseSrc * base_src, guint64 * size)
   return FALSE;
 }
 
+static gboolean
+gst_gio_base_src_get_size (GstBaseSrc * base_src, guint64 * size)
+{
+  GstGioBaseSrc *src = GST_GIO_BASE_SRC (base_src);
+  gboolean ret;
+
+  /* the read-ahead thread might be reading from the stream, wait for it
+   * and keep it away while querying and seeking */
+  g_mutex_lock (&src->ra_lock);
+  while (src->ra_busy)
+    g_cond_wait (&src->ra_cond, &src->ra_lock);
+  src->ra_busy = TRUE;
+  g_mutex_unlock (&src->ra_lock);
+
+  ret = gst_gio_base_src_query_size (src, size);
+
+  g_mutex_lock (&src->ra_lock);
+  src->ra_busy = FALSE;
+  g_cond_broadcast (&src->ra_cond);
+  g_mutex_unlock (&src->ra_lock);
+
+  return ret;
+}
+
 static gboolean
 gst_gio_base_src_is_seekable (GstBaseSrc * base_src)
 {
@@ -275,6 +744,14 @@ gst_gio_base_src_unlock (GstBaseSrc * base_src)
 
   g_cancellable_cancel (src->cancel);
 
+  /* don't make flushes wait for a slow background read */
+  g_mutex_lock (&src->ra_lock);
+  src->ra_flushing = TRUE;
+  if (src->ra_cancel)
+    g_cancellable_cancel (src->ra_cancel);
+  g_cond_broadcast (&src->ra_cond);
+  g_mutex_unlock (&src->ra_lock);
+
   return TRUE;
 }
 
@@ -288,19 +765,27 @@ gst_gio_base_src_unlock_stop (GstBaseSrc * base_src)
   g_object_unref (src->cancel);
   src->cancel = g_cancellable_new ();
 
+  /* the data read by a cancelled read-ahead is dropped with the generation */
+  g_mutex_lock (&src->ra_lock);
+  src->ra_flushing = FALSE;
+  if (src->ra_cancel) {
+    g_object_unref (src->ra_cancel);
+    src->ra_cancel = g_cancellable_new ();
+  }
+  gst_gio_base_src_read_ahead_flush (src, src->ra_next);
+  g_cond_broadcast (&src->ra_cond);
+  g_mutex_unlock (&src->ra_lock);
+
   return TRUE;
 }
 
 static GstFlowReturn
-gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
+gst_gio_base_src_read (GstGioBaseSrc * src, guint64 offset, guint size,
     GstBuffer ** buf_return)
 {
-  GstGioBaseSrc *src = GST_GIO_BASE_SRC (base_src);
   GstBuffer *buf;
   GstFlowReturn ret = GST_FLOW_OK;
 
-  g_return_val_if_fail (G_IS_INPUT_STREAM (src->stream), GST_FLOW_ERROR);
-
   /* If we have the requested part in our cache take a subbuffer of that,
    * otherwise fill the cache again with at least 4096 bytes from the
    * requested offset and return a subbuffer of that.
@@ -430,6 +915,54 @@ gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
   return ret;
 }
 
+static GstFlowReturn
+gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
+    GstBuffer ** buf_return)
+{
+  GstGioBaseSrc *src = GST_GIO_BASE_SRC (base_src);
+  GstBuffer *buf;
+  GstFlowReturn ret;
+
+  g_return_val_if_fail (G_IS_INPUT_STREAM (src->stream), GST_FLOW_ERROR);
+
+  if (src->mapped && offset < src->mapped_size) {
+    guint len = MIN (size, src->mapped_size - offset);
+
+    GST_LOG_OBJECT (src, "Creating buffer from mapping: offset %"
+        G_GUINT64_FORMAT " length %u", offset, len);
+
+    gst_gio_base_src_advise (src, offset, len);
+
+    buf = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY,
+        g_mapped_file_get_contents (src->mapped), src->mapped_size, offset,
+        len, g_mapped_file_ref (src->mapped),
+        (GDestroyNotify) g_mapped_file_unref);
+
+    GST_BUFFER_OFFSET (buf) = offset;
+    GST_BUFFER_OFFSET_END (buf) = offset + len;
+
+    *buf_return = buf;
+
+    return GST_FLOW_OK;
+  }
+
+  if (src->ra_thread) {
+    if (gst_gio_base_src_read_ahead_get (src, offset, size, buf_return))
+      return GST_FLOW_OK;
+
+    buf = NULL;
+    ret = gst_gio_base_src_read (src, offset, size, &buf);
+    gst_gio_base_src_read_ahead_release (src,
+        buf ? GST_BUFFER_OFFSET_END (buf) : offset);
+
+    *buf_return = buf;
+
+    return ret;
+  }
+
+  return gst_gio_base_src_read (src, offset, size, buf_return);
+}
+
 static gboolean
 gst_gio_base_src_query (GstBaseSrc * base_src, GstQuery * query)
 {
@@ -445,6 +978,24 @@ gst_gio_base_src_query (GstBaseSrc * base_src, GstQuery * query)
         ret = TRUE;
       }
       break;
+    case GST_QUERY_CUSTOM:{
+      GstStructure *s = gst_query_writable_structure (query);
+
+      if (gst_structure_has_name (s, READ_AHEAD_STATS_NAME)) {
+        guint64 total;
+
+        g_mutex_lock (&src->ra_lock);
+        total = src->ra_hits + src->ra_misses;
+        gst_structure_set (s, "hits", G_TYPE_UINT64, src->ra_hits,
+            "misses", G_TYPE_UINT64, src->ra_misses,
+            "prefetched-bytes", G_TYPE_UINT64, src->ra_prefetched,
+            "hit-rate", G_TYPE_DOUBLE,
+            total ? (gdouble) src->ra_hits / total : 0.0, NULL);
+        g_mutex_unlock (&src->ra_lock);
+        ret = TRUE;
+      }
+      break;
+    }
     default:
       ret = FALSE;
       break;
@@ -51,10 +51,39 @@ struct _GstGioBaseSrc
   /* < protected > */
   GCancellable *cancel;
   guint64 position;
+  gboolean use_mmap;
 
   /* < private > */
   GInputStream *stream;
   GstBuffer *cache;
+
+  /* read-only mapping of a local file, see use_mmap */
+  GMappedFile *mapped;
+  guint64 mapped_size;
+  guint64 mapped_next;
+  guint mapped_sequential;
+  gint mapped_advice;
+
+  /* background read-ahead, see the read-ahead property */
+  guint read_ahead;
+  GThread *ra_thread;
+  GMutex ra_lock;
+  GCond ra_cond;
+  GCancellable *ra_cancel;
+  gboolean ra_running;          /* thread should keep going */
+  gboolean ra_busy;             /* stream is in use, by the thread or create */
+  guint ra_generation;          /* bumped whenever the prefetched data is dropped */
+  GQueue ra_buffers;            /* prefetched buffers, contiguous and ascending */
+  guint64 ra_start;             /* range covered by ra_buffers */
+  guint64 ra_end;
+  guint64 ra_next;              /* offset following the last create */
+  guint ra_sequential;
+  gboolean ra_eos;
+  gboolean ra_error;            /* the last read-ahead failed */
+  gboolean ra_flushing;         /* between unlock and unlock_stop */
+  guint64 ra_hits;
+  guint64 ra_misses;
+  guint64 ra_prefetched;
 };
 
 struct _GstGioBaseSrcClass 
@@ -62,6 +91,7 @@ struct _GstGioBaseSrcClass
   GstBaseSrcClass parent_class;
 
   GInputStream * (*get_stream) (GstGioBaseSrc *bsrc);
+  gchar * (*get_local_path) (GstGioBaseSrc *bsrc);
   gboolean close_on_stop;
 };
 
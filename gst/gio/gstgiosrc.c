@@ -58,6 +58,11 @@
  * ]|
  *  The above pipeline will read and decode and play an mp3 file from a
  * SAMBA server.
+ * |[
+ * gst-launch-1.0 -v giosrc location=file:///home/joe/foo.ogg use-mmap=true ! decodebin ! autoaudiosink
+ * ]|
+ *  The above pipeline maps the local file into memory and hands out buffers
+ * pointing into the mapping instead of copying the data.
  *
  */
 
@@ -83,9 +88,12 @@ enum
 {
   PROP_0,
   PROP_LOCATION,
-  PROP_FILE
+  PROP_FILE,
+  PROP_USE_MMAP
 };
 
+#define DEFAULT_USE_MMAP FALSE
+
 #define gst_gio_src_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstGioSrc, gst_gio_src,
     GST_TYPE_GIO_BASE_SRC, gst_gio_uri_handler_do_init (g_define_type_id));
@@ -98,6 +106,7 @@ static void gst_gio_src_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
 
 static GInputStream *gst_gio_src_get_stream (GstGioBaseSrc * bsrc);
+static gchar *gst_gio_src_get_local_path (GstGioBaseSrc * bsrc);
 
 static gboolean gst_gio_src_query (GstBaseSrc * base_src, GstQuery * query);
 
@@ -128,6 +137,19 @@ gst_gio_src_class_init (GstGioSrcClass * klass)
       g_param_spec_object ("file", "File", "GFile to read from",
           G_TYPE_FILE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstGioSrc:use-mmap:
+   *
+   * Map local files into memory and output buffers that point into the
+   * mapping instead of reading into newly allocated memory. The buffers are
+   * read-only. Has no effect for non-local locations.
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Map local files into memory instead of reading them",
+          DEFAULT_USE_MMAP, G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class, "GIO source",
       "Source/File",
       "Read from any GIO-supported location",
@@ -137,12 +159,15 @@ gst_gio_src_class_init (GstGioSrcClass * klass)
   gstbasesrc_class->query = GST_DEBUG_FUNCPTR (gst_gio_src_query);
 
   gstgiobasesrc_class->get_stream = GST_DEBUG_FUNCPTR (gst_gio_src_get_stream);
+  gstgiobasesrc_class->get_local_path =
+      GST_DEBUG_FUNCPTR (gst_gio_src_get_local_path);
   gstgiobasesrc_class->close_on_stop = TRUE;
 }
 
 static void
 gst_gio_src_init (GstGioSrc * src)
 {
+  GST_GIO_BASE_SRC (src)->use_mmap = DEFAULT_USE_MMAP;
 }
 
 static void
@@ -209,6 +234,9 @@ gst_gio_src_set_property (GObject * object, guint prop_id,
 
       GST_OBJECT_UNLOCK (GST_OBJECT (src));
       break;
+    case PROP_USE_MMAP:
+      GST_GIO_BASE_SRC (src)->use_mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -241,6 +269,9 @@ gst_gio_src_get_property (GObject * object, guint prop_id,
       g_value_set_object (value, src->file);
       GST_OBJECT_UNLOCK (GST_OBJECT (src));
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, GST_GIO_BASE_SRC (src)->use_mmap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -348,3 +379,17 @@ gst_gio_src_get_stream (GstGioBaseSrc * bsrc)
 
   return stream;
 }
+
+static gchar *
+gst_gio_src_get_local_path (GstGioBaseSrc * bsrc)
+{
+  GstGioSrc *src = GST_GIO_SRC (bsrc);
+  gchar *path = NULL;
+
+  GST_OBJECT_LOCK (src);
+  if (src->file && g_file_is_native (src->file))
+    path = g_file_get_path (src->file);
+  GST_OBJECT_UNLOCK (src);
+
+  return path;
+}
@@ -47,6 +47,7 @@ static const gchar *collection_has_stream (GstStreamCollection * collection,
     gchar * sid);
 static gboolean ongoing_change_upstream (GstDecodebin3 * dbin,
     MultiQueueSlot * slot);
+static void release_idle_decoders (GstDecodebin3 * dbin, GstStreamType type);
 
 /* Virtual Functions */
 static void priv_decodebin3_init (GstDecodebin3 * dbin);
@@ -185,6 +186,8 @@ priv_decodebin3_init (GstDecodebin3 * dbin)
   dbin->use_fallback_preroll = FALSE;
   dbin->adaptive_mode = FALSE;
   dbin->dvr_playback = FALSE;
+  dbin->idle_decoders = NULL;
+  dbin->select_time = GST_CLOCK_TIME_NONE;
   GST_DEBUG_OBJECT (dbin, "Done");
 }
 
@@ -205,6 +208,8 @@ priv_decodebin3_dispose (GstDecodebin3 * dbin)
 
   dbin->use_fallback_preroll = FALSE;
 
+  release_idle_decoders (dbin, 0);
+
   GST_DEBUG_OBJECT (dbin, "Done");
 }
 
@@ -436,6 +441,170 @@ change_actual_decoder (GstDecodebin3 * dbin, DecodebinOutputStream * output)
   gst_element_send_event (output->decoder, event);
 }
 
+/* Maximum number of decoders kept warm after a stream switch. Hardware
+ * decoders are scarce, so only keep a couple around */
+#define MAX_IDLE_DECODERS 2
+
+typedef struct _IdleDecoder
+{
+  GstElement *decoder;
+  GstStreamType type;
+} IdleDecoder;
+
+static void
+free_idle_decoder (GstDecodebin3 * dbin, IdleDecoder * idle)
+{
+  GST_DEBUG_OBJECT (dbin, "Removing idle decoder %" GST_PTR_FORMAT,
+      idle->decoder);
+  gst_element_set_state (idle->decoder, GST_STATE_NULL);
+  if (GST_OBJECT_PARENT (idle->decoder) == GST_OBJECT_CAST (dbin))
+    gst_bin_remove ((GstBin *) dbin, idle->decoder);
+  gst_object_unref (idle->decoder);
+  g_free (idle);
+}
+
+/* Remove the idle decoders of @type, or all of them if @type is 0 */
+static void
+release_idle_decoders (GstDecodebin3 * dbin, GstStreamType type)
+{
+  GList *tmp, *next;
+
+  for (tmp = dbin->idle_decoders; tmp; tmp = next) {
+    IdleDecoder *idle = (IdleDecoder *) tmp->data;
+
+    next = tmp->next;
+    if (type != 0 && !(idle->type & type))
+      continue;
+
+    dbin->idle_decoders = g_list_delete_link (dbin->idle_decoders, tmp);
+    free_idle_decoder (dbin, idle);
+  }
+}
+
+/* Keep the unlinked decoder of @output in the bin instead of destroying it,
+ * so that switching back to a stream with compatible caps does not need to
+ * instantiate and open a new one. Going to READY flushes and stops the
+ * decoder but keeps the device opened. */
+static gboolean
+park_idle_decoder (GstDecodebin3 * dbin, DecodebinOutputStream * output)
+{
+  IdleDecoder *idle;
+  GList *last;
+
+  /* decproxy is driven by resource_info, never reuse it blindly */
+  if (g_str_has_prefix (GST_ELEMENT_NAME (output->decoder), "decproxy"))
+    return FALSE;
+
+  gst_element_set_locked_state (output->decoder, TRUE);
+  if (gst_element_set_state (output->decoder,
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+    gst_element_set_locked_state (output->decoder, FALSE);
+    return FALSE;
+  }
+
+  idle = g_new0 (IdleDecoder, 1);
+  idle->decoder = gst_object_ref (output->decoder);
+  idle->type = output->type;
+  dbin->idle_decoders = g_list_prepend (dbin->idle_decoders, idle);
+  GST_DEBUG_OBJECT (dbin, "Keeping idle decoder %" GST_PTR_FORMAT,
+      output->decoder);
+
+  if (g_list_length (dbin->idle_decoders) > MAX_IDLE_DECODERS) {
+    last = g_list_last (dbin->idle_decoders);
+    idle = (IdleDecoder *) last->data;
+    dbin->idle_decoders = g_list_delete_link (dbin->idle_decoders, last);
+    free_idle_decoder (dbin, idle);
+  }
+
+  return TRUE;
+}
+
+/* Returns an idle decoder of @type accepting @caps, still in the bin and in
+ * locked state. Idle decoders of the same type which can't handle @caps are
+ * released so that the new decoder can get the hardware resources. */
+static GstElement *
+take_idle_decoder (GstDecodebin3 * dbin, GstStreamType type, GstCaps * caps)
+{
+  GList *tmp;
+
+  for (tmp = dbin->idle_decoders; tmp; tmp = tmp->next) {
+    IdleDecoder *idle = (IdleDecoder *) tmp->data;
+    GstElement *decoder;
+    GstPad *sinkpad;
+    gboolean accepted;
+
+    if (!(idle->type & type))
+      continue;
+
+    sinkpad = gst_element_get_static_pad (idle->decoder, "sink");
+    accepted = sinkpad && gst_pad_query_accept_caps (sinkpad, caps);
+    if (sinkpad)
+      gst_object_unref (sinkpad);
+    if (!accepted)
+      continue;
+
+    GST_DEBUG_OBJECT (dbin, "Reusing idle decoder %" GST_PTR_FORMAT
+        " for caps %" GST_PTR_FORMAT, idle->decoder, caps);
+    dbin->idle_decoders = g_list_delete_link (dbin->idle_decoders, tmp);
+    /* the bin still holds a reference */
+    decoder = idle->decoder;
+    gst_object_unref (decoder);
+    g_free (idle);
+    return decoder;
+  }
+
+  release_idle_decoders (dbin, type);
+  return NULL;
+}
+
+static GstPadProbeReturn
+zapping_latency_probe (GstPad * pad, GstPadProbeInfo * info,
+    DecodebinOutputStream * output)
+{
+  GstDecodebin3 *dbin = output->dbin;
+  GstClockTime latency;
+  GstStructure *s;
+  gchar *stream_id;
+
+  latency = gst_util_get_timestamp () - output->select_time;
+  stream_id = gst_pad_get_stream_id (pad);
+
+  GST_INFO_OBJECT (dbin, "First buffer of stream %s %" GST_TIME_FORMAT
+      " after stream selection", GST_STR_NULL (stream_id),
+      GST_TIME_ARGS (latency));
+
+  s = gst_structure_new ("decodebin3-zapping-latency",
+      "stream-id", G_TYPE_STRING, stream_id,
+      "latency", GST_TYPE_CLOCK_TIME, latency,
+      "decoder-reused", G_TYPE_BOOLEAN, output->decoder_reused, NULL);
+  g_free (stream_id);
+
+  gst_element_post_message ((GstElement *) dbin,
+      gst_message_new_element ((GstObject *) dbin, s));
+
+  output->latency_probe_id = 0;
+  return GST_PAD_PROBE_REMOVE;
+}
+
+/* Post the time between the stream selection and the first decoded buffer
+ * of @output on the bus, to keep track of the zapping latency */
+static void
+add_zapping_latency_probe (GstDecodebin3 * dbin,
+    DecodebinOutputStream * output)
+{
+  if (!GST_CLOCK_TIME_IS_VALID (dbin->select_time) || !output->decoder_src)
+    return;
+
+  if (output->latency_probe_id)
+    gst_pad_remove_probe (output->decoder_src, output->latency_probe_id);
+
+  output->select_time = dbin->select_time;
+  output->latency_probe_id =
+      gst_pad_add_probe (output->decoder_src, GST_PAD_PROBE_TYPE_BUFFER |
+      GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) zapping_latency_probe, output, NULL);
+}
+
 static void
 priv_reconfigure_output_stream (DecodebinOutputStream * output,
     MultiQueueSlot * slot, gboolean reassign)
@@ -531,6 +700,8 @@ priv_reconfigure_output_stream (DecodebinOutputStream * output,
         gst_pad_link_full (slot->src_pad, output->decoder_sink,
             GST_PAD_LINK_CHECK_NOTHING);
         output->linked = TRUE;
+        output->decoder_reused = TRUE;
+        add_zapping_latency_probe (dbin, output);
 
         if (output->decoder && needs_actual_decoder && dbin->request_resource) {
           gchar *decname = NULL;
@@ -574,15 +745,21 @@ priv_reconfigure_output_stream (DecodebinOutputStream * output,
       goto cleanup;
     }
 
-    gst_element_set_locked_state (output->decoder, TRUE);
-    gst_element_set_state (output->decoder, GST_STATE_NULL);
+    if (!park_idle_decoder (dbin, output)) {
+      gst_element_set_locked_state (output->decoder, TRUE);
+      gst_element_set_state (output->decoder, GST_STATE_NULL);
 
-    gst_bin_remove ((GstBin *) dbin, output->decoder);
+      gst_bin_remove ((GstBin *) dbin, output->decoder);
+    }
     output->decoder = NULL;
   }
 
   gst_caps_unref (new_caps);
 
+  if (output->latency_probe_id) {
+    gst_pad_remove_probe (output->decoder_src, output->latency_probe_id);
+    output->latency_probe_id = 0;
+  }
   gst_object_replace ((GstObject **) & output->decoder_sink, NULL);
   gst_object_replace ((GstObject **) & output->decoder_src, NULL);
 
@@ -590,8 +767,12 @@ priv_reconfigure_output_stream (DecodebinOutputStream * output,
   if (needs_decoder) {
     gchar *decname = NULL;
 
-    /* If we don't have a decoder yet, instantiate one */
-    output->decoder = create_decoder (dbin, slot->active_stream);
+    /* Try a decoder kept from a previous stream first, if we don't
+     * have one instantiate a new one */
+    output->decoder = take_idle_decoder (dbin, output->type, new_caps);
+    output->decoder_reused = output->decoder != NULL;
+    if (output->decoder == NULL)
+      output->decoder = create_decoder (dbin, slot->active_stream);
     if (output->decoder == NULL) {
       GstCaps *caps;
 
@@ -618,14 +799,19 @@ priv_reconfigure_output_stream (DecodebinOutputStream * output,
     }
     g_free (decname);
 
-    GST_DEBUG_OBJECT (dbin, "Adding Decoder(%s)",
-        GST_OBJECT_NAME (output->decoder));
-    if (!gst_bin_add ((GstBin *) dbin, output->decoder)) {
-      GST_ERROR_OBJECT (dbin, "could not add decoder to pipeline");
-      goto cleanup;
+    if (output->decoder_reused) {
+      /* Already in the bin, only needs to be started again */
+      gst_element_set_locked_state (output->decoder, FALSE);
+    } else {
+      GST_DEBUG_OBJECT (dbin, "Adding Decoder(%s)",
+          GST_OBJECT_NAME (output->decoder));
+      if (!gst_bin_add ((GstBin *) dbin, output->decoder)) {
+        GST_ERROR_OBJECT (dbin, "could not add decoder to pipeline");
+        goto cleanup;
+      }
+      GST_DEBUG_OBJECT (dbin, "Added Decoder(%s)",
+          GST_OBJECT_NAME (output->decoder));
     }
-    GST_DEBUG_OBJECT (dbin, "Added Decoder(%s)",
-        GST_OBJECT_NAME (output->decoder));
 
     gst_element_sync_state_with_parent (output->decoder);
     output->decoder_sink = gst_element_get_static_pad (output->decoder, "sink");
@@ -666,8 +852,10 @@ priv_reconfigure_output_stream (DecodebinOutputStream * output,
   } else {
     output->decoder_src = gst_object_ref (slot->src_pad);
     output->decoder_sink = NULL;
+    output->decoder_reused = FALSE;
   }
   output->linked = TRUE;
+  add_zapping_latency_probe (dbin, output);
 
   GST_DEBUG_OBJECT (dbin, "Exposing decoder srcpad (%s:%s)",
       GST_DEBUG_PAD_NAME (output->decoder_src));
@@ -708,6 +896,10 @@ priv_reconfigure_output_stream (DecodebinOutputStream * output,
 cleanup:
   {
     GST_DEBUG_OBJECT (dbin, "Cleanup");
+    if (output->latency_probe_id) {
+      gst_pad_remove_probe (output->decoder_src, output->latency_probe_id);
+      output->latency_probe_id = 0;
+    }
     if (output->decoder_sink) {
       gst_object_unref (output->decoder_sink);
       output->decoder_sink = NULL;
@@ -982,6 +1174,9 @@ priv_update_requested_selection (GstDecodebin3 * dbin,
   GList *tmp = NULL;
   GstStreamType used_types = 0;
 
+  /* A new collection is where a channel change starts */
+  dbin->select_time = gst_util_get_timestamp ();
+
   nb = gst_stream_collection_get_size (collection);
 
   /* 1. Is there a pending SELECT_STREAMS we can return straight away since
@@ -1353,6 +1548,8 @@ priv_is_selection_done (GstDecodebin3 * dbin)
       GST_WARNING_OBJECT (dbin, "No valid slot for output %p", output);
   }
   dbin->selection_updated = FALSE;
+  /* Outputs reconfigured from now on aren't part of this selection */
+  dbin->select_time = GST_CLOCK_TIME_NONE;
   return msg;
 }
 
@@ -2183,6 +2380,8 @@ priv_handle_stream_switch (GstDecodebin3 * dbin, GList * select_streams,
   g_list_free (dbin->pending_select_streams);
   dbin->pending_select_streams = NULL;
 
+  dbin->select_time = gst_util_get_timestamp ();
+
   /* COMPARE the requested streams to the active and requested streams
    * on multiqueue. */
 
@@ -2518,6 +2717,8 @@ priv_release_resource_related (GstDecodebin3 * dbin)
     g_list_free_full (dbin->exposed_pads, gst_object_unref);
     dbin->exposed_pads = NULL;
   }
+  release_idle_decoders (dbin, 0);
+  dbin->select_time = GST_CLOCK_TIME_NONE;
   GST_DEBUG_OBJECT (dbin, "Done");
 }
 
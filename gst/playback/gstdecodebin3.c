@@ -294,6 +294,33 @@ struct _GstDecodebin3
   gboolean dvr_playback;
 
   GMutex reassign_lock;
+
+  /* Decoders kept warm after a stream switch (protected by selection_lock) */
+  GList *idle_decoders;
+  /* When the current stream selection was requested, for zapping latency */
+  GstClockTime select_time;
+
+  /* Adaptive multiqueue sizing, accessed atomically so that the rate probes
+   * bail out without locking when it is disabled */
+  gint adaptive_buffering;
+  /* protected by the object lock */
+  guint max_buffer_bytes;
+  guint64 min_buffer_time, max_buffer_time;
+  /* current target of buffered time per slot */
+  GstClockTime buffer_time;
+  /* limits currently set on multiqueue */
+  guint mq_max_bytes;
+  guint64 mq_min_interleave;
+  /* Serializes the changes of the multiqueue limits, and the limits
+   * multiqueue had before adaptive buffering first changed them */
+  GMutex mq_limits_lock;
+  gboolean mq_limits_saved;
+  guint saved_max_bytes;
+  guint64 saved_min_interleave;
+  guint underruns;
+  GstClockTime last_update, last_underrun;
+  /* MultiQueueSlot being measured */
+  GList *rate_slots;
 };
 
 struct _GstDecodebin3Class
@@ -412,6 +439,17 @@ typedef struct _MultiQueueSlot
   gboolean mark_async_pool;
 
   gboolean plugging_decoder;
+
+  /* Adaptive buffering, protected by the object lock */
+  gulong in_probe_id, out_probe_id;
+  /* current measurement windows */
+  guint64 in_bytes;
+  GstClockTime in_first_ts, in_last_ts;
+  guint64 out_bytes;
+  GstClockTime out_start;
+  /* averaged rates in bytes per second */
+  guint64 bitrate;
+  guint64 consumption;
 } MultiQueueSlot;
 
 /* Streams that are exposed downstream (i.e. output) */
@@ -436,6 +474,11 @@ struct _DecodebinOutputStream
   /* keyframe dropping probe */
   gulong drop_probe_id;
 
+  /* first decoded buffer probe, for zapping latency */
+  gulong latency_probe_id;
+  GstClockTime select_time;
+  gboolean decoder_reused;
+
   /* For resource related */
   gboolean puppet_done;
 
@@ -460,10 +503,20 @@ typedef struct _PendingPad
 } PendingPad;
 
 /* properties */
+#define DEFAULT_ADAPTIVE_BUFFERING FALSE
+#define DEFAULT_MAX_BUFFER_BYTES (32 * 1024 * 1024)
+#define DEFAULT_MIN_BUFFER_TIME GST_SECOND
+#define DEFAULT_MAX_BUFFER_TIME (5 * GST_SECOND)
+
 enum
 {
   PROP_0,
-  PROP_CAPS
+  PROP_CAPS,
+  PROP_ADAPTIVE_BUFFERING,
+  PROP_MAX_BUFFER_BYTES,
+  PROP_MIN_BUFFER_TIME,
+  PROP_MAX_BUFFER_TIME,
+  PROP_STATS
 };
 
 /* signals */
@@ -633,6 +686,10 @@ static MultiQueueSlot *get_slot_for_input (GstDecodebin3 * dbin,
 static void link_input_to_slot (DecodebinInput * parent_input,
     DecodebinInputStream * input, MultiQueueSlot * slot);
 static void free_multiqueue_slot (GstDecodebin3 * dbin, MultiQueueSlot * slot);
+static void multiqueue_underrun_cb (GstElement * multiqueue,
+    GstDecodebin3 * dbin);
+static void restore_multiqueue_limits (GstDecodebin3 * dbin);
+static GstStructure *gst_decodebin3_get_stats (GstDecodebin3 * dbin);
 static void free_multiqueue_slot_async (GstDecodebin3 * dbin,
     MultiQueueSlot * slot);
 
@@ -715,6 +772,74 @@ gst_decodebin3_class_init (GstDecodebin3Class * klass)
           "The caps on which to stop decoding. (NULL = default)",
           GST_TYPE_CAPS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDecodebin3:adaptive-buffering:
+   *
+   * Adapt the multiqueue size limits to the measured bitrate of the streams
+   * and to how fast they are consumed downstream, instead of using fixed
+   * limits. The amount of buffered time grows when the multiqueue runs
+   * empty and slowly shrinks back to #GstDecodebin3:min-buffer-time when it
+   * doesn't.
+   *
+   * The rates are only measured on the streams created while it is enabled.
+   */
+  g_object_class_install_property (gobject_klass, PROP_ADAPTIVE_BUFFERING,
+      g_param_spec_boolean ("adaptive-buffering", "Adaptive buffering",
+          "Adapt the multiqueue limits to the bitrate of the streams",
+          DEFAULT_ADAPTIVE_BUFFERING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDecodebin3:max-buffer-bytes:
+   *
+   * Memory budget for all the streams in the multiqueue when
+   * #GstDecodebin3:adaptive-buffering is enabled.
+   */
+  g_object_class_install_property (gobject_klass, PROP_MAX_BUFFER_BYTES,
+      g_param_spec_uint ("max-buffer-bytes", "Max buffer bytes",
+          "Maximum amount of data buffered for all streams with adaptive "
+          "buffering", 0, G_MAXUINT, DEFAULT_MAX_BUFFER_BYTES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDecodebin3:min-buffer-time:
+   *
+   * The amount of time buffered per stream with
+   * #GstDecodebin3:adaptive-buffering when the streams are consumed without
+   * underruns. Setting it above #GstDecodebin3:max-buffer-time raises the
+   * maximum to the same value.
+   */
+  g_object_class_install_property (gobject_klass, PROP_MIN_BUFFER_TIME,
+      g_param_spec_uint64 ("min-buffer-time", "Min buffer time",
+          "Minimum amount of time buffered per stream with adaptive buffering "
+          "(in ns)", 0, G_MAXUINT64, DEFAULT_MIN_BUFFER_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDecodebin3:max-buffer-time:
+   *
+   * The limit up to which #GstDecodebin3:adaptive-buffering grows the amount
+   * of time buffered per stream after underruns. Setting it below
+   * #GstDecodebin3:min-buffer-time lowers the minimum to the same value.
+   */
+  g_object_class_install_property (gobject_klass, PROP_MAX_BUFFER_TIME,
+      g_param_spec_uint64 ("max-buffer-time", "Max buffer time",
+          "Maximum amount of time buffered per stream with adaptive buffering "
+          "(in ns)", 0, G_MAXUINT64, DEFAULT_MAX_BUFFER_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDecodebin3:stats:
+   *
+   * Adaptive buffering statistics: the measured rates of every multiqueue
+   * slot, the current target buffering time, the limits set on the
+   * multiqueue and the number of underruns.
+   */
+  g_object_class_install_property (gobject_klass, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Adaptive buffering statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /* FIXME : ADD SIGNALS ! */
   /**
    * GstDecodebin3::select-stream
@@ -823,14 +948,24 @@ gst_decodebin3_init (GstDecodebin3 * dbin)
   dbin->multiqueue = gst_element_factory_make ("multiqueue", NULL);
   g_object_set (dbin->multiqueue, "sync-by-running-time", TRUE,
       "max-size-buffers", 0, "use-interleave", TRUE, NULL);
+  g_signal_connect (dbin->multiqueue, "underrun",
+      G_CALLBACK (multiqueue_underrun_cb), dbin);
   gst_bin_add ((GstBin *) dbin, dbin->multiqueue);
 
+  dbin->adaptive_buffering = DEFAULT_ADAPTIVE_BUFFERING;
+  dbin->max_buffer_bytes = DEFAULT_MAX_BUFFER_BYTES;
+  dbin->min_buffer_time = DEFAULT_MIN_BUFFER_TIME;
+  dbin->max_buffer_time = DEFAULT_MAX_BUFFER_TIME;
+  dbin->buffer_time = DEFAULT_MIN_BUFFER_TIME;
+  dbin->last_update = dbin->last_underrun = GST_CLOCK_TIME_NONE;
+
   dbin->current_group_id = GST_GROUP_ID_INVALID;
 
   g_mutex_init (&dbin->factories_lock);
   g_mutex_init (&dbin->selection_lock);
   g_mutex_init (&dbin->input_lock);
   g_mutex_init (&dbin->reassign_lock);
+  g_mutex_init (&dbin->mq_limits_lock);
 
   dbin->caps = gst_static_caps_get (&default_raw_caps);
 
@@ -858,6 +993,8 @@ gst_decodebin3_dispose (GObject * object)
   g_list_free (dbin->to_activate);
   g_list_free (dbin->pending_select_streams);
   g_clear_object (&dbin->collection);
+  g_list_free (dbin->rate_slots);
+  dbin->rate_slots = NULL;
 
   free_input (dbin, dbin->main_input);
 
@@ -881,6 +1018,7 @@ gst_decodebin3_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
   GstDecodebin3 *dbin = (GstDecodebin3 *) object;
+  const gchar *notify = NULL;
 
   /* FIXME : IMPLEMENT */
   switch (prop_id) {
@@ -891,10 +1029,46 @@ gst_decodebin3_set_property (GObject * object, guint prop_id,
       dbin->caps = g_value_dup_boxed (value);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_ADAPTIVE_BUFFERING:
+      g_atomic_int_set (&dbin->adaptive_buffering,
+          g_value_get_boolean (value));
+      if (!g_value_get_boolean (value))
+        restore_multiqueue_limits (dbin);
+      break;
+    case PROP_MAX_BUFFER_BYTES:
+      GST_OBJECT_LOCK (dbin);
+      dbin->max_buffer_bytes = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
+    case PROP_MIN_BUFFER_TIME:
+      GST_OBJECT_LOCK (dbin);
+      dbin->min_buffer_time = g_value_get_uint64 (value);
+      if (dbin->max_buffer_time < dbin->min_buffer_time) {
+        dbin->max_buffer_time = dbin->min_buffer_time;
+        notify = "max-buffer-time";
+      }
+      dbin->buffer_time = CLAMP (dbin->buffer_time, dbin->min_buffer_time,
+          dbin->max_buffer_time);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
+    case PROP_MAX_BUFFER_TIME:
+      GST_OBJECT_LOCK (dbin);
+      dbin->max_buffer_time = g_value_get_uint64 (value);
+      if (dbin->min_buffer_time > dbin->max_buffer_time) {
+        dbin->min_buffer_time = dbin->max_buffer_time;
+        notify = "min-buffer-time";
+      }
+      dbin->buffer_time = CLAMP (dbin->buffer_time, dbin->min_buffer_time,
+          dbin->max_buffer_time);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
+
+  if (notify)
+    g_object_notify (object, notify);
 }
 
 static void
@@ -910,6 +1084,27 @@ gst_decodebin3_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_boxed (value, dbin->caps);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_ADAPTIVE_BUFFERING:
+      g_value_set_boolean (value, g_atomic_int_get (&dbin->adaptive_buffering));
+      break;
+    case PROP_MAX_BUFFER_BYTES:
+      GST_OBJECT_LOCK (dbin);
+      g_value_set_uint (value, dbin->max_buffer_bytes);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
+    case PROP_MIN_BUFFER_TIME:
+      GST_OBJECT_LOCK (dbin);
+      g_value_set_uint64 (value, dbin->min_buffer_time);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
+    case PROP_MAX_BUFFER_TIME:
+      GST_OBJECT_LOCK (dbin);
+      g_value_set_uint64 (value, dbin->max_buffer_time);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_decodebin3_get_stats (dbin));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2290,6 +2485,347 @@ multiqueue_src_probe (GstPad * pad, GstPadProbeInfo * info,
   return ret;
 }
 
+/* Adaptive multiqueue sizing
+ *
+ * The content bitrate of every slot is measured from the buffers entering
+ * multiqueue (bytes over the timestamp span) and the consumption rate from
+ * the buffers leaving it (bytes over wall clock time). Once per
+ * UPDATE_INTERVAL, the byte limit of the multiqueue (which applies to every
+ * slot) is set to what the most demanding slot needs to hold buffer_time of
+ * data, within max_buffer_bytes shared by all slots.
+ *
+ * multiqueue handles the time limit itself with use-interleave, so the time
+ * target is applied as its min-interleave-time. The target grows by half
+ * every time multiqueue runs empty and shrinks by a tenth every
+ * UPDATE_INTERVAL once there was no underrun for SHRINK_INTERVAL. */
+#define RATE_WINDOW GST_SECOND
+#define UPDATE_INTERVAL GST_SECOND
+#define SHRINK_INTERVAL (10 * GST_SECOND)
+#define MIN_SLOT_BYTES (256 * 1024)
+
+/* Must be called with the object lock. Returns TRUE if the multiqueue
+ * limits need to be changed to @bytes and @interleave */
+static gboolean
+compute_multiqueue_limits (GstDecodebin3 * dbin, GstClockTime now,
+    guint * bytes, guint64 * interleave)
+{
+  GList *tmp;
+  guint64 needed = 0, budget;
+  guint n_slots = 0;
+
+  dbin->last_update = now;
+
+  if (dbin->buffer_time > dbin->min_buffer_time &&
+      (!GST_CLOCK_TIME_IS_VALID (dbin->last_underrun) ||
+          now - dbin->last_underrun >= SHRINK_INTERVAL))
+    dbin->buffer_time = MAX (dbin->min_buffer_time,
+        dbin->buffer_time - dbin->buffer_time / 10);
+
+  for (tmp = dbin->rate_slots; tmp; tmp = tmp->next) {
+    MultiQueueSlot *slot = (MultiQueueSlot *) tmp->data;
+    guint64 rate = MAX (slot->bitrate, slot->consumption);
+
+    needed = MAX (needed,
+        gst_util_uint64_scale (rate, dbin->buffer_time, GST_SECOND));
+    n_slots++;
+  }
+  if (n_slots == 0)
+    return FALSE;
+
+  /* Leave room for bursts above the average rate */
+  needed += needed / 2;
+
+  budget = dbin->max_buffer_bytes / n_slots;
+  if (dbin->max_buffer_bytes == 0)
+    *bytes = 0;
+  else if (needed == 0)
+    /* Nothing measured yet */
+    *bytes = budget;
+  else
+    *bytes = MIN (MAX (needed, MIN_SLOT_BYTES), budget);
+  *interleave = dbin->buffer_time;
+
+  /* Don't bother multiqueue for small variations */
+  if (*interleave == dbin->mq_min_interleave &&
+      ABS ((gint64) * bytes - (gint64) dbin->mq_max_bytes) <
+      dbin->mq_max_bytes / 10)
+    return FALSE;
+
+  GST_DEBUG_OBJECT (dbin, "%u slots, buffer time %" GST_TIME_FORMAT
+      ", needed %" G_GUINT64_FORMAT " bytes per slot, setting %u bytes",
+      n_slots, GST_TIME_ARGS (dbin->buffer_time), needed, *bytes);
+
+  dbin->mq_max_bytes = *bytes;
+  dbin->mq_min_interleave = *interleave;
+
+  return TRUE;
+}
+
+static void
+set_multiqueue_limits (GstDecodebin3 * dbin, guint bytes, guint64 interleave)
+{
+  gboolean has_interleave =
+      g_object_class_find_property (G_OBJECT_GET_CLASS (dbin->multiqueue),
+      "min-interleave-time") != NULL;
+
+  g_mutex_lock (&dbin->mq_limits_lock);
+  /* adaptive buffering could have been disabled in the meantime */
+  if (!g_atomic_int_get (&dbin->adaptive_buffering))
+    goto done;
+
+  if (!dbin->mq_limits_saved) {
+    g_object_get (dbin->multiqueue, "max-size-bytes", &dbin->saved_max_bytes,
+        NULL);
+    if (has_interleave)
+      g_object_get (dbin->multiqueue, "min-interleave-time",
+          &dbin->saved_min_interleave, NULL);
+    dbin->mq_limits_saved = TRUE;
+  }
+
+  g_object_set (dbin->multiqueue, "max-size-bytes", bytes, NULL);
+  if (has_interleave)
+    g_object_set (dbin->multiqueue, "min-interleave-time", interleave, NULL);
+
+done:
+  g_mutex_unlock (&dbin->mq_limits_lock);
+}
+
+/* Puts back the limits multiqueue had before adaptive buffering changed
+ * them */
+static void
+restore_multiqueue_limits (GstDecodebin3 * dbin)
+{
+  g_mutex_lock (&dbin->mq_limits_lock);
+  if (dbin->mq_limits_saved) {
+    GST_DEBUG_OBJECT (dbin, "restoring multiqueue limits, %u bytes",
+        dbin->saved_max_bytes);
+    g_object_set (dbin->multiqueue, "max-size-bytes", dbin->saved_max_bytes,
+        NULL);
+    if (g_object_class_find_property (G_OBJECT_GET_CLASS (dbin->multiqueue),
+            "min-interleave-time"))
+      g_object_set (dbin->multiqueue, "min-interleave-time",
+          dbin->saved_min_interleave, NULL);
+    dbin->mq_limits_saved = FALSE;
+  }
+
+  /* the limits are set again when it is enabled again */
+  GST_OBJECT_LOCK (dbin);
+  dbin->mq_max_bytes = 0;
+  dbin->mq_min_interleave = 0;
+  GST_OBJECT_UNLOCK (dbin);
+  g_mutex_unlock (&dbin->mq_limits_lock);
+}
+
+static gsize
+probe_info_get_size (GstPadProbeInfo * info, GstClockTime * ts)
+{
+  GstBuffer *buf;
+
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+
+    if (gst_buffer_list_length (list) == 0)
+      return 0;
+    buf = gst_buffer_list_get (list, 0);
+    *ts = GST_BUFFER_DTS_OR_PTS (buf);
+    return gst_buffer_list_calculate_size (list);
+  }
+
+  buf = GST_PAD_PROBE_INFO_BUFFER (info);
+  *ts = GST_BUFFER_DTS_OR_PTS (buf);
+  return gst_buffer_get_size (buf);
+}
+
+static GstPadProbeReturn
+slot_input_rate_probe (GstPad * pad, GstPadProbeInfo * info,
+    MultiQueueSlot * slot)
+{
+  GstDecodebin3 *dbin = slot->dbin;
+  GstClockTime ts = GST_CLOCK_TIME_NONE, now;
+  guint bytes = 0;
+  guint64 interleave = 0;
+  gboolean update = FALSE;
+  gsize size;
+
+  if (!g_atomic_int_get (&dbin->adaptive_buffering))
+    return GST_PAD_PROBE_OK;
+
+  size = probe_info_get_size (info, &ts);
+
+  GST_OBJECT_LOCK (dbin);
+  slot->in_bytes += size;
+  if (GST_CLOCK_TIME_IS_VALID (ts)) {
+    if (!GST_CLOCK_TIME_IS_VALID (slot->in_first_ts)
+        || ts < slot->in_first_ts) {
+      /* First buffer or discont backwards, restart the window */
+      slot->in_first_ts = slot->in_last_ts = ts;
+      slot->in_bytes = size;
+    } else if (ts > slot->in_last_ts) {
+      slot->in_last_ts = ts;
+    }
+
+    if (slot->in_last_ts - slot->in_first_ts >= RATE_WINDOW) {
+      guint64 rate = gst_util_uint64_scale (slot->in_bytes, GST_SECOND,
+          slot->in_last_ts - slot->in_first_ts);
+
+      slot->bitrate = slot->bitrate ? (3 * slot->bitrate + rate) / 4 : rate;
+      slot->in_first_ts = slot->in_last_ts;
+      slot->in_bytes = 0;
+    }
+  }
+
+  now = gst_util_get_timestamp ();
+  if (!GST_CLOCK_TIME_IS_VALID (dbin->last_update)
+      || now - dbin->last_update >= UPDATE_INTERVAL)
+    update = compute_multiqueue_limits (dbin, now, &bytes, &interleave);
+  GST_OBJECT_UNLOCK (dbin);
+
+  if (update)
+    set_multiqueue_limits (dbin, bytes, interleave);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+slot_output_rate_probe (GstPad * pad, GstPadProbeInfo * info,
+    MultiQueueSlot * slot)
+{
+  GstDecodebin3 *dbin = slot->dbin;
+  GstClockTime ts, now;
+  gsize size;
+
+  if (!g_atomic_int_get (&dbin->adaptive_buffering))
+    return GST_PAD_PROBE_OK;
+
+  size = probe_info_get_size (info, &ts);
+
+  GST_OBJECT_LOCK (dbin);
+  now = gst_util_get_timestamp ();
+  slot->out_bytes += size;
+  if (!GST_CLOCK_TIME_IS_VALID (slot->out_start)) {
+    slot->out_start = now;
+  } else if (now - slot->out_start >= RATE_WINDOW) {
+    guint64 rate = gst_util_uint64_scale (slot->out_bytes, GST_SECOND,
+        now - slot->out_start);
+
+    slot->consumption =
+        slot->consumption ? (3 * slot->consumption + rate) / 4 : rate;
+    slot->out_start = now;
+    slot->out_bytes = 0;
+  }
+  GST_OBJECT_UNLOCK (dbin);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+multiqueue_underrun_cb (GstElement * multiqueue, GstDecodebin3 * dbin)
+{
+  GList *tmp;
+  guint bytes = 0;
+  guint64 interleave = 0;
+  gboolean measured = FALSE, update = FALSE;
+
+  if (!g_atomic_int_get (&dbin->adaptive_buffering))
+    return;
+
+  GST_OBJECT_LOCK (dbin);
+  for (tmp = dbin->rate_slots; tmp; tmp = tmp->next)
+    measured |= ((MultiQueueSlot *) tmp->data)->bitrate != 0;
+
+  /* Ignore the underruns while starting up or not playing */
+  if (measured && GST_STATE (dbin) == GST_STATE_PLAYING) {
+    dbin->underruns++;
+    dbin->last_underrun = gst_util_get_timestamp ();
+    dbin->buffer_time = MIN (dbin->max_buffer_time,
+        dbin->buffer_time + dbin->buffer_time / 2);
+    GST_DEBUG_OBJECT (dbin, "Underrun %u, buffer time now %" GST_TIME_FORMAT,
+        dbin->underruns, GST_TIME_ARGS (dbin->buffer_time));
+    update = compute_multiqueue_limits (dbin, dbin->last_underrun, &bytes,
+        &interleave);
+  }
+  GST_OBJECT_UNLOCK (dbin);
+
+  if (update)
+    set_multiqueue_limits (dbin, bytes, interleave);
+}
+
+/* The probes are only installed while adaptive buffering is enabled, the
+ * other streams don't pay for the measurements */
+static void
+add_slot_rate_probes (GstDecodebin3 * dbin, MultiQueueSlot * slot)
+{
+  if (!g_atomic_int_get (&dbin->adaptive_buffering))
+    return;
+
+  slot->in_first_ts = slot->in_last_ts = GST_CLOCK_TIME_NONE;
+  slot->out_start = GST_CLOCK_TIME_NONE;
+
+  slot->in_probe_id = gst_pad_add_probe (slot->sink_pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) slot_input_rate_probe, slot, NULL);
+  slot->out_probe_id = gst_pad_add_probe (slot->src_pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) slot_output_rate_probe, slot, NULL);
+
+  GST_OBJECT_LOCK (dbin);
+  dbin->rate_slots = g_list_append (dbin->rate_slots, slot);
+  GST_OBJECT_UNLOCK (dbin);
+}
+
+static void
+remove_slot_rate_probes (GstDecodebin3 * dbin, MultiQueueSlot * slot)
+{
+  if (!slot->in_probe_id)
+    return;
+
+  gst_pad_remove_probe (slot->sink_pad, slot->in_probe_id);
+  slot->in_probe_id = 0;
+  gst_pad_remove_probe (slot->src_pad, slot->out_probe_id);
+  slot->out_probe_id = 0;
+
+  GST_OBJECT_LOCK (dbin);
+  dbin->rate_slots = g_list_remove (dbin->rate_slots, slot);
+  GST_OBJECT_UNLOCK (dbin);
+}
+
+static GstStructure *
+gst_decodebin3_get_stats (GstDecodebin3 * dbin)
+{
+  GstStructure *s;
+  GValue slots = G_VALUE_INIT;
+  GList *tmp;
+
+  g_value_init (&slots, GST_TYPE_ARRAY);
+
+  GST_OBJECT_LOCK (dbin);
+  for (tmp = dbin->rate_slots; tmp; tmp = tmp->next) {
+    MultiQueueSlot *slot = (MultiQueueSlot *) tmp->data;
+    GValue v = G_VALUE_INIT;
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, gst_structure_new ("slot",
+            "id", G_TYPE_UINT, slot->id,
+            "stream-type", G_TYPE_STRING, gst_stream_type_get_name (slot->type),
+            "bitrate", G_TYPE_UINT64, slot->bitrate * 8,
+            "consumption-rate", G_TYPE_UINT64, slot->consumption * 8, NULL));
+    gst_value_array_append_and_take_value (&slots, &v);
+  }
+
+  s = gst_structure_new ("application/x-decodebin3-stats",
+      "adaptive-buffering", G_TYPE_BOOLEAN,
+      g_atomic_int_get (&dbin->adaptive_buffering),
+      "buffer-time", G_TYPE_UINT64, dbin->buffer_time,
+      "max-size-bytes", G_TYPE_UINT, dbin->mq_max_bytes,
+      "min-interleave-time", G_TYPE_UINT64, dbin->mq_min_interleave,
+      "underruns", G_TYPE_UINT, dbin->underruns, NULL);
+  GST_OBJECT_UNLOCK (dbin);
+
+  gst_structure_take_value (s, "slots", &slots);
+
+  return s;
+}
+
 /* Create a new multiqueue slot for the given type
  *
  * It is up to the caller to know whether that slot is needed or not
@@ -2336,6 +2872,8 @@ create_new_slot (GstDecodebin3 * dbin, GstStreamType type)
         GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM,
         (GstPadProbeCallback) multiqueue_src_probe, slot, NULL);
 
+  add_slot_rate_probes (dbin, slot);
+
   GST_DEBUG ("Created new slot %u (%p) (%s:%s)", slot->id, slot,
       GST_DEBUG_PAD_NAME (slot->src_pad));
 
@@ -3505,6 +4043,7 @@ free_multiqueue_slot (GstDecodebin3 * dbin, MultiQueueSlot * slot)
 
   if (slot->probe_id)
     gst_pad_remove_probe (slot->src_pad, slot->probe_id);
+  remove_slot_rate_probes (dbin, slot);
   if (slot->input) {
     if (slot->input->srcpad)
       gst_pad_unlink (slot->input->srcpad, slot->sink_pad);
@@ -3614,6 +4153,12 @@ free_output_stream (GstDecodebin3 * dbin, DecodebinOutputStream * output)
   }
   gst_object_replace ((GstObject **) & output->decoder_sink, NULL);
   gst_ghost_pad_set_target ((GstGhostPad *) output->src_pad, NULL);
+  /* the first buffer might never have come, the probe must not outlive
+   * the output */
+  if (output->latency_probe_id) {
+    gst_pad_remove_probe (output->decoder_src, output->latency_probe_id);
+    output->latency_probe_id = 0;
+  }
   gst_object_replace ((GstObject **) & output->decoder_src, NULL);
   if (output->src_exposed) {
     gst_element_remove_pad ((GstElement *) dbin, output->src_pad);
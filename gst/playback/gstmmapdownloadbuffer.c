@@ -0,0 +1,1135 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-mmapdownloadbuffer
+ * @title: mmapdownloadbuffer
+ *
+ * Download buffering into memory mapped storage, as an alternative to
+ * downloadbuffer. The storage is an unlinked file created from
+ * #GstMmapDownloadBuffer:temp-template (or a memfd, which lives in memory,
+ * when no template is set) as large as the stream, so the downloaded bytes
+ * are written once into the mapping at their offset and never read back
+ * with read(): the buffers given downstream point straight into the
+ * mapping.
+ *
+ * The downloaded byte ranges are tracked, so pulling data that was already
+ * downloaded returns immediately. Pulling data that wasn't makes the
+ * element seek upstream, unless the download is about to reach it anyway.
+ *
+ * The size of the stream must be known and must fit in the address space,
+ * the element queries the upstream duration in bytes when the first buffer
+ * arrives and fails otherwise. The space for the whole stream is reserved
+ * then, so that a full disk makes the element fail with an error instead
+ * of a crash when writing into the mapping.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 souphttpsrc location=http://example.com/video.mp4 ! mmapdownloadbuffer ! decodebin ! autovideosink
+ * ]|
+ *
+ * Since: 1.16
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstmmapdownloadbuffer.h"
+
+#include <errno.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_POSIX_FALLOCATE
+#include <fcntl.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (mmap_download_buffer_debug);
+#define GST_CAT_DEFAULT mmap_download_buffer_debug
+
+#define DEFAULT_MAX_SIZE_BYTES (2 * 1024 * 1024)
+#define DEFAULT_MAX_SIZE_TIME (2 * GST_SECOND)
+#define DEFAULT_TEMP_TEMPLATE NULL
+
+/* size of the buffers pushed in push mode */
+#define DEFAULT_BLOCKSIZE 32768
+/* pulling at most this far after the download position waits for the data
+ * instead of seeking upstream */
+#define SEEK_THRESHOLD (1024 * 1024)
+
+enum
+{
+  PROP_0,
+  PROP_MAX_SIZE_BYTES,
+  PROP_MAX_SIZE_TIME,
+  PROP_TEMP_TEMPLATE,
+  PROP_TEMP_LOCATION
+};
+
+#define GST_MMAP_DOWNLOAD_BUFFER_LOCK(obj) \
+  g_mutex_lock (&GST_MMAP_DOWNLOAD_BUFFER_CAST (obj)->lock)
+#define GST_MMAP_DOWNLOAD_BUFFER_UNLOCK(obj) \
+  g_mutex_unlock (&GST_MMAP_DOWNLOAD_BUFFER_CAST (obj)->lock)
+#define GST_MMAP_DOWNLOAD_BUFFER_WAIT(obj) \
+  g_cond_wait (&GST_MMAP_DOWNLOAD_BUFFER_CAST (obj)->cond, \
+      &GST_MMAP_DOWNLOAD_BUFFER_CAST (obj)->lock)
+#define GST_MMAP_DOWNLOAD_BUFFER_SIGNAL(obj) \
+  g_cond_broadcast (&GST_MMAP_DOWNLOAD_BUFFER_CAST (obj)->cond)
+
+/* The mapping is refcounted so that the buffers given downstream stay valid
+ * after the element stopped */
+struct _GstMmapDownloadStorage
+{
+  gint refcount;
+  gint fd;
+  guint8 *data;
+  gsize size;
+};
+
+typedef struct
+{
+  guint64 start;
+  guint64 stop;
+} GstMmapDownloadRange;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+#define gst_mmap_download_buffer_parent_class parent_class
+G_DEFINE_TYPE (GstMmapDownloadBuffer, gst_mmap_download_buffer,
+    GST_TYPE_ELEMENT);
+
+static void gst_mmap_download_buffer_loop (GstPad * pad);
+
+/* storage */
+#ifdef HAVE_MMAP
+/* A file is preferred, a memfd would keep the whole stream in memory */
+static gint
+create_storage_fd (GstMmapDownloadBuffer * self)
+{
+  gint fd = -1;
+  gchar *location;
+
+  if (self->temp_template == NULL) {
+#ifdef SYS_memfd_create
+    fd = syscall (SYS_memfd_create, "gst-mmapdownloadbuffer", MFD_CLOEXEC);
+    if (fd < 0)
+      GST_WARNING_OBJECT (self, "memfd_create failed: %s", g_strerror (errno));
+#else
+    GST_WARNING_OBJECT (self, "no memfd and no temp-template set");
+#endif
+    return fd;
+  }
+
+  location = g_strdup (self->temp_template);
+  fd = g_mkstemp (location);
+  if (fd < 0) {
+    GST_WARNING_OBJECT (self, "could not create %s: %s", location,
+        g_strerror (errno));
+    g_free (location);
+    return -1;
+  }
+  /* only the mapping is needed, the file goes away with it */
+  g_unlink (location);
+
+  g_free (self->temp_location);
+  self->temp_location = location;
+  g_object_notify (G_OBJECT (self), "temp-location");
+
+  return fd;
+}
+#endif
+
+#ifdef HAVE_MMAP
+/* Allocates the blocks of the whole storage. Writing into a mapped hole
+ * when the file system is full raises SIGBUS, this makes it fail here
+ * instead. Returns 0 or an errno value. */
+static gint
+reserve_storage (gint fd, gsize size)
+{
+#ifdef HAVE_POSIX_FALLOCATE
+  gint res;
+
+  do {
+    res = posix_fallocate (fd, 0, size);
+  } while (res == EINTR);
+
+  return res;
+#else
+  static const guint8 zeros[4096] = { 0, };
+  gsize offset = 0;
+
+  if (ftruncate (fd, size) < 0)
+    return errno;
+
+  while (offset < size) {
+    gssize res = pwrite (fd, zeros, MIN (sizeof (zeros), size - offset),
+        offset);
+
+    if (res < 0 && errno == EINTR)
+      continue;
+    if (res <= 0)
+      return res < 0 ? errno : ENOSPC;
+    offset += res;
+  }
+
+  return 0;
+#endif
+}
+#endif
+
+/* Returns NULL and sets @no_space when the storage couldn't be reserved
+ * because the file system is full */
+static GstMmapDownloadStorage *
+gst_mmap_download_storage_new (GstMmapDownloadBuffer * self, gsize size,
+    gboolean * no_space)
+{
+#ifdef HAVE_MMAP
+  GstMmapDownloadStorage *storage;
+  gpointer data;
+  gint fd, res;
+
+  *no_space = FALSE;
+
+  fd = create_storage_fd (self);
+  if (fd < 0)
+    return NULL;
+
+  res = reserve_storage (fd, size);
+  if (res != 0) {
+    GST_WARNING_OBJECT (self, "could not reserve %" G_GSIZE_FORMAT
+        " bytes of storage: %s", size, g_strerror (res));
+    *no_space = (res == ENOSPC || res == EFBIG);
+    close (fd);
+    return NULL;
+  }
+
+  data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    GST_WARNING_OBJECT (self, "could not map storage: %s", g_strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  storage = g_slice_new (GstMmapDownloadStorage);
+  storage->refcount = 1;
+  storage->fd = fd;
+  storage->data = data;
+  storage->size = size;
+
+  GST_DEBUG_OBJECT (self, "mapped %" G_GSIZE_FORMAT " bytes storage at %p",
+      size, data);
+
+  return storage;
+#else
+  *no_space = FALSE;
+  return NULL;
+#endif
+}
+
+static GstMmapDownloadStorage *
+gst_mmap_download_storage_ref (GstMmapDownloadStorage * storage)
+{
+  g_atomic_int_inc (&storage->refcount);
+  return storage;
+}
+
+static void
+gst_mmap_download_storage_unref (GstMmapDownloadStorage * storage)
+{
+  if (!g_atomic_int_dec_and_test (&storage->refcount))
+    return;
+
+#ifdef HAVE_MMAP
+  munmap (storage->data, storage->size);
+  close (storage->fd);
+#endif
+  g_slice_free (GstMmapDownloadStorage, storage);
+}
+
+/* ranges, must be called with the lock */
+static GstMmapDownloadRange *
+find_range (GstMmapDownloadBuffer * self, guint64 offset)
+{
+  GList *l;
+
+  for (l = self->ranges; l; l = l->next) {
+    GstMmapDownloadRange *range = l->data;
+
+    if (offset < range->start)
+      break;
+    if (offset < range->stop)
+      return range;
+  }
+
+  return NULL;
+}
+
+static void
+add_range (GstMmapDownloadBuffer * self, guint64 start, guint64 stop)
+{
+  GstMmapDownloadRange *range = NULL;
+  GList *l, *next;
+
+  /* find the first range that ends at or after start */
+  for (l = self->ranges; l; l = l->next) {
+    range = l->data;
+    if (range->stop >= start)
+      break;
+  }
+
+  if (l == NULL || range->start > stop) {
+    GstMmapDownloadRange *new_range = g_slice_new (GstMmapDownloadRange);
+
+    new_range->start = start;
+    new_range->stop = stop;
+    self->ranges = g_list_insert_before (self->ranges, l, new_range);
+    return;
+  }
+
+  /* extend the range and swallow the ones it now overlaps */
+  range->start = MIN (range->start, start);
+  range->stop = MAX (range->stop, stop);
+  for (l = l->next; l; l = next) {
+    GstMmapDownloadRange *other = l->data;
+
+    next = l->next;
+    if (other->start > range->stop)
+      break;
+
+    range->stop = MAX (range->stop, other->stop);
+    g_slice_free (GstMmapDownloadRange, other);
+    self->ranges = g_list_delete_link (self->ranges, l);
+  }
+}
+
+static void
+free_range (GstMmapDownloadRange * range)
+{
+  g_slice_free (GstMmapDownloadRange, range);
+}
+
+static void
+reset_storage (GstMmapDownloadBuffer * self)
+{
+  g_list_free_full (self->ranges, (GDestroyNotify) free_range);
+  self->ranges = NULL;
+  if (self->storage)
+    gst_mmap_download_storage_unref (self->storage);
+  self->storage = NULL;
+
+  self->write_offset = 0;
+  self->read_offset = 0;
+  self->is_eos = FALSE;
+  self->rate_start = GST_CLOCK_TIME_NONE;
+  self->rate_bytes = 0;
+  self->byte_in_rate = 0.0;
+  self->percent = -1;
+}
+
+/* buffering, must be called with the lock. Returns the message to post
+ * when the percentage changed */
+static GstMessage *
+update_buffering (GstMmapDownloadBuffer * self)
+{
+  GstMmapDownloadRange *range;
+  GstMessage *message;
+  guint64 threshold, ahead, downloaded = 0;
+  gint64 left = -1;
+  gint percent;
+  GList *l;
+
+  if (self->storage == NULL)
+    return NULL;
+
+  range = find_range (self, self->read_offset);
+  ahead = range ? range->stop - self->read_offset : 0;
+
+  threshold = self->max_size_bytes;
+  if (self->max_size_time > 0 && self->byte_in_rate > 0.0)
+    threshold = MAX (threshold,
+        self->byte_in_rate * self->max_size_time / GST_SECOND);
+
+  if ((range && range->stop >= self->storage->size) || threshold == 0)
+    percent = 100;
+  else
+    percent = MIN (100, ahead * 100 / threshold);
+
+  if (percent == self->percent)
+    return NULL;
+  self->percent = percent;
+
+  for (l = self->ranges; l; l = l->next) {
+    GstMmapDownloadRange *r = l->data;
+    downloaded += r->stop - r->start;
+  }
+  if (self->byte_in_rate > 0.0)
+    left = (self->storage->size - downloaded) * 1000 / self->byte_in_rate;
+
+  GST_LOG_OBJECT (self, "buffering %d%%, %" G_GUINT64_FORMAT " bytes ahead",
+      percent, ahead);
+
+  message = gst_message_new_buffering (GST_OBJECT_CAST (self), percent);
+  gst_message_set_buffering_stats (message, GST_BUFFERING_DOWNLOAD,
+      self->byte_in_rate, -1, left);
+
+  return message;
+}
+
+static void
+post_buffering (GstMmapDownloadBuffer * self, GstMessage * message)
+{
+  if (message)
+    gst_element_post_message (GST_ELEMENT_CAST (self), message);
+}
+
+/* sink pad */
+static gboolean
+ensure_storage (GstMmapDownloadBuffer * self)
+{
+  GstMmapDownloadStorage *storage;
+  gint64 size = -1;
+  gboolean no_space;
+
+  if (!gst_pad_peer_query_duration (self->sinkpad, GST_FORMAT_BYTES, &size)
+      || size <= 0) {
+    GST_ELEMENT_ERROR (self, STREAM, FAILED, (NULL),
+        ("Can't buffer a stream of unknown size"));
+    return FALSE;
+  }
+
+  if ((guint64) size > G_MAXSIZE) {
+    GST_ELEMENT_ERROR (self, RESOURCE, NO_SPACE_LEFT, (NULL),
+        ("Stream of %" G_GINT64_FORMAT " bytes can't be mapped", size));
+    return FALSE;
+  }
+
+  storage = gst_mmap_download_storage_new (self, size, &no_space);
+  if (storage == NULL) {
+    if (no_space)
+      GST_ELEMENT_ERROR (self, RESOURCE, NO_SPACE_LEFT, (NULL),
+          ("Not enough space to store %" G_GINT64_FORMAT " bytes", size));
+    else
+      GST_ELEMENT_ERROR (self, RESOURCE, OPEN_READ_WRITE, (NULL),
+          ("Could not create storage of %" G_GINT64_FORMAT " bytes", size));
+    return FALSE;
+  }
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  self->storage = storage;
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_mmap_download_buffer_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (parent);
+  GstMessage *message;
+  GstClockTime now;
+  guint64 offset;
+  gsize size;
+
+  if (G_UNLIKELY (self->storage == NULL) && !ensure_storage (self)) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  if (self->sinkresult != GST_FLOW_OK) {
+    GstFlowReturn ret = self->sinkresult;
+
+    GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+    gst_buffer_unref (buffer);
+    return ret;
+  }
+
+  if (GST_BUFFER_OFFSET_IS_VALID (buffer))
+    offset = GST_BUFFER_OFFSET (buffer);
+  else
+    offset = self->write_offset;
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+  size = gst_buffer_get_size (buffer);
+  if (offset >= self->storage->size) {
+    GST_DEBUG_OBJECT (self, "dropping data after the end of the stream");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+  size = MIN (size, self->storage->size - offset);
+
+  /* Only this thread writes there and the range isn't visible to readers
+   * yet. Already downloaded data may get written again after a seek, with
+   * the same content, so buffers pointing there stay valid. */
+  gst_buffer_extract (buffer, 0, self->storage->data + offset, size);
+  gst_buffer_unref (buffer);
+
+  now = gst_util_get_timestamp ();
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  add_range (self, offset, offset + size);
+  self->write_offset = offset + size;
+
+  if (!GST_CLOCK_TIME_IS_VALID (self->rate_start))
+    self->rate_start = now;
+  self->rate_bytes += size;
+  if (now - self->rate_start >= GST_SECOND) {
+    gdouble rate = (gdouble) self->rate_bytes * GST_SECOND /
+        (now - self->rate_start);
+
+    self->byte_in_rate = self->byte_in_rate > 0.0 ?
+        (3.0 * self->byte_in_rate + rate) / 4.0 : rate;
+    self->rate_start = now;
+    self->rate_bytes = 0;
+  }
+
+  message = update_buffering (self);
+  GST_MMAP_DOWNLOAD_BUFFER_SIGNAL (self);
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+  post_buffering (self, message);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+gst_mmap_download_buffer_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (parent);
+  gboolean push_mode = GST_PAD_MODE (self->srcpad) == GST_PAD_MODE_PUSH;
+
+  GST_LOG_OBJECT (pad, "%" GST_PTR_FORMAT, event);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_START:
+      GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+      self->sinkresult = GST_FLOW_FLUSHING;
+      GST_MMAP_DOWNLOAD_BUFFER_SIGNAL (self);
+      GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+      /* flushes caused by our own seeks don't concern downstream, the
+       * downloaded data stays valid */
+      gst_event_unref (event);
+      return TRUE;
+    case GST_EVENT_FLUSH_STOP:
+      GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+      self->sinkresult = GST_FLOW_OK;
+      self->is_eos = FALSE;
+      GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+      gst_event_unref (event);
+      return TRUE;
+    case GST_EVENT_SEGMENT:
+    {
+      const GstSegment *segment;
+
+      gst_event_parse_segment (event, &segment);
+      GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+      if (segment->format == GST_FORMAT_BYTES)
+        self->write_offset = segment->start;
+      GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+      /* we output our own segments */
+      gst_event_unref (event);
+      return TRUE;
+    }
+    case GST_EVENT_EOS:
+    {
+      GstMessage *message;
+
+      GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+      GST_DEBUG_OBJECT (self, "download stopped at %" G_GUINT64_FORMAT,
+          self->write_offset);
+      self->is_eos = TRUE;
+      message = update_buffering (self);
+      GST_MMAP_DOWNLOAD_BUFFER_SIGNAL (self);
+      GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+      post_buffering (self, message);
+      /* EOS goes out when the reading reaches the end */
+      gst_event_unref (event);
+      return TRUE;
+    }
+    default:
+      if (!push_mode && GST_EVENT_IS_SERIALIZED (event)
+          && !GST_EVENT_IS_STICKY (event)) {
+        gst_event_unref (event);
+        return TRUE;
+      }
+      return gst_pad_event_default (pad, parent, event);
+  }
+}
+
+static gboolean
+gst_mmap_download_buffer_sink_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (parent);
+
+  if (mode != GST_PAD_MODE_PUSH)
+    return FALSE;
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  self->sinkresult = active ? GST_FLOW_OK : GST_FLOW_FLUSHING;
+  GST_MMAP_DOWNLOAD_BUFFER_SIGNAL (self);
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+  return TRUE;
+}
+
+/* src pad */
+
+/* Must be called with the lock, which is released while seeking */
+static gboolean
+seek_upstream (GstMmapDownloadBuffer * self, guint64 offset)
+{
+  GstEvent *event;
+  gboolean res;
+
+  GST_DEBUG_OBJECT (self, "seeking upstream to %" G_GUINT64_FORMAT, offset);
+
+  /* don't seek again while this one gets handled */
+  self->write_offset = offset;
+  self->is_eos = FALSE;
+
+  event = gst_event_new_seek (1.0, GST_FORMAT_BYTES, GST_SEEK_FLAG_FLUSH,
+      GST_SEEK_TYPE_SET, offset, GST_SEEK_TYPE_NONE, -1);
+
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+  res = gst_pad_push_event (self->sinkpad, event);
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+
+  return res;
+}
+
+static GstFlowReturn
+gst_mmap_download_buffer_get_range_unlocked (GstMmapDownloadBuffer * self,
+    guint64 offset, guint length, GstBuffer ** buffer)
+{
+  GstMmapDownloadRange *range;
+  GstMemory *mem;
+  GstMessage *message;
+  guint64 stop;
+
+  while (TRUE) {
+    if (self->srcresult != GST_FLOW_OK)
+      return self->srcresult;
+
+    if (self->storage == NULL) {
+      /* nothing arrived yet */
+      if (self->is_eos)
+        return GST_FLOW_EOS;
+      GST_MMAP_DOWNLOAD_BUFFER_WAIT (self);
+      continue;
+    }
+
+    if (offset >= self->storage->size)
+      return GST_FLOW_EOS;
+
+    stop = MIN (offset + length, self->storage->size);
+    range = find_range (self, offset);
+    if (range && range->stop >= stop)
+      break;
+
+    /* Wait if the download is going to reach the data soon, otherwise
+     * make it restart there */
+    if (range && range->stop == self->write_offset && !self->is_eos) {
+      GST_LOG_OBJECT (self, "waiting for %" G_GUINT64_FORMAT " bytes more",
+          stop - range->stop);
+    } else if (!range && offset >= self->write_offset
+        && offset < self->write_offset + SEEK_THRESHOLD && !self->is_eos) {
+      GST_LOG_OBJECT (self, "waiting for the download to reach %"
+          G_GUINT64_FORMAT, offset);
+    } else {
+      if (!seek_upstream (self, range ? range->stop : offset)) {
+        GST_ELEMENT_ERROR (self, RESOURCE, SEEK, (NULL),
+            ("Could not seek upstream to missing data"));
+        return GST_FLOW_ERROR;
+      }
+      continue;
+    }
+
+    GST_MMAP_DOWNLOAD_BUFFER_WAIT (self);
+  }
+
+  mem = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+      self->storage->data, self->storage->size, offset, stop - offset,
+      gst_mmap_download_storage_ref (self->storage),
+      (GDestroyNotify) gst_mmap_download_storage_unref);
+
+  *buffer = gst_buffer_new ();
+  gst_buffer_append_memory (*buffer, mem);
+  GST_BUFFER_OFFSET (*buffer) = offset;
+  GST_BUFFER_OFFSET_END (*buffer) = stop;
+
+  self->read_offset = stop;
+  message = update_buffering (self);
+  if (message) {
+    GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+    post_buffering (self, message);
+    GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  }
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_mmap_download_buffer_get_range (GstPad * pad, GstObject * parent,
+    guint64 offset, guint length, GstBuffer ** buffer)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (parent);
+  GstFlowReturn ret;
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  ret = gst_mmap_download_buffer_get_range_unlocked (self, offset, length,
+      buffer);
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+  GST_LOG_OBJECT (self, "pulled %u bytes at %" G_GUINT64_FORMAT ": %s",
+      length, offset, gst_flow_get_name (ret));
+
+  return ret;
+}
+
+static void
+gst_mmap_download_buffer_loop (GstPad * pad)
+{
+  GstMmapDownloadBuffer *self =
+      GST_MMAP_DOWNLOAD_BUFFER (GST_PAD_PARENT (pad));
+  GstBuffer *buffer = NULL;
+  GstFlowReturn ret;
+  guint64 offset;
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  offset = self->read_offset;
+  ret = gst_mmap_download_buffer_get_range_unlocked (self, offset,
+      DEFAULT_BLOCKSIZE, &buffer);
+  if (ret == GST_FLOW_OK && self->segment_pending) {
+    GstSegment segment;
+
+    self->segment_pending = FALSE;
+    GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+    gst_segment_init (&segment, GST_FORMAT_BYTES);
+    segment.start = segment.position = segment.time = offset;
+    gst_pad_push_event (pad, gst_event_new_segment (&segment));
+  } else {
+    GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+  }
+
+  if (ret == GST_FLOW_OK)
+    ret = gst_pad_push (pad, buffer);
+
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (self, "pausing task, reason %s", gst_flow_get_name (ret));
+
+    GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+    if (self->srcresult == GST_FLOW_OK)
+      self->srcresult = ret;
+    GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+    gst_pad_pause_task (pad);
+    if (ret == GST_FLOW_EOS) {
+      gst_pad_push_event (pad, gst_event_new_eos ());
+    } else if (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_EOS) {
+      GST_ELEMENT_FLOW_ERROR (self, ret);
+      gst_pad_push_event (pad, gst_event_new_eos ());
+    }
+  }
+}
+
+static gboolean
+gst_mmap_download_buffer_handle_seek (GstMmapDownloadBuffer * self,
+    GstEvent * event)
+{
+  GstFormat format;
+  GstSeekFlags flags;
+  GstSeekType start_type, stop_type;
+  gint64 start, stop;
+  gdouble rate;
+
+  gst_event_parse_seek (event, &rate, &format, &flags, &start_type, &start,
+      &stop_type, &stop);
+
+  if (format != GST_FORMAT_BYTES || rate <= 0.0
+      || start_type != GST_SEEK_TYPE_SET || start < 0)
+    return FALSE;
+
+  GST_DEBUG_OBJECT (self, "seeking to %" G_GINT64_FORMAT, start);
+
+  if (flags & GST_SEEK_FLAG_FLUSH)
+    gst_pad_push_event (self->srcpad, gst_event_new_flush_start ());
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  self->srcresult = GST_FLOW_FLUSHING;
+  GST_MMAP_DOWNLOAD_BUFFER_SIGNAL (self);
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+  gst_pad_pause_task (self->srcpad);
+  GST_PAD_STREAM_LOCK (self->srcpad);
+
+  if (flags & GST_SEEK_FLAG_FLUSH)
+    gst_pad_push_event (self->srcpad, gst_event_new_flush_stop (TRUE));
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  self->srcresult = GST_FLOW_OK;
+  self->read_offset = start;
+  self->segment_pending = TRUE;
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+  gst_pad_start_task (self->srcpad,
+      (GstTaskFunction) gst_mmap_download_buffer_loop, self->srcpad, NULL);
+  GST_PAD_STREAM_UNLOCK (self->srcpad);
+
+  return TRUE;
+}
+
+static gboolean
+gst_mmap_download_buffer_src_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (parent);
+  gboolean res;
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEEK
+      && GST_PAD_MODE (pad) == GST_PAD_MODE_PUSH
+      && gst_mmap_download_buffer_handle_seek (self, event)) {
+    gst_event_unref (event);
+    return TRUE;
+  }
+
+  res = gst_pad_push_event (self->sinkpad, event);
+
+  return res;
+}
+
+static gboolean
+gst_mmap_download_buffer_src_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (parent);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_SCHEDULING:
+      gst_query_set_scheduling (query, GST_SCHEDULING_FLAG_SEEKABLE, 1, -1, 0);
+      gst_query_add_scheduling_mode (query, GST_PAD_MODE_PULL);
+      gst_query_add_scheduling_mode (query, GST_PAD_MODE_PUSH);
+      return TRUE;
+    case GST_QUERY_DURATION:
+    {
+      GstFormat format;
+
+      gst_query_parse_duration (query, &format, NULL);
+      GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+      if (format == GST_FORMAT_BYTES && self->storage) {
+        gst_query_set_duration (query, format, self->storage->size);
+        GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+        return TRUE;
+      }
+      GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+      break;
+    }
+    case GST_QUERY_BUFFERING:
+    {
+      GstFormat format;
+      GList *l;
+      gint64 left = -1, size;
+
+      gst_query_parse_buffering_range (query, &format, NULL, NULL, NULL);
+      if (format != GST_FORMAT_BYTES && format != GST_FORMAT_PERCENT)
+        break;
+
+      GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+      if (self->storage == NULL) {
+        GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+        break;
+      }
+
+      size = self->storage->size;
+      gst_query_set_buffering_percent (query, self->percent < 100,
+          MAX (self->percent, 0));
+      if (self->byte_in_rate > 0.0)
+        left = (size - self->write_offset) * 1000 / self->byte_in_rate;
+      gst_query_set_buffering_stats (query, GST_BUFFERING_DOWNLOAD,
+          self->byte_in_rate, -1, left);
+      gst_query_set_buffering_range (query, format, 0,
+          format == GST_FORMAT_BYTES ? size : GST_FORMAT_PERCENT_MAX, -1);
+
+      for (l = self->ranges; l; l = l->next) {
+        GstMmapDownloadRange *range = l->data;
+
+        if (format == GST_FORMAT_BYTES)
+          gst_query_add_buffering_range (query, range->start, range->stop);
+        else
+          gst_query_add_buffering_range (query,
+              gst_util_uint64_scale (range->start, GST_FORMAT_PERCENT_MAX,
+                  size), gst_util_uint64_scale (range->stop,
+                  GST_FORMAT_PERCENT_MAX, size));
+      }
+      GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+      return TRUE;
+    }
+    default:
+      break;
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+static gboolean
+gst_mmap_download_buffer_src_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (parent);
+  gboolean res = TRUE;
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  self->srcresult = active ? GST_FLOW_OK : GST_FLOW_FLUSHING;
+  self->read_offset = 0;
+  self->segment_pending = TRUE;
+  GST_MMAP_DOWNLOAD_BUFFER_SIGNAL (self);
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+
+  switch (mode) {
+    case GST_PAD_MODE_PULL:
+      break;
+    case GST_PAD_MODE_PUSH:
+      if (active)
+        res = gst_pad_start_task (pad,
+            (GstTaskFunction) gst_mmap_download_buffer_loop, pad, NULL);
+      else
+        res = gst_pad_stop_task (pad);
+      break;
+    default:
+      res = FALSE;
+      break;
+  }
+
+  return res;
+}
+
+static GstStateChangeReturn
+gst_mmap_download_buffer_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (element);
+  GstStateChangeReturn ret;
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+      reset_storage (self);
+      GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+      reset_storage (self);
+      GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
+
+static void
+gst_mmap_download_buffer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (object);
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  switch (prop_id) {
+    case PROP_MAX_SIZE_BYTES:
+      self->max_size_bytes = g_value_get_uint (value);
+      break;
+    case PROP_MAX_SIZE_TIME:
+      self->max_size_time = g_value_get_uint64 (value);
+      break;
+    case PROP_TEMP_TEMPLATE:
+      g_free (self->temp_template);
+      self->temp_template = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+}
+
+static void
+gst_mmap_download_buffer_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (object);
+
+  GST_MMAP_DOWNLOAD_BUFFER_LOCK (self);
+  switch (prop_id) {
+    case PROP_MAX_SIZE_BYTES:
+      g_value_set_uint (value, self->max_size_bytes);
+      break;
+    case PROP_MAX_SIZE_TIME:
+      g_value_set_uint64 (value, self->max_size_time);
+      break;
+    case PROP_TEMP_TEMPLATE:
+      g_value_set_string (value, self->temp_template);
+      break;
+    case PROP_TEMP_LOCATION:
+      g_value_set_string (value, self->temp_location);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_MMAP_DOWNLOAD_BUFFER_UNLOCK (self);
+}
+
+static void
+gst_mmap_download_buffer_finalize (GObject * object)
+{
+  GstMmapDownloadBuffer *self = GST_MMAP_DOWNLOAD_BUFFER (object);
+
+  reset_storage (self);
+  g_free (self->temp_template);
+  g_free (self->temp_location);
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_mmap_download_buffer_init (GstMmapDownloadBuffer * self)
+{
+  self->sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_mmap_download_buffer_chain));
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_mmap_download_buffer_sink_event));
+  gst_pad_set_activatemode_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_mmap_download_buffer_sink_activate_mode));
+  GST_PAD_SET_PROXY_CAPS (self->sinkpad);
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->sinkpad);
+
+  self->srcpad = gst_pad_new_from_static_template (&srctemplate, "src");
+  gst_pad_set_getrange_function (self->srcpad,
+      GST_DEBUG_FUNCPTR (gst_mmap_download_buffer_get_range));
+  gst_pad_set_event_function (self->srcpad,
+      GST_DEBUG_FUNCPTR (gst_mmap_download_buffer_src_event));
+  gst_pad_set_query_function (self->srcpad,
+      GST_DEBUG_FUNCPTR (gst_mmap_download_buffer_src_query));
+  gst_pad_set_activatemode_function (self->srcpad,
+      GST_DEBUG_FUNCPTR (gst_mmap_download_buffer_src_activate_mode));
+  GST_PAD_SET_PROXY_CAPS (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->srcpad);
+
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+
+  self->max_size_bytes = DEFAULT_MAX_SIZE_BYTES;
+  self->max_size_time = DEFAULT_MAX_SIZE_TIME;
+  self->temp_template = g_strdup (DEFAULT_TEMP_TEMPLATE);
+  self->sinkresult = GST_FLOW_FLUSHING;
+  self->srcresult = GST_FLOW_FLUSHING;
+  reset_storage (self);
+}
+
+static void
+gst_mmap_download_buffer_class_init (GstMmapDownloadBufferClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstElementClass *element_class = (GstElementClass *) klass;
+
+  gobject_class->set_property = gst_mmap_download_buffer_set_property;
+  gobject_class->get_property = gst_mmap_download_buffer_get_property;
+  gobject_class->finalize = gst_mmap_download_buffer_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_MAX_SIZE_BYTES,
+      g_param_spec_uint ("max-size-bytes", "Max. size (kB)",
+          "Amount of data ahead of the reading position to be 100% buffered "
+          "(0=disable)", 0, G_MAXUINT, DEFAULT_MAX_SIZE_BYTES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_MAX_SIZE_TIME,
+      g_param_spec_uint64 ("max-size-time", "Max. size (ns)",
+          "Amount of data ahead of the reading position to be 100% buffered, "
+          "at the download rate (0=disable)", 0, G_MAXUINT64,
+          DEFAULT_MAX_SIZE_TIME, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_TEMP_TEMPLATE,
+      g_param_spec_string ("temp-template", "Temporary File Template",
+          "File template to store the data, a memfd is used when not set "
+          "(should end with XXXXXX)", DEFAULT_TEMP_TEMPLATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_TEMP_LOCATION,
+      g_param_spec_string ("temp-location", "Temporary File Location",
+          "Location of the temporary file, already unlinked", NULL,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_add_static_pad_template (element_class, &srctemplate);
+  gst_element_class_add_static_pad_template (element_class, &sinktemplate);
+
+  gst_element_class_set_static_metadata (element_class,
+      "Memory mapped download buffer", "Generic",
+      "Download buffering into a memory mapped file",
+      "LG Electronics, Inc.");
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_mmap_download_buffer_change_state);
+}
+
+gboolean
+gst_mmap_download_buffer_plugin_init (GstPlugin * plugin)
+{
+#ifdef HAVE_MMAP
+  GST_DEBUG_CATEGORY_INIT (mmap_download_buffer_debug,
+      "mmapdownloadbuffer", 0, "Memory mapped download buffer");
+
+  return gst_element_register (plugin, "mmapdownloadbuffer", GST_RANK_NONE,
+      GST_TYPE_MMAP_DOWNLOAD_BUFFER);
+#else
+  return TRUE;
+#endif
+}
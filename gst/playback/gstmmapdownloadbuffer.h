@@ -0,0 +1,95 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_MMAP_DOWNLOAD_BUFFER_H__
+#define __GST_MMAP_DOWNLOAD_BUFFER_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_MMAP_DOWNLOAD_BUFFER \
+  (gst_mmap_download_buffer_get_type())
+#define GST_MMAP_DOWNLOAD_BUFFER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_MMAP_DOWNLOAD_BUFFER, GstMmapDownloadBuffer))
+#define GST_MMAP_DOWNLOAD_BUFFER_CAST(obj) \
+  ((GstMmapDownloadBuffer *) obj)
+#define GST_MMAP_DOWNLOAD_BUFFER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_MMAP_DOWNLOAD_BUFFER, GstMmapDownloadBufferClass))
+#define GST_IS_MMAP_DOWNLOAD_BUFFER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_MMAP_DOWNLOAD_BUFFER))
+#define GST_IS_MMAP_DOWNLOAD_BUFFER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_MMAP_DOWNLOAD_BUFFER))
+
+typedef struct _GstMmapDownloadBuffer GstMmapDownloadBuffer;
+typedef struct _GstMmapDownloadBufferClass GstMmapDownloadBufferClass;
+typedef struct _GstMmapDownloadStorage GstMmapDownloadStorage;
+
+struct _GstMmapDownloadBuffer
+{
+  GstElement parent;
+
+  /* < private > */
+  GstPad *sinkpad;
+  GstPad *srcpad;
+
+  /* protects everything below, cond is signalled when data was written or
+   * when flushing */
+  GMutex lock;
+  GCond cond;
+
+  /* properties */
+  guint max_size_bytes;
+  guint64 max_size_time;
+  gchar *temp_template;
+  gchar *temp_location;
+
+  /* mapping of the whole stream, NULL until the size is known */
+  GstMmapDownloadStorage *storage;
+  /* downloaded byte ranges, sorted and merged */
+  GList *ranges;
+
+  guint64 write_offset;
+  gboolean is_eos;
+  GstFlowReturn sinkresult;
+
+  /* push mode output */
+  guint64 read_offset;
+  gboolean segment_pending;
+  GstFlowReturn srcresult;
+
+  /* download rate estimation, in bytes per second */
+  GstClockTime rate_start;
+  guint64 rate_bytes;
+  gdouble byte_in_rate;
+  gint percent;
+};
+
+struct _GstMmapDownloadBufferClass
+{
+  GstElementClass parent;
+};
+
+GType gst_mmap_download_buffer_get_type (void);
+
+gboolean gst_mmap_download_buffer_plugin_init (GstPlugin * plugin);
+
+G_END_DECLS
+
+#endif /* __GST_MMAP_DOWNLOAD_BUFFER_H__ */
@@ -830,7 +830,7 @@ priv_connect_pad (GstParseBin * parsebin, GstElement * src,
         chain->main_input = TRUE;
     }
     /* 2.1. Try to create an element */
-    else if ((element = gst_element_factory_create (factory, NULL)) == NULL) {
+    else if ((element = gst_parse_bin_create_element (factory)) == NULL) {
       GST_WARNING_OBJECT (parsebin, "Could not create an element from %s",
           gst_plugin_feature_get_name (GST_PLUGIN_FEATURE (factory)));
       g_string_append_printf (error_details,
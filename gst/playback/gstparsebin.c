@@ -161,10 +161,6 @@ struct _GstParseBin
   GstParseChain *parse_chain;   /* Top level parse chain */
   guint nbpads;                 /* unique identifier for source pads */
 
-  GMutex factories_lock;
-  guint32 factories_cookie;     /* Cookie from last time when factories was updated */
-  GList *factories;             /* factories we can use for selecting elements */
-
   GMutex subtitle_lock;         /* Protects changes to subtitles and encoding */
   GList *subtitles;             /* List of elements with subtitle-encoding,
                                  * protected by above mutex! */
@@ -291,6 +287,23 @@ enum
 static GstBinClass *parent_class;
 static guint gst_parse_bin_signals[LAST_SIGNAL] = { 0 };
 
+/* The factories are shared by all parsebins. A channel change creates a new
+ * parsebin that autoplugs the same caps as the previous one, so we remember
+ * the factories for the caps until the registry changes and keep a spare
+ * element of the demuxers and parsers we used, created in the background.
+ * The spares outlive the parsebins, the old parsebin is usually gone before
+ * the new one is created, they are bounded and dropped with the factories
+ * when the registry changes. */
+#define FACTORIES_CACHE_MAX_CAPS 128
+#define FACTORIES_CACHE_MAX_SPARES 8
+
+static GMutex factories_lock;
+static guint32 factories_cookie;        /* Cookie from last time when factories was updated */
+static GList *decodable_factories;      /* factories we can use for selecting elements */
+static GHashTable *factories_for_caps;  /* caps string -> list of factories */
+static GHashTable *spare_elements;      /* factory -> floating element or NULL */
+static GThreadPool *spare_pool;
+
 static void type_found (GstElement * typefind, guint probability,
     GstCaps * caps, GstParseBin * parse_bin);
 
@@ -326,6 +339,8 @@ static void gst_parse_pad_update_stream_collection (GstParsePad * parsepad,
 static GstCaps *get_pad_caps (GstPad * pad);
 static GstStreamType guess_stream_type_from_caps (GstCaps * caps);
 
+static GstElement *gst_parse_bin_create_element (GstElementFactory * factory);
+
 #define EXPOSE_LOCK(parsebin) G_STMT_START {				\
     GST_LOG_OBJECT (parsebin,						\
 		    "expose locking from thread %p",			\
@@ -983,35 +998,152 @@ gst_parse_bin_class_init (GstParseBinClass * klass)
 #endif
 
   g_type_class_ref (GST_TYPE_PARSE_PAD);
+
+  factories_for_caps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      (GDestroyNotify) gst_plugin_feature_list_free);
+  spare_elements = g_hash_table_new_full (NULL, NULL, gst_object_unref, NULL);
 }
 
+static gboolean
+remove_spare_element (GstElementFactory * factory, GstElement * element,
+    gpointer user_data)
+{
+  if (element) {
+    gst_object_ref_sink (element);
+    gst_object_unref (element);
+  }
+
+  return TRUE;
+}
+
+/* call with factories_lock */
 static void
-gst_parse_bin_update_factories_list (GstParseBin * parsebin)
+gst_parse_bin_update_factories_list (void)
 {
   guint cookie;
 
   cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
-  if (!parsebin->factories || parsebin->factories_cookie != cookie) {
-    if (parsebin->factories)
-      gst_plugin_feature_list_free (parsebin->factories);
-    parsebin->factories =
+  if (!decodable_factories || factories_cookie != cookie) {
+    if (decodable_factories)
+      gst_plugin_feature_list_free (decodable_factories);
+    decodable_factories =
         gst_element_factory_list_get_elements
         (GST_ELEMENT_FACTORY_TYPE_DECODABLE, GST_RANK_MARGINAL);
-    parsebin->factories =
-        g_list_sort (parsebin->factories,
+    decodable_factories = g_list_sort (decodable_factories,
         gst_playback_utils_compare_factories_func);
-    parsebin->factories_cookie = cookie;
+    factories_cookie = cookie;
+
+    g_hash_table_remove_all (factories_for_caps);
+    g_hash_table_foreach_remove (spare_elements,
+        (GHRFunc) remove_spare_element, NULL);
   }
 }
 
+/* returns the sorted factories that can handle @caps */
+static GList *
+gst_parse_bin_get_factories (GstCaps * caps)
+{
+  GList *list;
+  gchar *key;
+
+  key = gst_caps_to_string (caps);
+
+  g_mutex_lock (&factories_lock);
+  gst_parse_bin_update_factories_list ();
+  if (!g_hash_table_lookup_extended (factories_for_caps, key, NULL,
+          (gpointer *) & list)) {
+    list = gst_element_factory_list_filter (decodable_factories, caps,
+        GST_PAD_SINK, gst_caps_is_fixed (caps));
+
+    if (g_hash_table_size (factories_for_caps) >= FACTORIES_CACHE_MAX_CAPS)
+      g_hash_table_remove_all (factories_for_caps);
+    g_hash_table_insert (factories_for_caps, key, list);
+    key = NULL;
+  }
+  list = gst_plugin_feature_list_copy (list);
+  g_mutex_unlock (&factories_lock);
+
+  g_free (key);
+
+  return list;
+}
+
+static void
+gst_parse_bin_prepare_spare_element (GstElementFactory * factory,
+    gpointer user_data)
+{
+  GstElement *element;
+  gpointer old;
+  guint32 cookie;
+
+  g_mutex_lock (&factories_lock);
+  cookie = factories_cookie;
+  g_mutex_unlock (&factories_lock);
+
+  element = gst_element_factory_create (factory, NULL);
+
+  g_mutex_lock (&factories_lock);
+  /* the registry could have changed or someone else filled the slot */
+  if (element && factories_cookie == cookie
+      && g_hash_table_lookup_extended (spare_elements, factory, NULL, &old)
+      && old == NULL) {
+    GST_DEBUG ("prepared spare element %s", GST_ELEMENT_NAME (element));
+    g_hash_table_insert (spare_elements, gst_object_ref (factory), element);
+    element = NULL;
+  }
+  g_mutex_unlock (&factories_lock);
+
+  if (element)
+    gst_object_unref (element);
+  gst_object_unref (factory);
+}
+
+/* Creates an element from @factory. Demuxers and parsers come from the
+ * spare elements when we have one and the next one is prepared in the
+ * background. */
+static GstElement *
+gst_parse_bin_create_element (GstElementFactory * factory)
+{
+  GstElement *element = NULL;
+  gboolean prepare = FALSE;
+  gpointer spare;
+
+  if (!gst_element_factory_list_is_type (factory,
+          GST_ELEMENT_FACTORY_TYPE_DEMUXER | GST_ELEMENT_FACTORY_TYPE_PARSER))
+    return gst_element_factory_create (factory, NULL);
+
+  g_mutex_lock (&factories_lock);
+  if (g_hash_table_lookup_extended (spare_elements, factory, NULL, &spare)) {
+    element = spare;
+    g_hash_table_insert (spare_elements, gst_object_ref (factory), NULL);
+    prepare = TRUE;
+  } else if (g_hash_table_size (spare_elements) < FACTORIES_CACHE_MAX_SPARES) {
+    g_hash_table_insert (spare_elements, gst_object_ref (factory), NULL);
+    prepare = TRUE;
+  }
+
+  if (prepare) {
+    if (spare_pool == NULL)
+      spare_pool = g_thread_pool_new ((GFunc)
+          gst_parse_bin_prepare_spare_element, NULL, 1, FALSE, NULL);
+    if (spare_pool)
+      g_thread_pool_push (spare_pool, gst_object_ref (factory), NULL);
+  }
+  g_mutex_unlock (&factories_lock);
+
+  if (element) {
+    GST_DEBUG ("using spare element %s", GST_ELEMENT_NAME (element));
+    return element;
+  }
+
+  return gst_element_factory_create (factory, NULL);
+}
+
 static void
 gst_parse_bin_init (GstParseBin * parse_bin)
 {
   GstParseBinClass *klass = GST_PARSE_BIN_GET_CLASS (parse_bin);
 
-  /* first filter out the interesting element factories */
-  g_mutex_init (&parse_bin->factories_lock);
-
   /* we create the typefind element only once */
   parse_bin->typefind = gst_element_factory_make ("typefind", "typefind");
   if (!parse_bin->typefind) {
@@ -1075,10 +1207,6 @@ gst_parse_bin_dispose (GObject * object)
   parse_bin = GST_PARSE_BIN (object);
   klass = GST_PARSE_BIN_GET_CLASS (parse_bin);
 
-  if (parse_bin->factories)
-    gst_plugin_feature_list_free (parse_bin->factories);
-  parse_bin->factories = NULL;
-
   if (parse_bin->parse_chain)
     gst_parse_chain_free (parse_bin->parse_chain);
   parse_bin->parse_chain = NULL;
@@ -1107,7 +1235,6 @@ gst_parse_bin_finalize (GObject * object)
   g_mutex_clear (&parse_bin->expose_lock);
   g_mutex_clear (&parse_bin->dyn_lock);
   g_mutex_clear (&parse_bin->subtitle_lock);
-  g_mutex_clear (&parse_bin->factories_lock);
   g_mutex_clear (&parse_bin->cleanup_lock);
 
   if (G_LIKELY (klass->priv_parse_bin_finalize))
@@ -1256,17 +1383,11 @@ gst_parse_bin_autoplug_factories (GstElement * element, GstPad * pad,
 {
   GList *list, *tmp;
   GValueArray *result;
-  GstParseBin *parsebin = GST_PARSE_BIN_CAST (element);
 
   GST_DEBUG_OBJECT (element, "finding factories");
 
   /* return all compatible factories for caps */
-  g_mutex_lock (&parsebin->factories_lock);
-  gst_parse_bin_update_factories_list (parsebin);
-  list =
-      gst_element_factory_list_filter (parsebin->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
-  g_mutex_unlock (&parsebin->factories_lock);
+  list = gst_parse_bin_get_factories (caps);
 
   result = g_value_array_new (g_list_length (list));
   for (tmp = list; tmp; tmp = tmp->next) {
@@ -2009,7 +2130,7 @@ connect_pad (GstParseBin * parsebin, GstElement * src, GstParsePad * parsepad,
     parse_pad_set_target (parsepad, NULL);
 
     /* 2.1. Try to create an element */
-    if ((element = gst_element_factory_create (factory, NULL)) == NULL) {
+    if ((element = gst_parse_bin_create_element (factory)) == NULL) {
       GST_WARNING_OBJECT (parsebin, "Could not create an element from %s",
           gst_plugin_feature_get_name (GST_PLUGIN_FEATURE (factory)));
       g_string_append_printf (error_details,
@@ -31,6 +31,7 @@
 #include "gstplaysink.h"
 #include "gstsubtitleoverlay.h"
 #include "gststreamsynchronizer.h"
+#include "gstmmapdownloadbuffer.h"
 
 static gboolean
 plugin_init (GstPlugin * plugin)
@@ -59,6 +60,7 @@ plugin_init (GstPlugin * plugin)
   res &= gst_play_sink_plugin_init (plugin);
   res &= gst_subtitle_overlay_plugin_init (plugin);
   res &= gst_stream_synchronizer_plugin_init (plugin);
+  res &= gst_mmap_download_buffer_plugin_init (plugin);
 
   res &= gst_decode_bin_plugin_init (plugin);
   res &= gst_decodebin3_plugin_init (plugin);
@@ -72,6 +72,10 @@ typedef struct
   gboolean send_gap_event;
   GstClockTime gap_duration;
 
+  /* segment.position is updated from the chain function without the lock,
+   * odd while it is being written. See gst_sync_stream_get_position() */
+  gint position_seq;
+
   GstStreamFlags flags;
 
   GCond stream_finish_cond;
@@ -83,6 +87,49 @@ typedef struct
   guint group_id;
 } GstSyncStream;
 
+/* Only the streaming thread of the stream may call this without the lock */
+static inline void
+gst_sync_stream_set_position (GstSyncStream * stream, GstClockTime position)
+{
+  g_atomic_int_inc (&stream->position_seq);
+  stream->segment.position = position;
+  g_atomic_int_inc (&stream->position_seq);
+}
+
+/* Reads the position of a stream from another streaming thread. The 64 bits
+ * position can't be read atomically everywhere, so retry until no write
+ * happened meanwhile. */
+static inline GstClockTime
+gst_sync_stream_get_position (GstSyncStream * stream)
+{
+  GstClockTime position;
+  gint seq;
+
+  do {
+    seq = g_atomic_int_get (&stream->position_seq);
+    position = stream->segment.position;
+  } while ((seq & 1) || seq != g_atomic_int_get (&stream->position_seq));
+
+  return position;
+}
+
+/* Must be called with lock! */
+static void
+gst_stream_synchronizer_update_eos_pending (GstStreamSynchronizer * self)
+{
+  GList *l;
+  gint eos_pending = 0;
+
+  for (l = self->streams; l; l = l->next) {
+    GstSyncStream *ostream = l->data;
+
+    if (ostream->is_eos && !ostream->eos_sent)
+      eos_pending++;
+  }
+
+  g_atomic_int_set (&self->eos_pending, eos_pending);
+}
+
 /* Must be called with lock! */
 static inline GstPad *
 gst_stream_get_other_pad (GstSyncStream * stream, GstPad * pad)
@@ -310,6 +357,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
         stream->flushing = FALSE;
         stream->stream_start_seqnum = seqnum;
         stream->group_id = group_id;
+        gst_stream_synchronizer_update_eos_pending (self);
 
         if (!have_group_id) {
           /* Check if this belongs to a stream that is already there,
@@ -385,7 +433,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
 
               position_running_time =
                   gst_segment_to_running_time (&ostream->segment,
-                  GST_FORMAT_TIME, ostream->segment.position);
+                  GST_FORMAT_TIME, gst_sync_stream_get_position (ostream));
 
               position_running_time =
                   MAX (position_running_time, stop_running_time);
@@ -501,6 +549,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
         stream->flushing = FALSE;
         stream->wait = FALSE;
         g_cond_broadcast (&stream->stream_finish_cond);
+        gst_stream_synchronizer_update_eos_pending (self);
       }
 
       for (l = self->streams; l; l = l->next) {
@@ -546,6 +595,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
           stream->eos_sent = FALSE;
           stream->wait = FALSE;
           g_cond_broadcast (&stream->stream_finish_cond);
+          gst_stream_synchronizer_update_eos_pending (self);
         }
         GST_STREAM_SYNCHRONIZER_UNLOCK (self);
       }
@@ -571,6 +621,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
       GST_SYS_DEBUG_OBJECT (pad, "Have EOS for stream %d",
           stream->stream_number);
       stream->is_eos = TRUE;
+      gst_stream_synchronizer_update_eos_pending (self);
 
       seen_data = stream->seen_data;
       srcpad = gst_object_ref (stream->srcpad);
@@ -582,7 +633,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
       else
         timestamp = stream->segment.stop;
 
-      stream->segment.position = timestamp;
+      gst_sync_stream_set_position (stream, timestamp);
 
       for (l = self->streams; l; l = l->next) {
         GstSyncStream *ostream = l->data;
@@ -644,6 +695,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
         stream = gst_pad_get_element_private (pad);
         if (stream) {
           stream->eos_sent = TRUE;
+          gst_stream_synchronizer_update_eos_pending (self);
         }
       }
 
@@ -689,37 +741,45 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
       && GST_CLOCK_TIME_IS_VALID (duration))
     timestamp_end = timestamp + duration;
 
-  GST_STREAM_SYNCHRONIZER_LOCK (self);
+  /* Buffers only update the position of their own stream, which is only
+   * read from other threads through gst_sync_stream_get_position(), and the
+   * segment only changes from events on this same pad. The stream can't go
+   * away while we are in the chain function, releasing the pad deactivates
+   * it first. So the lock is only needed for the first buffer and when some
+   * stream is EOS and might need to be advanced. */
   stream = gst_pad_get_element_private (pad);
+  if (!stream) {
+    GST_WARNING_OBJECT (pad, "Trying to get other pad after releasing");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
 
-  if (stream) {
+  if (G_UNLIKELY (!stream->seen_data)) {
+    GST_STREAM_SYNCHRONIZER_LOCK (self);
     stream->seen_data = TRUE;
-    if (stream->segment.format == GST_FORMAT_TIME
-        && GST_CLOCK_TIME_IS_VALID (timestamp)) {
-      GST_LOG_OBJECT (pad,
-          "Updating position from %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT,
-          GST_TIME_ARGS (stream->segment.position), GST_TIME_ARGS (timestamp));
-      if (stream->segment.rate > 0.0)
-        stream->segment.position = timestamp;
-      else
-        stream->segment.position = timestamp_end;
-    }
+    GST_STREAM_SYNCHRONIZER_UNLOCK (self);
   }
-  GST_STREAM_SYNCHRONIZER_UNLOCK (self);
 
-  opad = gst_stream_get_other_pad_from_pad (self, pad);
-  if (opad) {
-    ret = gst_pad_push (opad, buffer);
-    gst_object_unref (opad);
+  if (stream->segment.format == GST_FORMAT_TIME
+      && GST_CLOCK_TIME_IS_VALID (timestamp)) {
+    GST_LOG_OBJECT (pad,
+        "Updating position from %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (stream->segment.position), GST_TIME_ARGS (timestamp));
+    if (stream->segment.rate > 0.0)
+      gst_sync_stream_set_position (stream, timestamp);
+    else
+      gst_sync_stream_set_position (stream, timestamp_end);
   }
 
+  opad = gst_object_ref (stream->srcpad);
+  ret = gst_pad_push (opad, buffer);
+  gst_object_unref (opad);
+
   GST_LOG_OBJECT (pad, "Push returned: %s", gst_flow_get_name (ret));
   if (ret == GST_FLOW_OK) {
     GList *l;
 
-    GST_STREAM_SYNCHRONIZER_LOCK (self);
-    stream = gst_pad_get_element_private (pad);
-    if (stream && stream->segment.format == GST_FORMAT_TIME) {
+    if (stream->segment.format == GST_FORMAT_TIME) {
       GstClockTime position;
 
       if (stream->segment.rate > 0.0)
@@ -731,10 +791,15 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
         GST_LOG_OBJECT (pad,
             "Updating position from %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT,
             GST_TIME_ARGS (stream->segment.position), GST_TIME_ARGS (position));
-        stream->segment.position = position;
+        gst_sync_stream_set_position (stream, position);
       }
     }
 
+    if (G_LIKELY (g_atomic_int_get (&self->eos_pending) == 0))
+      return ret;
+
+    GST_STREAM_SYNCHRONIZER_LOCK (self);
+
     /* Advance EOS streams if necessary. For non-EOS
      * streams the demuxers should already do this! */
     if (!GST_CLOCK_TIME_IS_VALID (timestamp_end) &&
@@ -767,7 +832,7 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
             GST_TIME_FORMAT, ostream->stream_number, GST_TIME_ARGS (position),
             GST_TIME_ARGS (new_start));
 
-        ostream->segment.position = new_start;
+        gst_sync_stream_set_position (ostream, new_start);
 
         ostream->send_gap_event = TRUE;
         ostream->gap_duration = new_start - position;
@@ -864,6 +929,7 @@ gst_stream_synchronizer_release_stream (GstStreamSynchronizer * self,
     }
   }
   g_assert (l != NULL);
+  gst_stream_synchronizer_update_eos_pending (self);
   if (self->streams == NULL) {
     self->have_group_id = TRUE;
     self->group_id = G_MAXUINT;
@@ -996,6 +1062,7 @@ gst_stream_synchronizer_change_state (GstElement * element,
         stream->flushing = FALSE;
         stream->send_gap_event = FALSE;
       }
+      g_atomic_int_set (&self->eos_pending, 0);
       GST_STREAM_SYNCHRONIZER_UNLOCK (self);
       break;
     }
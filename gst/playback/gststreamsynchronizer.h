@@ -57,6 +57,9 @@ struct _GstStreamSynchronizer
 
   gboolean have_group_id;
   guint group_id;
+
+  /* number of streams that are EOS but didn't send it yet, atomic */
+  gint eos_pending;
 };
 
 struct _GstStreamSynchronizerClass
@@ -33,6 +33,13 @@
  * ]|
  *  This will play back the given Matroska file with h264 video and dvd subpicture style subtitles.
  *
+ * The elements of the previous subtitle chain are kept around and reused
+ * when switching to subtitles that need the same ones. After each switch
+ * an element message named "subtitleoverlay-switch" is posted, with the
+ * time it took in the "latency" field (#guint64, in nanoseconds), the
+ * resulting "mode" ("unchanged", "passthrough" or "overlay") and the
+ * number of reused elements in "reused-elements" (#guint).
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -54,6 +61,17 @@ GST_DEBUG_CATEGORY_STATIC (subtitle_overlay_debug);
 #define IS_VIDEO_CHAIN_IGNORE_ERROR(flow) \
   G_UNLIKELY (flow == GST_FLOW_ERROR)
 
+/* number of caps for which the candidate factories are remembered */
+#define MAX_FACTORY_CACHE 8
+/* renderer/parser/overlay and both colorspace converters */
+#define MAX_SPARE_ELEMENTS 5
+
+typedef struct
+{
+  GstCaps *caps;
+  GList *factories;             /* sorted by rank */
+} FactoryCacheEntry;
+
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
@@ -118,6 +136,9 @@ block_video (GstSubtitleOverlay * self)
   if (self->video_block_id != 0)
     return;
 
+  if (!GST_CLOCK_TIME_IS_VALID (self->switch_start))
+    self->switch_start = gst_util_get_timestamp ();
+
   if (self->video_block_pad) {
     self->video_block_id =
         gst_pad_add_probe (self->video_block_pad,
@@ -141,6 +162,9 @@ block_subtitle (GstSubtitleOverlay * self)
   if (self->subtitle_block_id != 0)
     return;
 
+  if (!GST_CLOCK_TIME_IS_VALID (self->switch_start))
+    self->switch_start = gst_util_get_timestamp ();
+
   if (self->subtitle_block_pad) {
     self->subtitle_block_id =
         gst_pad_add_probe (self->subtitle_block_pad,
@@ -172,6 +196,36 @@ pad_supports_caps (GstPad * pad, GstCaps * caps)
   return ret;
 }
 
+static void
+_factory_cache_entry_free (FactoryCacheEntry * entry)
+{
+  gst_caps_unref (entry->caps);
+  gst_plugin_feature_list_free (entry->factories);
+  g_slice_free (FactoryCacheEntry, entry);
+}
+
+/* Call with factories_lock! */
+static void
+gst_subtitle_overlay_clear_factory_cache (GstSubtitleOverlay * self)
+{
+  g_list_free_full (self->factory_cache,
+      (GDestroyNotify) _factory_cache_entry_free);
+  self->factory_cache = NULL;
+}
+
+static void
+_free_spare_elements (GstSubtitleOverlay * self)
+{
+  GList *l;
+
+  for (l = self->spare_elements; l; l = l->next) {
+    gst_element_set_state (l->data, GST_STATE_NULL);
+    gst_object_unref (l->data);
+  }
+  g_list_free (self->spare_elements);
+  self->spare_elements = NULL;
+}
+
 static void
 gst_subtitle_overlay_finalize (GObject * object)
 {
@@ -180,11 +234,14 @@ gst_subtitle_overlay_finalize (GObject * object)
   g_mutex_clear (&self->lock);
   g_mutex_clear (&self->factories_lock);
 
+  gst_subtitle_overlay_clear_factory_cache (self);
   if (self->factories)
     gst_plugin_feature_list_free (self->factories);
   self->factories = NULL;
   gst_caps_replace (&self->factory_caps, NULL);
 
+  _free_spare_elements (self);
+
   if (self->font_desc) {
     g_free (self->font_desc);
     self->font_desc = NULL;
@@ -406,6 +463,7 @@ gst_subtitle_overlay_update_factory_list (GstSubtitleOverlay * self)
       gst_plugin_feature_list_free (self->factories);
     self->factories = factories;
     self->factories_cookie = cookie;
+    gst_subtitle_overlay_clear_factory_cache (self);
   }
 
   return (self->factories != NULL);
@@ -481,6 +539,47 @@ gst_subtitle_overlay_get_factories_for_caps (const GList * list,
   return result;
 }
 
+static gint _sort_by_ranks (GstPluginFeature * f1, GstPluginFeature * f2);
+
+/* Call with factories_lock! Returns the factories supporting caps, sorted
+ * by rank. The results are remembered until the registry changes, as
+ * switching between subtitle tracks keeps asking for the same caps. */
+static GList *
+gst_subtitle_overlay_get_cached_factories (GstSubtitleOverlay * self,
+    GstCaps * caps)
+{
+  FactoryCacheEntry *entry;
+  GList *l, *factories;
+
+  for (l = self->factory_cache; l; l = l->next) {
+    entry = l->data;
+
+    if (gst_caps_is_equal (entry->caps, caps)) {
+      GST_LOG_OBJECT (self, "Cached factories for caps %" GST_PTR_FORMAT, caps);
+      self->factory_cache = g_list_remove_link (self->factory_cache, l);
+      self->factory_cache = g_list_concat (l, self->factory_cache);
+      return gst_plugin_feature_list_copy (entry->factories);
+    }
+  }
+
+  factories = gst_subtitle_overlay_get_factories_for_caps (self->factories,
+      caps);
+  factories = g_list_sort (factories, (GCompareFunc) _sort_by_ranks);
+
+  entry = g_slice_new (FactoryCacheEntry);
+  entry->caps = gst_caps_ref (caps);
+  entry->factories = gst_plugin_feature_list_copy (factories);
+  self->factory_cache = g_list_prepend (self->factory_cache, entry);
+
+  if (g_list_length (self->factory_cache) > MAX_FACTORY_CACHE) {
+    l = g_list_last (self->factory_cache);
+    _factory_cache_entry_free (l->data);
+    self->factory_cache = g_list_delete_link (self->factory_cache, l);
+  }
+
+  return factories;
+}
+
 static gint
 _sort_by_ranks (GstPluginFeature * f1, GstPluginFeature * f2)
 {
@@ -529,6 +628,26 @@ _get_video_pad (GstElement * element)
   return NULL;
 }
 
+static GstElement *
+_take_spare_element (GstSubtitleOverlay * self, const gchar * factory_name)
+{
+  GList *l;
+
+  for (l = self->spare_elements; l; l = l->next) {
+    GstElementFactory *factory = gst_element_get_factory (l->data);
+
+    if (factory && strcmp (gst_plugin_feature_get_name
+            (GST_PLUGIN_FEATURE_CAST (factory)), factory_name) == 0) {
+      GstElement *elt = l->data;
+
+      self->spare_elements = g_list_delete_link (self->spare_elements, l);
+      return elt;
+    }
+  }
+
+  return NULL;
+}
+
 static gboolean
 _create_element (GstSubtitleOverlay * self, GstElement ** element,
     const gchar * factory_name, GstElementFactory * factory,
@@ -538,12 +657,20 @@ _create_element (GstSubtitleOverlay * self, GstElement ** element,
 
   g_assert (!factory || !factory_name);
 
-  if (factory_name) {
-    elt = gst_element_factory_make (factory_name, element_name);
-  } else {
+  if (factory)
     factory_name =
         gst_plugin_feature_get_name (GST_PLUGIN_FEATURE_CAST (factory));
+
+  elt = _take_spare_element (self, factory_name);
+  if (elt) {
+    GST_DEBUG_OBJECT (self, "Reusing %" GST_PTR_FORMAT " as %s", elt,
+        element_name);
+    gst_object_set_name (GST_OBJECT_CAST (elt), element_name);
+    self->reused_elements++;
+  } else if (factory) {
     elt = gst_element_factory_create (factory, element_name);
+  } else {
+    elt = gst_element_factory_make (factory_name, element_name);
   }
 
   if (G_UNLIKELY (!elt)) {
@@ -615,6 +742,61 @@ _remove_element (GstSubtitleOverlay * self, GstElement ** element)
   }
 }
 
+/* Like _remove_element() but keeps the element in READY for the next
+ * chains */
+static void
+_park_element (GstSubtitleOverlay * self, GstElement ** element)
+{
+  GstElement *elt = *element;
+
+  if (!elt)
+    return;
+  *element = NULL;
+
+  gst_bin_remove (GST_BIN_CAST (self), elt);
+  if (gst_element_set_state (elt, GST_STATE_READY) != GST_STATE_CHANGE_SUCCESS) {
+    gst_element_set_state (elt, GST_STATE_NULL);
+    gst_object_unref (elt);
+    return;
+  }
+
+  self->spare_elements = g_list_prepend (self->spare_elements, elt);
+  if (g_list_length (self->spare_elements) > MAX_SPARE_ELEMENTS) {
+    GList *last = g_list_last (self->spare_elements);
+
+    gst_element_set_state (last->data, GST_STATE_NULL);
+    gst_object_unref (last->data);
+    self->spare_elements = g_list_delete_link (self->spare_elements, last);
+  }
+}
+
+/* Call with the lock, returns the message to post once it's released */
+static GstMessage *
+_switch_done (GstSubtitleOverlay * self, const gchar * mode)
+{
+  GstClockTime latency;
+  GstMessage *msg;
+
+  if (!GST_CLOCK_TIME_IS_VALID (self->switch_start))
+    return NULL;
+
+  latency = gst_util_get_timestamp () - self->switch_start;
+  GST_INFO_OBJECT (self, "Switched to %s in %" GST_TIME_FORMAT
+      ", reused %u elements", mode, GST_TIME_ARGS (latency),
+      self->reused_elements);
+
+  msg = gst_message_new_element (GST_OBJECT_CAST (self),
+      gst_structure_new ("subtitleoverlay-switch",
+          "latency", G_TYPE_UINT64, latency,
+          "mode", G_TYPE_STRING, mode,
+          "reused-elements", G_TYPE_UINT, self->reused_elements, NULL));
+
+  self->switch_start = GST_CLOCK_TIME_NONE;
+  self->reused_elements = 0;
+
+  return msg;
+}
+
 static gboolean
 _setup_passthrough (GstSubtitleOverlay * self)
 {
@@ -633,11 +815,11 @@ _setup_passthrough (GstSubtitleOverlay * self)
   gst_ghost_pad_set_target (GST_GHOST_PAD_CAST (self->video_sinkpad), NULL);
   gst_ghost_pad_set_target (GST_GHOST_PAD_CAST (self->subtitle_sinkpad), NULL);
   self->silent_property = NULL;
-  _remove_element (self, &self->post_colorspace);
-  _remove_element (self, &self->overlay);
-  _remove_element (self, &self->parser);
-  _remove_element (self, &self->renderer);
-  _remove_element (self, &self->pre_colorspace);
+  _park_element (self, &self->post_colorspace);
+  _park_element (self, &self->overlay);
+  _park_element (self, &self->parser);
+  _park_element (self, &self->renderer);
+  _park_element (self, &self->pre_colorspace);
   _remove_element (self, &self->passthrough_identity);
 
   if (G_UNLIKELY (!_create_element (self, &self->passthrough_identity,
@@ -719,6 +901,50 @@ gst_subtitle_overlay_set_fps (GstSubtitleOverlay * self)
   g_object_set (self->parser, "video-fps", self->fps_n, self->fps_d, NULL);
 }
 
+/* Must be called with subtitleoverlay lock! Sets @value, or the default
+ * value of the property if @value is NULL */
+static void
+_set_string_property (GstElement * element, const gchar * property,
+    const gchar * value)
+{
+  GParamSpec *pspec;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element),
+      property);
+  if (!pspec || pspec->value_type != G_TYPE_STRING)
+    return;
+
+  if (value)
+    g_object_set (element, property, value, NULL);
+  else
+    g_object_set_property (G_OBJECT (element), property,
+        g_param_spec_get_default_value (pspec));
+}
+
+/* Must be called with subtitleoverlay lock! Elements can be reused from a
+ * previous chain, where they could have been configured differently, so
+ * our settings are applied again once the chain is linked */
+static void
+_apply_element_settings (GstSubtitleOverlay * self)
+{
+  GstElement *renderer = self->overlay ? self->overlay : self->renderer;
+
+  if (renderer && self->silent_property) {
+    gboolean silent = self->silent;
+
+    if (self->silent_property_invert)
+      silent = !silent;
+    g_object_set (renderer, self->silent_property, silent, NULL);
+  }
+  if (renderer)
+    _set_string_property (renderer, "font-desc", self->font_desc);
+  if (self->renderer)
+    _set_string_property (self->renderer, "subtitle-encoding",
+        self->encoding);
+  if (self->parser)
+    _set_string_property (self->parser, "subtitle-encoding", self->encoding);
+}
+
 static const gchar *
 _get_silent_property (GstElement * element, gboolean * invert)
 {
@@ -1024,6 +1250,7 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   GstSubtitleOverlay *self = GST_SUBTITLE_OVERLAY_CAST (user_data);
   GstCaps *subcaps;
   GList *l, *factories = NULL;
+  GstMessage *switch_msg = NULL;
 
   if (GST_IS_EVENT (info->data)) {
     if (!GST_EVENT_IS_SERIALIZED (info->data)) {
@@ -1083,6 +1310,7 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   if (self->subtitle_error || (self->silent && !self->silent_property)) {
     _setup_passthrough (self);
     do_async_done (self);
+    switch_msg = _switch_done (self, "passthrough");
     goto out;
   }
 
@@ -1099,6 +1327,7 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
       /* Unblock pads */
       unblock_video (self);
       unblock_subtitle (self);
+      switch_msg = _switch_done (self, "unchanged");
       goto out;
     } else if (target) {
       gst_object_unref (target);
@@ -1117,8 +1346,7 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   g_mutex_lock (&self->factories_lock);
   gst_subtitle_overlay_update_factory_list (self);
   if (subcaps) {
-    factories =
-        gst_subtitle_overlay_get_factories_for_caps (self->factories, subcaps);
+    factories = gst_subtitle_overlay_get_cached_factories (self, subcaps);
     if (!factories) {
       GstMessage *msg;
 
@@ -1135,14 +1363,12 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   if (!subcaps) {
     _setup_passthrough (self);
     do_async_done (self);
+    switch_msg = _switch_done (self, "passthrough");
     goto out;
   }
 
   /* Now the interesting parts are done: subtitle overlaying! */
 
-  /* Sort the factories by rank */
-  factories = g_list_sort (factories, (GCompareFunc) _sort_by_ranks);
-
   for (l = factories; l; l = l->next) {
     GstElementFactory *factory = l->data;
     gboolean is_renderer = _is_renderer (factory);
@@ -1155,12 +1381,12 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
     gst_ghost_pad_set_target (GST_GHOST_PAD_CAST (self->subtitle_sinkpad),
         NULL);
     self->silent_property = NULL;
-    _remove_element (self, &self->post_colorspace);
-    _remove_element (self, &self->overlay);
-    _remove_element (self, &self->parser);
-    _remove_element (self, &self->renderer);
-    _remove_element (self, &self->pre_colorspace);
-    _remove_element (self, &self->passthrough_identity);
+    _park_element (self, &self->post_colorspace);
+    _park_element (self, &self->overlay);
+    _park_element (self, &self->parser);
+    _park_element (self, &self->renderer);
+    _park_element (self, &self->pre_colorspace);
+    _park_element (self, &self->passthrough_identity);
 
     GST_DEBUG_OBJECT (self, "Trying factory '%s'",
         GST_STR_NULL (gst_plugin_feature_get_name (GST_PLUGIN_FEATURE_CAST
@@ -1192,8 +1418,7 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
       GST_DEBUG_OBJECT (self,
           "Searching overlay factories for caps %" GST_PTR_FORMAT, parser_caps);
       overlay_factories =
-          gst_subtitle_overlay_get_factories_for_caps (self->factories,
-          parser_caps);
+          gst_subtitle_overlay_get_cached_factories (self, parser_caps);
       g_mutex_unlock (&self->factories_lock);
 
       if (!overlay_factories) {
@@ -1205,10 +1430,6 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
       }
       gst_caps_unref (parser_caps);
 
-      /* Sort the factories by rank */
-      overlay_factories =
-          g_list_sort (overlay_factories, (GCompareFunc) _sort_by_ranks);
-
       for (k = overlay_factories; k; k = k->next) {
         GstElementFactory *overlay_factory = k->data;
 
@@ -1227,9 +1448,9 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
         gst_ghost_pad_set_target (GST_GHOST_PAD_CAST (self->subtitle_sinkpad),
             NULL);
         self->silent_property = NULL;
-        _remove_element (self, &self->post_colorspace);
-        _remove_element (self, &self->overlay);
-        _remove_element (self, &self->pre_colorspace);
+        _park_element (self, &self->post_colorspace);
+        _park_element (self, &self->overlay);
+        _park_element (self, &self->pre_colorspace);
 
         if (!_create_element (self, &self->overlay, NULL, overlay_factory,
                 "overlay", FALSE)) {
@@ -1297,19 +1518,26 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
     self->subtitle_error = TRUE;
     _setup_passthrough (self);
     do_async_done (self);
+    switch_msg = _switch_done (self, "passthrough");
     goto out;
   }
 
+  _apply_element_settings (self);
+
   GST_DEBUG_OBJECT (self, "Everything worked, unblocking pads");
   unblock_video (self);
   unblock_subtitle (self);
   do_async_done (self);
+  switch_msg = _switch_done (self, "overlay");
 
 out:
   if (factories)
     gst_plugin_feature_list_free (factories);
   GST_SUBTITLE_OVERLAY_UNLOCK (self);
 
+  if (switch_msg)
+    gst_element_post_message (GST_ELEMENT_CAST (self), switch_msg);
+
   return GST_PAD_PROBE_OK;
 }
 
@@ -1346,6 +1574,11 @@ gst_subtitle_overlay_change_state (GstElement * element,
 
       self->downstream_chain_error = FALSE;
 
+      GST_SUBTITLE_OVERLAY_LOCK (self);
+      self->switch_start = gst_util_get_timestamp ();
+      self->reused_elements = 0;
+      GST_SUBTITLE_OVERLAY_UNLOCK (self);
+
       do_async_start (self);
       ret = GST_STATE_CHANGE_ASYNC;
 
@@ -1414,6 +1647,7 @@ gst_subtitle_overlay_change_state (GstElement * element,
       _remove_element (self, &self->renderer);
       _remove_element (self, &self->pre_colorspace);
       _remove_element (self, &self->passthrough_identity);
+      _free_spare_elements (self);
       GST_SUBTITLE_OVERLAY_UNLOCK (self);
 
       break;
@@ -2015,6 +2249,8 @@ gst_subtitle_overlay_init (GstSubtitleOverlay * self)
   g_mutex_init (&self->lock);
   g_mutex_init (&self->factories_lock);
 
+  self->switch_start = GST_CLOCK_TIME_NONE;
+
   templ = gst_static_pad_template_get (&srctemplate);
   self->srcpad = gst_ghost_pad_new_no_target_from_template ("src", templ);
   gst_object_unref (templ);
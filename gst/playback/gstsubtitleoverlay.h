@@ -87,6 +87,8 @@ struct _GstSubtitleOverlay
   GList *factories;
   guint32 factories_cookie;
   GstCaps *factory_caps;
+  /* most recently used first, cleared with the factories */
+  GList *factory_cache;
 
   GMutex lock;
   GstCaps *subcaps;
@@ -103,6 +105,11 @@ struct _GstSubtitleOverlay
 
   const gchar *silent_property;
   gboolean silent_property_invert;
+
+  /* elements of the previous chains, in READY, to be reused */
+  GList *spare_elements;
+  guint reused_elements;
+  GstClockTime switch_start;
 };
 
 struct _GstSubtitleOverlayClass
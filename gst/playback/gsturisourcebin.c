@@ -140,6 +140,7 @@ struct _GstURISourceBin
   guint64 buffer_duration;      /* When buffering, buffer duration (ns) */
   guint buffer_size;            /* When buffering, buffer size (bytes) */
   gboolean download;
+  gboolean mmap_download;
   gboolean use_buffering;
 
   GstElement *source;
@@ -217,6 +218,7 @@ enum
 #define DEFAULT_BUFFER_DURATION     -1
 #define DEFAULT_BUFFER_SIZE         -1
 #define DEFAULT_DOWNLOAD            FALSE
+#define DEFAULT_MMAP_DOWNLOAD       FALSE
 #define DEFAULT_USE_BUFFERING       FALSE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
 
@@ -230,6 +232,7 @@ enum
   PROP_BUFFER_SIZE,
   PROP_BUFFER_DURATION,
   PROP_DOWNLOAD,
+  PROP_MMAP_DOWNLOAD,
   PROP_USE_BUFFERING,
   PROP_RING_BUFFER_MAX_SIZE
 };
@@ -274,7 +277,8 @@ static GstStateChangeReturn gst_uri_source_bin_change_state (GstElement *
 static void remove_demuxer (GstURISourceBin * bin);
 static void expose_output_pad (GstURISourceBin * urisrc, GstPad * pad);
 static OutputSlotInfo *get_output_slot (GstURISourceBin * urisrc,
-    gboolean do_download, gboolean is_adaptive, GstCaps * caps);
+    gboolean do_download, gboolean mmap_download, gboolean is_adaptive,
+    GstCaps * caps);
 static void free_output_slot (OutputSlotInfo * slot, GstURISourceBin * urisrc);
 static void free_output_slot_async (GstURISourceBin * urisrc,
     OutputSlotInfo * slot);
@@ -342,6 +346,21 @@ gst_uri_source_bin_class_init (GstURISourceBinClass * klass)
           "Attempt download buffering when buffering network streams",
           DEFAULT_DOWNLOAD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstURISourceBin::mmap-download:
+   *
+   * Use mmapdownloadbuffer instead of downloadbuffer for download buffering.
+   * The downloaded data is kept in a memory mapped sparse file and handed
+   * downstream without copies, and seeks into already downloaded ranges
+   * don't restart the download.
+   *
+   * Since: 1.16
+   */
+  g_object_class_install_property (gobject_class, PROP_MMAP_DOWNLOAD,
+      g_param_spec_boolean ("mmap-download", "Mmap Download",
+          "Use a memory mapped file for download buffering",
+          DEFAULT_MMAP_DOWNLOAD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstURISourceBin::use-buffering:
    *
@@ -451,6 +470,7 @@ gst_uri_source_bin_init (GstURISourceBin * urisrc)
   urisrc->buffer_duration = DEFAULT_BUFFER_DURATION;
   urisrc->buffer_size = DEFAULT_BUFFER_SIZE;
   urisrc->download = DEFAULT_DOWNLOAD;
+  urisrc->mmap_download = DEFAULT_MMAP_DOWNLOAD;
   urisrc->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
   urisrc->last_buffering_pct = -1;
 
@@ -504,6 +524,9 @@ gst_uri_source_bin_set_property (GObject * object, guint prop_id,
     case PROP_DOWNLOAD:
       urisrc->download = g_value_get_boolean (value);
       break;
+    case PROP_MMAP_DOWNLOAD:
+      urisrc->mmap_download = g_value_get_boolean (value);
+      break;
     case PROP_USE_BUFFERING:
       urisrc->use_buffering = g_value_get_boolean (value);
       break;
@@ -551,6 +574,9 @@ gst_uri_source_bin_get_property (GObject * object, guint prop_id,
     case PROP_DOWNLOAD:
       g_value_set_boolean (value, urisrc->download);
       break;
+    case PROP_MMAP_DOWNLOAD:
+      g_value_set_boolean (value, urisrc->mmap_download);
+      break;
     case PROP_USE_BUFFERING:
       g_value_set_boolean (value, urisrc->use_buffering);
       break;
@@ -663,7 +689,7 @@ pending_pad_blocked (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   if (caps == NULL)
     caps = gst_pad_query_caps (pad, NULL);
 
-  slot = get_output_slot (urisrc, FALSE, TRUE, caps);
+  slot = get_output_slot (urisrc, FALSE, FALSE, TRUE, caps);
 
   gst_caps_unref (caps);
 
@@ -894,10 +920,12 @@ pre_queue_event_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   return ret;
 }
 
-/* Called with lock held */
+/* Called with lock held. @mmap_download selects mmapdownloadbuffer for
+ * download buffering, the caller checked that the size of the stream is
+ * known and can be mapped */
 static OutputSlotInfo *
 get_output_slot (GstURISourceBin * urisrc, gboolean do_download,
-    gboolean is_adaptive, GstCaps * caps)
+    gboolean mmap_download, gboolean is_adaptive, GstCaps * caps)
 {
   OutputSlotInfo *slot;
   GstPad *srcpad;
@@ -934,12 +962,18 @@ get_output_slot (GstURISourceBin * urisrc, gboolean do_download,
   }
 
   /* Otherwise create the new slot */
-  if (do_download)
+  if (do_download && mmap_download)
+    elem_name = "mmapdownloadbuffer";
+  else if (do_download)
     elem_name = "downloadbuffer";
   else
     elem_name = "queue2";
 
   queue = gst_element_factory_make (elem_name, NULL);
+  if (!queue && do_download && mmap_download) {
+    GST_WARNING_OBJECT (urisrc, "no mmapdownloadbuffer, using downloadbuffer");
+    queue = gst_element_factory_make ("downloadbuffer", NULL);
+  }
   if (!queue)
     goto no_buffer_element;
 
@@ -1552,7 +1586,8 @@ analyse_source (GstURISourceBin * urisrc, gboolean * is_raw,
         if (*is_raw) {
           GST_URI_SOURCE_BIN_LOCK (urisrc);
           if (use_queue) {
-            OutputSlotInfo *slot = get_output_slot (urisrc, FALSE, FALSE, NULL);
+            OutputSlotInfo *slot =
+                get_output_slot (urisrc, FALSE, FALSE, FALSE, NULL);
             if (!slot)
               goto no_slot;
 
@@ -1704,7 +1739,7 @@ handle_new_pad (GstURISourceBin * urisrc, GstPad * srcpad, GstCaps * caps)
   gboolean is_raw;
   GstStructure *s;
   const gchar *media_type;
-  gboolean do_download = FALSE;
+  gboolean do_download = FALSE, mmap_download = FALSE;
 
   GST_URI_SOURCE_BIN_LOCK (urisrc);
 
@@ -1763,6 +1798,13 @@ handle_new_pad (GstURISourceBin * urisrc, GstPad * srcpad, GstCaps * caps)
         gint64 dur;
         gst_query_parse_duration (query, NULL, &dur);
         do_download = (dur != -1);
+        /* the memory mapped storage is as large as the stream, use
+         * downloadbuffer when it can't be mapped */
+        mmap_download = urisrc->mmap_download && dur > 0
+            && (guint64) dur <= G_MAXSIZE;
+        if (urisrc->mmap_download && do_download && !mmap_download)
+          GST_DEBUG_OBJECT (urisrc, "can't map %" G_GINT64_FORMAT
+              " bytes, using downloadbuffer", dur);
       }
       gst_query_unref (query);
     }
@@ -1771,7 +1813,7 @@ handle_new_pad (GstURISourceBin * urisrc, GstPad * srcpad, GstCaps * caps)
         do_download);
 
     GST_URI_SOURCE_BIN_LOCK (urisrc);
-    slot = get_output_slot (urisrc, do_download, FALSE, NULL);
+    slot = get_output_slot (urisrc, do_download, mmap_download, FALSE, NULL);
 
     if (slot == NULL || gst_pad_link (srcpad, slot->sinkpad) != GST_PAD_LINK_OK)
       goto could_not_link;
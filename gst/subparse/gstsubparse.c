@@ -77,6 +77,13 @@ static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src",
     );
 
 
+typedef struct
+{
+  guint64 offset;
+  /* latest end time of this cue and all the previous ones */
+  GstClockTime max_end;
+} GstSubParseIndexEntry;
+
 static gboolean gst_sub_parse_src_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
 static gboolean gst_sub_parse_src_query (GstPad * pad, GstObject * parent,
@@ -120,6 +127,11 @@ gst_sub_parse_dispose (GObject * object)
     subparse->textbuf = NULL;
   }
 
+  if (subparse->index) {
+    g_array_free (subparse->index, TRUE);
+    subparse->index = NULL;
+  }
+
   GST_CALL_PARENT (G_OBJECT_CLASS, dispose, (object));
 }
 
@@ -185,6 +197,7 @@ gst_sub_parse_init (GstSubParse * subparse)
   subparse->encoding = g_strdup (DEFAULT_ENCODING);
   subparse->detected_encoding = NULL;
   subparse->adapter = gst_adapter_new ();
+  subparse->index = g_array_new (FALSE, FALSE, sizeof (GstSubParseIndexEntry));
 
   subparse->fps_n = 24000;
   subparse->fps_d = 1001;
@@ -243,6 +256,131 @@ gst_sub_parse_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
   return ret;
 }
 
+/*
+ * Cue index, to resume parsing close to the seek position instead of from
+ * the start of the file. Only filled while parsing contiguously from the
+ * start or from an indexed offset, with formats that don't carry state
+ * from one cue to the next.
+ */
+static gboolean
+gst_sub_parse_format_can_index (GstSubParseFormat format)
+{
+  return format == GST_SUB_PARSE_FORMAT_SUBRIP ||
+      format == GST_SUB_PARSE_FORMAT_MDVDSUB;
+}
+
+static void
+gst_sub_parse_index_add (GstSubParse * self, guint64 offset,
+    GstClockTime start, GstClockTime duration)
+{
+  GstSubParseIndexEntry entry;
+  GstClockTime end = start;
+
+  if (GST_CLOCK_TIME_IS_VALID (duration))
+    end += duration;
+
+  GST_OBJECT_LOCK (self);
+  entry.offset = offset;
+  entry.max_end = end;
+  if (self->index->len > 0) {
+    GstSubParseIndexEntry *last = &g_array_index (self->index,
+        GstSubParseIndexEntry, self->index->len - 1);
+
+    /* already indexed when parsing again after a seek */
+    if (offset <= last->offset) {
+      GST_OBJECT_UNLOCK (self);
+      return;
+    }
+    entry.max_end = MAX (last->max_end, end);
+  }
+  g_array_append_val (self->index, entry);
+  GST_OBJECT_UNLOCK (self);
+
+  GST_LOG_OBJECT (self, "indexed cue %" GST_TIME_FORMAT " at offset %"
+      G_GUINT64_FORMAT, GST_TIME_ARGS (start), offset);
+}
+
+static gboolean
+gst_sub_parse_index_has_offset (GstSubParse * self, guint64 offset)
+{
+  guint lo = 0, hi;
+  gboolean ret = FALSE;
+
+  GST_OBJECT_LOCK (self);
+  hi = self->index->len;
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+    guint64 mid_offset =
+        g_array_index (self->index, GstSubParseIndexEntry, mid).offset;
+
+    if (mid_offset == offset) {
+      ret = TRUE;
+      break;
+    } else if (mid_offset < offset) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return ret;
+}
+
+/* Returns the offset of the first cue still visible at time, all the cues
+ * before it are over by then. max_end only grows along the index so it can
+ * be searched even if the cues aren't sorted by time. */
+static guint64
+gst_sub_parse_index_lookup (GstSubParse * self, GstClockTime time)
+{
+  guint lo = 0, hi;
+  guint64 offset = 0;
+
+  GST_OBJECT_LOCK (self);
+  hi = self->index->len;
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (g_array_index (self->index, GstSubParseIndexEntry, mid).max_end > time)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  /* the first cue needs whatever comes before it, e.g. the MicroDVD
+   * framerate line, and the cues after the last indexed one weren't
+   * parsed yet: resume from the last one */
+  if (lo > 0 && self->index->len > 0) {
+    lo = MIN (lo, self->index->len - 1);
+    offset = g_array_index (self->index, GstSubParseIndexEntry, lo).offset;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return offset;
+}
+
+static void
+gst_sub_parse_index_line (GstSubParse * self, gint prev_state)
+{
+  ParserState *state = &self->state;
+
+  switch (self->parser_type) {
+    case GST_SUB_PARSE_FORMAT_SUBRIP:
+      /* found the timestamps line */
+      if (prev_state == 1 && state->state == 2)
+        gst_sub_parse_index_add (self, self->cue_offset, state->start_time,
+            state->duration);
+      break;
+    case GST_SUB_PARSE_FORMAT_MDVDSUB:
+      if (GST_CLOCK_TIME_IS_VALID (state->start_time))
+        gst_sub_parse_index_add (self, self->cue_offset, state->start_time,
+            state->duration);
+      break;
+    default:
+      break;
+  }
+}
+
 static gboolean
 gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -260,6 +398,7 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
       gint64 start, stop;
       gdouble rate;
       gboolean update;
+      guint64 offset = 0;
 
       gst_event_parse_seek (event, &rate, &format, &flags,
           &start_type, &start, &stop_type, &stop);
@@ -270,11 +409,17 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         goto beach;
       }
 
-      /* Convert that seek to a seeking in bytes at position 0,
-         FIXME: could use an index */
+      /* Convert that seek to a seeking in bytes at the first cue that may
+       * still be visible at the requested position, position 0 if that
+       * part wasn't parsed yet */
+      if (rate > 0.0 && start_type == GST_SEEK_TYPE_SET && start > 0)
+        offset = gst_sub_parse_index_lookup (self, start);
+      GST_DEBUG_OBJECT (self, "seeking to %" GST_TIME_FORMAT " from offset %"
+          G_GUINT64_FORMAT, GST_TIME_ARGS (start), offset);
+
       ret = gst_pad_push_event (self->sinkpad,
           gst_event_new_seek (rate, GST_FORMAT_BYTES, flags,
-              GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_NONE, 0));
+              GST_SEEK_TYPE_SET, offset, GST_SEEK_TYPE_NONE, 0));
 
       if (ret) {
         /* Apply the seek to our segment */
@@ -288,7 +433,8 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
          * after FLUSH and all that has happened,
          * rather than racing with chain */
       } else {
-        GST_WARNING_OBJECT (self, "seek to 0 bytes failed");
+        GST_WARNING_OBJECT (self, "seek to %" G_GUINT64_FORMAT " bytes failed",
+            offset);
       }
 
       gst_event_unref (event);
@@ -505,31 +651,28 @@ convert_encoding (GstSubParse * self, const gchar * str, gsize len,
   return ret;
 }
 
+/* Returns the next line, terminated in place in textbuf. It stays valid
+ * until the next feed_textbuf(), which drops the parsed lines. */
 static gchar *
 get_next_line (GstSubParse * self)
 {
-  char *line = NULL;
-  const char *line_end;
-  int line_len;
-  gboolean have_r = FALSE;
+  gchar *line, *line_end;
 
-  line_end = strchr (self->textbuf->str, '\n');
+  line = self->textbuf->str + self->textbuf_pos;
+  line_end = strchr (line, '\n');
 
   if (!line_end) {
     /* end-of-line not found; return for more data */
     return NULL;
   }
 
+  self->textbuf_pos += line_end - line + 1;
+
   /* get rid of '\r' */
-  if (line_end != self->textbuf->str && *(line_end - 1) == '\r') {
+  if (line_end != line && *(line_end - 1) == '\r')
     line_end--;
-    have_r = TRUE;
-  }
+  *line_end = '\0';
 
-  line_len = line_end - self->textbuf->str;
-  line = g_strndup (self->textbuf->str, line_len);
-  self->textbuf = g_string_erase (self->textbuf, 0,
-      line_len + (have_r ? 2 : 1));
   return line;
 }
 
@@ -1731,6 +1874,10 @@ feed_textbuf (GstSubParse * self, GstBuffer * buf)
     /* flush the parser state */
     parser_state_init (&self->state);
     g_string_truncate (self->textbuf, 0);
+    self->textbuf_pos = 0;
+    self->textbuf_offset = self->offset;
+    self->indexing = !self->index_broken && (self->offset == 0 ||
+        gst_sub_parse_index_has_offset (self, self->offset));
     gst_adapter_clear (self->adapter);
     if (self->parser_type == GST_SUB_PARSE_FORMAT_SAMI)
       sami_context_reset (&self->state);
@@ -1739,6 +1886,13 @@ feed_textbuf (GstSubParse * self, GstBuffer * buf)
      * subtitles which are discontinuous by nature. */
   }
 
+  /* drop the lines parsed so far */
+  if (self->textbuf_pos > 0) {
+    g_string_erase (self->textbuf, 0, self->textbuf_pos);
+    self->textbuf_offset += self->textbuf_pos;
+    self->textbuf_pos = 0;
+  }
+
   self->offset += gst_buffer_get_size (buf);
 
   gst_adapter_push (self->adapter, buf);
@@ -1748,6 +1902,14 @@ feed_textbuf (GstSubParse * self, GstBuffer * buf)
   input = convert_encoding (self, (const gchar *) data, avail, &consumed);
 
   if (input && consumed > 0) {
+    /* the index needs textbuf positions to be input offsets */
+    if (!self->index_broken && (strlen (input) != consumed ||
+            (self->detected_encoding &&
+                strcmp (self->detected_encoding, "UTF-8") != 0))) {
+      GST_DEBUG_OBJECT (self, "input isn't UTF-8, not indexing cues");
+      self->index_broken = TRUE;
+      self->indexing = FALSE;
+    }
     self->textbuf = g_string_append (self->textbuf, input);
     gst_adapter_unmap (self->adapter);
     gst_adapter_flush (self->adapter, consumed);
@@ -1812,16 +1974,34 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
     }
   }
 
-  while (!self->flushing && (line = get_next_line (self))) {
+  if (!gst_sub_parse_format_can_index (self->parser_type))
+    self->indexing = FALSE;
+
+  while (!self->flushing) {
+    guint64 line_offset = self->textbuf_offset + self->textbuf_pos;
+    gint prev_state = self->state.state;
     guint offset = 0;
 
+    if (!(line = get_next_line (self)))
+      break;
+
+    if (self->indexing) {
+      /* a cue starts at the last line parsed in the initial state */
+      if (prev_state == 0)
+        self->cue_offset = line_offset;
+      if (self->parser_type == GST_SUB_PARSE_FORMAT_MDVDSUB)
+        self->state.start_time = GST_CLOCK_TIME_NONE;
+    }
+
     /* Set segment on our parser state machine */
     self->state.segment = &self->segment;
     /* Now parse the line, out of segment lines will just return NULL */
     GST_LOG_OBJECT (self, "State %d. Parsing line '%s'", self->state.state,
         line + offset);
     subtitle = self->parse_line (&self->state, line + offset);
-    g_free (line);
+
+    if (self->indexing)
+      gst_sub_parse_index_line (self, prev_state);
 
     if (subtitle) {
       guint subtitle_len = strlen (subtitle);
@@ -2009,7 +2189,14 @@ gst_sub_parse_change_state (GstElement * element, GstStateChange transition)
       g_free (self->detected_encoding);
       self->detected_encoding = NULL;
       g_string_truncate (self->textbuf, 0);
+      self->textbuf_pos = 0;
+      self->textbuf_offset = 0;
       gst_adapter_clear (self->adapter);
+      GST_OBJECT_LOCK (self);
+      g_array_set_size (self->index, 0);
+      GST_OBJECT_UNLOCK (self);
+      self->indexing = TRUE;
+      self->index_broken = FALSE;
       break;
     default:
       break;
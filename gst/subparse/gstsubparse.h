@@ -92,6 +92,9 @@ struct _GstSubParse {
   GstAdapter *adapter;
   /* contains the UTF-8 decoded input */
   GString *textbuf;
+  /* parsing position in textbuf and input offset of textbuf */
+  gsize textbuf_pos;
+  guint64 textbuf_offset;
 
   GstSubParseFormat parser_type;
   gboolean parser_detected;
@@ -102,6 +105,15 @@ struct _GstSubParse {
 
   /* seek */
   guint64 offset;
+
+  /* cue start times and input offsets to resume parsing from, protected
+   * by the object lock */
+  GArray *index;
+  /* parsing contiguously from an indexed offset */
+  gboolean indexing;
+  /* input and textbuf offsets don't match anymore */
+  gboolean index_broken;
+  guint64 cue_offset;
   
   /* Segment */
   GstSegment    segment;
@@ -28,6 +28,10 @@
 #include "gsttcpserversink.h"
 #include "gstmultifdsink.h"
 #include "gstmultisocketsink.h"
+#ifdef HAVE_UNIX_SEQPACKET
+#include "gstunixfdsink.h"
+#include "gstunixfdsrc.h"
+#endif
 
 GST_DEBUG_CATEGORY (tcp_debug);
 
@@ -53,6 +57,14 @@ plugin_init (GstPlugin * plugin)
   if (!gst_element_register (plugin, "multifdsink", GST_RANK_NONE,
           GST_TYPE_MULTI_FD_SINK))
     return FALSE;
+#endif
+#ifdef HAVE_UNIX_SEQPACKET
+  if (!gst_element_register (plugin, "unixfdsink", GST_RANK_NONE,
+          GST_TYPE_UNIX_FD_SINK))
+    return FALSE;
+  if (!gst_element_register (plugin, "unixfdsrc", GST_RANK_NONE,
+          GST_TYPE_UNIX_FD_SRC))
+    return FALSE;
 #endif
   if (!gst_element_register (plugin, "multisocketsink", GST_RANK_NONE,
           GST_TYPE_MULTI_SOCKET_SINK))
@@ -0,0 +1,170 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * gstunixfd.c: protocol of unixfdsink and unixfdsrc
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "gstunixfd.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#ifndef MSG_CMSG_CLOEXEC
+#define MSG_CMSG_CLOEXEC 0
+#endif
+
+/* Sends one message with @n_fds fds attached. Returns the number of bytes
+ * sent or -1 with errno set. */
+gssize
+gst_unix_fd_send_message (gint socket, GstUnixFdMessageType type,
+    gconstpointer payload, gsize size, const gint * fds, guint n_fds)
+{
+  GstUnixFdMessageHeader header;
+  struct msghdr msg;
+  struct iovec iov[2];
+  union
+  {
+    struct cmsghdr hdr;
+    gchar buf[CMSG_SPACE (sizeof (gint) * GST_UNIX_FD_MAX_MEMORIES)];
+  } control;
+  gssize res;
+
+  g_return_val_if_fail (n_fds <= GST_UNIX_FD_MAX_MEMORIES, -1);
+
+  header.type = type;
+  header.size = size;
+
+  iov[0].iov_base = &header;
+  iov[0].iov_len = sizeof (header);
+  iov[1].iov_base = (gpointer) payload;
+  iov[1].iov_len = size;
+
+  memset (&msg, 0, sizeof (msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = size > 0 ? 2 : 1;
+
+  if (n_fds > 0) {
+    struct cmsghdr *cmsg;
+
+    memset (&control, 0, sizeof (control));
+    msg.msg_control = control.buf;
+    msg.msg_controllen = CMSG_SPACE (sizeof (gint) * n_fds);
+
+    cmsg = CMSG_FIRSTHDR (&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN (sizeof (gint) * n_fds);
+    memcpy (CMSG_DATA (cmsg), fds, sizeof (gint) * n_fds);
+  }
+
+  do {
+    res = sendmsg (socket, &msg, MSG_NOSIGNAL);
+  } while (res < 0 && errno == EINTR);
+
+  return res;
+}
+
+/* Receives one message. The payload is written in @payload, the received fds
+ * in @fds, which must have room for GST_UNIX_FD_MAX_MEMORIES fds and its size
+ * in @payload_size. Returns the size of the message, 0 when the peer closed
+ * the connection or -1 with errno set. */
+gssize
+gst_unix_fd_receive_message (gint socket, GstUnixFdMessageType * type,
+    gpointer payload, gsize size, gsize * payload_size, gint * fds,
+    guint * n_fds, gboolean block)
+{
+  GstUnixFdMessageHeader header;
+  struct msghdr msg;
+  struct iovec iov[2];
+  struct cmsghdr *cmsg;
+  union
+  {
+    struct cmsghdr hdr;
+    gchar buf[CMSG_SPACE (sizeof (gint) * GST_UNIX_FD_MAX_MEMORIES)];
+  } control;
+  gssize res;
+
+  iov[0].iov_base = &header;
+  iov[0].iov_len = sizeof (header);
+  iov[1].iov_base = payload;
+  iov[1].iov_len = size;
+
+  memset (&msg, 0, sizeof (msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 2;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+
+  *n_fds = 0;
+
+  do {
+    res = recvmsg (socket, &msg,
+        MSG_CMSG_CLOEXEC | (block ? 0 : MSG_DONTWAIT));
+  } while (res < 0 && errno == EINTR);
+
+  if (res <= 0)
+    return res;
+
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+    guint i, n;
+
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+
+    n = (cmsg->cmsg_len - CMSG_LEN (0)) / sizeof (gint);
+    for (i = 0; i < n; i++) {
+      gint fd;
+
+      memcpy (&fd, CMSG_DATA (cmsg) + i * sizeof (gint), sizeof (gint));
+      if (*n_fds < GST_UNIX_FD_MAX_MEMORIES)
+        fds[(*n_fds)++] = fd;
+      else
+        close (fd);
+    }
+  }
+
+  if (G_UNLIKELY ((gsize) res < sizeof (header) ||
+          (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) ||
+          header.size != res - sizeof (header)))
+    goto invalid;
+
+  *type = header.type;
+  *payload_size = header.size;
+
+  return res;
+
+  /* ERRORS */
+invalid:
+  {
+    while (*n_fds > 0)
+      close (fds[--(*n_fds)]);
+    errno = EBADMSG;
+    return -1;
+  }
+}
@@ -0,0 +1,99 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * gstunixfd.h: protocol of unixfdsink and unixfdsrc
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_UNIX_FD_H__
+#define __GST_UNIX_FD_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* unixfdsink listens on a SOCK_SEQPACKET unix socket, unixfdsrc connects to
+ * it. Every message is one packet made of a GstUnixFdMessageHeader followed
+ * by the payload. BUFFER messages carry the fds of the memories as
+ * SCM_RIGHTS, one per memory. The receiver sends RELEASE when all memories
+ * of a buffer are freed, only then the sender gives the buffer back to its
+ * pool. */
+
+#define UNIX_FD_DEFAULT_SOCKET_PATH    "/tmp/gst-unixfd"
+
+/* the number of fds we pass with a buffer */
+#define GST_UNIX_FD_MAX_MEMORIES       16
+
+/* biggest message we receive, limits the size of the caps */
+#define GST_UNIX_FD_MAX_MESSAGE_SIZE   (64 * 1024)
+
+typedef enum {
+  GST_UNIX_FD_MESSAGE_CAPS = 1,
+  GST_UNIX_FD_MESSAGE_BUFFER,
+  GST_UNIX_FD_MESSAGE_EOS,
+  GST_UNIX_FD_MESSAGE_RELEASE
+} GstUnixFdMessageType;
+
+typedef struct {
+  guint32 type;
+  guint32 size;
+} GstUnixFdMessageHeader;
+
+typedef struct {
+  guint64 offset;
+  guint64 size;
+  guint64 maxsize;
+} GstUnixFdMemoryPayload;
+
+typedef struct {
+  guint64 id;
+
+  /* running time */
+  guint64 pts;
+  guint64 dts;
+  guint64 duration;
+  guint64 offset;
+  guint64 offset_end;
+  guint32 flags;
+
+  guint32 has_video_meta;
+  guint32 video_flags;
+  guint32 video_format;
+  guint32 video_width;
+  guint32 video_height;
+  guint32 video_n_planes;
+  guint64 video_offset[4];
+  gint32 video_stride[4];
+
+  guint32 n_memory;
+  GstUnixFdMemoryPayload memories[GST_UNIX_FD_MAX_MEMORIES];
+} GstUnixFdBufferPayload;
+
+typedef struct {
+  guint64 id;
+} GstUnixFdReleasePayload;
+
+gssize gst_unix_fd_send_message (gint socket, GstUnixFdMessageType type,
+    gconstpointer payload, gsize size, const gint * fds, guint n_fds);
+
+gssize gst_unix_fd_receive_message (gint socket, GstUnixFdMessageType * type,
+    gpointer payload, gsize size, gsize * payload_size, gint * fds,
+    guint * n_fds, gboolean block);
+
+G_END_DECLS
+
+#endif /* __GST_UNIX_FD_H__ */
@@ -0,0 +1,710 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-unixfdsink
+ * @title: unixfdsink
+ * @see_also: #unixfdsrc
+ *
+ * unixfdsink sends buffers to a unixfdsrc in another process without
+ * copying the data. The memory of the buffers is passed as file descriptors
+ * over a unix socket, together with the caps, the timestamps and the video
+ * meta of the buffers.
+ *
+ * The sink proposes a pool of memfd backed buffers to upstream, buffers with
+ * other memory are copied into memfd memory once. A buffer is given back to
+ * its pool only after the receiving process released it, at most
+ * #GstUnixFdSink:max-buffers buffers are in use by the receiver before the
+ * sink blocks.
+ *
+ * ## Example launch line
+ * |[
+ * # sender:
+ * gst-launch-1.0 videotestsrc ! unixfdsink socket-path=/tmp/video
+ * # receiver:
+ * gst-launch-1.0 unixfdsrc socket-path=/tmp/video ! videoconvert ! autovideosink
+ * ]|
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <gst/gst-i18n-plugin.h>
+#include <gst/allocators/allocators.h>
+#include <gst/video/video.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "gstunixfd.h"
+#include "gstunixfdsink.h"
+
+GST_DEBUG_CATEGORY_STATIC (unixfdsink_debug);
+#define GST_CAT_DEFAULT (unixfdsink_debug)
+
+#define DEFAULT_SOCKET_PATH     UNIX_FD_DEFAULT_SOCKET_PATH
+#define DEFAULT_MAX_BUFFERS     4
+
+enum
+{
+  PROP_0,
+  PROP_SOCKET_PATH,
+  PROP_MAX_BUFFERS
+};
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static void gst_unix_fd_sink_finalize (GObject * gobject);
+static void gst_unix_fd_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_unix_fd_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static gboolean gst_unix_fd_sink_start (GstBaseSink * bsink);
+static gboolean gst_unix_fd_sink_stop (GstBaseSink * bsink);
+static gboolean gst_unix_fd_sink_unlock (GstBaseSink * bsink);
+static gboolean gst_unix_fd_sink_unlock_stop (GstBaseSink * bsink);
+static gboolean gst_unix_fd_sink_set_caps (GstBaseSink * bsink,
+    GstCaps * caps);
+static gboolean gst_unix_fd_sink_event (GstBaseSink * bsink,
+    GstEvent * event);
+static gboolean gst_unix_fd_sink_propose_allocation (GstBaseSink * bsink,
+    GstQuery * query);
+static GstFlowReturn gst_unix_fd_sink_render (GstBaseSink * bsink,
+    GstBuffer * buffer);
+
+#define gst_unix_fd_sink_parent_class parent_class
+G_DEFINE_TYPE (GstUnixFdSink, gst_unix_fd_sink, GST_TYPE_BASE_SINK);
+
+static void
+gst_unix_fd_sink_class_init (GstUnixFdSinkClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstElementClass *gstelement_class;
+  GstBaseSinkClass *gstbasesink_class;
+
+  gobject_class = (GObjectClass *) klass;
+  gstelement_class = (GstElementClass *) klass;
+  gstbasesink_class = (GstBaseSinkClass *) klass;
+
+  gobject_class->set_property = gst_unix_fd_sink_set_property;
+  gobject_class->get_property = gst_unix_fd_sink_get_property;
+  gobject_class->finalize = gst_unix_fd_sink_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_SOCKET_PATH,
+      g_param_spec_string ("socket-path", "Socket path",
+          "Path of the unix socket to listen on", DEFAULT_SOCKET_PATH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_MAX_BUFFERS,
+      g_param_spec_uint ("max-buffers", "Max buffers",
+          "Maximum number of buffers the receiver can hold before the sink "
+          "blocks (0 = unlimited)", 0, G_MAXUINT, DEFAULT_MAX_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_add_static_pad_template (gstelement_class, &sinktemplate);
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "Unix fd sink", "Sink/Network",
+      "Send buffers as file descriptors to another process over a unix socket",
+      "LG Electronics, Inc.");
+
+  gstbasesink_class->start = GST_DEBUG_FUNCPTR (gst_unix_fd_sink_start);
+  gstbasesink_class->stop = GST_DEBUG_FUNCPTR (gst_unix_fd_sink_stop);
+  gstbasesink_class->unlock = GST_DEBUG_FUNCPTR (gst_unix_fd_sink_unlock);
+  gstbasesink_class->unlock_stop =
+      GST_DEBUG_FUNCPTR (gst_unix_fd_sink_unlock_stop);
+  gstbasesink_class->set_caps = GST_DEBUG_FUNCPTR (gst_unix_fd_sink_set_caps);
+  gstbasesink_class->event = GST_DEBUG_FUNCPTR (gst_unix_fd_sink_event);
+  gstbasesink_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_unix_fd_sink_propose_allocation);
+  gstbasesink_class->render = GST_DEBUG_FUNCPTR (gst_unix_fd_sink_render);
+
+  GST_DEBUG_CATEGORY_INIT (unixfdsink_debug, "unixfdsink", 0,
+      "unix fd sink");
+}
+
+static void
+gst_unix_fd_sink_init (GstUnixFdSink * this)
+{
+  this->socket_path = g_strdup (DEFAULT_SOCKET_PATH);
+  this->max_buffers = DEFAULT_MAX_BUFFERS;
+
+  gst_poll_fd_init (&this->server);
+  gst_poll_fd_init (&this->client);
+
+  this->in_flight = g_hash_table_new_full (g_int64_hash, g_int64_equal,
+      g_free, (GDestroyNotify) gst_buffer_unref);
+}
+
+static void
+gst_unix_fd_sink_finalize (GObject * gobject)
+{
+  GstUnixFdSink *this = GST_UNIX_FD_SINK (gobject);
+
+  g_free (this->socket_path);
+  g_hash_table_unref (this->in_flight);
+
+  G_OBJECT_CLASS (parent_class)->finalize (gobject);
+}
+
+static void
+gst_unix_fd_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (object);
+
+  switch (prop_id) {
+    case PROP_SOCKET_PATH:
+      g_free (sink->socket_path);
+      sink->socket_path = g_value_dup_string (value);
+      break;
+    case PROP_MAX_BUFFERS:
+      sink->max_buffers = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_unix_fd_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (object);
+
+  switch (prop_id) {
+    case PROP_SOCKET_PATH:
+      g_value_set_string (value, sink->socket_path);
+      break;
+    case PROP_MAX_BUFFERS:
+      g_value_set_uint (value, sink->max_buffers);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_unix_fd_sink_close_client (GstUnixFdSink * sink)
+{
+  if (sink->client.fd < 0)
+    return;
+
+  GST_DEBUG_OBJECT (sink, "closing client fd %d, %u buffers in flight",
+      sink->client.fd, g_hash_table_size (sink->in_flight));
+
+  /* the receiver is gone, it can't use the buffers anymore */
+  g_hash_table_remove_all (sink->in_flight);
+
+  gst_poll_remove_fd (sink->fdset, &sink->client);
+  close (sink->client.fd);
+  gst_poll_fd_init (&sink->client);
+
+  /* accept the next client */
+  gst_poll_fd_ctl_read (sink->fdset, &sink->server, TRUE);
+  sink->caps_sent = FALSE;
+}
+
+/* Removes the socket file of a previous run. Anything that isn't a socket
+ * is left alone, the path could point to some other file by mistake. */
+static gboolean
+gst_unix_fd_sink_remove_stale_socket (GstUnixFdSink * sink)
+{
+  struct stat st;
+
+  if (lstat (sink->socket_path, &st) < 0)
+    return errno == ENOENT;
+
+  if (!S_ISSOCK (st.st_mode)) {
+    errno = EEXIST;
+    return FALSE;
+  }
+
+  return unlink (sink->socket_path) == 0 || errno == ENOENT;
+}
+
+static gboolean
+gst_unix_fd_sink_start (GstBaseSink * bsink)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (bsink);
+  struct sockaddr_un addr;
+  struct stat st;
+  gint fd;
+
+  if (sink->socket_path == NULL ||
+      strlen (sink->socket_path) >= sizeof (addr.sun_path))
+    goto invalid_path;
+
+  if (!gst_unix_fd_sink_remove_stale_socket (sink))
+    goto path_in_use;
+
+  if ((sink->fdset = gst_poll_new (TRUE)) == NULL)
+    goto no_fdset;
+
+  fd = socket (AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    goto no_socket;
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, sink->socket_path);
+
+  if (bind (fd, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+    goto bind_failed;
+
+  if (lstat (sink->socket_path, &st) == 0) {
+    sink->bound_path = g_strdup (sink->socket_path);
+    sink->bound_dev = st.st_dev;
+    sink->bound_ino = st.st_ino;
+  }
+
+  if (listen (fd, 1) < 0)
+    goto bind_failed;
+
+  sink->server.fd = fd;
+  gst_poll_add_fd (sink->fdset, &sink->server);
+  gst_poll_fd_ctl_read (sink->fdset, &sink->server, TRUE);
+
+  sink->allocator = gst_memfd_allocator_new (GST_MEMFD_ALLOCATOR_FLAG_DEFAULT);
+  sink->next_id = 0;
+
+  GST_DEBUG_OBJECT (sink, "listening on %s", sink->socket_path);
+
+  return TRUE;
+
+  /* ERRORS */
+invalid_path:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, SETTINGS, (NULL),
+        ("Invalid socket path '%s'", GST_STR_NULL (sink->socket_path)));
+    return FALSE;
+  }
+path_in_use:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, SETTINGS, (NULL),
+        ("Can't use socket path %s: %s", sink->socket_path,
+            errno == EEXIST ? "not a socket" : g_strerror (errno)));
+    return FALSE;
+  }
+no_fdset:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, OPEN_READ_WRITE, (NULL),
+        GST_ERROR_SYSTEM);
+    return FALSE;
+  }
+no_socket:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, OPEN_READ_WRITE, (NULL),
+        GST_ERROR_SYSTEM);
+    gst_poll_free (sink->fdset);
+    sink->fdset = NULL;
+    return FALSE;
+  }
+bind_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, OPEN_READ_WRITE, (NULL),
+        ("Could not listen on %s: %s", sink->socket_path, g_strerror (errno)));
+    close (fd);
+    if (sink->bound_path) {
+      unlink (sink->bound_path);
+      g_free (sink->bound_path);
+      sink->bound_path = NULL;
+    }
+    gst_poll_free (sink->fdset);
+    sink->fdset = NULL;
+    return FALSE;
+  }
+}
+
+static gboolean
+gst_unix_fd_sink_stop (GstBaseSink * bsink)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (bsink);
+
+  gst_unix_fd_sink_close_client (sink);
+
+  if (sink->server.fd >= 0) {
+    close (sink->server.fd);
+    gst_poll_fd_init (&sink->server);
+  }
+  if (sink->bound_path) {
+    struct stat st;
+
+    /* only if it's still our socket */
+    if (lstat (sink->bound_path, &st) == 0 && S_ISSOCK (st.st_mode)
+        && st.st_dev == sink->bound_dev && st.st_ino == sink->bound_ino)
+      unlink (sink->bound_path);
+    g_free (sink->bound_path);
+    sink->bound_path = NULL;
+  }
+  if (sink->fdset) {
+    gst_poll_free (sink->fdset);
+    sink->fdset = NULL;
+  }
+
+  g_free (sink->caps);
+  sink->caps = NULL;
+  sink->caps_sent = FALSE;
+
+  if (sink->allocator) {
+    gst_object_unref (sink->allocator);
+    sink->allocator = NULL;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_unix_fd_sink_unlock (GstBaseSink * bsink)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (bsink);
+
+  GST_DEBUG_OBJECT (sink, "set to flushing");
+  gst_poll_set_flushing (sink->fdset, TRUE);
+
+  return TRUE;
+}
+
+static gboolean
+gst_unix_fd_sink_unlock_stop (GstBaseSink * bsink)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (bsink);
+
+  GST_DEBUG_OBJECT (sink, "unset flushing");
+  gst_poll_set_flushing (sink->fdset, FALSE);
+
+  return TRUE;
+}
+
+static gboolean
+gst_unix_fd_sink_set_caps (GstBaseSink * bsink, GstCaps * caps)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (bsink);
+
+  g_free (sink->caps);
+  sink->caps = gst_caps_to_string (caps);
+  sink->caps_sent = FALSE;
+
+  return TRUE;
+}
+
+static gboolean
+gst_unix_fd_sink_event (GstBaseSink * bsink, GstEvent * event)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (bsink);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_EOS && sink->client.fd >= 0) {
+    GST_DEBUG_OBJECT (sink, "sending EOS");
+    gst_unix_fd_send_message (sink->client.fd, GST_UNIX_FD_MESSAGE_EOS, NULL,
+        0, NULL, 0);
+  }
+
+  return GST_BASE_SINK_CLASS (parent_class)->event (bsink, event);
+}
+
+static gboolean
+gst_unix_fd_sink_propose_allocation (GstBaseSink * bsink, GstQuery * query)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (bsink);
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstVideoInfo info;
+  GstCaps *caps;
+  gboolean need_pool;
+
+  if (sink->allocator == NULL)
+    return FALSE;
+
+  gst_query_parse_allocation (query, &caps, &need_pool);
+  if (caps == NULL)
+    return FALSE;
+
+  /* raw video frames come from a pool of memfd memory that we get back when
+   * the receiver released them */
+  if (need_pool && gst_video_info_from_caps (&info, caps)) {
+    pool = gst_video_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, caps, info.size, 0, 0);
+    gst_buffer_pool_config_set_allocator (config, sink->allocator, NULL);
+    gst_buffer_pool_config_add_option (config,
+        GST_BUFFER_POOL_OPTION_VIDEO_META);
+    if (!gst_buffer_pool_set_config (pool, config)) {
+      gst_object_unref (pool);
+      return FALSE;
+    }
+    gst_query_add_allocation_pool (query, pool, info.size, 0, 0);
+    gst_object_unref (pool);
+  }
+
+  gst_query_add_allocation_param (query, sink->allocator, NULL);
+  gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+
+  return TRUE;
+}
+
+/* read the buffers the client released, returns FALSE when the client
+ * disconnected */
+static gboolean
+gst_unix_fd_sink_read_releases (GstUnixFdSink * sink)
+{
+  GstUnixFdMessageType type;
+  GstUnixFdReleasePayload release;
+  gint fds[GST_UNIX_FD_MAX_MEMORIES];
+  guint n_fds;
+  gsize size;
+  gssize res;
+
+  while (TRUE) {
+    res = gst_unix_fd_receive_message (sink->client.fd, &type, &release,
+        sizeof (release), &size, fds, &n_fds, FALSE);
+    if (res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      return TRUE;
+    if (res <= 0) {
+      GST_DEBUG_OBJECT (sink, "client disconnected: %s",
+          res < 0 ? g_strerror (errno) : "EOF");
+      return FALSE;
+    }
+
+    while (n_fds > 0)
+      close (fds[--n_fds]);
+
+    if (type != GST_UNIX_FD_MESSAGE_RELEASE || size != sizeof (release)) {
+      GST_WARNING_OBJECT (sink, "unexpected message %d", type);
+      continue;
+    }
+
+    GST_LOG_OBJECT (sink, "client released buffer %" G_GUINT64_FORMAT,
+        release.id);
+    g_hash_table_remove (sink->in_flight, &release.id);
+  }
+}
+
+/* wait until we have a client that can take another buffer */
+static GstFlowReturn
+gst_unix_fd_sink_wait_client (GstUnixFdSink * sink)
+{
+  while (TRUE) {
+    if (sink->client.fd >= 0) {
+      if (!gst_unix_fd_sink_read_releases (sink)) {
+        gst_unix_fd_sink_close_client (sink);
+        continue;
+      }
+      if (sink->max_buffers == 0 ||
+          g_hash_table_size (sink->in_flight) < sink->max_buffers)
+        return GST_FLOW_OK;
+
+      GST_LOG_OBJECT (sink, "%u buffers in flight, waiting",
+          g_hash_table_size (sink->in_flight));
+    } else {
+      GST_DEBUG_OBJECT (sink, "waiting for a client");
+    }
+
+    if (gst_poll_wait (sink->fdset, GST_CLOCK_TIME_NONE) < 0) {
+      if (errno == EBUSY)
+        return GST_FLOW_FLUSHING;
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+      goto poll_error;
+    }
+
+    if (sink->client.fd < 0 && gst_poll_fd_can_read (sink->fdset,
+            &sink->server)) {
+      gint fd;
+
+      fd = accept (sink->server.fd, NULL, NULL);
+      if (fd < 0) {
+        GST_WARNING_OBJECT (sink, "accept failed: %s", g_strerror (errno));
+        continue;
+      }
+
+      GST_DEBUG_OBJECT (sink, "client connected on fd %d", fd);
+      sink->client.fd = fd;
+      gst_poll_add_fd (sink->fdset, &sink->client);
+      gst_poll_fd_ctl_read (sink->fdset, &sink->client, TRUE);
+      /* one client at a time */
+      gst_poll_fd_ctl_read (sink->fdset, &sink->server, FALSE);
+    }
+  }
+
+  /* ERRORS */
+poll_error:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, READ, (NULL),
+        ("poll failed: %s", g_strerror (errno)));
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* copies @buffer into a single memfd memory */
+static GstBuffer *
+gst_unix_fd_sink_copy_buffer (GstUnixFdSink * sink, GstBuffer * buffer)
+{
+  GstBuffer *copy;
+  GstMemory *mem;
+  GstMapInfo map;
+  gsize size;
+
+  size = gst_buffer_get_size (buffer);
+
+  mem = gst_allocator_alloc (sink->allocator, size, NULL);
+  if (mem == NULL)
+    return NULL;
+
+  gst_memory_map (mem, &map, GST_MAP_WRITE);
+  gst_buffer_extract (buffer, 0, map.data, size);
+  gst_memory_unmap (mem, &map);
+
+  copy = gst_buffer_new ();
+  gst_buffer_append_memory (copy, mem);
+  gst_buffer_copy_into (copy, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
+
+  return copy;
+}
+
+static GstClockTime
+to_running_time (GstUnixFdSink * sink, GstClockTime ts)
+{
+  GstSegment *segment = &GST_BASE_SINK_CAST (sink)->segment;
+
+  if (!GST_CLOCK_TIME_IS_VALID (ts) || segment->format != GST_FORMAT_TIME)
+    return ts;
+
+  return gst_segment_to_running_time (segment, GST_FORMAT_TIME, ts);
+}
+
+static GstFlowReturn
+gst_unix_fd_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
+{
+  GstUnixFdSink *sink = GST_UNIX_FD_SINK (bsink);
+  GstUnixFdBufferPayload payload;
+  gint fds[GST_UNIX_FD_MAX_MEMORIES];
+  GstVideoMeta *vmeta;
+  GstBuffer *send;
+  GstFlowReturn ret;
+  gboolean copy;
+  guint i, n;
+
+  if (gst_buffer_get_size (buffer) == 0)
+    return GST_FLOW_OK;
+
+  if ((ret = gst_unix_fd_sink_wait_client (sink)) != GST_FLOW_OK)
+    return ret;
+
+  if (!sink->caps_sent && sink->caps) {
+    GST_DEBUG_OBJECT (sink, "sending caps %s", sink->caps);
+    if (gst_unix_fd_send_message (sink->client.fd, GST_UNIX_FD_MESSAGE_CAPS,
+            sink->caps, strlen (sink->caps) + 1, NULL, 0) < 0)
+      goto send_failed;
+    sink->caps_sent = TRUE;
+  }
+
+  /* pass the memory as is when we can, otherwise copy it once */
+  n = gst_buffer_n_memory (buffer);
+  copy = n > GST_UNIX_FD_MAX_MEMORIES;
+  for (i = 0; i < n && !copy; i++)
+    copy = !gst_is_fd_memory (gst_buffer_peek_memory (buffer, i));
+
+  if (copy) {
+    GST_LOG_OBJECT (sink, "copying buffer into fd memory");
+    if (sink->allocator == NULL ||
+        (send = gst_unix_fd_sink_copy_buffer (sink, buffer)) == NULL)
+      goto no_memory;
+  } else {
+    send = gst_buffer_ref (buffer);
+  }
+
+  memset (&payload, 0, sizeof (payload));
+  payload.id = sink->next_id++;
+  payload.pts = to_running_time (sink, GST_BUFFER_PTS (send));
+  payload.dts = to_running_time (sink, GST_BUFFER_DTS (send));
+  payload.duration = GST_BUFFER_DURATION (send);
+  payload.offset = GST_BUFFER_OFFSET (send);
+  payload.offset_end = GST_BUFFER_OFFSET_END (send);
+  payload.flags = GST_BUFFER_FLAGS (send);
+
+  if ((vmeta = gst_buffer_get_video_meta (send))) {
+    payload.has_video_meta = TRUE;
+    payload.video_flags = vmeta->flags;
+    payload.video_format = vmeta->format;
+    payload.video_width = vmeta->width;
+    payload.video_height = vmeta->height;
+    payload.video_n_planes = vmeta->n_planes;
+    for (i = 0; i < vmeta->n_planes; i++) {
+      payload.video_offset[i] = vmeta->offset[i];
+      payload.video_stride[i] = vmeta->stride[i];
+    }
+  }
+
+  n = gst_buffer_n_memory (send);
+  payload.n_memory = n;
+  for (i = 0; i < n; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (send, i);
+
+    payload.memories[i].offset = mem->offset;
+    payload.memories[i].size = mem->size;
+    payload.memories[i].maxsize = mem->maxsize;
+    fds[i] = gst_fd_memory_get_fd (mem);
+  }
+
+  GST_LOG_OBJECT (sink, "sending buffer %" G_GUINT64_FORMAT " with %u fds",
+      payload.id, n);
+
+  if (gst_unix_fd_send_message (sink->client.fd, GST_UNIX_FD_MESSAGE_BUFFER,
+          &payload, sizeof (payload), fds, n) < 0) {
+    gst_buffer_unref (send);
+    goto send_failed;
+  }
+
+  /* keep the buffer out of its pool until the client released it */
+  g_hash_table_insert (sink->in_flight, g_memdup (&payload.id,
+          sizeof (payload.id)), send);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+send_failed:
+  {
+    if (errno == EPIPE || errno == ECONNRESET) {
+      /* drop the buffer and wait for the next client */
+      GST_DEBUG_OBJECT (sink, "client went away");
+      gst_unix_fd_sink_close_client (sink);
+      return GST_FLOW_OK;
+    }
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
+        ("Error while sending data to client: %s", g_strerror (errno)));
+    return GST_FLOW_ERROR;
+  }
+no_memory:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL),
+        ("Could not allocate fd memory"));
+    return GST_FLOW_ERROR;
+  }
+}
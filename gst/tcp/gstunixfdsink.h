@@ -0,0 +1,83 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GST_UNIX_FD_SINK_H__
+#define __GST_UNIX_FD_SINK_H__
+
+#include <gst/gst.h>
+#include <gst/base/gstbasesink.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_UNIX_FD_SINK \
+  (gst_unix_fd_sink_get_type())
+#define GST_UNIX_FD_SINK(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_UNIX_FD_SINK,GstUnixFdSink))
+#define GST_UNIX_FD_SINK_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_UNIX_FD_SINK,GstUnixFdSinkClass))
+#define GST_IS_UNIX_FD_SINK(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_UNIX_FD_SINK))
+#define GST_IS_UNIX_FD_SINK_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_UNIX_FD_SINK))
+
+typedef struct _GstUnixFdSink GstUnixFdSink;
+typedef struct _GstUnixFdSinkClass GstUnixFdSinkClass;
+
+/**
+ * GstUnixFdSink:
+ *
+ * Opaque data structure.
+ */
+struct _GstUnixFdSink {
+  GstBaseSink element;
+
+  /* properties */
+  gchar *socket_path;
+  guint max_buffers;
+
+  GstPoll *fdset;
+  GstPollFD server;
+  GstPollFD client;
+
+  /* the socket file we created, only that one is removed again */
+  gchar *bound_path;
+  guint64 bound_dev;
+  guint64 bound_ino;
+
+  /* caps to send to the next client */
+  gchar *caps;
+  gboolean caps_sent;
+
+  /* buffers the client still uses, by id */
+  GHashTable *in_flight;
+  guint64 next_id;
+
+  GstAllocator *allocator;
+};
+
+struct _GstUnixFdSinkClass {
+  GstBaseSinkClass parent_class;
+};
+
+GType gst_unix_fd_sink_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_UNIX_FD_SINK_H__ */
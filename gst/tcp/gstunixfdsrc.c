@@ -0,0 +1,565 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-unixfdsrc
+ * @title: unixfdsrc
+ * @see_also: #unixfdsink
+ *
+ * unixfdsrc receives buffers from a unixfdsink in another process. The
+ * memory of the buffers is the memory of the sender, mapped from the file
+ * descriptors it passed, no data is copied.
+ *
+ * The timestamps of the buffers are the running time of the sender. When all
+ * memory of a buffer is freed, the sender is told that it can reuse the
+ * buffer.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 unixfdsrc socket-path=/tmp/video ! videoconvert ! autovideosink
+ * ]|
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <gst/gst-i18n-plugin.h>
+#include <gst/allocators/allocators.h>
+#include <gst/video/video.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "gstunixfd.h"
+#include "gstunixfdsrc.h"
+
+GST_DEBUG_CATEGORY_STATIC (unixfdsrc_debug);
+#define GST_CAT_DEFAULT (unixfdsrc_debug)
+
+#define DEFAULT_SOCKET_PATH     UNIX_FD_DEFAULT_SOCKET_PATH
+
+enum
+{
+  PROP_0,
+  PROP_SOCKET_PATH
+};
+
+/* the socket to the sender, kept open until the last buffer is released */
+struct _GstUnixFdConnection
+{
+  gint refcount;
+  gint fd;
+};
+
+/* shared by the memories of one buffer */
+typedef struct
+{
+  GstUnixFdConnection *connection;
+  guint64 id;
+  gint n_memory;
+} GstUnixFdRelease;
+
+static GQuark release_quark;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static void gst_unix_fd_src_finalize (GObject * gobject);
+static void gst_unix_fd_src_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_unix_fd_src_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static gboolean gst_unix_fd_src_start (GstBaseSrc * bsrc);
+static gboolean gst_unix_fd_src_stop (GstBaseSrc * bsrc);
+static gboolean gst_unix_fd_src_unlock (GstBaseSrc * bsrc);
+static gboolean gst_unix_fd_src_unlock_stop (GstBaseSrc * bsrc);
+static GstFlowReturn gst_unix_fd_src_create (GstPushSrc * psrc,
+    GstBuffer ** outbuf);
+
+#define gst_unix_fd_src_parent_class parent_class
+G_DEFINE_TYPE (GstUnixFdSrc, gst_unix_fd_src, GST_TYPE_PUSH_SRC);
+
+static void
+gst_unix_fd_src_class_init (GstUnixFdSrcClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstElementClass *gstelement_class;
+  GstBaseSrcClass *gstbasesrc_class;
+  GstPushSrcClass *gstpush_src_class;
+
+  gobject_class = (GObjectClass *) klass;
+  gstelement_class = (GstElementClass *) klass;
+  gstbasesrc_class = (GstBaseSrcClass *) klass;
+  gstpush_src_class = (GstPushSrcClass *) klass;
+
+  gobject_class->set_property = gst_unix_fd_src_set_property;
+  gobject_class->get_property = gst_unix_fd_src_get_property;
+  gobject_class->finalize = gst_unix_fd_src_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_SOCKET_PATH,
+      g_param_spec_string ("socket-path", "Socket path",
+          "Path of the unix socket to connect to", DEFAULT_SOCKET_PATH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "Unix fd source", "Source/Network",
+      "Receive buffers as file descriptors from another process over a unix "
+      "socket", "LG Electronics, Inc.");
+
+  gstbasesrc_class->start = GST_DEBUG_FUNCPTR (gst_unix_fd_src_start);
+  gstbasesrc_class->stop = GST_DEBUG_FUNCPTR (gst_unix_fd_src_stop);
+  gstbasesrc_class->unlock = GST_DEBUG_FUNCPTR (gst_unix_fd_src_unlock);
+  gstbasesrc_class->unlock_stop =
+      GST_DEBUG_FUNCPTR (gst_unix_fd_src_unlock_stop);
+
+  gstpush_src_class->create = GST_DEBUG_FUNCPTR (gst_unix_fd_src_create);
+
+  GST_DEBUG_CATEGORY_INIT (unixfdsrc_debug, "unixfdsrc", 0,
+      "unix fd source");
+
+  release_quark = g_quark_from_static_string ("GstUnixFdRelease");
+}
+
+static void
+gst_unix_fd_src_init (GstUnixFdSrc * this)
+{
+  this->socket_path = g_strdup (DEFAULT_SOCKET_PATH);
+
+  gst_poll_fd_init (&this->socket);
+
+  gst_base_src_set_format (GST_BASE_SRC (this), GST_FORMAT_TIME);
+}
+
+static void
+gst_unix_fd_src_finalize (GObject * gobject)
+{
+  GstUnixFdSrc *this = GST_UNIX_FD_SRC (gobject);
+
+  g_free (this->socket_path);
+
+  G_OBJECT_CLASS (parent_class)->finalize (gobject);
+}
+
+static void
+gst_unix_fd_src_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstUnixFdSrc *src = GST_UNIX_FD_SRC (object);
+
+  switch (prop_id) {
+    case PROP_SOCKET_PATH:
+      g_free (src->socket_path);
+      src->socket_path = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_unix_fd_src_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstUnixFdSrc *src = GST_UNIX_FD_SRC (object);
+
+  switch (prop_id) {
+    case PROP_SOCKET_PATH:
+      g_value_set_string (value, src->socket_path);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static GstUnixFdConnection *
+gst_unix_fd_connection_new (gint fd)
+{
+  GstUnixFdConnection *connection;
+
+  connection = g_slice_new (GstUnixFdConnection);
+  connection->refcount = 1;
+  connection->fd = fd;
+
+  return connection;
+}
+
+static GstUnixFdConnection *
+gst_unix_fd_connection_ref (GstUnixFdConnection * connection)
+{
+  g_atomic_int_inc (&connection->refcount);
+
+  return connection;
+}
+
+static void
+gst_unix_fd_connection_unref (GstUnixFdConnection * connection)
+{
+  if (g_atomic_int_dec_and_test (&connection->refcount)) {
+    close (connection->fd);
+    g_slice_free (GstUnixFdConnection, connection);
+  }
+}
+
+/* called when a memory of the buffer is freed, from any thread */
+static void
+gst_unix_fd_release_free (GstUnixFdRelease * release)
+{
+  GstUnixFdReleasePayload payload;
+
+  if (!g_atomic_int_dec_and_test (&release->n_memory))
+    return;
+
+  GST_LOG ("releasing buffer %" G_GUINT64_FORMAT, release->id);
+
+  /* a failure means the sender is gone and doesn't care anymore */
+  payload.id = release->id;
+  if (gst_unix_fd_send_message (release->connection->fd,
+          GST_UNIX_FD_MESSAGE_RELEASE, &payload, sizeof (payload), NULL,
+          0) < 0)
+    GST_DEBUG ("could not release buffer %" G_GUINT64_FORMAT ": %s",
+        release->id, g_strerror (errno));
+
+  gst_unix_fd_connection_unref (release->connection);
+  g_slice_free (GstUnixFdRelease, release);
+}
+
+static gboolean
+gst_unix_fd_src_start (GstBaseSrc * bsrc)
+{
+  GstUnixFdSrc *src = GST_UNIX_FD_SRC (bsrc);
+  struct sockaddr_un addr;
+  gint fd;
+
+  if (src->socket_path == NULL ||
+      strlen (src->socket_path) >= sizeof (addr.sun_path))
+    goto invalid_path;
+
+  if ((src->fdset = gst_poll_new (TRUE)) == NULL)
+    goto no_fdset;
+
+  fd = socket (AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    goto no_socket;
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, src->socket_path);
+
+  if (connect (fd, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+    goto connect_failed;
+
+  src->socket.fd = fd;
+  gst_poll_add_fd (src->fdset, &src->socket);
+  gst_poll_fd_ctl_read (src->fdset, &src->socket, TRUE);
+
+  src->connection = gst_unix_fd_connection_new (fd);
+  src->allocator = gst_fd_allocator_new ();
+  src->message = g_malloc (GST_UNIX_FD_MAX_MESSAGE_SIZE);
+
+  GST_DEBUG_OBJECT (src, "connected to %s", src->socket_path);
+
+  return TRUE;
+
+  /* ERRORS */
+invalid_path:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, SETTINGS, (NULL),
+        ("Invalid socket path '%s'", GST_STR_NULL (src->socket_path)));
+    return FALSE;
+  }
+no_fdset:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, OPEN_READ_WRITE, (NULL),
+        GST_ERROR_SYSTEM);
+    return FALSE;
+  }
+no_socket:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, OPEN_READ_WRITE, (NULL),
+        GST_ERROR_SYSTEM);
+    gst_poll_free (src->fdset);
+    src->fdset = NULL;
+    return FALSE;
+  }
+connect_failed:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, OPEN_READ, (NULL),
+        ("Could not connect to %s: %s", src->socket_path, g_strerror (errno)));
+    close (fd);
+    gst_poll_free (src->fdset);
+    src->fdset = NULL;
+    return FALSE;
+  }
+}
+
+static gboolean
+gst_unix_fd_src_stop (GstBaseSrc * bsrc)
+{
+  GstUnixFdSrc *src = GST_UNIX_FD_SRC (bsrc);
+
+  if (src->connection) {
+    /* buffers still in use downstream keep the socket open to release them */
+    gst_poll_remove_fd (src->fdset, &src->socket);
+    gst_poll_fd_init (&src->socket);
+    gst_unix_fd_connection_unref (src->connection);
+    src->connection = NULL;
+  }
+  if (src->fdset) {
+    gst_poll_free (src->fdset);
+    src->fdset = NULL;
+  }
+  if (src->allocator) {
+    gst_object_unref (src->allocator);
+    src->allocator = NULL;
+  }
+
+  g_free (src->message);
+  src->message = NULL;
+
+  return TRUE;
+}
+
+static gboolean
+gst_unix_fd_src_unlock (GstBaseSrc * bsrc)
+{
+  GstUnixFdSrc *src = GST_UNIX_FD_SRC (bsrc);
+
+  GST_DEBUG_OBJECT (src, "set to flushing");
+  gst_poll_set_flushing (src->fdset, TRUE);
+
+  return TRUE;
+}
+
+static gboolean
+gst_unix_fd_src_unlock_stop (GstBaseSrc * bsrc)
+{
+  GstUnixFdSrc *src = GST_UNIX_FD_SRC (bsrc);
+
+  GST_DEBUG_OBJECT (src, "unset flushing");
+  gst_poll_set_flushing (src->fdset, FALSE);
+
+  return TRUE;
+}
+
+static gboolean
+gst_unix_fd_src_set_caps_string (GstUnixFdSrc * src, gchar * str, gsize size)
+{
+  GstCaps *caps;
+  gboolean res;
+
+  if (size == 0 || str[size - 1] != '\0')
+    return FALSE;
+
+  if ((caps = gst_caps_from_string (str)) == NULL)
+    return FALSE;
+
+  GST_DEBUG_OBJECT (src, "received caps %" GST_PTR_FORMAT, caps);
+  res = gst_base_src_set_caps (GST_BASE_SRC (src), caps);
+  gst_caps_unref (caps);
+
+  return res;
+}
+
+/* wraps the received fds in a buffer, takes ownership of @fds */
+static GstBuffer *
+gst_unix_fd_src_make_buffer (GstUnixFdSrc * src,
+    const GstUnixFdBufferPayload * payload, gint * fds, guint n_fds)
+{
+  GstUnixFdRelease *release;
+  GstBuffer *buffer;
+  guint i;
+
+  if (payload->n_memory == 0 || payload->n_memory != n_fds)
+    goto invalid;
+
+  for (i = 0; i < n_fds; i++) {
+    const GstUnixFdMemoryPayload *m = &payload->memories[i];
+    struct stat st;
+
+    if (m->maxsize == 0 || m->offset > m->maxsize
+        || m->size > m->maxsize - m->offset)
+      goto invalid;
+
+    /* the whole maxsize gets mapped, touching pages past the end of the
+     * file would raise SIGBUS */
+    if (fstat (fds[i], &st) < 0 || st.st_size < 0
+        || m->maxsize > (guint64) st.st_size) {
+      GST_WARNING_OBJECT (src, "memory %u of %" G_GUINT64_FORMAT " bytes "
+          "doesn't fit in its fd", i, m->maxsize);
+      goto invalid;
+    }
+  }
+
+  release = g_slice_new (GstUnixFdRelease);
+  release->connection = gst_unix_fd_connection_ref (src->connection);
+  release->id = payload->id;
+  release->n_memory = n_fds;
+
+  buffer = gst_buffer_new ();
+  for (i = 0; i < n_fds; i++) {
+    const GstUnixFdMemoryPayload *m = &payload->memories[i];
+    GstMemory *mem;
+
+    mem = gst_fd_allocator_alloc (src->allocator, fds[i], m->maxsize,
+        GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+    gst_memory_resize (mem, m->offset, m->size);
+    gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (mem), release_quark,
+        release, (GDestroyNotify) gst_unix_fd_release_free);
+    gst_buffer_append_memory (buffer, mem);
+  }
+
+  GST_BUFFER_PTS (buffer) = payload->pts;
+  GST_BUFFER_DTS (buffer) = payload->dts;
+  GST_BUFFER_DURATION (buffer) = payload->duration;
+  GST_BUFFER_OFFSET (buffer) = payload->offset;
+  GST_BUFFER_OFFSET_END (buffer) = payload->offset_end;
+  GST_BUFFER_FLAGS (buffer) = payload->flags & ~GST_BUFFER_FLAG_TAG_MEMORY;
+
+  if (payload->has_video_meta && payload->video_n_planes > 0
+      && payload->video_n_planes <= GST_VIDEO_MAX_PLANES) {
+    gsize offset[GST_VIDEO_MAX_PLANES] = { 0, };
+    gint stride[GST_VIDEO_MAX_PLANES] = { 0, };
+
+    for (i = 0; i < payload->video_n_planes; i++) {
+      offset[i] = payload->video_offset[i];
+      stride[i] = payload->video_stride[i];
+    }
+    gst_buffer_add_video_meta_full (buffer, payload->video_flags,
+        payload->video_format, payload->video_width, payload->video_height,
+        payload->video_n_planes, offset, stride);
+  }
+
+  return buffer;
+
+  /* ERRORS */
+invalid:
+  {
+    GST_WARNING_OBJECT (src, "invalid buffer with %u memories and %u fds",
+        payload->n_memory, n_fds);
+    while (n_fds > 0)
+      close (fds[--n_fds]);
+    return NULL;
+  }
+}
+
+static GstFlowReturn
+gst_unix_fd_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
+{
+  GstUnixFdSrc *src = GST_UNIX_FD_SRC (psrc);
+  GstUnixFdMessageType type;
+  gint fds[GST_UNIX_FD_MAX_MEMORIES];
+  guint n_fds;
+  gsize size;
+  gssize res;
+
+  while (TRUE) {
+    if (gst_poll_wait (src->fdset, GST_CLOCK_TIME_NONE) < 0) {
+      if (errno == EBUSY)
+        return GST_FLOW_FLUSHING;
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+      goto poll_error;
+    }
+
+    res = gst_unix_fd_receive_message (src->socket.fd, &type, src->message,
+        GST_UNIX_FD_MAX_MESSAGE_SIZE, &size, fds, &n_fds, FALSE);
+    if (res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      continue;
+    if (res == 0)
+      goto closed;
+    if (res < 0)
+      goto read_error;
+
+    switch (type) {
+      case GST_UNIX_FD_MESSAGE_CAPS:
+        while (n_fds > 0)
+          close (fds[--n_fds]);
+        if (!gst_unix_fd_src_set_caps_string (src, src->message, size))
+          goto caps_error;
+        break;
+      case GST_UNIX_FD_MESSAGE_BUFFER:
+        if (size != sizeof (GstUnixFdBufferPayload)) {
+          while (n_fds > 0)
+            close (fds[--n_fds]);
+          goto invalid_message;
+        }
+        *outbuf = gst_unix_fd_src_make_buffer (src,
+            (GstUnixFdBufferPayload *) src->message, fds, n_fds);
+        if (*outbuf == NULL)
+          goto invalid_message;
+
+        GST_LOG_OBJECT (src, "received buffer %" GST_PTR_FORMAT, *outbuf);
+        return GST_FLOW_OK;
+      case GST_UNIX_FD_MESSAGE_EOS:
+        GST_DEBUG_OBJECT (src, "received EOS");
+        while (n_fds > 0)
+          close (fds[--n_fds]);
+        return GST_FLOW_EOS;
+      default:
+        GST_WARNING_OBJECT (src, "unexpected message %d", type);
+        while (n_fds > 0)
+          close (fds[--n_fds]);
+        break;
+    }
+  }
+
+  /* ERRORS */
+poll_error:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("poll failed: %s", g_strerror (errno)));
+    return GST_FLOW_ERROR;
+  }
+closed:
+  {
+    GST_DEBUG_OBJECT (src, "sender closed the connection");
+    return GST_FLOW_EOS;
+  }
+read_error:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("Error while receiving data: %s", g_strerror (errno)));
+    return GST_FLOW_ERROR;
+  }
+caps_error:
+  {
+    GST_ELEMENT_ERROR (src, CORE, NEGOTIATION, (NULL),
+        ("Received invalid caps"));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+invalid_message:
+  {
+    GST_ELEMENT_ERROR (src, STREAM, DECODE, (NULL),
+        ("Received an invalid buffer"));
+    return GST_FLOW_ERROR;
+  }
+}
@@ -0,0 +1,73 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GST_UNIX_FD_SRC_H__
+#define __GST_UNIX_FD_SRC_H__
+
+#include <gst/gst.h>
+#include <gst/base/gstpushsrc.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_UNIX_FD_SRC \
+  (gst_unix_fd_src_get_type())
+#define GST_UNIX_FD_SRC(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_UNIX_FD_SRC,GstUnixFdSrc))
+#define GST_UNIX_FD_SRC_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_UNIX_FD_SRC,GstUnixFdSrcClass))
+#define GST_IS_UNIX_FD_SRC(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_UNIX_FD_SRC))
+#define GST_IS_UNIX_FD_SRC_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_UNIX_FD_SRC))
+
+typedef struct _GstUnixFdSrc GstUnixFdSrc;
+typedef struct _GstUnixFdSrcClass GstUnixFdSrcClass;
+typedef struct _GstUnixFdConnection GstUnixFdConnection;
+
+/**
+ * GstUnixFdSrc:
+ *
+ * Opaque data structure.
+ */
+struct _GstUnixFdSrc {
+  GstPushSrc element;
+
+  /* properties */
+  gchar *socket_path;
+
+  GstPoll *fdset;
+  GstPollFD socket;
+
+  /* shared with the buffers we pushed, they release through it */
+  GstUnixFdConnection *connection;
+
+  GstAllocator *allocator;
+  gchar *message;
+};
+
+struct _GstUnixFdSrcClass {
+  GstPushSrcClass parent_class;
+};
+
+GType gst_unix_fd_src_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_UNIX_FD_SRC_H__ */
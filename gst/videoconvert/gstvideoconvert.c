@@ -373,7 +373,8 @@ gst_video_convert_filter_meta (GstBaseTransform * trans, GstQuery * query,
 {
   /* This element cannot passthrough the crop meta, because it would convert the
    * wrong sub-region of the image, and worst, our output image may not be large
-   * enough for the crop to be applied later */
+   * enough for the crop to be applied later. We apply it ourselves instead and
+   * propose it in propose_allocation. */
   if (api == GST_VIDEO_CROP_META_API_TYPE)
     return FALSE;
 
@@ -381,6 +382,49 @@ gst_video_convert_filter_meta (GstBaseTransform * trans, GstQuery * query,
   return TRUE;
 }
 
+static gboolean
+gst_video_convert_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  /* passthrough, downstream answered and decides about the crop meta */
+  if (decide_query == NULL)
+    return TRUE;
+
+  /* we convert from the cropped region, the crop meta needs the video meta to
+   * describe the whole frame */
+  if (!gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL))
+    gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+  gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE, NULL);
+
+  return TRUE;
+}
+
+/* The crop meta is applied when the caps have the size of the cropped region,
+ * the buffer then has a video meta with the size of the whole frame. */
+static GstVideoCropMeta *
+gst_video_convert_get_crop_meta (GstVideoFilter * filter, GstBuffer * buffer)
+{
+  GstVideoCropMeta *crop;
+
+  crop = gst_buffer_get_video_crop_meta (buffer);
+  if (crop == NULL)
+    return NULL;
+
+  if (crop->width != GST_VIDEO_INFO_WIDTH (&filter->in_info) ||
+      crop->height != GST_VIDEO_INFO_HEIGHT (&filter->in_info)) {
+    GST_DEBUG_OBJECT (filter, "ignoring crop meta %ux%u, caps are %dx%d",
+        crop->width, crop->height, GST_VIDEO_INFO_WIDTH (&filter->in_info),
+        GST_VIDEO_INFO_HEIGHT (&filter->in_info));
+    return NULL;
+  }
+
+  return crop;
+}
+
 /* The caps can be transformed into any other caps with format info removed.
  * However, we should prefer passthrough, so if passthrough is possible,
  * put it first in the list. */
@@ -419,6 +463,10 @@ gst_video_convert_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
     /* don't copy colorspace specific metadata, FIXME, we need a MetaTransform
      * for the colorspace metadata. */
     ret = FALSE;
+  } else if (info->api == GST_VIDEO_CROP_META_API_TYPE &&
+      gst_video_convert_get_crop_meta (GST_VIDEO_FILTER_CAST (trans), inbuf)) {
+    /* the output only contains the cropped region */
+    ret = FALSE;
   } else {
     /* copy other metadata */
     ret = TRUE;
@@ -540,6 +588,8 @@ gst_video_convert_class_init (GstVideoConvertClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_convert_filter_meta);
   gstbasetransform_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_video_convert_transform_meta);
+  gstbasetransform_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_propose_allocation);
 
   gstbasetransform_class->passthrough_on_same_caps = TRUE;
 
@@ -703,6 +753,8 @@ gst_video_convert_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
 {
   GstVideoConvert *space;
+  GstVideoCropMeta *crop;
+  GstVideoFrame cropped;
 
   space = GST_VIDEO_CONVERT_CAST (filter);
 
@@ -711,6 +763,18 @@ gst_video_convert_transform_frame (GstVideoFilter * filter,
       GST_VIDEO_INFO_NAME (&filter->in_info),
       GST_VIDEO_INFO_NAME (&filter->out_info));
 
+  /* convert straight from the cropped region */
+  crop = gst_video_convert_get_crop_meta (filter, in_frame->buffer);
+  if (crop) {
+    cropped = *in_frame;
+    if (gst_video_frame_crop (&cropped, crop->x, crop->y, crop->width,
+            crop->height))
+      in_frame = &cropped;
+    else
+      GST_WARNING_OBJECT (filter, "can't apply crop meta %ux%u at %u,%u",
+          crop->width, crop->height, crop->x, crop->y);
+  }
+
   gst_video_converter_frame (space->convert, in_frame, out_frame);
 
   return GST_FLOW_OK;
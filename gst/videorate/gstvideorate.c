@@ -57,6 +57,12 @@
  * certain factor. It must not be confused with framerate. Think of rate as
  * speed and framerate as flow.
  *
+ * By default every duplicated frame is pushed as a buffer of its own. The
+ * #GstVideoRate:duplication-mode property can be set to push the duplicates
+ * of a frame together with it in one buffer list, or to only extend the
+ * duration of the repeated frame for downstream elements that handle frame
+ * repetition themselves, for example sinks showing a frame until the next one.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 -v uridecodebin uri=file:///path/to/video.ogg ! videoconvert ! videoscale ! videorate ! video/x-raw,framerate=15/1 ! autovideosink
@@ -99,6 +105,7 @@ enum
 #define DEFAULT_AVERAGE_PERIOD  0
 #define DEFAULT_MAX_RATE        G_MAXINT
 #define DEFAULT_RATE            1.0
+#define DEFAULT_DUPLICATION_MODE GST_VIDEO_RATE_DUPLICATION_MODE_COPY
 
 enum
 {
@@ -113,9 +120,34 @@ enum
   PROP_DROP_ONLY,
   PROP_AVERAGE_PERIOD,
   PROP_MAX_RATE,
-  PROP_RATE
+  PROP_RATE,
+  PROP_DUPLICATION_MODE
 };
 
+#define GST_TYPE_VIDEO_RATE_DUPLICATION_MODE \
+  (gst_video_rate_duplication_mode_get_type ())
+static GType
+gst_video_rate_duplication_mode_get_type (void)
+{
+  static GType video_rate_duplication_mode_type = 0;
+
+  static const GEnumValue video_rate_duplication_modes[] = {
+    {GST_VIDEO_RATE_DUPLICATION_MODE_COPY, "Push every duplicate", "copy"},
+    {GST_VIDEO_RATE_DUPLICATION_MODE_LIST,
+        "Push the duplicates in a buffer list", "list"},
+    {GST_VIDEO_RATE_DUPLICATION_MODE_TIMESTAMP,
+        "Extend the duration of the repeated frame", "timestamp"},
+    {0, NULL, NULL},
+  };
+
+  if (!video_rate_duplication_mode_type) {
+    video_rate_duplication_mode_type =
+        g_enum_register_static ("GstVideoRateDuplicationMode",
+        video_rate_duplication_modes);
+  }
+  return video_rate_duplication_mode_type;
+}
+
 static GstStaticPadTemplate gst_video_rate_src_template =
     GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -275,6 +307,23 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           DEFAULT_RATE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstVideoRate:duplication-mode:
+   *
+   * How duplicated frames are pushed downstream. In the list mode the
+   * duplicates of a frame are pushed together with it in one buffer list. In
+   * the timestamp mode no duplicates are produced, the duration and the
+   * offset end of the repeated frame cover all of its repetitions instead.
+   *
+   * Since: 1.16
+   */
+  g_object_class_install_property (object_class, PROP_DUPLICATION_MODE,
+      g_param_spec_enum ("duplication-mode", "Duplication mode",
+          "How duplicated frames are pushed downstream",
+          GST_TYPE_VIDEO_RATE_DUPLICATION_MODE, DEFAULT_DUPLICATION_MODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -599,6 +648,10 @@ gst_video_rate_reset (GstVideoRate * videorate)
   videorate->average = 0;
   videorate->force_variable_rate = FALSE;
   gst_video_rate_swap_prev (videorate, NULL, 0);
+  if (videorate->pending) {
+    gst_buffer_list_unref (videorate->pending);
+    videorate->pending = NULL;
+  }
 
   gst_segment_init (&videorate->segment, GST_FORMAT_TIME);
 }
@@ -614,6 +667,7 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->average_period_set = DEFAULT_AVERAGE_PERIOD;
   videorate->max_rate = DEFAULT_MAX_RATE;
   videorate->rate = DEFAULT_RATE;
+  videorate->duplication_mode = DEFAULT_DUPLICATION_MODE;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -623,6 +677,56 @@ gst_video_rate_init (GstVideoRate * videorate)
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (videorate), TRUE);
 }
 
+/* whether a duplicate is merged into the frame queued before it */
+static gboolean
+gst_video_rate_extends_pending (GstVideoRate * videorate, gboolean duplicate)
+{
+  return duplicate && videorate->pending != NULL &&
+      videorate->duplication_mode == GST_VIDEO_RATE_DUPLICATION_MODE_TIMESTAMP;
+}
+
+/* @outbuf: (transfer full) needs to be writable */
+static void
+gst_video_rate_queue_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
+    gboolean duplicate)
+{
+  GstBuffer *last;
+
+  if (!gst_video_rate_extends_pending (videorate, duplicate)) {
+    if (videorate->pending == NULL)
+      videorate->pending = gst_buffer_list_new ();
+    gst_buffer_list_add (videorate->pending, outbuf);
+    return;
+  }
+
+  last = gst_buffer_list_get_writable (videorate->pending,
+      gst_buffer_list_length (videorate->pending) - 1);
+
+  /* the repeated frame now lasts until the end of its duplicate, the
+   * duplicate comes first in reverse playback */
+  if (GST_BUFFER_PTS_IS_VALID (last) && GST_BUFFER_PTS_IS_VALID (outbuf) &&
+      GST_BUFFER_DURATION_IS_VALID (outbuf)) {
+    GstClockTime start, stop;
+
+    start = MIN (GST_BUFFER_PTS (last), GST_BUFFER_PTS (outbuf));
+    stop = GST_BUFFER_PTS (outbuf) + GST_BUFFER_DURATION (outbuf);
+    if (GST_BUFFER_DURATION_IS_VALID (last))
+      stop = MAX (stop, GST_BUFFER_PTS (last) + GST_BUFFER_DURATION (last));
+
+    GST_BUFFER_PTS (last) = start;
+    GST_BUFFER_DURATION (last) = stop - start;
+  } else {
+    GST_BUFFER_DURATION (last) = GST_CLOCK_TIME_NONE;
+  }
+  GST_BUFFER_OFFSET_END (last) = GST_BUFFER_OFFSET_END (outbuf);
+
+  GST_LOG_OBJECT (videorate, "extended buffer to %" GST_TIME_FORMAT
+      " duration %" GST_TIME_FORMAT, GST_TIME_ARGS (GST_BUFFER_PTS (last)),
+      GST_TIME_ARGS (GST_BUFFER_DURATION (last)));
+
+  gst_buffer_unref (outbuf);
+}
+
 /* @outbuf: (transfer full) needs to be writable */
 static GstFlowReturn
 gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
@@ -696,11 +800,42 @@ gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
       "old is best, dup, pushing buffer outgoing ts %" GST_TIME_FORMAT,
       GST_TIME_ARGS (push_ts));
 
-  res = gst_pad_push (GST_BASE_TRANSFORM_SRC_PAD (videorate), outbuf);
+  if (videorate->duplication_mode == GST_VIDEO_RATE_DUPLICATION_MODE_COPY ||
+      videorate->drop_only) {
+    res = gst_pad_push (GST_BASE_TRANSFORM_SRC_PAD (videorate), outbuf);
+  } else {
+    gst_video_rate_queue_buffer (videorate, outbuf, duplicate);
+    res = GST_FLOW_OK;
+  }
 
   return res;
 }
 
+/* push the frames queued by gst_video_rate_queue_buffer() */
+static GstFlowReturn
+gst_video_rate_push_pending (GstVideoRate * videorate)
+{
+  GstBufferList *list = videorate->pending;
+  GstPad *srcpad = GST_BASE_TRANSFORM_SRC_PAD (videorate);
+  GstBuffer *buf;
+
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  videorate->pending = NULL;
+
+  if (gst_buffer_list_length (list) > 1) {
+    GST_LOG_OBJECT (videorate, "pushing list of %u buffers",
+        gst_buffer_list_length (list));
+    return gst_pad_push_list (srcpad, list);
+  }
+
+  buf = gst_buffer_ref (gst_buffer_list_get (list, 0));
+  gst_buffer_list_unref (list);
+
+  return gst_pad_push (srcpad, buf);
+}
+
 /* flush the oldest buffer */
 static GstFlowReturn
 gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate,
@@ -711,9 +846,16 @@ gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate,
   if (!videorate->prevbuf)
     goto eos_before_buffers;
 
-  outbuf = gst_buffer_ref (videorate->prevbuf);
-  /* make sure we can write to the metadata */
-  outbuf = gst_buffer_make_writable (outbuf);
+  if (gst_video_rate_extends_pending (videorate, duplicate)) {
+    /* only the timing of the duplicate is used, don't copy the frame */
+    outbuf = gst_buffer_new ();
+    gst_buffer_copy_into (outbuf, videorate->prevbuf,
+        GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+  } else {
+    outbuf = gst_buffer_ref (videorate->prevbuf);
+    /* make sure we can write to the metadata */
+    outbuf = gst_buffer_make_writable (outbuf);
+  }
 
   return gst_video_rate_push_buffer (videorate, outbuf, duplicate, next_intime);
 
@@ -794,6 +936,7 @@ gst_video_rate_sink_event (GstBaseTransform * trans, GstEvent * event)
               GST_CLOCK_TIME_NONE);
           count++;
         }
+        gst_video_rate_push_pending (videorate);
         if (count > 1) {
           videorate->dup += count - 1;
           if (!videorate->silent)
@@ -881,6 +1024,7 @@ gst_video_rate_sink_event (GstBaseTransform * trans, GstEvent * event)
           count = 1;
         }
       }
+      gst_video_rate_push_pending (videorate);
 
       if (count > 1) {
         videorate->dup += count - 1;
@@ -1401,6 +1545,7 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
     }
   } else {
     GstClockTime prevtime;
+    GstFlowReturn r;
     gint count = 0;
     gint64 diff1, diff2;
 
@@ -1464,7 +1609,6 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
 
       /* output first one when its the best */
       if (diff1 <= diff2) {
-        GstFlowReturn r;
         count++;
 
         /* on error the _flush function posted a warning already */
@@ -1480,6 +1624,12 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
     }
     while (diff1 < diff2);
 
+    /* push the duplicates queued by the list and timestamp modes */
+    if ((r = gst_video_rate_push_pending (videorate)) != GST_FLOW_OK) {
+      res = r;
+      goto done;
+    }
+
     /* if we outputed the first buffer more then once, we have dups */
     if (count > 1) {
       videorate->dup += count - 1;
@@ -1589,6 +1739,9 @@ gst_video_rate_set_property (GObject * object,
 
       gst_videorate_update_duration (videorate);
       return;
+    case PROP_DUPLICATION_MODE:
+      videorate->duplication_mode = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1648,6 +1801,9 @@ gst_video_rate_get_property (GObject * object,
     case PROP_RATE:
       g_value_set_double (value, videorate->rate);
       break;
+    case PROP_DUPLICATION_MODE:
+      g_value_set_enum (value, videorate->duplication_mode);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
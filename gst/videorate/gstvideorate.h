@@ -37,6 +37,23 @@ G_BEGIN_DECLS
 typedef struct _GstVideoRate GstVideoRate;
 typedef struct _GstVideoRateClass GstVideoRateClass;
 
+/**
+ * GstVideoRateDuplicationMode:
+ * @GST_VIDEO_RATE_DUPLICATION_MODE_COPY: push a new buffer for every
+ *     duplicated frame
+ * @GST_VIDEO_RATE_DUPLICATION_MODE_LIST: push the duplicates of a frame
+ *     together with it in one buffer list
+ * @GST_VIDEO_RATE_DUPLICATION_MODE_TIMESTAMP: don't duplicate frames, extend
+ *     the duration of the repeated frame instead
+ *
+ * How frames are repeated to fill the output framerate.
+ */
+typedef enum {
+  GST_VIDEO_RATE_DUPLICATION_MODE_COPY,
+  GST_VIDEO_RATE_DUPLICATION_MODE_LIST,
+  GST_VIDEO_RATE_DUPLICATION_MODE_TIMESTAMP
+} GstVideoRateDuplicationMode;
+
 /**
  * GstVideoRate:
  *
@@ -59,6 +76,7 @@ struct _GstVideoRate
                                  * frame rate caps change */
   gboolean discont;
   guint64 last_ts;              /* Timestamp of last input buffer */
+  GstBufferList *pending;       /* Frames waiting to be pushed together */
 
   guint64 average_period;
   GstClockTimeDiff wanted_diff; /* target average diff */
@@ -79,6 +97,7 @@ struct _GstVideoRate
 
   volatile int max_rate;
   gdouble rate;
+  GstVideoRateDuplicationMode duplication_mode;
 };
 
 struct _GstVideoRateClass
@@ -0,0 +1,1017 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-videomultiscale
+ * @title: videomultiscale
+ * @see_also: videoscale
+ *
+ * Scales one video stream to several sizes at once, like the renditions of
+ * an adaptive streaming ladder. Every src pad is one rendition. Its size is
+ * negotiated with downstream and the "method" and "sharpness" properties of
+ * the pad select the filter used for it. The format is not changed.
+ *
+ * With #GstVideoMultiScale:cascade, the renditions are made from the largest
+ * to the smallest and each one is scaled from the smallest rendition already
+ * made that is at least as large, instead of from the input. For a ladder
+ * like 2160p, 1080p, 720p, 480p only the 1080p rendition reads the input.
+ * A rendition with the size of the input, or of another rendition, shares
+ * its buffer.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 -v videotestsrc ! video/x-raw,width=3840,height=2160 ! \
+ *   videomultiscale name=s \
+ *   s.src_0 ! video/x-raw,width=1920,height=1080 ! queue ! fakesink \
+ *   s.src_1 ! video/x-raw,width=1280,height=720 ! queue ! fakesink \
+ *   s.src_2 ! video/x-raw,width=854,height=480 ! queue ! fakesink
+ * ]|
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include <gst/video/gstvideometa.h>
+#include <gst/video/gstvideopool.h>
+
+#include "gstvideomultiscale.h"
+
+#define GST_CAT_DEFAULT video_multi_scale_debug
+GST_DEBUG_CATEGORY_STATIC (video_multi_scale_debug);
+
+#define DEFAULT_PROP_CASCADE      TRUE
+#define DEFAULT_PROP_N_THREADS    1
+
+#define DEFAULT_PAD_METHOD        GST_VIDEO_SCALE_BILINEAR
+#define DEFAULT_PAD_SHARPNESS     1.0
+
+enum
+{
+  PROP_0,
+  PROP_CASCADE,
+  PROP_N_THREADS
+};
+
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_METHOD,
+  PROP_PAD_SHARPNESS
+};
+
+#undef GST_VIDEO_SIZE_RANGE
+#define GST_VIDEO_SIZE_RANGE "(int) [ 1, 32767]"
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL))
+    );
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL))
+    );
+
+/* a rendition while it is made */
+typedef struct
+{
+  GstVideoMultiScalePad *pad;
+  GstBuffer *buffer;
+  GstFlowReturn ret;
+  GstVideoFrame frame;
+  gboolean mapped;
+  /* what the next renditions can be scaled from */
+  GstVideoFrame *view;
+  GstBuffer *view_buffer;
+} GstVideoMultiScaleOutput;
+
+G_DEFINE_TYPE (GstVideoMultiScalePad, gst_video_multi_scale_pad,
+    GST_TYPE_PAD);
+
+static void
+gst_video_multi_scale_pad_reset (GstVideoMultiScalePad * pad)
+{
+  if (pad->convert) {
+    gst_video_converter_free (pad->convert);
+    pad->convert = NULL;
+  }
+  if (pad->pool) {
+    gst_buffer_pool_set_active (pad->pool, FALSE);
+    gst_object_unref (pad->pool);
+    pad->pool = NULL;
+  }
+  pad->negotiated = FALSE;
+  pad->video_meta = FALSE;
+}
+
+static void
+gst_video_multi_scale_pad_finalize (GObject * object)
+{
+  gst_video_multi_scale_pad_reset (GST_VIDEO_MULTI_SCALE_PAD_CAST (object));
+
+  G_OBJECT_CLASS (gst_video_multi_scale_pad_parent_class)->finalize (object);
+}
+
+static void
+gst_video_multi_scale_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVideoMultiScalePad *pad = GST_VIDEO_MULTI_SCALE_PAD (object);
+
+  switch (prop_id) {
+    case PROP_PAD_METHOD:
+      GST_OBJECT_LOCK (pad);
+      pad->method = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (pad);
+      break;
+    case PROP_PAD_SHARPNESS:
+      GST_OBJECT_LOCK (pad);
+      pad->sharpness = g_value_get_double (value);
+      GST_OBJECT_UNLOCK (pad);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_video_multi_scale_pad_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoMultiScalePad *pad = GST_VIDEO_MULTI_SCALE_PAD (object);
+
+  switch (prop_id) {
+    case PROP_PAD_METHOD:
+      GST_OBJECT_LOCK (pad);
+      g_value_set_enum (value, pad->method);
+      GST_OBJECT_UNLOCK (pad);
+      break;
+    case PROP_PAD_SHARPNESS:
+      GST_OBJECT_LOCK (pad);
+      g_value_set_double (value, pad->sharpness);
+      GST_OBJECT_UNLOCK (pad);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_video_multi_scale_pad_class_init (GstVideoMultiScalePadClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->finalize = gst_video_multi_scale_pad_finalize;
+  gobject_class->set_property = gst_video_multi_scale_pad_set_property;
+  gobject_class->get_property = gst_video_multi_scale_pad_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_PAD_METHOD,
+      g_param_spec_enum ("method", "method",
+          "Method used to scale this rendition",
+          GST_TYPE_VIDEO_SCALE_METHOD, DEFAULT_PAD_METHOD,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_PAD_SHARPNESS,
+      g_param_spec_double ("sharpness", "Sharpness",
+          "Sharpness of the filter of this rendition", 0.5, 1.5,
+          DEFAULT_PAD_SHARPNESS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gst_video_multi_scale_pad_init (GstVideoMultiScalePad * pad)
+{
+  pad->method = DEFAULT_PAD_METHOD;
+  pad->sharpness = DEFAULT_PAD_SHARPNESS;
+}
+
+#define gst_video_multi_scale_parent_class parent_class
+G_DEFINE_TYPE (GstVideoMultiScale, gst_video_multi_scale, GST_TYPE_ELEMENT);
+
+static void gst_video_multi_scale_finalize (GObject * object);
+static void gst_video_multi_scale_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_video_multi_scale_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
+
+static GstStateChangeReturn gst_video_multi_scale_change_state (GstElement *
+    element, GstStateChange transition);
+static GstPad *gst_video_multi_scale_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
+static void gst_video_multi_scale_release_pad (GstElement * element,
+    GstPad * pad);
+
+static GstFlowReturn gst_video_multi_scale_chain (GstPad * pad,
+    GstObject * parent, GstBuffer * buffer);
+static gboolean gst_video_multi_scale_sink_event (GstPad * pad,
+    GstObject * parent, GstEvent * event);
+static gboolean gst_video_multi_scale_sink_query (GstPad * pad,
+    GstObject * parent, GstQuery * query);
+static gboolean gst_video_multi_scale_src_query (GstPad * pad,
+    GstObject * parent, GstQuery * query);
+
+static void
+gst_video_multi_scale_class_init (GstVideoMultiScaleClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstElementClass *element_class = (GstElementClass *) klass;
+
+  gobject_class->finalize = gst_video_multi_scale_finalize;
+  gobject_class->set_property = gst_video_multi_scale_set_property;
+  gobject_class->get_property = gst_video_multi_scale_get_property;
+
+  /**
+   * GstVideoMultiScale:cascade:
+   *
+   * Scale each rendition from the smallest larger rendition instead of from
+   * the input.
+   */
+  g_object_class_install_property (gobject_class, PROP_CASCADE,
+      g_param_spec_boolean ("cascade", "Cascade",
+          "Scale each rendition from the next larger one instead of from "
+          "the input", DEFAULT_PROP_CASCADE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use per rendition", 0, G_MAXUINT,
+          DEFAULT_PROP_N_THREADS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "Video multi scaler", "Filter/Converter/Video/Scaler",
+      "Resizes video to several sizes at once",
+      "LG Electronics, Inc.");
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &src_template, GST_TYPE_VIDEO_MULTI_SCALE_PAD);
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_video_multi_scale_change_state);
+  element_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_video_multi_scale_request_new_pad);
+  element_class->release_pad =
+      GST_DEBUG_FUNCPTR (gst_video_multi_scale_release_pad);
+
+  GST_DEBUG_CATEGORY_INIT (video_multi_scale_debug, "videomultiscale", 0,
+      "videomultiscale element");
+}
+
+static void
+gst_video_multi_scale_init (GstVideoMultiScale * self)
+{
+  self->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_multi_scale_chain));
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_multi_scale_sink_event));
+  gst_pad_set_query_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_multi_scale_sink_query));
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->sinkpad);
+
+  self->cascade = DEFAULT_PROP_CASCADE;
+  self->n_threads = DEFAULT_PROP_N_THREADS;
+  self->flow_combiner = gst_flow_combiner_new ();
+}
+
+static void
+gst_video_multi_scale_finalize (GObject * object)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE (object);
+
+  gst_flow_combiner_free (self->flow_combiner);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_video_multi_scale_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE (object);
+
+  switch (prop_id) {
+    case PROP_CASCADE:
+      GST_OBJECT_LOCK (self);
+      self->cascade = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (self);
+      self->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_video_multi_scale_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE (object);
+
+  switch (prop_id) {
+    case PROP_CASCADE:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, self->cascade);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->n_threads);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* the outputs have the format of the input and any size */
+static GstCaps *
+gst_video_multi_scale_src_caps (const GstVideoInfo * in_info)
+{
+  GstCaps *caps;
+
+  if (in_info == NULL)
+    return gst_static_pad_template_get_caps (&src_template);
+
+  caps = gst_video_info_to_caps ((GstVideoInfo *) in_info);
+  gst_caps_set_simple (caps,
+      "width", GST_TYPE_INT_RANGE, 1, 32767,
+      "height", GST_TYPE_INT_RANGE, 1, 32767,
+      "pixel-aspect-ratio", GST_TYPE_FRACTION_RANGE, 1, G_MAXINT, G_MAXINT, 1,
+      NULL);
+
+  return caps;
+}
+
+/* pick the size downstream wants, keeping the display aspect ratio of the
+ * input for what downstream leaves open */
+static GstCaps *
+gst_video_multi_scale_fixate_src_caps (GstVideoMultiScale * self,
+    GstVideoMultiScalePad * pad, const GstVideoInfo * in_info)
+{
+  GstCaps *templ, *caps;
+  GstStructure *s;
+  gint w, h, par_n, par_d, dar_n, dar_d, n, d;
+  gboolean have_w, have_h;
+
+  templ = gst_video_multi_scale_src_caps (in_info);
+  caps = gst_pad_peer_query_caps (GST_PAD_CAST (pad), templ);
+  gst_caps_unref (templ);
+
+  if (gst_caps_is_empty (caps)) {
+    gst_caps_unref (caps);
+    return NULL;
+  }
+
+  caps = gst_caps_truncate (caps);
+  caps = gst_caps_make_writable (caps);
+  s = gst_caps_get_structure (caps, 0);
+
+  if (!gst_util_fraction_multiply (in_info->width, in_info->height,
+          in_info->par_n, in_info->par_d, &dar_n, &dar_d)) {
+    dar_n = in_info->width;
+    dar_d = in_info->height;
+  }
+
+  have_w = gst_structure_get_int (s, "width", &w);
+  have_h = gst_structure_get_int (s, "height", &h);
+
+  if (have_w && have_h) {
+    if (!gst_util_fraction_multiply (dar_n, dar_d, h, w, &par_n, &par_d))
+      par_n = par_d = 1;
+    gst_structure_fixate_field_nearest_fraction (s, "pixel-aspect-ratio",
+        par_n, par_d);
+  } else {
+    gst_structure_fixate_field_nearest_fraction (s, "pixel-aspect-ratio",
+        in_info->par_n, in_info->par_d);
+    if (!gst_structure_get_fraction (s, "pixel-aspect-ratio", &par_n, &par_d))
+      par_n = par_d = 1;
+
+    if (have_w) {
+      if (gst_util_fraction_multiply (par_n, par_d, dar_d, dar_n, &n, &d))
+        gst_structure_fixate_field_nearest_int (s, "height",
+            gst_util_uint64_scale_int (w, n, d));
+    } else if (have_h) {
+      if (gst_util_fraction_multiply (par_d, par_n, dar_n, dar_d, &n, &d))
+        gst_structure_fixate_field_nearest_int (s, "width",
+            gst_util_uint64_scale_int (h, n, d));
+    } else {
+      gst_structure_fixate_field_nearest_int (s, "width", in_info->width);
+      gst_structure_fixate_field_nearest_int (s, "height", in_info->height);
+    }
+  }
+
+  caps = gst_caps_fixate (caps);
+
+  GST_DEBUG_OBJECT (pad, "fixated to %" GST_PTR_FORMAT, caps);
+
+  return caps;
+}
+
+/* send the caps of a rendition and set up its buffer pool */
+static gboolean
+gst_video_multi_scale_negotiate_pad (GstVideoMultiScale * self,
+    GstVideoMultiScalePad * pad, const GstVideoInfo * in_info)
+{
+  GstCaps *caps;
+  GstVideoInfo info;
+  GstQuery *query;
+  GstBufferPool *pool = NULL;
+  GstStructure *config;
+  guint size = 0, min = 0, max = 0;
+  gboolean video_meta;
+
+  gst_pad_check_reconfigure (GST_PAD_CAST (pad));
+  gst_video_multi_scale_pad_reset (pad);
+
+  caps = gst_video_multi_scale_fixate_src_caps (self, pad, in_info);
+  if (caps == NULL || !gst_video_info_from_caps (&info, caps))
+    goto no_caps;
+
+  /* unlinked pads keep the caps until they are linked and renegotiate */
+  if (!gst_pad_push_event (GST_PAD_CAST (pad), gst_event_new_caps (caps))
+      && gst_pad_is_linked (GST_PAD_CAST (pad)))
+    goto refused;
+
+  query = gst_query_new_allocation (caps, TRUE);
+  if (!gst_pad_peer_query (GST_PAD_CAST (pad), query))
+    GST_DEBUG_OBJECT (pad, "allocation query failed");
+
+  if (gst_query_get_n_allocation_pools (query) > 0)
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+  if (pool == NULL)
+    pool = gst_video_buffer_pool_new ();
+  size = MAX (size, info.size);
+
+  video_meta =
+      gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, size, min, max);
+  if (video_meta)
+    gst_buffer_pool_config_add_option (config,
+        GST_BUFFER_POOL_OPTION_VIDEO_META);
+  gst_query_unref (query);
+
+  if (!gst_buffer_pool_set_config (pool, config)) {
+    /* downstream's pool doesn't take our config, use our own */
+    gst_object_unref (pool);
+    pool = gst_video_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, caps, info.size, 0, 0);
+    if (!gst_buffer_pool_set_config (pool, config))
+      goto config_failed;
+  }
+  if (!gst_buffer_pool_set_active (pool, TRUE))
+    goto activate_failed;
+
+  GST_DEBUG_OBJECT (pad, "negotiated %dx%d", info.width, info.height);
+
+  pad->pool = pool;
+  pad->info = info;
+  pad->video_meta = video_meta;
+  pad->negotiated = TRUE;
+  gst_caps_unref (caps);
+
+  return TRUE;
+
+  /* ERRORS */
+no_caps:
+  {
+    GST_WARNING_OBJECT (pad, "no usable caps");
+    if (caps)
+      gst_caps_unref (caps);
+    return FALSE;
+  }
+refused:
+  {
+    GST_WARNING_OBJECT (pad, "downstream refused %" GST_PTR_FORMAT, caps);
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+config_failed:
+  {
+    GST_ERROR_OBJECT (pad, "failed to set pool config");
+    gst_object_unref (pool);
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+activate_failed:
+  {
+    GST_ERROR_OBJECT (pad, "failed to activate pool");
+    gst_object_unref (pool);
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+}
+
+static void
+gst_video_multi_scale_pad_ensure_converter (GstVideoMultiScalePad * pad,
+    const GstVideoInfo * from, guint n_threads)
+{
+  GstVideoScaleMethod method;
+  gdouble sharpness;
+  GstStructure *options;
+
+  GST_OBJECT_LOCK (pad);
+  method = pad->method;
+  sharpness = pad->sharpness;
+  GST_OBJECT_UNLOCK (pad);
+
+  if (pad->convert && pad->convert_width == from->width
+      && pad->convert_height == from->height
+      && pad->convert_method == method && pad->convert_sharpness == sharpness
+      && pad->convert_threads == n_threads)
+    return;
+
+  GST_DEBUG_OBJECT (pad, "scaling from %dx%d to %dx%d", from->width,
+      from->height, pad->info.width, pad->info.height);
+
+  options = gst_structure_new_empty ("videomultiscale");
+  gst_video_scale_method_set_options (method, options);
+  gst_structure_set (options,
+      GST_VIDEO_RESAMPLER_OPT_SHARPNESS, G_TYPE_DOUBLE, sharpness,
+      GST_VIDEO_CONVERTER_OPT_MATRIX_MODE, GST_TYPE_VIDEO_MATRIX_MODE,
+      GST_VIDEO_MATRIX_MODE_NONE, GST_VIDEO_CONVERTER_OPT_DITHER_METHOD,
+      GST_TYPE_VIDEO_DITHER_METHOD, GST_VIDEO_DITHER_NONE,
+      GST_VIDEO_CONVERTER_OPT_CHROMA_MODE, GST_TYPE_VIDEO_CHROMA_MODE,
+      GST_VIDEO_CHROMA_MODE_NONE,
+      GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, n_threads, NULL);
+
+  if (pad->convert)
+    gst_video_converter_free (pad->convert);
+  pad->convert = gst_video_converter_new ((GstVideoInfo *) from, &pad->info,
+      options);
+  pad->convert_width = from->width;
+  pad->convert_height = from->height;
+  pad->convert_method = method;
+  pad->convert_sharpness = sharpness;
+  pad->convert_threads = n_threads;
+}
+
+/* whether a frame of the size of the rendition can be pushed as is */
+static gboolean
+gst_video_multi_scale_pad_can_share (GstVideoMultiScalePad * pad,
+    const GstVideoFrame * frame)
+{
+  const GstVideoInfo *info = &pad->info;
+  guint i;
+
+  if (GST_VIDEO_FRAME_FORMAT (frame) != GST_VIDEO_INFO_FORMAT (info))
+    return FALSE;
+
+  if (pad->video_meta && gst_buffer_get_video_meta (frame->buffer))
+    return TRUE;
+
+  /* without a video meta downstream expects the default layout */
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++) {
+    if (GST_VIDEO_FRAME_PLANE_OFFSET (frame, i) !=
+        GST_VIDEO_INFO_PLANE_OFFSET (info, i)
+        || GST_VIDEO_FRAME_PLANE_STRIDE (frame, i) !=
+        GST_VIDEO_INFO_PLANE_STRIDE (info, i))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/* largest first */
+static gint
+compare_output_size (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const GstVideoMultiScaleOutput *oa = a, *ob = b;
+  guint64 sa, sb;
+
+  sa = (guint64) oa->pad->info.width * oa->pad->info.height;
+  sb = (guint64) ob->pad->info.width * ob->pad->info.height;
+
+  return sb > sa ? 1 : sb < sa ? -1 : 0;
+}
+
+static GstFlowReturn
+gst_video_multi_scale_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE_CAST (parent);
+  GstVideoMultiScaleOutput *outputs;
+  GstVideoInfo in_info;
+  GstVideoFrame in_frame, cropped;
+  GstVideoFrame *source;
+  GstVideoCropMeta *crop;
+  GstFlowReturn ret = GST_FLOW_OK;
+  gboolean cascade;
+  guint n_threads, n_outputs = 0, i, j;
+  GList *l;
+
+  GST_OBJECT_LOCK (self);
+  if (!self->negotiated) {
+    GST_OBJECT_UNLOCK (self);
+    goto not_negotiated;
+  }
+  in_info = self->in_info;
+  cascade = self->cascade;
+  n_threads = self->n_threads;
+
+  outputs = g_new0 (GstVideoMultiScaleOutput,
+      GST_ELEMENT_CAST (self)->numsrcpads);
+  for (l = GST_ELEMENT_CAST (self)->srcpads; l; l = l->next)
+    outputs[n_outputs++].pad = gst_object_ref (l->data);
+  GST_OBJECT_UNLOCK (self);
+
+  if (n_outputs == 0)
+    goto no_outputs;
+
+  for (i = 0; i < n_outputs; i++) {
+    GstVideoMultiScalePad *srcpad = outputs[i].pad;
+
+    if (!gst_pad_check_reconfigure (GST_PAD_CAST (srcpad))
+        && srcpad->negotiated)
+      continue;
+
+    if (!gst_video_multi_scale_negotiate_pad (self, srcpad, &in_info)) {
+      /* try again with the next buffer */
+      gst_pad_mark_reconfigure (GST_PAD_CAST (srcpad));
+    }
+  }
+
+  if (!gst_video_frame_map (&in_frame, &in_info, buffer, GST_MAP_READ))
+    goto invalid_buffer;
+
+  /* scale straight from the cropped region */
+  source = &in_frame;
+  crop = gst_buffer_get_video_crop_meta (buffer);
+  if (crop && crop->width == in_info.width && crop->height == in_info.height) {
+    cropped = in_frame;
+    if (gst_video_frame_crop (&cropped, crop->x, crop->y, crop->width,
+            crop->height))
+      source = &cropped;
+    else
+      GST_WARNING_OBJECT (self, "can't apply crop meta %ux%u at %u,%u",
+          crop->width, crop->height, crop->x, crop->y);
+  }
+
+  g_qsort_with_data (outputs, n_outputs, sizeof (GstVideoMultiScaleOutput),
+      compare_output_size, NULL);
+
+  for (i = 0; i < n_outputs; i++) {
+    GstVideoMultiScaleOutput *out = &outputs[i];
+    GstVideoFrame *from = source;
+    GstBuffer *from_buffer = buffer;
+    gint width, height;
+
+    if (!out->pad->negotiated) {
+      out->ret = GST_FLOW_NOT_NEGOTIATED;
+      continue;
+    }
+
+    width = GST_VIDEO_INFO_WIDTH (&out->pad->info);
+    height = GST_VIDEO_INFO_HEIGHT (&out->pad->info);
+
+    /* The renditions are sorted by size, the last one that is large enough
+     * is the smallest. Renditions that are larger than the input are not
+     * used, scaling them down again would only lose detail. */
+    if (cascade) {
+      for (j = 0; j < i; j++) {
+        GstVideoFrame *view = outputs[j].view;
+
+        if (view == NULL || view == source)
+          continue;
+        if (GST_VIDEO_FRAME_WIDTH (view) > GST_VIDEO_FRAME_WIDTH (source)
+            || GST_VIDEO_FRAME_HEIGHT (view) > GST_VIDEO_FRAME_HEIGHT (source))
+          continue;
+        if (GST_VIDEO_FRAME_WIDTH (view) < width
+            || GST_VIDEO_FRAME_HEIGHT (view) < height)
+          continue;
+
+        from = view;
+        from_buffer = outputs[j].view_buffer;
+      }
+    }
+
+    /* same size, nothing to scale. The input can't be shared when it needs
+     * to be cropped, downstream might not know about the crop meta, or when
+     * downstream can't read its layout, it's copied to one of our buffers
+     * then. */
+    if (GST_VIDEO_FRAME_WIDTH (from) == width
+        && GST_VIDEO_FRAME_HEIGHT (from) == height && from != &cropped
+        && gst_video_multi_scale_pad_can_share (out->pad, from)) {
+      out->buffer = gst_buffer_ref (from_buffer);
+      out->view = from;
+      out->view_buffer = from_buffer;
+      continue;
+    }
+
+    out->ret = gst_buffer_pool_acquire_buffer (out->pad->pool, &out->buffer,
+        NULL);
+    if (out->ret != GST_FLOW_OK)
+      continue;
+
+    if (!gst_video_frame_map (&out->frame, &out->pad->info, out->buffer,
+            GST_MAP_READWRITE)) {
+      GST_ERROR_OBJECT (out->pad, "failed to map output buffer");
+      gst_buffer_unref (out->buffer);
+      out->buffer = NULL;
+      out->ret = GST_FLOW_ERROR;
+      continue;
+    }
+    out->mapped = TRUE;
+
+    gst_video_multi_scale_pad_ensure_converter (out->pad, &from->info,
+        n_threads);
+    gst_video_converter_frame (out->pad->convert, from, &out->frame);
+
+    gst_buffer_copy_into (out->buffer, buffer,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+    out->view = &out->frame;
+    out->view_buffer = out->buffer;
+  }
+
+  for (i = 0; i < n_outputs; i++) {
+    if (outputs[i].mapped)
+      gst_video_frame_unmap (&outputs[i].frame);
+  }
+  gst_video_frame_unmap (&in_frame);
+  gst_buffer_unref (buffer);
+
+  /* the renditions are pushed from the largest to the smallest */
+  for (i = 0; i < n_outputs; i++) {
+    GstVideoMultiScaleOutput *out = &outputs[i];
+
+    if (out->buffer)
+      out->ret = gst_pad_push (GST_PAD_CAST (out->pad), out->buffer);
+
+    GST_OBJECT_LOCK (self);
+    ret = gst_flow_combiner_update_pad_flow (self->flow_combiner,
+        GST_PAD_CAST (out->pad), out->ret);
+    GST_OBJECT_UNLOCK (self);
+
+    gst_object_unref (out->pad);
+  }
+  g_free (outputs);
+
+  return ret;
+
+  /* ERRORS */
+not_negotiated:
+  {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL),
+        ("buffer without caps"));
+    gst_buffer_unref (buffer);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+no_outputs:
+  {
+    GST_DEBUG_OBJECT (self, "no renditions requested");
+    g_free (outputs);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_NOT_LINKED;
+  }
+invalid_buffer:
+  {
+    GST_ELEMENT_WARNING (self, CORE, NOT_IMPLEMENTED, (NULL),
+        ("invalid video buffer received"));
+    for (i = 0; i < n_outputs; i++)
+      gst_object_unref (outputs[i].pad);
+    g_free (outputs);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+}
+
+static gboolean
+gst_video_multi_scale_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE_CAST (parent);
+
+  GST_DEBUG_OBJECT (pad, "handling %s event", GST_EVENT_TYPE_NAME (event));
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+    {
+      GstCaps *caps;
+      GstVideoInfo info;
+      GList *pads, *l;
+
+      gst_event_parse_caps (event, &caps);
+      if (!gst_video_info_from_caps (&info, caps)) {
+        GST_WARNING_OBJECT (self, "invalid caps %" GST_PTR_FORMAT, caps);
+        gst_event_unref (event);
+        return FALSE;
+      }
+
+      GST_OBJECT_LOCK (self);
+      self->in_info = info;
+      self->negotiated = TRUE;
+      pads = g_list_copy_deep (GST_ELEMENT_CAST (self)->srcpads,
+          (GCopyFunc) gst_object_ref, NULL);
+      GST_OBJECT_UNLOCK (self);
+
+      /* every rendition gets its own caps, before the segment */
+      for (l = pads; l; l = l->next) {
+        if (!gst_video_multi_scale_negotiate_pad (self, l->data, &info))
+          gst_pad_mark_reconfigure (l->data);
+      }
+      g_list_free_full (pads, gst_object_unref);
+
+      gst_event_unref (event);
+      return TRUE;
+    }
+    case GST_EVENT_FLUSH_STOP:
+      GST_OBJECT_LOCK (self);
+      gst_flow_combiner_reset (self->flow_combiner);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static gboolean
+gst_video_multi_scale_sink_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_ALLOCATION:
+      /* the input is only read, any layout and crop region will do */
+      gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+      gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE,
+          NULL);
+      return TRUE;
+    default:
+      return gst_pad_query_default (pad, parent, query);
+  }
+}
+
+static gboolean
+gst_video_multi_scale_src_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE_CAST (parent);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+    {
+      GstCaps *filter, *caps, *tmp;
+      GstVideoInfo in_info;
+      gboolean negotiated;
+
+      GST_OBJECT_LOCK (self);
+      negotiated = self->negotiated;
+      in_info = self->in_info;
+      GST_OBJECT_UNLOCK (self);
+
+      gst_query_parse_caps (query, &filter);
+      caps = gst_video_multi_scale_src_caps (negotiated ? &in_info : NULL);
+      if (filter) {
+        tmp = gst_caps_intersect_full (filter, caps, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+    }
+    default:
+      return gst_pad_query_default (pad, parent, query);
+  }
+}
+
+static gboolean
+forward_sticky_events (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  GstVideoMultiScalePad *srcpad = user_data;
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE_CAST (GST_PAD_PARENT (pad));
+
+  if (GST_EVENT_TYPE (*event) == GST_EVENT_CAPS) {
+    GstVideoInfo in_info;
+    gboolean negotiated;
+
+    GST_OBJECT_LOCK (self);
+    negotiated = self->negotiated;
+    in_info = self->in_info;
+    GST_OBJECT_UNLOCK (self);
+
+    /* the pad isn't linked yet and gets caps with the size of the input, it
+     * renegotiates when it is linked */
+    if (negotiated)
+      gst_video_multi_scale_negotiate_pad (self, srcpad, &in_info);
+  } else {
+    gst_pad_push_event (GST_PAD_CAST (srcpad), gst_event_ref (*event));
+  }
+
+  return TRUE;
+}
+
+static GstPad *
+gst_video_multi_scale_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE (element);
+  GstPad *srcpad;
+  gchar *pad_name;
+  guint id;
+
+  GST_OBJECT_LOCK (self);
+  if (name && sscanf (name, "src_%u", &id) == 1) {
+    pad_name = g_strdup (name);
+    self->next_pad_id = MAX (self->next_pad_id, id + 1);
+  } else {
+    pad_name = g_strdup_printf ("src_%u", self->next_pad_id++);
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  srcpad = g_object_new (GST_TYPE_VIDEO_MULTI_SCALE_PAD, "name", pad_name,
+      "direction", GST_PAD_SRC, "template", templ, NULL);
+  g_free (pad_name);
+
+  gst_pad_set_query_function (srcpad,
+      GST_DEBUG_FUNCPTR (gst_video_multi_scale_src_query));
+
+  /* join a running stream */
+  if (GST_PAD_IS_ACTIVE (self->sinkpad))
+    gst_pad_set_active (srcpad, TRUE);
+  gst_pad_sticky_events_foreach (self->sinkpad, forward_sticky_events, srcpad);
+
+  GST_OBJECT_LOCK (self);
+  gst_flow_combiner_add_pad (self->flow_combiner, srcpad);
+  GST_OBJECT_UNLOCK (self);
+
+  gst_element_add_pad (element, srcpad);
+
+  return srcpad;
+}
+
+static void
+gst_video_multi_scale_release_pad (GstElement * element, GstPad * pad)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE (element);
+
+  GST_OBJECT_LOCK (self);
+  gst_flow_combiner_remove_pad (self->flow_combiner, pad);
+  GST_OBJECT_UNLOCK (self);
+
+  gst_pad_set_active (pad, FALSE);
+  gst_element_remove_pad (element, pad);
+}
+
+static GstStateChangeReturn
+gst_video_multi_scale_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstVideoMultiScale *self = GST_VIDEO_MULTI_SCALE (element);
+  GstStateChangeReturn ret;
+  GList *l;
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      GST_OBJECT_LOCK (self);
+      self->negotiated = FALSE;
+      gst_flow_combiner_reset (self->flow_combiner);
+      for (l = element->srcpads; l; l = l->next)
+        gst_video_multi_scale_pad_reset (l->data);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
@@ -0,0 +1,122 @@
+/* GStreamer
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_MULTI_SCALE_H__
+#define __GST_VIDEO_MULTI_SCALE_H__
+
+#include <gst/gst.h>
+#include <gst/base/gstflowcombiner.h>
+#include <gst/video/video.h>
+
+#include "gstvideoscale.h"
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_VIDEO_MULTI_SCALE \
+  (gst_video_multi_scale_get_type())
+#define GST_VIDEO_MULTI_SCALE(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_VIDEO_MULTI_SCALE,GstVideoMultiScale))
+#define GST_VIDEO_MULTI_SCALE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_VIDEO_MULTI_SCALE,GstVideoMultiScaleClass))
+#define GST_IS_VIDEO_MULTI_SCALE(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_VIDEO_MULTI_SCALE))
+#define GST_IS_VIDEO_MULTI_SCALE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_VIDEO_MULTI_SCALE))
+#define GST_VIDEO_MULTI_SCALE_CAST(obj) ((GstVideoMultiScale *)(obj))
+
+#define GST_TYPE_VIDEO_MULTI_SCALE_PAD \
+  (gst_video_multi_scale_pad_get_type())
+#define GST_VIDEO_MULTI_SCALE_PAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_VIDEO_MULTI_SCALE_PAD,GstVideoMultiScalePad))
+#define GST_VIDEO_MULTI_SCALE_PAD_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_VIDEO_MULTI_SCALE_PAD,GstVideoMultiScalePadClass))
+#define GST_IS_VIDEO_MULTI_SCALE_PAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_VIDEO_MULTI_SCALE_PAD))
+#define GST_IS_VIDEO_MULTI_SCALE_PAD_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_VIDEO_MULTI_SCALE_PAD))
+#define GST_VIDEO_MULTI_SCALE_PAD_CAST(obj) ((GstVideoMultiScalePad *)(obj))
+
+typedef struct _GstVideoMultiScale GstVideoMultiScale;
+typedef struct _GstVideoMultiScaleClass GstVideoMultiScaleClass;
+typedef struct _GstVideoMultiScalePad GstVideoMultiScalePad;
+typedef struct _GstVideoMultiScalePadClass GstVideoMultiScalePadClass;
+
+/**
+ * GstVideoMultiScalePad:
+ *
+ * Opaque data structure
+ */
+struct _GstVideoMultiScalePad {
+  GstPad parent;
+
+  /* properties, protected by the object lock */
+  GstVideoScaleMethod method;
+  gdouble sharpness;
+
+  /* below only used from the streaming thread */
+  gboolean negotiated;
+  GstVideoInfo info;
+  GstBufferPool *pool;
+  /* downstream reads the layout from the video meta */
+  gboolean video_meta;
+
+  /* converter from the rendition it is scaled from and what it was made for */
+  GstVideoConverter *convert;
+  gint convert_width;
+  gint convert_height;
+  GstVideoScaleMethod convert_method;
+  gdouble convert_sharpness;
+  guint convert_threads;
+};
+
+struct _GstVideoMultiScalePadClass {
+  GstPadClass parent_class;
+};
+
+/**
+ * GstVideoMultiScale:
+ *
+ * Opaque data structure
+ */
+struct _GstVideoMultiScale {
+  GstElement element;
+
+  GstPad *sinkpad;
+
+  /* properties */
+  gboolean cascade;
+  guint n_threads;
+
+  /* protected by the object lock */
+  gboolean negotiated;
+  GstVideoInfo in_info;
+  guint next_pad_id;
+  GstFlowCombiner *flow_combiner;
+};
+
+struct _GstVideoMultiScaleClass {
+  GstElementClass parent_class;
+};
+
+G_GNUC_INTERNAL GType gst_video_multi_scale_get_type (void);
+G_GNUC_INTERNAL GType gst_video_multi_scale_pad_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_MULTI_SCALE_H__ */
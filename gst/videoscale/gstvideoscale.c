@@ -79,6 +79,7 @@
 #include <gst/video/gstvideopool.h>
 
 #include "gstvideoscale.h"
+#include "gstvideomultiscale.h"
 
 #define GST_CAT_DEFAULT video_scale_debug
 GST_DEBUG_CATEGORY_STATIC (video_scale_debug);
@@ -127,8 +128,7 @@ static GstStaticCaps gst_video_scale_format_caps =
     GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS) ";"
     GST_VIDEO_CAPS_MAKE_WITH_FEATURES ("ANY", GST_VIDEO_FORMATS));
 
-#define GST_TYPE_VIDEO_SCALE_METHOD (gst_video_scale_method_get_type())
-static GType
+GType
 gst_video_scale_method_get_type (void)
 {
   static GType video_scale_method_type = 0;
@@ -154,6 +154,83 @@ gst_video_scale_method_get_type (void)
   return video_scale_method_type;
 }
 
+/* set the resampler options of the converter for @method */
+void
+gst_video_scale_method_set_options (GstVideoScaleMethod method,
+    GstStructure * options)
+{
+  switch (method) {
+    case GST_VIDEO_SCALE_NEAREST:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_NEAREST,
+          NULL);
+      break;
+    case GST_VIDEO_SCALE_BILINEAR:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+          GST_VIDEO_RESAMPLER_OPT_MAX_TAPS, G_TYPE_INT, 2, NULL);
+      break;
+    case GST_VIDEO_SCALE_4TAP:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_SINC,
+          GST_VIDEO_RESAMPLER_OPT_MAX_TAPS, G_TYPE_INT, 4, NULL);
+      break;
+    case GST_VIDEO_SCALE_LANCZOS:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+          NULL);
+      break;
+    case GST_VIDEO_SCALE_BILINEAR2:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+          NULL);
+      break;
+    case GST_VIDEO_SCALE_SINC:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_SINC,
+          NULL);
+      break;
+    case GST_VIDEO_SCALE_HERMITE:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+          GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE, (gdouble) 0.0,
+          GST_VIDEO_RESAMPLER_OPT_CUBIC_C, G_TYPE_DOUBLE, (gdouble) 0.0,
+          NULL);
+      break;
+    case GST_VIDEO_SCALE_SPLINE:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+          GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE, (gdouble) 1.0,
+          GST_VIDEO_RESAMPLER_OPT_CUBIC_C, G_TYPE_DOUBLE, (gdouble) 0.0,
+          NULL);
+      break;
+    case GST_VIDEO_SCALE_CATROM:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+          GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE, (gdouble) 0.0,
+          GST_VIDEO_RESAMPLER_OPT_CUBIC_C, G_TYPE_DOUBLE, (gdouble) 0.5,
+          NULL);
+      break;
+    case GST_VIDEO_SCALE_MITCHELL:
+      gst_structure_set (options,
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+          GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE, (gdouble) 1.0 / 3.0,
+          GST_VIDEO_RESAMPLER_OPT_CUBIC_C, G_TYPE_DOUBLE, (gdouble) 1.0 / 3.0,
+          NULL);
+      break;
+  }
+}
+
 static GstCaps *
 gst_video_scale_get_capslist (void)
 {
@@ -192,6 +269,9 @@ static GstCaps *gst_video_scale_transform_caps (GstBaseTransform * trans,
 static GstCaps *gst_video_scale_fixate_caps (GstBaseTransform * base,
     GstPadDirection direction, GstCaps * caps, GstCaps * othercaps);
 
+static gboolean gst_video_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query);
+
 static gboolean gst_video_scale_set_info (GstVideoFilter * filter,
     GstCaps * in, GstVideoInfo * in_info, GstCaps * out,
     GstVideoInfo * out_info);
@@ -283,6 +363,8 @@ gst_video_scale_class_init (GstVideoScaleClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_scale_transform_caps);
   trans_class->fixate_caps = GST_DEBUG_FUNCPTR (gst_video_scale_fixate_caps);
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_scale_src_event);
+  trans_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_scale_propose_allocation);
 
   filter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_scale_set_info);
   filter_class->transform_frame =
@@ -487,6 +569,29 @@ gst_video_scale_transform_caps (GstBaseTransform * trans,
   return ret;
 }
 
+static gboolean
+gst_video_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  /* passthrough, downstream answered and decides about the crop meta */
+  if (decide_query == NULL)
+    return TRUE;
+
+  /* we scale from the cropped region, the crop meta needs the video meta to
+   * describe the whole frame */
+  if (!gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL))
+    gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+  if (!gst_query_find_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE,
+          NULL))
+    gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE, NULL);
+
+  return TRUE;
+}
+
 static gboolean
 gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info)
@@ -542,76 +647,8 @@ gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
 
     options = gst_structure_new_empty ("videoscale");
 
-    switch (videoscale->method) {
-      case GST_VIDEO_SCALE_NEAREST:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_NEAREST,
-            NULL);
-        break;
-      case GST_VIDEO_SCALE_BILINEAR:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LINEAR,
-            GST_VIDEO_RESAMPLER_OPT_MAX_TAPS, G_TYPE_INT, 2, NULL);
-        break;
-      case GST_VIDEO_SCALE_4TAP:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_SINC,
-            GST_VIDEO_RESAMPLER_OPT_MAX_TAPS, G_TYPE_INT, 4, NULL);
-        break;
-      case GST_VIDEO_SCALE_LANCZOS:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
-            NULL);
-        break;
-      case GST_VIDEO_SCALE_BILINEAR2:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LINEAR,
-            NULL);
-        break;
-      case GST_VIDEO_SCALE_SINC:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_SINC,
-            NULL);
-        break;
-      case GST_VIDEO_SCALE_HERMITE:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
-            GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE, (gdouble) 0.0,
-            GST_VIDEO_RESAMPLER_OPT_CUBIC_C, G_TYPE_DOUBLE, (gdouble) 0.0,
-            NULL);
-        break;
-      case GST_VIDEO_SCALE_SPLINE:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
-            GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE, (gdouble) 1.0,
-            GST_VIDEO_RESAMPLER_OPT_CUBIC_C, G_TYPE_DOUBLE, (gdouble) 0.0,
-            NULL);
-        break;
-      case GST_VIDEO_SCALE_CATROM:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
-            GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE, (gdouble) 0.0,
-            GST_VIDEO_RESAMPLER_OPT_CUBIC_C, G_TYPE_DOUBLE, (gdouble) 0.5,
-            NULL);
-        break;
-      case GST_VIDEO_SCALE_MITCHELL:
-        gst_structure_set (options,
-            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
-            GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_CUBIC,
-            GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE, (gdouble) 1.0 / 3.0,
-            GST_VIDEO_RESAMPLER_OPT_CUBIC_C, G_TYPE_DOUBLE, (gdouble) 1.0 / 3.0,
-            NULL);
-        break;
-    }
+    gst_video_scale_method_set_options (videoscale->method, options);
+
     gst_structure_set (options,
         GST_VIDEO_RESAMPLER_OPT_ENVELOPE, G_TYPE_DOUBLE, videoscale->envelope,
         GST_VIDEO_RESAMPLER_OPT_SHARPNESS, G_TYPE_DOUBLE, videoscale->sharpness,
@@ -1100,9 +1137,27 @@ gst_video_scale_transform_frame (GstVideoFilter * filter,
 {
   GstVideoScale *videoscale = GST_VIDEO_SCALE_CAST (filter);
   GstFlowReturn ret = GST_FLOW_OK;
+  GstVideoCropMeta *crop;
+  GstVideoFrame cropped;
 
   GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter, "doing video scaling");
 
+  /* The crop meta is applied when the caps have the size of the cropped
+   * region, the buffer then has a video meta with the size of the whole frame.
+   * We scale straight from the region. The meta is not copied to the output,
+   * it has video size tags. */
+  crop = gst_buffer_get_video_crop_meta (in_frame->buffer);
+  if (crop && crop->width == GST_VIDEO_INFO_WIDTH (&filter->in_info)
+      && crop->height == GST_VIDEO_INFO_HEIGHT (&filter->in_info)) {
+    cropped = *in_frame;
+    if (gst_video_frame_crop (&cropped, crop->x, crop->y, crop->width,
+            crop->height))
+      in_frame = &cropped;
+    else
+      GST_WARNING_OBJECT (filter, "can't apply crop meta %ux%u at %u,%u",
+          crop->width, crop->height, crop->x, crop->y);
+  }
+
   gst_video_converter_frame (videoscale->convert, in_frame, out_frame);
 
   return ret;
@@ -1153,6 +1208,9 @@ plugin_init (GstPlugin * plugin)
   if (!gst_element_register (plugin, "videoscale", GST_RANK_NONE,
           GST_TYPE_VIDEO_SCALE))
     return FALSE;
+  if (!gst_element_register (plugin, "videomultiscale", GST_RANK_NONE,
+          GST_TYPE_VIDEO_MULTI_SCALE))
+    return FALSE;
 
   GST_DEBUG_CATEGORY_INIT (video_scale_debug, "videoscale", 0,
       "videoscale element");
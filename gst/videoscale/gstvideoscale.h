@@ -68,6 +68,12 @@ typedef enum {
   GST_VIDEO_SCALE_MITCHELL
 } GstVideoScaleMethod;
 
+#define GST_TYPE_VIDEO_SCALE_METHOD (gst_video_scale_method_get_type())
+G_GNUC_INTERNAL GType gst_video_scale_method_get_type (void);
+
+G_GNUC_INTERNAL void gst_video_scale_method_set_options (
+    GstVideoScaleMethod method, GstStructure * options);
+
 typedef struct _GstVideoScale GstVideoScale;
 typedef struct _GstVideoScaleClass GstVideoScaleClass;
 
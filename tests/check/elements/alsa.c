@@ -0,0 +1,155 @@
+/* GStreamer
+ *
+ * unit test for alsasink
+ *
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/audio/audio.h>
+
+/* the null device accepts any mmap access without real hardware */
+static GstElement *
+setup_pipeline (gboolean mmap)
+{
+  GstElement *pipeline;
+  gchar *desc;
+
+  desc = g_strdup_printf ("audiotestsrc num-buffers=50 samplesperbuffer=441 "
+      "! audio/x-raw,format=S16LE,rate=44100,channels=2 "
+      "! alsasink name=sink device=null mmap=%s", mmap ? "true" : "false");
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipeline != NULL);
+
+  return pipeline;
+}
+
+/* returns FALSE when there is no usable ALSA device */
+static gboolean
+open_device (GstElement * pipeline)
+{
+  if (gst_element_set_state (pipeline,
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+    GST_INFO ("no ALSA, skipping");
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* the device was opened, so it has to play until EOS */
+static void
+run_pipeline (GstElement * pipeline)
+{
+  GstMessage *msg;
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS,
+      "playback failed: %" GST_PTR_FORMAT, msg);
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+}
+
+GST_START_TEST (test_mmap_property)
+{
+  GstElement *sink;
+  gboolean mmap;
+
+  sink = gst_element_factory_make ("alsasink", NULL);
+  fail_unless (sink != NULL);
+
+  g_object_get (sink, "mmap", &mmap, NULL);
+  fail_unless (mmap == FALSE);
+
+  g_object_set (sink, "mmap", TRUE, NULL);
+  g_object_get (sink, "mmap", &mmap, NULL);
+  fail_unless (mmap == TRUE);
+
+  gst_object_unref (sink);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_mmap_playback)
+{
+  GstElement *pipeline, *sink;
+  GstAudioRingBuffer *ringbuffer;
+
+  pipeline = setup_pipeline (TRUE);
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+
+  if (!open_device (pipeline))
+    goto done;
+
+  /* the ringbuffer is created when going to READY */
+  ringbuffer = GST_AUDIO_BASE_SINK (sink)->ringbuffer;
+  fail_unless (ringbuffer != NULL);
+  fail_unless (g_type_is_a (G_OBJECT_TYPE (ringbuffer),
+          GST_TYPE_AUDIO_RING_BUFFER));
+  fail_if (g_str_equal (G_OBJECT_TYPE_NAME (ringbuffer),
+          "GstAudioSinkRingBuffer"));
+
+  /* the null device accepts mmap access, so this plays until EOS */
+  run_pipeline (pipeline);
+
+done:
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rw_playback)
+{
+  GstElement *pipeline;
+
+  pipeline = setup_pipeline (FALSE);
+  if (open_device (pipeline))
+    run_pipeline (pipeline);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static Suite *
+alsa_suite (void)
+{
+  Suite *s = suite_create ("alsa");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_mmap_property);
+  tcase_add_test (tc_chain, test_mmap_playback);
+  tcase_add_test (tc_chain, test_rw_playback);
+
+  return s;
+}
+
+GST_CHECK_MAIN (alsa);
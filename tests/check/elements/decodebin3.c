@@ -0,0 +1,432 @@
+/* GStreamer unit tests for decodebin3
+ *
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#define TEST_CAPS "video/x-test"
+#define MESSAGE_TIMEOUT (5 * GST_SECOND)
+
+static void
+pad_added_cb (GstElement * dbin, GstPad * pad, GstElement * pipe)
+{
+  GstElement *sink;
+  GstPad *sinkpad;
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  gst_bin_add (GST_BIN (pipe), sink);
+  gst_element_sync_state_with_parent (sink);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless_equals_int (gst_pad_link (pad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+}
+
+static GstPad *
+setup_input (GstElement * dbin, const gchar * sinkname,
+    const gchar * stream_id, guint group_id)
+{
+  GstPad *srcpad, *sinkpad;
+  GstEvent *event;
+  GstCaps *caps;
+  GstSegment segment;
+
+  srcpad = gst_pad_new (stream_id, GST_PAD_SRC);
+  if (g_str_has_suffix (sinkname, "%u"))
+    sinkpad = gst_element_get_request_pad (dbin, sinkname);
+  else
+    sinkpad = gst_element_get_static_pad (dbin, sinkname);
+  fail_unless (sinkpad != NULL);
+  fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+  gst_pad_set_active (srcpad, TRUE);
+
+  event = gst_event_new_stream_start (stream_id);
+  gst_event_set_group_id (event, group_id);
+  fail_unless (gst_pad_push_event (srcpad, event));
+
+  caps = gst_caps_from_string (TEST_CAPS);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_caps (caps)));
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_segment (&segment)));
+
+  return srcpad;
+}
+
+static void
+select_stream (GstElement * dbin, const gchar * stream_id)
+{
+  GList *streams;
+
+  streams = g_list_append (NULL, (gchar *) stream_id);
+  fail_unless (gst_element_send_event (dbin,
+          gst_event_new_select_streams (streams)));
+  g_list_free (streams);
+}
+
+static GstFlowReturn
+push_buffer (GstPad * srcpad, GstClockTime pts)
+{
+  GstBuffer *buf;
+
+  buf = gst_buffer_new_allocate (NULL, 16, NULL);
+  GST_BUFFER_PTS (buf) = pts;
+  GST_BUFFER_DURATION (buf) = 40 * GST_MSECOND;
+
+  return gst_pad_push (srcpad, buf);
+}
+
+/* Switches back and forth between two streams before any buffer made it
+ * out of decodebin3. The outputs dropped by the switches must not leave
+ * their first buffer probe behind. */
+GST_START_TEST (test_switch_before_first_buffer)
+{
+  GstElement *pipe, *dbin;
+  GstPad *pad_a, *pad_b;
+  GstStreamCollection *collection = NULL;
+  const gchar *id_a = NULL, *id_b = NULL;
+  GstCaps *caps;
+  GstBus *bus;
+  GstMessage *msg;
+  guint group_id, i;
+  gboolean got_eos = FALSE;
+
+  pipe = gst_pipeline_new (NULL);
+  dbin = gst_element_factory_make ("decodebin3", NULL);
+  fail_unless (dbin != NULL);
+  caps = gst_caps_from_string (TEST_CAPS);
+  g_object_set (dbin, "caps", caps, NULL);
+  gst_caps_unref (caps);
+  g_signal_connect (dbin, "pad-added", G_CALLBACK (pad_added_cb), pipe);
+  gst_bin_add (GST_BIN (pipe), dbin);
+
+  fail_if (gst_element_set_state (pipe, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE);
+
+  group_id = gst_util_group_id_next ();
+  pad_a = setup_input (dbin, "sink", "test-stream-a", group_id);
+  pad_b = setup_input (dbin, "sink_%u", "test-stream-b", group_id);
+
+  /* wait until both streams are known */
+  bus = gst_element_get_bus (pipe);
+  while (collection == NULL) {
+    msg = gst_bus_timed_pop_filtered (bus, MESSAGE_TIMEOUT,
+        GST_MESSAGE_STREAM_COLLECTION | GST_MESSAGE_ERROR);
+    fail_unless (msg != NULL, "no stream collection");
+    fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_STREAM_COLLECTION);
+    gst_message_parse_stream_collection (msg, &collection);
+    gst_message_unref (msg);
+    if (gst_stream_collection_get_size (collection) < 2) {
+      gst_object_unref (collection);
+      collection = NULL;
+    }
+  }
+
+  for (i = 0; i < gst_stream_collection_get_size (collection); i++) {
+    GstStream *stream = gst_stream_collection_get_stream (collection, i);
+    const gchar *stream_id = gst_stream_get_stream_id (stream);
+
+    if (strstr (stream_id, "test-stream-a"))
+      id_a = stream_id;
+    else if (strstr (stream_id, "test-stream-b"))
+      id_b = stream_id;
+  }
+  fail_unless (id_a != NULL && id_b != NULL);
+
+  select_stream (dbin, id_a);
+  select_stream (dbin, id_b);
+  select_stream (dbin, id_a);
+
+  for (i = 0; i < 5; i++) {
+    push_buffer (pad_a, i * 40 * GST_MSECOND);
+    push_buffer (pad_b, i * 40 * GST_MSECOND);
+  }
+  gst_pad_push_event (pad_a, gst_event_new_eos ());
+  gst_pad_push_event (pad_b, gst_event_new_eos ());
+
+  /* only the selected stream may report its first buffer */
+  while (!got_eos) {
+    msg = gst_bus_timed_pop_filtered (bus, MESSAGE_TIMEOUT,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR | GST_MESSAGE_ELEMENT);
+    fail_unless (msg != NULL, "no EOS");
+
+    switch (GST_MESSAGE_TYPE (msg)) {
+      case GST_MESSAGE_EOS:
+        got_eos = TRUE;
+        break;
+      case GST_MESSAGE_ELEMENT:{
+        const GstStructure *s = gst_message_get_structure (msg);
+
+        if (gst_structure_has_name (s, "decodebin3-zapping-latency")) {
+          const gchar *stream_id = gst_structure_get_string (s, "stream-id");
+
+          fail_unless (stream_id != NULL);
+          fail_unless (strstr (stream_id, "test-stream-a") != NULL,
+              "first buffer reported for %s", stream_id);
+        }
+        break;
+      }
+      default:
+        fail ("unexpected message %" GST_PTR_FORMAT, msg);
+        break;
+    }
+    gst_message_unref (msg);
+  }
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+
+  gst_object_unref (collection);
+  gst_object_unref (bus);
+  gst_object_unref (pad_a);
+  gst_object_unref (pad_b);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static guint64
+stats_get_uint64 (GstElement * dbin, const gchar * field)
+{
+  GstStructure *stats;
+  guint64 val = 0;
+
+  g_object_get (dbin, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, field, &val));
+  gst_structure_free (stats);
+
+  return val;
+}
+
+GST_START_TEST (test_adaptive_buffering_time_limits)
+{
+  GstElement *dbin;
+  GstStructure *stats;
+  gboolean adaptive = TRUE;
+  guint underruns = 1;
+  guint64 min_time = 0, max_time = 0;
+
+  dbin = gst_element_factory_make ("decodebin3", NULL);
+  fail_unless (dbin != NULL);
+
+  g_object_get (dbin, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_boolean (stats, "adaptive-buffering",
+          &adaptive));
+  fail_if (adaptive);
+  fail_unless (gst_structure_get_uint (stats, "underruns", &underruns));
+  fail_unless_equals_int (underruns, 0);
+  fail_unless_equals_int (gst_value_array_get_size (gst_structure_get_value
+          (stats, "slots")), 0);
+  gst_structure_free (stats);
+  fail_unless_equals_uint64 (stats_get_uint64 (dbin, "buffer-time"),
+      GST_SECOND);
+
+  /* the target follows the limits */
+  g_object_set (dbin, "min-buffer-time", 2 * GST_SECOND, NULL);
+  fail_unless_equals_uint64 (stats_get_uint64 (dbin, "buffer-time"),
+      2 * GST_SECOND);
+  g_object_set (dbin, "max-buffer-time", 1500 * GST_MSECOND, NULL);
+  fail_unless_equals_uint64 (stats_get_uint64 (dbin, "buffer-time"),
+      1500 * GST_MSECOND);
+  g_object_set (dbin, "min-buffer-time", 500 * GST_MSECOND, NULL);
+  fail_unless_equals_uint64 (stats_get_uint64 (dbin, "buffer-time"),
+      1500 * GST_MSECOND);
+
+  /* the minimum can't go above the maximum and the other way around */
+  g_object_set (dbin, "min-buffer-time", 3 * GST_SECOND, NULL);
+  g_object_get (dbin, "max-buffer-time", &max_time, NULL);
+  fail_unless_equals_uint64 (max_time, 3 * GST_SECOND);
+  fail_unless_equals_uint64 (stats_get_uint64 (dbin, "buffer-time"),
+      3 * GST_SECOND);
+  g_object_set (dbin, "max-buffer-time", GST_SECOND, NULL);
+  g_object_get (dbin, "min-buffer-time", &min_time, NULL);
+  fail_unless_equals_uint64 (min_time, GST_SECOND);
+  fail_unless_equals_uint64 (stats_get_uint64 (dbin, "buffer-time"),
+      GST_SECOND);
+
+  gst_object_unref (dbin);
+}
+
+GST_END_TEST;
+
+static GstElement *
+get_multiqueue (GstElement * dbin)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  GstElement *mq = NULL;
+
+  it = gst_bin_iterate_elements (GST_BIN (dbin));
+  while (mq == NULL && gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstElement *elem = g_value_get_object (&item);
+    GstElementFactory *factory = gst_element_get_factory (elem);
+
+    if (factory && !g_strcmp0 (GST_OBJECT_NAME (factory), "multiqueue"))
+      mq = gst_object_ref (elem);
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  return mq;
+}
+
+/* 1000 bytes every 20ms is 400 kbit/s */
+#define RATE_BUFFER_SIZE 1000
+#define RATE_BUFFER_DURATION (20 * GST_MSECOND)
+#define RATE_BITRATE 400000
+
+static void
+run_rate_stream (gboolean adaptive, GstStructure ** p_stats,
+    guint64 * buffer_times, guint n_underruns)
+{
+  GstElement *pipe, *dbin, *mq;
+  GstPad *srcpad;
+  GstCaps *caps;
+  GstBus *bus;
+  GstMessage *msg;
+  guint i, mq_bytes, orig_bytes;
+  guint64 mq_interleave, orig_interleave;
+
+  pipe = gst_pipeline_new (NULL);
+  dbin = gst_element_factory_make ("decodebin3", NULL);
+  fail_unless (dbin != NULL);
+  caps = gst_caps_from_string (TEST_CAPS);
+  g_object_set (dbin, "caps", caps, "adaptive-buffering", adaptive, NULL);
+  gst_caps_unref (caps);
+
+  mq = get_multiqueue (dbin);
+  fail_unless (mq != NULL);
+  g_object_get (mq, "max-size-bytes", &orig_bytes, "min-interleave-time",
+      &orig_interleave, NULL);
+  g_signal_connect (dbin, "pad-added", G_CALLBACK (pad_added_cb), pipe);
+  gst_bin_add (GST_BIN (pipe), dbin);
+
+  fail_if (gst_element_set_state (pipe, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE);
+
+  srcpad = setup_input (dbin, "sink", "test-stream-a",
+      gst_util_group_id_next ());
+
+  /* 2 seconds of data, two measurement windows */
+  for (i = 0; i <= 100; i++) {
+    GstBuffer *buf = gst_buffer_new_allocate (NULL, RATE_BUFFER_SIZE, NULL);
+
+    GST_BUFFER_PTS (buf) = i * RATE_BUFFER_DURATION;
+    GST_BUFFER_DURATION (buf) = RATE_BUFFER_DURATION;
+    fail_unless_equals_int (gst_pad_push (srcpad, buf), GST_FLOW_OK);
+  }
+
+  fail_unless_equals_int (gst_element_get_state (pipe, NULL, NULL,
+          MESSAGE_TIMEOUT), GST_STATE_CHANGE_SUCCESS);
+
+  for (i = 0; i < n_underruns; i++) {
+    g_signal_emit_by_name (mq, "underrun");
+    buffer_times[i] = stats_get_uint64 (dbin, "buffer-time");
+  }
+
+  g_object_get (dbin, "stats", p_stats, NULL);
+
+  /* the limits adaptive buffering set are undone when it is disabled */
+  g_object_get (mq, "max-size-bytes", &mq_bytes, "min-interleave-time",
+      &mq_interleave, NULL);
+  if (adaptive && n_underruns > 0) {
+    fail_if (mq_bytes == orig_bytes && mq_interleave == orig_interleave);
+    g_object_set (dbin, "adaptive-buffering", FALSE, NULL);
+    g_object_get (mq, "max-size-bytes", &mq_bytes, "min-interleave-time",
+        &mq_interleave, NULL);
+  }
+  fail_unless_equals_int (mq_bytes, orig_bytes);
+  fail_unless_equals_uint64 (mq_interleave, orig_interleave);
+  gst_object_unref (mq);
+
+  gst_pad_push_event (srcpad, gst_event_new_eos ());
+  bus = gst_element_get_bus (pipe);
+  msg = gst_bus_timed_pop_filtered (bus, MESSAGE_TIMEOUT,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (srcpad);
+  gst_object_unref (pipe);
+}
+
+GST_START_TEST (test_adaptive_buffering_stats)
+{
+  GstStructure *stats;
+  const GstStructure *slot;
+  const GValue *slots;
+  guint64 bitrate = 0, buffer_times[5];
+  guint underruns = 0, max_bytes = 0;
+
+  /* disabled, the streams are not measured */
+  run_rate_stream (FALSE, &stats, NULL, 0);
+  slots = gst_structure_get_value (stats, "slots");
+  fail_unless_equals_int (gst_value_array_get_size (slots), 0);
+  gst_structure_free (stats);
+
+  /* every underrun grows the target by half, up to max-buffer-time */
+  run_rate_stream (TRUE, &stats, buffer_times, 5);
+  fail_unless_equals_uint64 (buffer_times[0], 1500 * GST_MSECOND);
+  fail_unless_equals_uint64 (buffer_times[1], 2250 * GST_MSECOND);
+  fail_unless_equals_uint64 (buffer_times[2], 3375 * GST_MSECOND);
+  fail_unless_equals_uint64 (buffer_times[3], 5 * GST_SECOND);
+  fail_unless_equals_uint64 (buffer_times[4], 5 * GST_SECOND);
+
+  fail_unless (gst_structure_get_uint (stats, "underruns", &underruns));
+  fail_unless_equals_int (underruns, 5);
+  fail_unless (gst_structure_get_uint (stats, "max-size-bytes", &max_bytes));
+  fail_unless (max_bytes > 0 && max_bytes <= 32 * 1024 * 1024);
+
+  slots = gst_structure_get_value (stats, "slots");
+  fail_unless_equals_int (gst_value_array_get_size (slots), 1);
+  slot = gst_value_get_structure (gst_value_array_get_value (slots, 0));
+  fail_unless (gst_structure_get_uint64 (slot, "bitrate", &bitrate));
+  fail_unless (bitrate > RATE_BITRATE * 9 / 10
+      && bitrate < RATE_BITRATE * 11 / 10, "bitrate %" G_GUINT64_FORMAT,
+      bitrate);
+  gst_structure_free (stats);
+}
+
+GST_END_TEST;
+
+static Suite *
+decodebin3_suite (void)
+{
+  Suite *s = suite_create ("decodebin3");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_switch_before_first_buffer);
+  tcase_add_test (tc_chain, test_adaptive_buffering_time_limits);
+  tcase_add_test (tc_chain, test_adaptive_buffering_stats);
+
+  return s;
+}
+
+GST_CHECK_MAIN (decodebin3);
@@ -0,0 +1,264 @@
+/* GStreamer
+ *
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
+
+/* big enough for the download to be seeked when pulling near the end */
+#define N_WORDS (1024 * 1024)
+#define FILE_SIZE (N_WORDS * 4)
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+typedef struct
+{
+  gchar *location;
+  GstElement *pipeline;
+  GstElement *buffer;
+  GstPad *sinkpad;
+} DownloadTest;
+
+static void
+download_test_setup (DownloadTest * t, const gchar * temp_template)
+{
+  GstElement *src;
+  GstPad *srcpad;
+  guint32 *data;
+  guint i;
+
+  data = g_new (guint32, N_WORDS);
+  for (i = 0; i < N_WORDS; i++)
+    data[i] = GUINT32_TO_LE (i);
+
+  t->location = g_build_filename (g_get_tmp_dir (), "gst-mmapdownload-XXXXXX",
+      NULL);
+  g_close (g_mkstemp (t->location), NULL);
+  fail_unless (g_file_set_contents (t->location, (const gchar *) data,
+          FILE_SIZE, NULL));
+  g_free (data);
+
+  t->pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("filesrc", NULL);
+  fail_unless (src != NULL);
+  g_object_set (src, "location", t->location, "blocksize", 16384, NULL);
+  t->buffer = gst_element_factory_make ("mmapdownloadbuffer", NULL);
+  fail_unless (t->buffer != NULL);
+  g_object_set (t->buffer, "temp-template", temp_template, NULL);
+  gst_bin_add_many (GST_BIN (t->pipeline), src, t->buffer, NULL);
+  fail_unless (gst_element_link (src, t->buffer));
+
+  t->sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  srcpad = gst_element_get_static_pad (t->buffer, "src");
+  fail_unless_equals_int (gst_pad_link (srcpad, t->sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (srcpad);
+
+  fail_unless (gst_element_set_state (t->pipeline, GST_STATE_PAUSED) !=
+      GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_pad_activate_mode (t->sinkpad, GST_PAD_MODE_PULL, TRUE));
+}
+
+static void
+download_test_teardown (DownloadTest * t)
+{
+  gst_pad_activate_mode (t->sinkpad, GST_PAD_MODE_PULL, FALSE);
+  gst_element_set_state (t->pipeline, GST_STATE_NULL);
+  gst_object_unref (t->sinkpad);
+  gst_object_unref (t->pipeline);
+
+  g_unlink (t->location);
+  g_free (t->location);
+}
+
+static void
+check_range (DownloadTest * t, guint64 offset, guint size)
+{
+  GstBuffer *buf = NULL;
+  GstMapInfo map;
+  guint i;
+
+  fail_unless_equals_int (gst_pad_pull_range (t->sinkpad, offset, size, &buf),
+      GST_FLOW_OK);
+  fail_unless (buf != NULL);
+  fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buf), offset);
+
+  /* the data isn't copied, the buffers point into the mapping */
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 1);
+  fail_unless (GST_MEMORY_IS_READONLY (gst_buffer_peek_memory (buf, 0)));
+
+  fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+  fail_unless_equals_int (map.size, size);
+  for (i = 0; i < size; i += 4)
+    fail_unless_equals_int (GST_READ_UINT32_LE (map.data + i),
+        (offset + i) / 4);
+  gst_buffer_unmap (buf, &map);
+  gst_buffer_unref (buf);
+}
+
+GST_START_TEST (test_pull_ranges)
+{
+  DownloadTest t;
+  GstBuffer *buf = NULL;
+
+  download_test_setup (&t, NULL);
+
+  check_range (&t, 0, 4096);
+  check_range (&t, 65536, 65536);
+  /* far ahead of the download, makes it restart there */
+  check_range (&t, FILE_SIZE - 8192, 8192);
+  /* already downloaded, returns right away */
+  check_range (&t, 4096, 4096);
+  /* the gap between the two downloaded ranges */
+  check_range (&t, FILE_SIZE / 2, 4096);
+
+  fail_unless_equals_int (gst_pad_pull_range (t.sinkpad, FILE_SIZE, 4096,
+          &buf), GST_FLOW_EOS);
+
+  download_test_teardown (&t);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_buffering_query)
+{
+  DownloadTest t;
+  GstQuery *query;
+  gint64 start, stop, duration;
+  guint n_ranges;
+
+  download_test_setup (&t, NULL);
+
+  check_range (&t, 0, 4096);
+  check_range (&t, FILE_SIZE - 4096, 4096);
+
+  fail_unless (gst_pad_peer_query_duration (t.sinkpad, GST_FORMAT_BYTES,
+          &duration));
+  fail_unless_equals_int64 (duration, FILE_SIZE);
+
+  query = gst_query_new_buffering (GST_FORMAT_BYTES);
+  fail_unless (gst_pad_peer_query (t.sinkpad, query));
+  n_ranges = gst_query_get_n_buffering_ranges (query);
+  fail_unless (n_ranges >= 1);
+  /* the ranges are sorted, the last one holds the end of the stream */
+  fail_unless (gst_query_parse_nth_buffering_range (query, 0, &start, &stop));
+  fail_unless_equals_int64 (start, 0);
+  fail_unless (gst_query_parse_nth_buffering_range (query, n_ranges - 1,
+          &start, &stop));
+  fail_unless (stop >= FILE_SIZE - 4096);
+  gst_query_unref (query);
+
+  download_test_teardown (&t);
+}
+
+GST_END_TEST;
+
+/* the file from temp-template is used instead of a memfd when set */
+GST_START_TEST (test_temp_template)
+{
+  DownloadTest t;
+  gchar *temp_template, *temp_location = NULL;
+
+  temp_template = g_build_filename (g_get_tmp_dir (),
+      "gst-mmapdownload-storage-XXXXXX", NULL);
+  download_test_setup (&t, temp_template);
+
+  check_range (&t, 0, 4096);
+  check_range (&t, FILE_SIZE - 4096, 4096);
+
+  g_object_get (t.buffer, "temp-location", &temp_location, NULL);
+  fail_unless (temp_location != NULL);
+  fail_unless_equals_int (strlen (temp_location), strlen (temp_template));
+  fail_unless (g_str_has_prefix (temp_location, g_get_tmp_dir ()));
+  /* unlinked right away, the mapping keeps it */
+  fail_if (g_file_test (temp_location, G_FILE_TEST_EXISTS));
+  g_free (temp_location);
+
+  download_test_teardown (&t);
+  g_free (temp_template);
+}
+
+GST_END_TEST;
+
+/* without the size of the stream there is nothing to map */
+GST_START_TEST (test_unknown_size)
+{
+  GstElement *pipeline, *src, *buffer, *sink;
+  GstFlowReturn flow;
+  GstBuffer *buf;
+  GstMessage *msg;
+  GstBus *bus;
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("appsrc", NULL);
+  buffer = gst_element_factory_make ("mmapdownloadbuffer", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (src != NULL && buffer != NULL && sink != NULL);
+  g_object_set (src, "format", GST_FORMAT_BYTES, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), src, buffer, sink, NULL);
+  fail_unless (gst_element_link_many (src, buffer, sink, NULL));
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  buf = gst_buffer_new_allocate (NULL, 4096, NULL);
+  g_signal_emit_by_name (src, "push-buffer", buf, &flow);
+  gst_buffer_unref (buf);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND, GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  fail_unless (GST_MESSAGE_SRC (msg) == GST_OBJECT (buffer));
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static Suite *
+mmapdownloadbuffer_suite (void)
+{
+  Suite *s = suite_create ("mmapdownloadbuffer");
+  TCase *tc_chain = tcase_create ("general");
+  GstRegistry *registry = gst_registry_get ();
+  GstPluginFeature *feature;
+
+  suite_add_tcase (s, tc_chain);
+
+  /* only built where mmap is available */
+  feature = gst_registry_lookup_feature (registry, "mmapdownloadbuffer");
+  if (feature) {
+    tcase_add_test (tc_chain, test_pull_ranges);
+    tcase_add_test (tc_chain, test_buffering_query);
+    tcase_add_test (tc_chain, test_temp_template);
+    tcase_add_test (tc_chain, test_unknown_size);
+    gst_object_unref (feature);
+  }
+
+  return s;
+}
+
+GST_CHECK_MAIN (mmapdownloadbuffer);
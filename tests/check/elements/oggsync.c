@@ -0,0 +1,314 @@
+/* GStreamer
+ *
+ * unit tests for the ogg page sync of oggdemux and oggparse
+ *
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/check/gstcheck.h>
+#include <ogg/ogg.h>
+
+/* the functions are internal to the plugin, build them in */
+#include "../../../ext/ogg/gstoggsync.c"
+
+#define SEED 0x6f676753
+
+static void
+fill_random (GRand * rand, guint8 * data, gsize size)
+{
+  gsize i;
+
+  for (i = 0; i < size; i++)
+    data[i] = g_rand_int (rand);
+}
+
+/* a stream of valid pages with random packets, from libogg */
+static GByteArray *
+make_pages (GRand * rand, guint n_packets)
+{
+  GByteArray *pages = g_byte_array_new ();
+  ogg_stream_state os;
+  ogg_packet op;
+  ogg_page og;
+  guint8 *packet;
+  guint i;
+
+  packet = g_malloc (70000);
+  ogg_stream_init (&os, 0x1234);
+
+  for (i = 0; i < n_packets; i++) {
+    /* mostly small packets, some spanning several pages */
+    op.bytes = g_rand_int_range (rand, 0, i % 7 == 0 ? 70000 : 3000);
+    fill_random (rand, packet, op.bytes);
+    op.packet = packet;
+    op.b_o_s = i == 0;
+    op.e_o_s = i == n_packets - 1;
+    op.granulepos = i;
+    op.packetno = i;
+    ogg_stream_packetin (&os, &op);
+
+    while (ogg_stream_pageout (&os, &og)) {
+      g_byte_array_append (pages, og.header, og.header_len);
+      g_byte_array_append (pages, og.body, og.body_len);
+    }
+  }
+  while (ogg_stream_flush (&os, &og)) {
+    g_byte_array_append (pages, og.header, og.header_len);
+    g_byte_array_append (pages, og.body, og.body_len);
+  }
+
+  ogg_stream_clear (&os);
+  g_free (packet);
+
+  return pages;
+}
+
+GST_START_TEST (test_page_checksum)
+{
+  GRand *rand = g_rand_new_with_seed (SEED);
+  guint8 *header, *body;
+  ogg_page og;
+  guint i;
+
+  header = g_malloc (27 + 255);
+  body = g_malloc (255 * 255);
+
+  /* any header and body, the checksum field must be ignored */
+  for (i = 0; i < 500; i++) {
+    gsize header_len = 27 + g_rand_int_range (rand, 0, 256);
+    gsize body_len = g_rand_int_range (rand, 0, 255 * 255 + 1);
+    guint32 crc;
+
+    fill_random (rand, header, header_len);
+    fill_random (rand, body, body_len);
+    crc = gst_ogg_page_checksum (header, header_len, body, body_len);
+
+    og.header = header;
+    og.header_len = header_len;
+    og.body = body;
+    og.body_len = body_len;
+    ogg_page_checksum_set (&og);
+
+    fail_unless_equals_int (crc, GST_READ_UINT32_LE (header + 22));
+  }
+
+  g_free (body);
+  g_free (header);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+static const guint8 *
+find_capture_pattern_ref (const guint8 * data, gsize size)
+{
+  gsize i;
+
+  for (i = 0; i + 4 <= size; i++)
+    if (memcmp (data + i, "OggS", 4) == 0)
+      return data + i;
+
+  return NULL;
+}
+
+GST_START_TEST (test_find_capture_pattern)
+{
+  static const gchar *const parts[] = { "OggS", "Ogg", "Og", "O", "gS" };
+  GRand *rand = g_rand_new_with_seed (SEED);
+  guint8 data[100];
+  guint i, j;
+
+  for (i = 0; i < 5000; i++) {
+    gsize size = g_rand_int_range (rand, 0, sizeof (data) + 1);
+    guint n_parts = g_rand_int_range (rand, 0, 4);
+
+    /* few distinct values so that partial patterns show up */
+    for (j = 0; j < size; j++)
+      data[j] = "OgSx"[g_rand_int_range (rand, 0, 4)];
+    for (j = 0; j < n_parts && size >= 4; j++) {
+      const gchar *part = parts[g_rand_int_range (rand, 0, 5)];
+      gsize len = strlen (part);
+
+      memcpy (data + g_rand_int_range (rand, 0, size - len + 1), part, len);
+    }
+
+    fail_unless (gst_ogg_find_capture_pattern (data, size) ==
+        find_capture_pattern_ref (data, size));
+    /* every start alignment */
+    if (size > 0)
+      fail_unless (gst_ogg_find_capture_pattern (data + 1, size - 1) ==
+          find_capture_pattern_ref (data + 1, size - 1));
+  }
+
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+typedef gint (*PageoutFunc) (ogg_sync_state * oy, ogg_page * og);
+
+/* feeds @data in random chunks and collects the pages, each one as its
+ * length followed by its offset in @data */
+static GArray *
+sync_pages (const GByteArray * data, guint32 seed, PageoutFunc pageout)
+{
+  GRand *rand = g_rand_new_with_seed (seed);
+  GArray *pages = g_array_new (FALSE, FALSE, sizeof (guint));
+  ogg_sync_state oy;
+  ogg_page og;
+  guint offset = 0, pos, len;
+  gint ret;
+
+  ogg_sync_init (&oy);
+
+  while (offset < data->len) {
+    gsize chunk = MIN (g_rand_int_range (rand, 1, 8192), data->len - offset);
+    gchar *buf = ogg_sync_buffer (&oy, chunk);
+
+    memcpy (buf, data->data + offset, chunk);
+    ogg_sync_wrote (&oy, chunk);
+    offset += chunk;
+
+    /* the returned bytes are dropped from the state when buffering, track
+     * the position of the first byte the state holds */
+    pos = offset - oy.fill;
+
+    while ((ret = pageout (&oy, &og)) != 0) {
+      if (ret < 0)
+        continue;               /* skipped some bytes */
+
+      fail_unless (og.body == og.header + og.header_len);
+      len = og.header_len + og.body_len;
+      g_array_append_val (pages, len);
+      len = pos + (og.header - oy.data);
+      g_array_append_val (pages, len);
+    }
+  }
+
+  ogg_sync_clear (&oy);
+  g_rand_free (rand);
+
+  return pages;
+}
+
+static void
+check_page_splits (const GByteArray * data)
+{
+  GArray *ref, *pages;
+  guint i;
+
+  for (i = 0; i < 4; i++) {
+    ref = sync_pages (data, SEED + i, ogg_sync_pageout);
+    pages = sync_pages (data, SEED + i, gst_ogg_sync_pageout);
+
+    fail_unless (ref->len > 0);
+    fail_unless_equals_int (pages->len, ref->len);
+    fail_unless (memcmp (pages->data, ref->data,
+            ref->len * sizeof (guint)) == 0);
+
+    g_array_unref (pages);
+    g_array_unref (ref);
+  }
+}
+
+GST_START_TEST (test_page_splits)
+{
+  GRand *rand = g_rand_new_with_seed (SEED);
+  GByteArray *data;
+
+  data = make_pages (rand, 300);
+  check_page_splits (data);
+  g_byte_array_unref (data);
+
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_page_splits_damaged)
+{
+  GRand *rand = g_rand_new_with_seed (SEED);
+  GByteArray *pages, *data;
+  guint8 garbage[600];
+  guint i, len;
+
+  pages = make_pages (rand, 300);
+  data = g_byte_array_new ();
+
+  /* garbage with partial and full capture patterns, corrupted headers and
+   * bodies between the pages */
+  for (i = 0; i < pages->len; i += len) {
+    guint8 *page = pages->data + i;
+    gint j;
+
+    len = 27 + page[26];
+    for (j = 0; j < page[26]; j++)
+      len += page[27 + j];
+
+    switch (g_rand_int_range (rand, 0, 6)) {
+      case 0:
+        fill_random (rand, garbage, sizeof (garbage));
+        memcpy (garbage + g_rand_int_range (rand, 0, 590), "OggS", 4);
+        memcpy (garbage + g_rand_int_range (rand, 0, 590), "Ogg", 3);
+        g_byte_array_append (data, garbage, g_rand_int_range (rand, 1, 600));
+        break;
+      case 1:
+        g_byte_array_append (data, page, len);
+        data->data[data->len - len + g_rand_int_range (rand, 0, len)] ^= 0x10;
+        continue;
+      case 2:
+        /* truncated page */
+        g_byte_array_append (data, page, g_rand_int_range (rand, 4, len));
+        break;
+      default:
+        break;
+    }
+    g_byte_array_append (data, page, len);
+  }
+
+  check_page_splits (data);
+
+  g_byte_array_unref (data);
+  g_byte_array_unref (pages);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+static Suite *
+oggsync_suite (void)
+{
+  Suite *s = suite_create ("oggsync");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_page_checksum);
+  tcase_add_test (tc_chain, test_find_capture_pattern);
+  tcase_add_test (tc_chain, test_page_splits);
+  tcase_add_test (tc_chain, test_page_splits_damaged);
+
+  return s;
+}
+
+GST_CHECK_MAIN (oggsync);
@@ -0,0 +1,281 @@
+/* GStreamer unit tests for parsebin
+ *
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+
+/* Two parsers, each for its own media type. They turn parsed=false into
+ * parsed=true and count their live instances, which includes the spare
+ * elements parsebin prepares in the background. */
+typedef struct _TestParser
+{
+  GstElement parent;
+
+  GstPad *sinkpad;
+  GstPad *srcpad;
+} TestParser;
+
+typedef GstElementClass TestParserClass;
+typedef TestParser TestParserA;
+typedef TestParserClass TestParserAClass;
+typedef TestParser TestParserB;
+typedef TestParserClass TestParserBClass;
+
+static GType test_parser_get_type (void);
+static GType test_parser_a_get_type (void);
+static GType test_parser_b_get_type (void);
+
+G_DEFINE_ABSTRACT_TYPE (TestParser, test_parser, GST_TYPE_ELEMENT);
+G_DEFINE_TYPE (TestParserA, test_parser_a, test_parser_get_type ());
+G_DEFINE_TYPE (TestParserB, test_parser_b, test_parser_get_type ());
+
+static gint live_parsers = 0;
+
+static gboolean
+test_parser_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  TestParser *self = (TestParser *) parent;
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_CAPS) {
+    GstCaps *caps;
+    gboolean res;
+
+    gst_event_parse_caps (event, &caps);
+    caps = gst_caps_copy (caps);
+    gst_caps_set_simple (caps, "parsed", G_TYPE_BOOLEAN, TRUE, NULL);
+    res = gst_pad_push_event (self->srcpad, gst_event_new_caps (caps));
+    gst_caps_unref (caps);
+    gst_event_unref (event);
+
+    return res;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static GstFlowReturn
+test_parser_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+{
+  TestParser *self = (TestParser *) parent;
+
+  return gst_pad_push (self->srcpad, buf);
+}
+
+static void
+test_parser_finalize (GObject * object)
+{
+  g_atomic_int_add (&live_parsers, -1);
+
+  G_OBJECT_CLASS (test_parser_parent_class)->finalize (object);
+}
+
+static void
+test_parser_class_init (TestParserClass * klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = test_parser_finalize;
+}
+
+static void
+test_parser_init (TestParser * self)
+{
+  GstElementClass *klass = GST_ELEMENT_GET_CLASS (self);
+
+  self->sinkpad =
+      gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
+          "sink"), "sink");
+  gst_pad_set_event_function (self->sinkpad, test_parser_sink_event);
+  gst_pad_set_chain_function (self->sinkpad, test_parser_sink_chain);
+  gst_element_add_pad (GST_ELEMENT (self), self->sinkpad);
+
+  self->srcpad =
+      gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
+          "src"), "src");
+  gst_pad_use_fixed_caps (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  g_atomic_int_inc (&live_parsers);
+}
+
+static void
+test_parser_class_setup (GstElementClass * klass, const gchar * media_type)
+{
+  GstCaps *caps;
+
+  caps = gst_caps_new_simple (media_type, "parsed", G_TYPE_BOOLEAN, FALSE,
+      NULL);
+  gst_element_class_add_pad_template (klass,
+      gst_pad_template_new ("sink", GST_PAD_SINK, GST_PAD_ALWAYS, caps));
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_simple (media_type, "parsed", G_TYPE_BOOLEAN, TRUE,
+      NULL);
+  gst_element_class_add_pad_template (klass,
+      gst_pad_template_new ("src", GST_PAD_SRC, GST_PAD_ALWAYS, caps));
+  gst_caps_unref (caps);
+
+  gst_element_class_set_metadata (klass, "Test parser", "Codec/Parser",
+      "Marks the stream as parsed", "Test <test@example.com>");
+}
+
+static void
+test_parser_a_class_init (TestParserAClass * klass)
+{
+  test_parser_class_setup (klass, "test/x-a");
+}
+
+static void
+test_parser_a_init (TestParserA * self)
+{
+}
+
+static void
+test_parser_b_class_init (TestParserBClass * klass)
+{
+  test_parser_class_setup (klass, "test/x-b");
+}
+
+static void
+test_parser_b_init (TestParserB * self)
+{
+}
+
+static gboolean
+autoplug_continue_cb (GstElement * parsebin, GstPad * pad, GstCaps * caps,
+    gpointer user_data)
+{
+  gboolean parsed = FALSE;
+
+  gst_structure_get_boolean (gst_caps_get_structure (caps, 0), "parsed",
+      &parsed);
+
+  return !parsed;
+}
+
+static void
+pad_added_cb (GstElement * parsebin, GstPad * pad, GstCaps ** p_caps)
+{
+  GstElement *pipe, *sink;
+  GstPad *sinkpad;
+
+  *p_caps = gst_pad_get_current_caps (pad);
+
+  pipe = GST_ELEMENT (gst_object_get_parent (GST_OBJECT (parsebin)));
+  sink = gst_element_factory_make ("fakesink", NULL);
+  gst_bin_add (GST_BIN (pipe), sink);
+  gst_element_sync_state_with_parent (sink);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless_equals_int (gst_pad_link (pad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+  gst_object_unref (pipe);
+}
+
+/* Plugs a new parsebin for every stream and switches between two media
+ * types, like a channel change does. The cached factories must follow the
+ * caps and the spare elements, which outlive the parsebins, must be bounded
+ * to one per factory. */
+GST_START_TEST (test_parser_caps_switch)
+{
+  gint i;
+
+  fail_unless (gst_element_register (NULL, "testparsera",
+          GST_RANK_PRIMARY + 1, test_parser_a_get_type ()));
+  fail_unless (gst_element_register (NULL, "testparserb",
+          GST_RANK_PRIMARY + 1, test_parser_b_get_type ()));
+
+  for (i = 0; i < 10; i++) {
+    const gchar *media_type = (i % 2) ? "test/x-b" : "test/x-a";
+    GstElement *pipe, *src, *parsebin;
+    GstCaps *caps, *out_caps = NULL;
+    GstFlowReturn flow;
+    GstStructure *s;
+    GstBuffer *buf;
+    GstMessage *msg;
+    GstBus *bus;
+    gboolean parsed = FALSE;
+
+    pipe = gst_pipeline_new (NULL);
+    src = gst_element_factory_make ("appsrc", NULL);
+    parsebin = gst_element_factory_make ("parsebin", NULL);
+    fail_unless (src != NULL && parsebin != NULL);
+
+    caps = gst_caps_new_simple (media_type, "parsed", G_TYPE_BOOLEAN, FALSE,
+        NULL);
+    g_object_set (src, "caps", caps, "format", GST_FORMAT_TIME, NULL);
+    gst_caps_unref (caps);
+
+    g_signal_connect (parsebin, "autoplug-continue",
+        G_CALLBACK (autoplug_continue_cb), NULL);
+    g_signal_connect (parsebin, "pad-added", G_CALLBACK (pad_added_cb),
+        &out_caps);
+
+    gst_bin_add_many (GST_BIN (pipe), src, parsebin, NULL);
+    fail_unless (gst_element_link (src, parsebin));
+
+    fail_unless (gst_element_set_state (pipe, GST_STATE_PLAYING) !=
+        GST_STATE_CHANGE_FAILURE);
+
+    buf = gst_buffer_new_allocate (NULL, 16, NULL);
+    GST_BUFFER_PTS (buf) = 0;
+    g_signal_emit_by_name (src, "push-buffer", buf, &flow);
+    gst_buffer_unref (buf);
+    fail_unless_equals_int (flow, GST_FLOW_OK);
+    g_signal_emit_by_name (src, "end-of-stream", &flow);
+
+    bus = gst_element_get_bus (pipe);
+    msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+    gst_message_unref (msg);
+    gst_object_unref (bus);
+
+    fail_unless (out_caps != NULL);
+    s = gst_caps_get_structure (out_caps, 0);
+    fail_unless (gst_structure_has_name (s, media_type));
+    fail_unless (gst_structure_get_boolean (s, "parsed", &parsed));
+    fail_unless (parsed);
+    gst_caps_unref (out_caps);
+
+    gst_element_set_state (pipe, GST_STATE_NULL);
+    gst_object_unref (pipe);
+  }
+
+  /* one spare per factory, or one being prepared for it */
+  fail_unless (g_atomic_int_get (&live_parsers) <= 2);
+}
+
+GST_END_TEST;
+
+static Suite *
+parsebin_suite (void)
+{
+  Suite *s = suite_create ("parsebin");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_parser_caps_switch);
+
+  return s;
+}
+
+GST_CHECK_MAIN (parsebin);
@@ -378,6 +378,84 @@ GST_START_TEST (test_srt)
 
 GST_END_TEST;
 
+static guint64 seek_offset;
+
+static gboolean
+seek_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEEK) {
+    GstFormat format;
+    GstSeekType start_type;
+    gint64 start;
+
+    gst_event_parse_seek (event, NULL, &format, NULL, &start_type, &start,
+        NULL, NULL);
+    fail_unless_equals_int (format, GST_FORMAT_BYTES);
+    fail_unless_equals_int (start_type, GST_SEEK_TYPE_SET);
+    seek_offset = start;
+  }
+  gst_event_unref (event);
+
+  return TRUE;
+}
+
+static guint64
+do_seek (GstClockTime time)
+{
+  seek_offset = G_MAXUINT64;
+  fail_unless (gst_pad_push_event (mysinkpad,
+          gst_event_new_seek (1.0, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH,
+              GST_SEEK_TYPE_SET, time, GST_SEEK_TYPE_NONE, -1)));
+  fail_unless (seek_offset != G_MAXUINT64);
+
+  return seek_offset;
+}
+
+static guint64
+srt_input_offset (guint idx)
+{
+  guint64 offset = 0;
+  guint n;
+
+  for (n = 0; n < idx; n++)
+    offset += strlen (srt_input[n].in);
+
+  return offset;
+}
+
+GST_START_TEST (test_srt_seek_index)
+{
+  guint n;
+
+  setup_subparse ();
+  gst_pad_set_event_function (mysrcpad, seek_src_event);
+
+  /* nothing parsed yet, has to start from the beginning */
+  fail_unless_equals_uint64 (do_seek (5 * GST_SECOND), 0);
+
+  for (n = 0; n < G_N_ELEMENTS (srt_input); ++n) {
+    GstBuffer *buf;
+
+    buf = buffer_from_static_string (srt_input[n].in);
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  }
+
+  fail_unless_equals_uint64 (do_seek (0), 0);
+  fail_unless_equals_uint64 (do_seek (GST_SECOND / 2), 0);
+  /* in the middle of the seventh cue */
+  fail_unless_equals_uint64 (do_seek (7500 * GST_MSECOND),
+      srt_input_offset (6));
+  /* between two cues, resumes from the next one */
+  fail_unless_equals_uint64 (do_seek (150 * GST_SECOND), srt_input_offset (14));
+  fail_unless_equals_uint64 (do_seek (200 * GST_SECOND), srt_input_offset (14));
+  /* after the last cue, resumes from it */
+  fail_unless_equals_uint64 (do_seek (1000 * GST_SECOND),
+      srt_input_offset (G_N_ELEMENTS (srt_input) - 1));
+
+  teardown_subparse ();
+}
+
+GST_END_TEST;
 
 GST_START_TEST (test_webvtt)
 {
@@ -1013,6 +1091,7 @@ subparse_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_srt);
+  tcase_add_test (tc_chain, test_srt_seek_index);
   tcase_add_test (tc_chain, test_webvtt);
   tcase_add_test (tc_chain, test_tmplayer_multiline);
   tcase_add_test (tc_chain, test_tmplayer_multiline_with_bogus_lines);
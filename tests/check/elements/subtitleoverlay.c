@@ -0,0 +1,398 @@
+/* GStreamer unit tests for subtitleoverlay
+ *
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+
+/* Two subtitle renderers, each for its own subtitle format. They pass the
+ * video through, drop the subtitles and only store their properties. */
+typedef struct _TestRenderer
+{
+  GstElement parent;
+
+  GstPad *video_sinkpad;
+  GstPad *subtitle_sinkpad;
+  GstPad *srcpad;
+
+  gboolean silent;
+  gchar *font_desc;
+  gchar *encoding;
+} TestRenderer;
+
+typedef GstElementClass TestRendererClass;
+typedef TestRenderer TestRendererA;
+typedef TestRendererClass TestRendererAClass;
+typedef TestRenderer TestRendererB;
+typedef TestRendererClass TestRendererBClass;
+
+static GType test_renderer_get_type (void);
+static GType test_renderer_a_get_type (void);
+static GType test_renderer_b_get_type (void);
+
+G_DEFINE_ABSTRACT_TYPE (TestRenderer, test_renderer, GST_TYPE_ELEMENT);
+G_DEFINE_TYPE (TestRendererA, test_renderer_a, test_renderer_get_type ());
+G_DEFINE_TYPE (TestRendererB, test_renderer_b, test_renderer_get_type ());
+
+enum
+{
+  PROP_0,
+  PROP_SILENT,
+  PROP_FONT_DESC,
+  PROP_SUBTITLE_ENCODING
+};
+
+static gboolean
+test_renderer_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  TestRenderer *self = (TestRenderer *) parent;
+
+  return gst_pad_peer_query (self->video_sinkpad, query);
+}
+
+static GstFlowReturn
+test_renderer_video_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+{
+  TestRenderer *self = (TestRenderer *) parent;
+
+  return gst_pad_push (self->srcpad, buf);
+}
+
+static gboolean
+test_renderer_subtitle_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  gst_event_unref (event);
+  return TRUE;
+}
+
+static GstFlowReturn
+test_renderer_subtitle_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buf)
+{
+  gst_buffer_unref (buf);
+  return GST_FLOW_OK;
+}
+
+static void
+test_renderer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  TestRenderer *self = (TestRenderer *) object;
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_SILENT:
+      self->silent = g_value_get_boolean (value);
+      break;
+    case PROP_FONT_DESC:
+      g_free (self->font_desc);
+      self->font_desc = g_value_dup_string (value);
+      break;
+    case PROP_SUBTITLE_ENCODING:
+      g_free (self->encoding);
+      self->encoding = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+test_renderer_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  TestRenderer *self = (TestRenderer *) object;
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_SILENT:
+      g_value_set_boolean (value, self->silent);
+      break;
+    case PROP_FONT_DESC:
+      g_value_set_string (value, self->font_desc);
+      break;
+    case PROP_SUBTITLE_ENCODING:
+      g_value_set_string (value, self->encoding);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+test_renderer_finalize (GObject * object)
+{
+  TestRenderer *self = (TestRenderer *) object;
+
+  g_free (self->font_desc);
+  g_free (self->encoding);
+
+  G_OBJECT_CLASS (test_renderer_parent_class)->finalize (object);
+}
+
+static void
+test_renderer_class_init (TestRendererClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->set_property = test_renderer_set_property;
+  gobject_class->get_property = test_renderer_get_property;
+  gobject_class->finalize = test_renderer_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_SILENT,
+      g_param_spec_boolean ("silent", "Silent", "Silent", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_FONT_DESC,
+      g_param_spec_string ("font-desc", "Font", "Font", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_SUBTITLE_ENCODING,
+      g_param_spec_string ("subtitle-encoding", "Encoding", "Encoding", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void
+test_renderer_init (TestRenderer * self)
+{
+  GstElementClass *klass = GST_ELEMENT_GET_CLASS (self);
+
+  self->video_sinkpad =
+      gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
+          "video_sink"), "video_sink");
+  GST_PAD_SET_PROXY_CAPS (self->video_sinkpad);
+  GST_PAD_SET_PROXY_ALLOCATION (self->video_sinkpad);
+  gst_pad_set_chain_function (self->video_sinkpad, test_renderer_video_chain);
+  gst_element_add_pad (GST_ELEMENT (self), self->video_sinkpad);
+
+  self->subtitle_sinkpad =
+      gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
+          "subtitle_sink"), "subtitle_sink");
+  gst_pad_set_event_function (self->subtitle_sinkpad,
+      test_renderer_subtitle_event);
+  gst_pad_set_chain_function (self->subtitle_sinkpad,
+      test_renderer_subtitle_chain);
+  gst_element_add_pad (GST_ELEMENT (self), self->subtitle_sinkpad);
+
+  self->srcpad =
+      gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
+          "src"), "src");
+  gst_pad_set_query_function (self->srcpad, test_renderer_src_query);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+}
+
+static void
+test_renderer_class_setup (GstElementClass * klass, const gchar * media_type)
+{
+  GstCaps *caps;
+
+  caps = gst_caps_new_empty_simple ("video/x-raw");
+  gst_element_class_add_pad_template (klass,
+      gst_pad_template_new ("video_sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+          caps));
+  gst_element_class_add_pad_template (klass,
+      gst_pad_template_new ("src", GST_PAD_SRC, GST_PAD_ALWAYS, caps));
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_empty_simple (media_type);
+  gst_element_class_add_pad_template (klass,
+      gst_pad_template_new ("subtitle_sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+          caps));
+  gst_caps_unref (caps);
+
+  gst_element_class_set_metadata (klass, "Test renderer",
+      "Overlay/Subtitle", "Drops subtitles", "Test <test@example.com>");
+}
+
+static void
+test_renderer_a_class_init (TestRendererAClass * klass)
+{
+  test_renderer_class_setup (klass, "test/x-sub-a");
+}
+
+static void
+test_renderer_a_init (TestRendererA * self)
+{
+}
+
+static void
+test_renderer_b_class_init (TestRendererBClass * klass)
+{
+  test_renderer_class_setup (klass, "test/x-sub-b");
+}
+
+static void
+test_renderer_b_init (TestRendererB * self)
+{
+}
+
+/* Switches the subtitle track to @media_type and waits until a new
+ * renderer is in place. Returns the number of reused elements */
+static guint
+switch_subtitles (GstElement * pipe, GstElement * src,
+    const gchar * media_type)
+{
+  GstCaps *caps;
+  GstBuffer *buf;
+  GstFlowReturn flow;
+  GstBus *bus;
+  guint reused = 0;
+
+  caps = gst_caps_new_empty_simple (media_type);
+  g_object_set (src, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  buf = gst_buffer_new_allocate (NULL, 16, NULL);
+  GST_BUFFER_PTS (buf) = 0;
+  g_signal_emit_by_name (src, "push-buffer", buf, &flow);
+  gst_buffer_unref (buf);
+  fail_unless_equals_int (flow, GST_FLOW_OK);
+
+  bus = gst_element_get_bus (pipe);
+  for (;;) {
+    GstMessage *msg;
+    const GstStructure *s;
+    const gchar *mode;
+
+    /* skips the passthrough switch done while there were no caps yet */
+    msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+        GST_MESSAGE_ELEMENT | GST_MESSAGE_ERROR);
+    fail_unless (msg != NULL);
+    fail_unless (GST_MESSAGE_TYPE (msg) != GST_MESSAGE_ERROR);
+
+    s = gst_message_get_structure (msg);
+    if (gst_structure_has_name (s, "subtitleoverlay-switch")) {
+      mode = gst_structure_get_string (s, "mode");
+      if (g_strcmp0 (mode, "overlay") == 0) {
+        fail_unless (gst_structure_get_uint (s, "reused-elements", &reused));
+        gst_message_unref (msg);
+        break;
+      }
+    }
+    gst_message_unref (msg);
+  }
+  gst_object_unref (bus);
+
+  return reused;
+}
+
+static void
+check_renderer_settings (GstElement * renderer, gboolean silent,
+    const gchar * font_desc, const gchar * encoding)
+{
+  gboolean r_silent;
+  gchar *r_font_desc, *r_encoding;
+
+  g_object_get (renderer, "silent", &r_silent, "font-desc", &r_font_desc,
+      "subtitle-encoding", &r_encoding, NULL);
+  fail_unless_equals_int (r_silent, silent);
+  fail_unless_equals_string (r_font_desc, font_desc);
+  fail_unless_equals_string (r_encoding, encoding);
+  g_free (r_font_desc);
+  g_free (r_encoding);
+}
+
+/* Switches between two subtitle tracks that need different renderers.
+ * The renderer of the first track is reused when switching back and
+ * must follow the settings changed in between. */
+GST_START_TEST (test_track_switch_reuse)
+{
+  GstElement *pipe, *vsrc, *src, *overlay, *sink, *renderer, *renderer_a;
+  GstPad *srcpad, *sinkpad;
+  guint reused;
+
+  fail_unless (gst_element_register (NULL, "testrenderera",
+          GST_RANK_PRIMARY + 1, test_renderer_a_get_type ()));
+  fail_unless (gst_element_register (NULL, "testrendererb",
+          GST_RANK_PRIMARY + 1, test_renderer_b_get_type ()));
+
+  pipe = gst_pipeline_new (NULL);
+  vsrc = gst_element_factory_make ("videotestsrc", NULL);
+  src = gst_element_factory_make ("appsrc", NULL);
+  overlay = gst_element_factory_make ("subtitleoverlay", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (vsrc && src && overlay && sink);
+
+  g_object_set (src, "format", GST_FORMAT_TIME, NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  g_object_set (overlay, "font-desc", "Sans 10", NULL);
+
+  gst_bin_add_many (GST_BIN (pipe), vsrc, src, overlay, sink, NULL);
+  fail_unless (gst_element_link_pads (vsrc, "src", overlay, "video_sink"));
+  fail_unless (gst_element_link (overlay, sink));
+  srcpad = gst_element_get_static_pad (src, "src");
+  sinkpad = gst_element_get_static_pad (overlay, "subtitle_sink");
+  fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+
+  fail_unless (gst_element_set_state (pipe, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  switch_subtitles (pipe, src, "test/x-sub-a");
+  renderer_a = gst_bin_get_by_name (GST_BIN (overlay), "renderer");
+  fail_unless (renderer_a != NULL);
+  fail_unless (G_TYPE_CHECK_INSTANCE_TYPE (renderer_a,
+          test_renderer_a_get_type ()));
+  check_renderer_settings (renderer_a, FALSE, "Sans 10", NULL);
+
+  switch_subtitles (pipe, src, "test/x-sub-b");
+  renderer = gst_bin_get_by_name (GST_BIN (overlay), "renderer");
+  fail_unless (renderer != NULL);
+  fail_unless (G_TYPE_CHECK_INSTANCE_TYPE (renderer,
+          test_renderer_b_get_type ()));
+
+  g_object_set (overlay, "silent", TRUE, "font-desc", "Serif 20",
+      "subtitle-encoding", "UTF-8", NULL);
+  check_renderer_settings (renderer, TRUE, "Serif 20", "UTF-8");
+  gst_object_unref (renderer);
+
+  reused = switch_subtitles (pipe, src, "test/x-sub-a");
+  fail_unless (reused > 0);
+  renderer = gst_bin_get_by_name (GST_BIN (overlay), "renderer");
+  fail_unless (renderer == renderer_a);
+  check_renderer_settings (renderer, TRUE, "Serif 20", "UTF-8");
+  gst_object_unref (renderer);
+  gst_object_unref (renderer_a);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+subtitleoverlay_suite (void)
+{
+  Suite *s = suite_create ("subtitleoverlay");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_track_switch_reuse);
+
+  return s;
+}
+
+GST_CHECK_MAIN (subtitleoverlay);
@@ -28,6 +28,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
 
 static guint
@@ -117,6 +118,83 @@ GST_START_TEST (test_template_formats)
 
 GST_END_TEST;
 
+GST_START_TEST (test_crop_meta)
+{
+  GstHarness *h;
+  GstVideoInfo info, out_info;
+  GstBuffer *buf;
+  GstVideoFrame frame;
+  GstVideoCropMeta *crop;
+  guint8 *data;
+  gint x, y, stride;
+
+  h = gst_harness_new ("videoconvert");
+  gst_harness_set_src_caps_str (h, "video/x-raw, format=NV12, width=32, "
+      "height=16, framerate=30/1");
+  gst_harness_set_sink_caps_str (h, "video/x-raw, format=I420, width=32, "
+      "height=16, framerate=30/1");
+
+  /* the caps have the size of the region, the video meta the size of the
+   * whole frame */
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_NV12, 64, 48);
+  buf = gst_buffer_new_allocate (NULL, info.size, NULL);
+  gst_buffer_add_video_meta_full (buf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_NV12, 64, 48, info.finfo->n_planes, info.offset,
+      info.stride);
+  crop = gst_buffer_add_video_crop_meta (buf);
+  crop->x = 16;
+  crop->y = 8;
+  crop->width = 32;
+  crop->height = 16;
+
+  fail_unless (gst_video_frame_map (&frame, &info, buf, GST_MAP_WRITE));
+  data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 0);
+  stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0);
+  for (y = 0; y < 48; y++)
+    for (x = 0; x < 64; x++)
+      data[y * stride + x] = x + y * 3;
+  data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 1);
+  stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 1);
+  for (y = 0; y < 24; y++) {
+    for (x = 0; x < 32; x++) {
+      data[y * stride + 2 * x] = 100 + x + y * 2;
+      data[y * stride + 2 * x + 1] = 50 + x + y * 2;
+    }
+  }
+  gst_video_frame_unmap (&frame);
+
+  buf = gst_harness_push_and_pull (h, buf);
+  fail_unless (buf != NULL);
+  /* the crop was applied when converting */
+  fail_if (gst_buffer_get_video_crop_meta (buf));
+
+  gst_video_info_set_format (&out_info, GST_VIDEO_FORMAT_I420, 32, 16);
+  fail_unless (gst_video_frame_map (&frame, &out_info, buf, GST_MAP_READ));
+  for (y = 0; y < 16; y++) {
+    data = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&frame, 0) +
+        y * GST_VIDEO_FRAME_COMP_STRIDE (&frame, 0);
+    for (x = 0; x < 32; x++)
+      fail_unless_equals_int (data[x], x + 16 + (y + 8) * 3);
+  }
+  for (y = 0; y < 8; y++) {
+    guint8 *u = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&frame, 1) +
+        y * GST_VIDEO_FRAME_COMP_STRIDE (&frame, 1);
+    guint8 *v = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&frame, 2) +
+        y * GST_VIDEO_FRAME_COMP_STRIDE (&frame, 2);
+
+    for (x = 0; x < 16; x++) {
+      fail_unless_equals_int (u[x], 100 + x + 8 + (y + 4) * 2);
+      fail_unless_equals_int (v[x], 50 + x + 8 + (y + 4) * 2);
+    }
+  }
+  gst_video_frame_unmap (&frame);
+  gst_buffer_unref (buf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 videoconvert_suite (void)
 {
@@ -126,6 +204,7 @@ videoconvert_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_template_formats);
+  tcase_add_test (tc_chain, test_crop_meta);
 
   return s;
 }
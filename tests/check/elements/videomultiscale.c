@@ -0,0 +1,302 @@
+/* GStreamer
+ *
+ * unit test for videomultiscale
+ *
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/video/video.h>
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("I420")));
+
+typedef struct
+{
+  GstPad *srcpad;
+  GstPad *sinkpad;
+  GList *buffers;
+} Rendition;
+
+static GstFlowReturn
+rendition_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  Rendition *r = g_object_get_data (G_OBJECT (pad), "rendition");
+
+  r->buffers = g_list_append (r->buffers, buffer);
+
+  return GST_FLOW_OK;
+}
+
+/* a height of 0 leaves the height to the element */
+static void
+setup_rendition (GstElement * scale, Rendition * r, gint width, gint height)
+{
+  GstPadTemplate *templ;
+  GstCaps *caps;
+
+  caps = gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT, width,
+      NULL);
+  if (height)
+    gst_caps_set_simple (caps, "height", G_TYPE_INT, height, NULL);
+  templ = gst_pad_template_new ("sink", GST_PAD_SINK, GST_PAD_ALWAYS, caps);
+  gst_caps_unref (caps);
+
+  r->buffers = NULL;
+  r->srcpad = gst_element_get_request_pad (scale, "src_%u");
+  fail_unless (r->srcpad != NULL);
+  r->sinkpad = gst_pad_new_from_template (templ, "sink");
+  gst_object_unref (templ);
+
+  g_object_set_data (G_OBJECT (r->sinkpad), "rendition", r);
+  gst_pad_set_chain_function (r->sinkpad, rendition_chain);
+  gst_pad_set_active (r->sinkpad, TRUE);
+  fail_unless_equals_int (gst_pad_link (r->srcpad, r->sinkpad),
+      GST_PAD_LINK_OK);
+}
+
+static void
+teardown_rendition (GstElement * scale, Rendition * r)
+{
+  gst_pad_unlink (r->srcpad, r->sinkpad);
+  gst_pad_set_active (r->sinkpad, FALSE);
+  gst_object_unref (r->sinkpad);
+  gst_element_release_request_pad (scale, r->srcpad);
+  gst_object_unref (r->srcpad);
+  g_list_free_full (r->buffers, (GDestroyNotify) gst_buffer_unref);
+}
+
+static void
+fill_gradient (GstVideoFrame * frame)
+{
+  guint p;
+  gint x, y;
+
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (frame); p++) {
+    guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (frame, p);
+    gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, p);
+    gint w = GST_VIDEO_FRAME_COMP_WIDTH (frame, p);
+    gint h = GST_VIDEO_FRAME_COMP_HEIGHT (frame, p);
+
+    for (y = 0; y < h; y++)
+      for (x = 0; x < w; x++)
+        data[y * stride + x] = (x + y) * 255 / (w + h - 2);
+  }
+}
+
+/* what videoscale makes of @buffer with the same method */
+static GstBuffer *
+scale_reference (GstBuffer * buffer, gint in_width, gint in_height,
+    gint width, gint height, gint method)
+{
+  GstHarness *h;
+  GstVideoInfo info;
+  GstCaps *in_caps, *out_caps;
+  GstBuffer *outbuf;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, in_width,
+      in_height);
+  in_caps = gst_video_info_to_caps (&info);
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, width, height);
+  out_caps = gst_video_info_to_caps (&info);
+
+  h = gst_harness_new ("videoscale");
+  g_object_set (h->element, "method", method, NULL);
+  gst_harness_set_caps (h, in_caps, out_caps);
+  outbuf = gst_harness_push_and_pull (h, gst_buffer_ref (buffer));
+  fail_unless (outbuf != NULL);
+  gst_harness_teardown (h);
+
+  return outbuf;
+}
+
+static void
+check_rendition (Rendition * r, gint width, gint height, GstBuffer * ref)
+{
+  GstCaps *caps;
+  GstVideoInfo info;
+  GstVideoFrame frame, ref_frame;
+  guint p;
+  gint x, y;
+
+  caps = gst_pad_get_current_caps (r->sinkpad);
+  fail_unless (caps != NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_caps_unref (caps);
+
+  fail_unless_equals_int (GST_VIDEO_INFO_FORMAT (&info),
+      GST_VIDEO_FORMAT_I420);
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&info), width);
+  fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&info), height);
+  fail_unless_equals_int (GST_VIDEO_INFO_PAR_N (&info),
+      GST_VIDEO_INFO_PAR_D (&info));
+
+  fail_unless_equals_int (g_list_length (r->buffers), 1);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (r->buffers->data), 0);
+
+  /* the rendition has no video meta, it must have the default layout */
+  fail_unless (gst_buffer_get_video_meta (r->buffers->data) == NULL);
+  fail_unless (gst_video_frame_map (&frame, &info, r->buffers->data,
+          GST_MAP_READ));
+  fail_unless (gst_video_frame_map (&ref_frame, &info, ref, GST_MAP_READ));
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&frame); p++) {
+    const guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (&frame, p);
+    const guint8 *ref_data = GST_VIDEO_FRAME_PLANE_DATA (&ref_frame, p);
+    gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, p);
+    gint ref_stride = GST_VIDEO_FRAME_PLANE_STRIDE (&ref_frame, p);
+
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&frame, p); y++)
+      for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (&frame, p); x++)
+        fail_unless_equals_int (data[y * stride + x],
+            ref_data[y * ref_stride + x]);
+  }
+  gst_video_frame_unmap (&ref_frame);
+  gst_video_frame_unmap (&frame);
+}
+
+/* @padding adds bytes at the end of the lines of the input, described by
+ * a video meta */
+static void
+run_ladder (gboolean cascade, guint padding)
+{
+  static const gint sizes[][2] = {
+    {80, 60}, {320, 240}, {160, 120}, {100, 0}
+  };
+  Rendition r[G_N_ELEMENTS (sizes)];
+  GstElement *scale;
+  GstPad *srcpad;
+  GstVideoInfo info;
+  GstVideoAlignment align;
+  GstVideoFrame frame;
+  GstCaps *caps;
+  GstBuffer *inbuf, *ref;
+  guint i;
+
+  scale = gst_check_setup_element ("videomultiscale");
+  g_object_set (scale, "cascade", cascade, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++)
+    setup_rendition (scale, &r[i], sizes[i][0], sizes[i][1]);
+  g_object_set (r[2].srcpad, "method", 3, NULL);
+
+  srcpad = gst_check_setup_src_pad (scale, &srctemplate);
+  gst_pad_set_active (srcpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (scale, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 320, 240);
+  caps = gst_video_info_to_caps (&info);
+  gst_check_setup_events (srcpad, scale, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  gst_video_alignment_reset (&align);
+  align.padding_right = padding;
+  fail_unless (gst_video_info_align (&info, &align));
+  inbuf = gst_buffer_new_allocate (NULL, info.size, NULL);
+  if (padding)
+    gst_buffer_add_video_meta_full (inbuf, GST_VIDEO_FRAME_FLAG_NONE,
+        GST_VIDEO_INFO_FORMAT (&info), GST_VIDEO_INFO_WIDTH (&info),
+        GST_VIDEO_INFO_HEIGHT (&info), GST_VIDEO_INFO_N_PLANES (&info),
+        info.offset, info.stride);
+  fail_unless (gst_video_frame_map (&frame, &info, inbuf, GST_MAP_WRITE));
+  fill_gradient (&frame);
+  gst_video_frame_unmap (&frame);
+  GST_BUFFER_PTS (inbuf) = 0;
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_ref (inbuf)),
+      GST_FLOW_OK);
+
+  /* the same size as the input is videoscale's passthrough */
+  ref = scale_reference (inbuf, 320, 240, 320, 240, 1);
+  check_rendition (&r[1], 320, 240, ref);
+  gst_buffer_unref (ref);
+
+  ref = scale_reference (inbuf, 320, 240, 160, 120, 3);
+  check_rendition (&r[2], 160, 120, ref);
+  gst_buffer_unref (ref);
+
+  /* the height keeps the display aspect ratio. With cascade the smaller
+   * renditions are scaled from the next larger one. */
+  ref = cascade ? scale_reference (r[2].buffers->data, 160, 120, 100, 75, 1)
+      : scale_reference (inbuf, 320, 240, 100, 75, 1);
+  check_rendition (&r[3], 100, 75, ref);
+  gst_buffer_unref (ref);
+
+  ref = cascade ? scale_reference (r[3].buffers->data, 100, 75, 80, 60, 1)
+      : scale_reference (inbuf, 320, 240, 80, 60, 1);
+  check_rendition (&r[0], 80, 60, ref);
+  gst_buffer_unref (ref);
+
+  /* the rendition with the size of the input is only copied when
+   * downstream can't read the layout of the input */
+  if (padding)
+    fail_unless (r[1].buffers->data != inbuf);
+  else
+    fail_unless (r[1].buffers->data == inbuf);
+  gst_buffer_unref (inbuf);
+
+  fail_unless_equals_int (gst_element_set_state (scale, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++)
+    teardown_rendition (scale, &r[i]);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_check_teardown_src_pad (scale);
+  gst_check_teardown_element (scale);
+}
+
+GST_START_TEST (test_ladder)
+{
+  run_ladder (FALSE, 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_ladder_cascade)
+{
+  run_ladder (TRUE, 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_ladder_padded)
+{
+  run_ladder (FALSE, 32);
+}
+
+GST_END_TEST;
+
+static Suite *
+videomultiscale_suite (void)
+{
+  Suite *s = suite_create ("videomultiscale");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_ladder);
+  tcase_add_test (tc_chain, test_ladder_cascade);
+  tcase_add_test (tc_chain, test_ladder_padded);
+
+  return s;
+}
+
+GST_CHECK_MAIN (videomultiscale);
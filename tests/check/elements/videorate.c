@@ -1397,6 +1397,94 @@ GST_START_TEST (test_query_position)
 
 GST_END_TEST;
 
+static const gchar *duplication_modes[] = { "copy", "list", "timestamp" };
+
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *n_lists = user_data;
+
+  (*n_lists)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+push_frame (GstClockTime ts, guint8 value)
+{
+  GstBuffer *buf;
+
+  buf = gst_buffer_new_and_alloc (4);
+  gst_buffer_memset (buf, 0, value, 4);
+  GST_BUFFER_TIMESTAMP (buf) = ts;
+  fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+}
+
+GST_START_TEST (test_duplication_mode)
+{
+  const gchar *mode = duplication_modes[__i__];
+  GstElement *videorate;
+  GstCaps *caps;
+  GList *l;
+  guint n_lists = 0;
+  gint i;
+
+  videorate = setup_videorate ();
+  gst_util_set_object_arg (G_OBJECT (videorate), "duplication-mode", mode);
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+  gst_pad_add_probe (mysinkpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      count_buffer_lists, &n_lists, NULL);
+
+  caps = gst_caps_from_string (VIDEO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  /* the second frame is used for three output frames, like in test_more */
+  push_frame (0, 1);
+  push_frame (GST_SECOND * 3 / 50, 2);
+  push_frame (GST_SECOND * 12 / 50, 3);
+  assert_videorate_stats (videorate, mode, 3, 4, 0, 2);
+
+  l = buffers;
+  fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (l->data), 0);
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (l->data), GST_SECOND / 25);
+  fail_unless_equals_int (buffer_get_byte (l->data, 0), 1);
+
+  if (g_str_equal (mode, "timestamp")) {
+    /* one buffer lasting for the three frames */
+    fail_unless_equals_int (g_list_length (buffers), 2);
+    l = g_list_next (l);
+    fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (l->data),
+        GST_SECOND / 25);
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (l->data),
+        GST_SECOND * 3 / 25);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (l->data), 1);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET_END (l->data), 4);
+    fail_unless (!GST_BUFFER_FLAG_IS_SET (l->data, GST_BUFFER_FLAG_GAP));
+    fail_unless_equals_int (buffer_get_byte (l->data, 0), 2);
+    fail_unless_equals_int (n_lists, 0);
+  } else {
+    fail_unless_equals_int (g_list_length (buffers), 4);
+    for (i = 1; i < 4; i++) {
+      l = g_list_next (l);
+      fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (l->data),
+          GST_SECOND * i / 25);
+      fail_unless_equals_uint64 (GST_BUFFER_DURATION (l->data),
+          GST_SECOND / 25);
+      fail_unless_equals_uint64 (GST_BUFFER_OFFSET (l->data), i);
+      fail_unless_equals_int (buffer_get_byte (l->data, 0), 2);
+    }
+    /* the three frames made from the second input come in one list */
+    fail_unless_equals_int (n_lists, g_str_equal (mode, "list") ? 1 : 0);
+  }
+
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 static Suite *
 videorate_suite (void)
 {
@@ -1421,6 +1509,8 @@ videorate_suite (void)
   tcase_add_test (tc_chain, test_query_duration);
   tcase_add_loop_test (tc_chain, test_query_position, 0,
       G_N_ELEMENTS (position_tests));
+  tcase_add_loop_test (tc_chain, test_duplication_mode, 0,
+      G_N_ELEMENTS (duplication_modes));
 
   return s;
 }
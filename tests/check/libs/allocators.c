@@ -26,6 +26,7 @@
 #include <gst/check/gstcheck.h>
 
 #include <gst/allocators/gstdmabuf.h>
+#include <gst/allocators/gstmemfdallocator.h>
 #include <string.h>
 
 #define FILE_SIZE 4096
@@ -60,6 +61,57 @@ GST_START_TEST (test_dmabuf)
 
 GST_END_TEST;
 
+GST_START_TEST (test_memfd)
+{
+  GstAllocationParams params;
+  GstAllocator *alloc;
+  GstMemory *mem, *sub;
+  GstMapInfo info;
+  guint i;
+
+  alloc = gst_memfd_allocator_new (GST_MEMFD_ALLOCATOR_FLAG_DEFAULT);
+  if (alloc == NULL)
+    return;
+
+  gst_allocation_params_init (&params);
+  params.prefix = 64;
+  params.padding = 32;
+
+  /* small allocations use normal pages, large ones may use huge pages */
+  for (i = 0; i < 2; i++) {
+    gsize size = i == 0 ? FILE_SIZE : 3840 * 2160 * 3 / 2;
+
+    mem = gst_allocator_alloc (alloc, size, &params);
+    fail_unless (mem != NULL);
+    fail_unless (gst_is_memfd_memory (mem));
+    fail_unless (gst_is_fd_memory (mem));
+    fail_unless (gst_fd_memory_get_fd (mem) >= 0);
+    fail_unless_equals_int (mem->offset, 64);
+    fail_unless_equals_int (mem->size, size);
+    fail_unless (mem->maxsize >= size + 64 + 32);
+
+    fail_unless (gst_memory_map (mem, &info, GST_MAP_READWRITE));
+    fail_unless (info.size == size);
+    /* fresh memory is zeroed */
+    fail_unless (info.data[0] == 0 && info.data[size - 1] == 0);
+    memset (info.data, 0xaa, size);
+    gst_memory_unmap (mem, &info);
+
+    /* shared memory sees the same pages */
+    sub = gst_memory_share (mem, 16, 16);
+    fail_unless (gst_memory_map (sub, &info, GST_MAP_READ));
+    fail_unless (info.data[0] == 0xaa && info.data[15] == 0xaa);
+    gst_memory_unmap (sub, &info);
+    gst_memory_unref (sub);
+
+    gst_memory_unref (mem);
+  }
+
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 static Suite *
 allocators_suite (void)
 {
@@ -68,6 +120,7 @@ allocators_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_dmabuf);
+  tcase_add_test (tc_chain, test_memfd);
 
   return s;
 }
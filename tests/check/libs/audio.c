@@ -1065,6 +1065,593 @@ GST_START_TEST (test_stream_align_reverse)
 
 GST_END_TEST;
 
+static void
+quantize_both (GstAudioQuantize * fast, GstAudioQuantize * ref,
+    GstAudioQuantizeFlags flags, guint channels, const gint32 * in,
+    gint32 * out_fast, gint32 * out_ref, guint samples)
+{
+  gpointer in_p[8], fast_p[8], ref_p[8];
+  guint c;
+
+  if (flags & GST_AUDIO_QUANTIZE_FLAG_NON_INTERLEAVED) {
+    for (c = 0; c < channels; c++) {
+      in_p[c] = (gpointer) (in + c * samples);
+      fast_p[c] = out_fast + c * samples;
+      ref_p[c] = out_ref + c * samples;
+    }
+  } else {
+    in_p[0] = (gpointer) in;
+    fast_p[0] = out_fast;
+    ref_p[0] = out_ref;
+  }
+
+  gst_audio_quantize_samples (fast, in_p, fast_p, samples);
+  gst_audio_quantize_samples (ref, in_p, ref_p, samples);
+}
+
+GST_START_TEST (test_quantize_noise_shaping_reference)
+{
+  static const guint sizes[] = { 1, 7, 333, 1024 };
+  static const guint channels[] = { 1, 2, 6 };
+  GstAudioNoiseShapingMethod ns;
+  guint c, f, i, k;
+  GRand *rand = g_rand_new_with_seed (42);
+
+  /* without dither the output must match the reference bit by bit, also
+   * when the error history is carried over between calls of different
+   * sizes and the samples get clipped */
+  for (ns = GST_AUDIO_NOISE_SHAPING_NONE; ns <= GST_AUDIO_NOISE_SHAPING_HIGH;
+      ns++) {
+    for (c = 0; c < G_N_ELEMENTS (channels); c++) {
+      for (f = 0; f < 2; f++) {
+        GstAudioQuantizeFlags flags =
+            f ? GST_AUDIO_QUANTIZE_FLAG_NON_INTERLEAVED : 0;
+        GstAudioQuantize *fast, *ref;
+
+        fast = gst_audio_quantize_new (GST_AUDIO_DITHER_NONE, ns, flags,
+            GST_AUDIO_FORMAT_S32, channels[c], 1 << 16);
+        ref = gst_audio_quantize_new (GST_AUDIO_DITHER_NONE, ns,
+            flags | GST_AUDIO_QUANTIZE_FLAG_REFERENCE, GST_AUDIO_FORMAT_S32,
+            channels[c], 1 << 16);
+
+        for (k = 0; k < G_N_ELEMENTS (sizes); k++) {
+          guint len = sizes[k] * channels[c];
+          gint32 *in = g_new (gint32, len);
+          gint32 *out_fast = g_new (gint32, len);
+          gint32 *out_ref = g_new (gint32, len);
+
+          for (i = 0; i < len; i++) {
+            if (i % 97 == 0)
+              in[i] = g_rand_boolean (rand) ? G_MAXINT32 : G_MININT32;
+            else
+              in[i] = (gint32) g_rand_int (rand) >> 1;
+          }
+
+          quantize_both (fast, ref, flags, channels[c], in, out_fast,
+              out_ref, sizes[k]);
+          fail_unless (memcmp (out_fast, out_ref, len * sizeof (gint32)) == 0,
+              "mismatch for ns %d, %u channels, flags 0x%x", ns,
+              channels[c], flags);
+
+          g_free (in);
+          g_free (out_fast);
+          g_free (out_ref);
+        }
+
+        gst_audio_quantize_free (fast);
+        gst_audio_quantize_free (ref);
+      }
+    }
+  }
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_quantize_dither)
+{
+  GstAudioDitherMethod dither;
+  gint32 in[2 * 1000] = { 0, }, out[2 * 1000], out2[2 * 1000];
+  gpointer in_p[1] = { in }, out_p[1] = { out }, out2_p[1] = { out2 };
+  guint i, counts[3];
+
+  for (dither = GST_AUDIO_DITHER_RPDF; dither <= GST_AUDIO_DITHER_TPDF_HF;
+      dither++) {
+    GstAudioQuantize *quant, *quant2;
+
+    quant = gst_audio_quantize_new (dither, GST_AUDIO_NOISE_SHAPING_NONE, 0,
+        GST_AUDIO_FORMAT_S32, 2, 1 << 16);
+    quant2 = gst_audio_quantize_new (dither, GST_AUDIO_NOISE_SHAPING_NONE, 0,
+        GST_AUDIO_FORMAT_S32, 2, 1 << 16);
+
+    gst_audio_quantize_samples (quant, in_p, out_p, 1000);
+    gst_audio_quantize_samples (quant2, in_p, out2_p, 1000);
+
+    /* the generator is per instance and deterministic */
+    fail_unless (memcmp (out, out2, sizeof (out)) == 0);
+
+    /* silence dithered by at most one quantization step */
+    counts[0] = counts[1] = counts[2] = 0;
+    for (i = 0; i < G_N_ELEMENTS (out); i++) {
+      fail_unless (out[i] == -65536 || out[i] == 0 || out[i] == 65536,
+          "unexpected value %d", out[i]);
+      counts[out[i] / 65536 + 1]++;
+    }
+    fail_unless (counts[0] > 0 && counts[2] > 0);
+
+    gst_audio_quantize_free (quant);
+    gst_audio_quantize_free (quant2);
+  }
+}
+
+GST_END_TEST;
+
+static gdouble
+mix_get_sample (GstAudioFormat format, gconstpointer data, gint idx)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+      return ((const gint16 *) data)[idx];
+    case GST_AUDIO_FORMAT_S32:
+      return ((const gint32 *) data)[idx];
+    case GST_AUDIO_FORMAT_F32:
+      return ((const gfloat *) data)[idx];
+    default:
+      return ((const gdouble *) data)[idx];
+  }
+}
+
+static void
+mix_set_sample (GstAudioFormat format, gpointer data, gint idx, gdouble val)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+      ((gint16 *) data)[idx] = val;
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      ((gint32 *) data)[idx] = val;
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      ((gfloat *) data)[idx] = val;
+      break;
+    default:
+      ((gdouble *) data)[idx] = val;
+      break;
+  }
+}
+
+#define MIX_SAMPLES 67
+
+/* runs @m through the mixer in all layouts and compares with a plain
+ * evaluation of the matrix */
+static void
+check_channel_mixer (GstAudioFormat format, gint in_channels,
+    gint out_channels, const gfloat * m)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gint bps = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+  gint flags, c, n, i;
+  gdouble *ref = g_new (gdouble, MIX_SAMPLES * out_channels);
+  gdouble *src = g_new (gdouble, MIX_SAMPLES * in_channels);
+  gpointer *in = g_new (gpointer, in_channels);
+  gpointer *out = g_new (gpointer, out_channels);
+
+  for (n = 0; n < MIX_SAMPLES; n++) {
+    for (c = 0; c < in_channels; c++) {
+      if (format == GST_AUDIO_FORMAT_S16)
+        src[n * in_channels + c] = g_random_int_range (-20000, 20000);
+      else if (format == GST_AUDIO_FORMAT_S32)
+        src[n * in_channels + c] = g_random_int_range (-(1 << 28), 1 << 28);
+      else
+        src[n * in_channels + c] = (gfloat) g_random_double_range (-1.0, 1.0);
+    }
+
+    for (c = 0; c < out_channels; c++) {
+      if (GST_AUDIO_FORMAT_INFO_IS_INTEGER (finfo)) {
+        gint64 res = 0;
+
+        for (i = 0; i < in_channels; i++) {
+          gint coeff = m[i * out_channels + c] * 1024.0f;
+
+          res += (gint64) src[n * in_channels + i] * coeff;
+        }
+        res = (res + 512) >> 10;
+        if (format == GST_AUDIO_FORMAT_S16)
+          ref[n * out_channels + c] = CLAMP (res, G_MININT16, G_MAXINT16);
+        else
+          ref[n * out_channels + c] = CLAMP (res, G_MININT32, G_MAXINT32);
+      } else {
+        gdouble res = 0;
+
+        for (i = 0; i < in_channels; i++)
+          res += src[n * in_channels + i] * m[i * out_channels + c];
+        ref[n * out_channels + c] = res;
+      }
+    }
+  }
+
+  for (flags = 0; flags < 4; flags++) {
+    GstAudioChannelMixer *mix;
+    gboolean in_planar, out_planar;
+    guint8 *in_data, *out_data;
+    gfloat **matrix;
+
+    in_planar = ! !(flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN);
+    out_planar = ! !(flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT);
+
+    matrix = g_new (gfloat *, in_channels);
+    for (i = 0; i < in_channels; i++) {
+      matrix[i] = g_new (gfloat, out_channels);
+      for (c = 0; c < out_channels; c++)
+        matrix[i][c] = m[i * out_channels + c];
+    }
+
+    mix = gst_audio_channel_mixer_new_with_matrix (flags, format, in_channels,
+        out_channels, matrix);
+    fail_unless (mix != NULL);
+
+    in_data = g_malloc (MIX_SAMPLES * in_channels * bps);
+    out_data = g_malloc (MIX_SAMPLES * out_channels * bps);
+    for (c = 0; c < in_channels; c++)
+      in[c] = in_planar ? in_data + c * MIX_SAMPLES * bps : in_data;
+    for (c = 0; c < out_channels; c++)
+      out[c] = out_planar ? out_data + c * MIX_SAMPLES * bps : out_data;
+
+    for (n = 0; n < MIX_SAMPLES; n++)
+      for (c = 0; c < in_channels; c++)
+        mix_set_sample (format, in[c],
+            in_planar ? n : n * in_channels + c, src[n * in_channels + c]);
+
+    gst_audio_channel_mixer_samples (mix, in, out, MIX_SAMPLES);
+
+    for (n = 0; n < MIX_SAMPLES; n++) {
+      for (c = 0; c < out_channels; c++) {
+        gdouble val = mix_get_sample (format, out[c],
+            out_planar ? n : n * out_channels + c);
+
+        if (GST_AUDIO_FORMAT_INFO_IS_INTEGER (finfo))
+          fail_unless_equals_float (val, ref[n * out_channels + c]);
+        else
+          fail_unless (ABS (val - ref[n * out_channels + c]) < 1e-5,
+              "%s %d->%d flags %d: sample %d channel %d is %f, expected %f",
+              gst_audio_format_to_string (format), in_channels, out_channels,
+              flags, n, c, val, ref[n * out_channels + c]);
+      }
+    }
+
+    g_free (in_data);
+    g_free (out_data);
+    gst_audio_channel_mixer_free (mix);
+  }
+
+  g_free (ref);
+  g_free (src);
+  g_free (in);
+  g_free (out);
+}
+
+GST_START_TEST (test_channel_mixer_kernels)
+{
+  static const GstAudioFormat formats[] = { GST_AUDIO_FORMAT_S16,
+    GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64
+  };
+  /* permutation */
+  static const gfloat swap[] = {
+    0.0, 1.0,
+    1.0, 0.0
+  };
+  /* dropping channels and adding silence */
+  static const gfloat pick[] = {
+    1.0, 0.0, 0.0,
+    0.0, 0.0, 0.0,
+    0.0, 0.0, 1.0,
+    0.0, 0.0, 0.0
+  };
+  /* 5.1 to stereo */
+  static const gfloat downmix_51[] = {
+    0.4142, 0.0,
+    0.0, 0.4142,
+    0.2929, 0.2929,
+    0.2929, 0.2929,
+    0.2929, 0.0,
+    0.0, 0.2929
+  };
+  /* 7.1 to 5.1, sides folded into the rear */
+  static const gfloat downmix_71[] = {
+    1.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+    0.0, 1.0, 0.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 1.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 1.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.5858, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.0, 0.5858,
+    0.0, 0.0, 0.0, 0.0, 0.4142, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.0, 0.4142
+  };
+  /* dense */
+  static const gfloat dense[] = {
+    0.3, -0.2, 0.1, 0.25, 0.5,
+    0.1, 0.4, -0.3, 0.25, 0.125,
+    -0.1, 0.2, 0.5, 0.25, 0.375
+  };
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    check_channel_mixer (formats[i], 2, 2, swap);
+    check_channel_mixer (formats[i], 4, 3, pick);
+    check_channel_mixer (formats[i], 6, 2, downmix_51);
+    check_channel_mixer (formats[i], 8, 6, downmix_71);
+    check_channel_mixer (formats[i], 3, 5, dense);
+  }
+}
+
+GST_END_TEST;
+
+/* unpositioned audio can have any number of channels */
+GST_START_TEST (test_channel_mixer_many_channels)
+{
+  static const GstAudioFormat formats[] = { GST_AUDIO_FORMAT_S16,
+    GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64
+  };
+  const gint in_channels = 80, out_channels = 72;
+  gfloat *reverse, *pairs;
+  gint i, o;
+
+  /* outputs are the inputs in reverse order, the last ones dropped */
+  reverse = g_new0 (gfloat, in_channels * out_channels);
+  for (o = 0; o < out_channels; o++)
+    reverse[(out_channels - 1 - o) * out_channels + o] = 1.0;
+
+  /* outputs average two neighbouring inputs */
+  pairs = g_new0 (gfloat, in_channels * out_channels);
+  for (o = 0; o < out_channels; o++) {
+    pairs[o * out_channels + o] = 0.5;
+    pairs[(o + 1) * out_channels + o] = 0.5;
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    check_channel_mixer (formats[i], in_channels, out_channels, reverse);
+    check_channel_mixer (formats[i], in_channels, out_channels, pairs);
+  }
+
+  g_free (reverse);
+  g_free (pairs);
+}
+
+GST_END_TEST;
+
+/* ringbuffer that only provides the memory, the tests act as the device by
+ * calling prepare_read() and advance() themselves */
+typedef GstAudioRingBuffer GstTestRingBuffer;
+typedef GstAudioRingBufferClass GstTestRingBufferClass;
+
+static GType gst_test_ring_buffer_get_type (void);
+G_DEFINE_TYPE (GstTestRingBuffer, gst_test_ring_buffer,
+    GST_TYPE_AUDIO_RING_BUFFER);
+
+static gboolean
+test_ring_buffer_true (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_acquire (GstAudioRingBuffer * buf,
+    GstAudioRingBufferSpec * spec)
+{
+  buf->size = spec->segtotal * spec->segsize;
+  buf->memory = g_malloc0 (buf->size);
+
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_release (GstAudioRingBuffer * buf)
+{
+  g_free (buf->memory);
+  buf->memory = NULL;
+
+  return TRUE;
+}
+
+static void
+gst_test_ring_buffer_class_init (GstTestRingBufferClass * klass)
+{
+  klass->open_device = test_ring_buffer_true;
+  klass->close_device = test_ring_buffer_true;
+  klass->acquire = test_ring_buffer_acquire;
+  klass->release = test_ring_buffer_release;
+  klass->start = test_ring_buffer_true;
+  klass->pause = test_ring_buffer_true;
+  klass->resume = test_ring_buffer_true;
+  klass->stop = test_ring_buffer_true;
+}
+
+static void
+gst_test_ring_buffer_init (GstTestRingBuffer * buf)
+{
+}
+
+#define RB_SAMPLES_PER_SEG 480
+#define RB_SEGTOTAL 4
+
+/* mono S16 at 48kHz, 4 segments of 10ms */
+static GstAudioRingBuffer *
+setup_test_ring_buffer (void)
+{
+  GstAudioRingBuffer *buf;
+  GstCaps *caps;
+
+  buf = g_object_new (gst_test_ring_buffer_get_type (), NULL);
+  gst_object_ref_sink (buf);
+
+  buf->spec.latency_time = 10000;
+  buf->spec.buffer_time = 40000;
+  caps = gst_caps_from_string ("audio/x-raw, format=" GST_AUDIO_NE (S16)
+      ", rate=48000, channels=1, layout=interleaved");
+  fail_unless (gst_audio_ring_buffer_parse_caps (&buf->spec, caps));
+  gst_caps_unref (caps);
+
+  fail_unless (gst_audio_ring_buffer_open_device (buf));
+  fail_unless (gst_audio_ring_buffer_acquire (buf, &buf->spec));
+  fail_unless_equals_int (buf->spec.segtotal, RB_SEGTOTAL);
+  fail_unless_equals_int (buf->samples_per_seg, RB_SAMPLES_PER_SEG);
+  gst_audio_ring_buffer_set_flushing (buf, FALSE);
+
+  return buf;
+}
+
+static void
+cleanup_test_ring_buffer (GstAudioRingBuffer * buf)
+{
+  fail_unless (gst_audio_ring_buffer_release (buf));
+  fail_unless (gst_audio_ring_buffer_close_device (buf));
+  gst_object_unref (buf);
+}
+
+/* sample i holds the number of the segment it belongs to, counting from 1 so
+ * that it can't be confused with silence */
+static gint16 *
+make_segment_data (guint n_segments)
+{
+  gint16 *data = g_new (gint16, n_segments * RB_SAMPLES_PER_SEG);
+  guint i;
+
+  for (i = 0; i < n_segments * RB_SAMPLES_PER_SEG; i++)
+    data[i] = i / RB_SAMPLES_PER_SEG + 1;
+
+  return data;
+}
+
+GST_START_TEST (test_ring_buffer_write_spans)
+{
+  GstAudioRingBuffer *buf;
+  gint16 *data;
+  guint64 sample = 0;
+  guint8 *writeptr;
+  guint len;
+  gint accum = 0;
+
+  buf = setup_test_ring_buffer ();
+  data = make_segment_data (3);
+
+  /* not allowed to start, three segments fit without waiting */
+  fail_unless_equals_int (gst_audio_ring_buffer_commit (buf, &sample,
+          (guint8 *) data, 3 * RB_SAMPLES_PER_SEG, 3 * RB_SAMPLES_PER_SEG,
+          &accum), 3 * RB_SAMPLES_PER_SEG);
+  fail_unless_equals_uint64 (sample, 3 * RB_SAMPLES_PER_SEG);
+  fail_unless (memcmp (buf->memory, data,
+          3 * RB_SAMPLES_PER_SEG * sizeof (gint16)) == 0);
+
+  /* the last segment can be written directly */
+  fail_unless (gst_audio_ring_buffer_prepare_write (buf, &sample, &writeptr,
+          &len));
+  fail_unless_equals_uint64 (sample, 3 * RB_SAMPLES_PER_SEG);
+  fail_unless (writeptr == buf->memory + 3 * buf->spec.segsize);
+  fail_unless_equals_int (len, RB_SAMPLES_PER_SEG);
+
+  /* from the middle of a segment */
+  sample = 3 * RB_SAMPLES_PER_SEG + 100;
+  fail_unless (gst_audio_ring_buffer_prepare_write (buf, &sample, &writeptr,
+          &len));
+  fail_unless (writeptr == buf->memory + 3 * buf->spec.segsize + 200);
+  fail_unless_equals_int (len, RB_SAMPLES_PER_SEG - 100);
+
+  /* full now and we may not start, so no space */
+  sample = 4 * RB_SAMPLES_PER_SEG;
+  fail_if (gst_audio_ring_buffer_prepare_write (buf, &sample, &writeptr,
+          &len));
+
+  g_free (data);
+  cleanup_test_ring_buffer (buf);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  GstAudioRingBuffer *buf;
+  volatile gint stop;
+  gint16 first[256];
+  guint n_read;
+} RingBufferReader;
+
+static gpointer
+ring_buffer_reader_func (RingBufferReader * reader)
+{
+  GstAudioRingBuffer *buf = reader->buf;
+
+  while (!g_atomic_int_get (&reader->stop)) {
+    gint segment, len;
+    guint8 *readptr;
+
+    if (gst_audio_ring_buffer_prepare_read (buf, &segment, &readptr, &len)) {
+      if (reader->n_read < G_N_ELEMENTS (reader->first))
+        reader->first[reader->n_read++] = *(gint16 *) readptr;
+      gst_audio_ring_buffer_clear (buf, segment);
+      gst_audio_ring_buffer_advance (buf, 1);
+    }
+    g_usleep (1000);
+  }
+
+  return NULL;
+}
+
+GST_START_TEST (test_ring_buffer_wakeup_threshold)
+{
+  RingBufferReader reader = { NULL, };
+  GstAudioRingBuffer *buf;
+  GThread *thread;
+  guint64 histogram[GST_AUDIO_RING_BUFFER_LATENCY_BUCKETS];
+  guint64 sample = 0, wakeups = 0;
+  gint16 *data, last = 0;
+  gint accum = 0;
+  guint i;
+
+  buf = setup_test_ring_buffer ();
+  data = make_segment_data (40);
+
+  gst_audio_ring_buffer_set_wakeup_threshold (buf, 2);
+  fail_unless_equals_int (gst_audio_ring_buffer_get_wakeup_threshold (buf), 2);
+  gst_audio_ring_buffer_set_latency_probe (buf, TRUE);
+  gst_audio_ring_buffer_may_start (buf, TRUE);
+
+  reader.buf = buf;
+  thread = g_thread_new ("reader", (GThreadFunc) ring_buffer_reader_func,
+      &reader);
+
+  fail_unless_equals_int (gst_audio_ring_buffer_commit (buf, &sample,
+          (guint8 *) data, 40 * RB_SAMPLES_PER_SEG, 40 * RB_SAMPLES_PER_SEG,
+          &accum), 40 * RB_SAMPLES_PER_SEG);
+
+  g_atomic_int_set (&reader.stop, 1);
+  g_thread_join (thread);
+
+  /* every wakeup leaves at least two free segments to fill */
+  fail_unless_equals_int (gst_audio_ring_buffer_get_latency_histogram (buf,
+          histogram, G_N_ELEMENTS (histogram)),
+      GST_AUDIO_RING_BUFFER_LATENCY_BUCKETS);
+  for (i = 0; i < G_N_ELEMENTS (histogram); i++)
+    wakeups += histogram[i];
+  GST_DEBUG ("%" G_GUINT64_FORMAT " wakeups for %u segments", wakeups,
+      reader.n_read);
+  fail_unless (wakeups <= 40 / 2);
+
+  /* the device saw the segments in order, silence only when the writer was
+   * too late */
+  fail_unless (reader.n_read > 0);
+  for (i = 0; i < reader.n_read; i++) {
+    if (reader.first[i] == 0)
+      continue;
+    fail_unless (reader.first[i] > last);
+    last = reader.first[i];
+  }
+
+  g_free (data);
+  cleanup_test_ring_buffer (buf);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1094,6 +1681,12 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_fill_silence);
   tcase_add_test (tc_chain, test_stream_align);
   tcase_add_test (tc_chain, test_stream_align_reverse);
+  tcase_add_test (tc_chain, test_quantize_noise_shaping_reference);
+  tcase_add_test (tc_chain, test_quantize_dither);
+  tcase_add_test (tc_chain, test_channel_mixer_kernels);
+  tcase_add_test (tc_chain, test_channel_mixer_many_channels);
+  tcase_add_test (tc_chain, test_ring_buffer_write_spans);
+  tcase_add_test (tc_chain, test_ring_buffer_wakeup_threshold);
 
   return s;
 }
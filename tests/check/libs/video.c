@@ -35,6 +35,7 @@
 #include <gst/video/gstvideometa.h>
 #include <gst/video/video-overlay-composition.h>
 #include <string.h>
+#include <math.h>
 
 /* These are from the current/old videotestsrc; we check our new public API
  * in libgstvideo against the old one to make sure the sizes and offsets
@@ -2827,6 +2828,612 @@ GST_START_TEST (test_overlay_composition_over_transparency)
 GST_END_TEST;
 
 
+GST_START_TEST (test_video_pool_memfd)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocator *allocator;
+  GstVideoInfo info;
+  GstBuffer *buffer;
+  GstMemory *mem;
+  GstCaps *caps;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 1920, 1080);
+  caps = gst_video_info_to_caps (&info);
+
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, info.size, 2, 2);
+  gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_MEMFD);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+
+  config = gst_buffer_pool_get_config (pool);
+  fail_unless (gst_buffer_pool_config_get_allocator (config, &allocator,
+          NULL));
+  gst_structure_free (config);
+
+  /* the memfd allocator isn't available on all systems */
+  if (allocator != NULL) {
+    fail_unless_equals_string (allocator->mem_type, "memfd");
+
+    fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+    fail_unless (gst_buffer_pool_acquire_buffer (pool, &buffer,
+            NULL) == GST_FLOW_OK);
+    mem = gst_buffer_peek_memory (buffer, 0);
+    fail_unless_equals_string (mem->allocator->mem_type, "memfd");
+    fail_unless (gst_buffer_get_size (buffer) == info.size);
+    gst_buffer_unref (buffer);
+    fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  }
+
+  gst_object_unref (pool);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_frame_copy)
+{
+  static const gint sizes[][2] = { {320, 240}, {3840, 2160}, {7680, 4320} };
+  guint i, p;
+  gint x, y;
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    GstVideoInfo sinfo, dinfo;
+    GstVideoAlignment align;
+    GstBuffer *sbuf, *dbuf;
+    GstVideoFrame src, dest;
+    GstMapInfo map;
+
+    gst_video_info_set_format (&sinfo, GST_VIDEO_FORMAT_NV12, sizes[i][0],
+        sizes[i][1]);
+    /* a padded destination needs a copy per row */
+    dinfo = sinfo;
+    gst_video_alignment_reset (&align);
+    align.padding_right = 32;
+    gst_video_info_align (&dinfo, &align);
+
+    sbuf = gst_buffer_new_allocate (NULL, sinfo.size, NULL);
+    dbuf = gst_buffer_new_allocate (NULL, dinfo.size, NULL);
+
+    fail_unless (gst_video_frame_map (&src, &sinfo, sbuf, GST_MAP_WRITE));
+    fail_unless (gst_video_frame_map (&dest, &dinfo, dbuf, GST_MAP_WRITE));
+
+    for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&src); p++) {
+      guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (&src, p);
+      gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (&src, p);
+
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&src, p); y++)
+        for (x = 0; x < stride; x++)
+          data[y * stride + x] = x + y * 7 + p;
+    }
+
+    fail_unless (gst_video_frame_copy (&dest, &src));
+
+    for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&dest); p++) {
+      guint8 *sdata = GST_VIDEO_FRAME_PLANE_DATA (&src, p);
+      guint8 *ddata = GST_VIDEO_FRAME_PLANE_DATA (&dest, p);
+      gint sstride = GST_VIDEO_FRAME_PLANE_STRIDE (&src, p);
+      gint dstride = GST_VIDEO_FRAME_PLANE_STRIDE (&dest, p);
+
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&dest, p); y++)
+        fail_unless (memcmp (ddata + y * dstride, sdata + y * sstride,
+                sizes[i][0]) == 0);
+    }
+
+    gst_video_frame_unmap (&dest);
+    gst_buffer_unref (dbuf);
+
+    /* with the same layout the planes are copied in one go */
+    dbuf = gst_buffer_new_allocate (NULL, sinfo.size, NULL);
+    fail_unless (gst_video_frame_map (&dest, &sinfo, dbuf, GST_MAP_WRITE));
+    fail_unless (gst_video_frame_copy (&dest, &src));
+    gst_video_frame_unmap (&dest);
+    gst_video_frame_unmap (&src);
+
+    fail_unless (gst_buffer_map (sbuf, &map, GST_MAP_READ));
+    fail_unless (gst_buffer_memcmp (dbuf, 0, map.data, map.size) == 0);
+    gst_buffer_unmap (sbuf, &map);
+
+    gst_buffer_unref (dbuf);
+    gst_buffer_unref (sbuf);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_frame_crop)
+{
+  GstVideoInfo info, cinfo;
+  GstBuffer *buffer, *cbuffer;
+  GstVideoFrame frame, cropped, cframe;
+  GstVideoConverter *convert;
+  guint8 *data;
+  gint x, y, p, stride;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_NV12, 64, 48);
+  buffer = gst_buffer_new_allocate (NULL, info.size, NULL);
+  fail_unless (gst_video_frame_map (&frame, &info, buffer, GST_MAP_READWRITE));
+
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&frame); p++) {
+    data = GST_VIDEO_FRAME_PLANE_DATA (&frame, p);
+    stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, p);
+
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&frame, p); y++)
+      for (x = 0; x < stride; x++)
+        data[y * stride + x] = x + y * 3 + p;
+  }
+
+  /* odd offsets would split the chroma samples */
+  cropped = frame;
+  fail_if (gst_video_frame_crop (&cropped, 15, 8, 32, 16));
+  fail_if (gst_video_frame_crop (&cropped, 16, 7, 32, 16));
+  /* outside of the frame */
+  fail_if (gst_video_frame_crop (&cropped, 48, 8, 32, 16));
+  fail_unless (memcmp (&cropped, &frame, sizeof (frame)) == 0);
+
+  fail_unless (gst_video_frame_crop (&cropped, 16, 8, 32, 16));
+  fail_unless_equals_int (GST_VIDEO_FRAME_WIDTH (&cropped), 32);
+  fail_unless_equals_int (GST_VIDEO_FRAME_HEIGHT (&cropped), 16);
+  fail_unless_equals_int (GST_VIDEO_FRAME_PLANE_STRIDE (&cropped, 0), 64);
+  fail_unless_equals_int (GST_VIDEO_FRAME_COMP_WIDTH (&cropped, 1), 16);
+  fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&cropped, 0) ==
+      (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 0) + 8 * 64 + 16);
+  fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&cropped, 1) ==
+      (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 1) + 4 * 64 + 16);
+
+  /* convert from the cropped region without copying it first */
+  gst_video_info_set_format (&cinfo, GST_VIDEO_FORMAT_NV12, 32, 16);
+  cbuffer = gst_buffer_new_allocate (NULL, cinfo.size, NULL);
+  fail_unless (gst_video_frame_map (&cframe, &cinfo, cbuffer, GST_MAP_WRITE));
+  convert = gst_video_converter_new (&cinfo, &cinfo, NULL);
+  gst_video_converter_frame (convert, &cropped, &cframe);
+  gst_video_converter_free (convert);
+
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&cframe); p++) {
+    /* the chroma plane is subsampled vertically only */
+    gint top = p == 0 ? 8 : 4;
+
+    data = GST_VIDEO_FRAME_PLANE_DATA (&cframe, p);
+    stride = GST_VIDEO_FRAME_PLANE_STRIDE (&cframe, p);
+
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&cframe, p); y++)
+      for (x = 0; x < 32; x++)
+        fail_unless_equals_int (data[y * stride + x],
+            x + 16 + (y + top) * 3 + p);
+  }
+
+  gst_video_frame_unmap (&cframe);
+  gst_buffer_unref (cbuffer);
+  gst_video_frame_unmap (&frame);
+  gst_buffer_unref (buffer);
+
+  /* the components of packed 4:2:2 share the pixel groups */
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_YUY2, 64, 48);
+  buffer = gst_buffer_new_allocate (NULL, info.size, NULL);
+  fail_unless (gst_video_frame_map (&frame, &info, buffer, GST_MAP_READ));
+  cropped = frame;
+  fail_if (gst_video_frame_crop (&cropped, 3, 1, 32, 16));
+  fail_unless (gst_video_frame_crop (&cropped, 2, 1, 32, 16));
+  fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&cropped, 0) ==
+      (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 0) + 128 + 4);
+  gst_video_frame_unmap (&frame);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
+static guint
+depth_sample (const GstVideoFrame * frame, gint plane, gint x, gint y)
+{
+  const guint8 *line = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame,
+      plane) + y * GST_VIDEO_FRAME_PLANE_STRIDE (frame, plane);
+
+  if (GST_VIDEO_FRAME_COMP_DEPTH (frame, 0) > 8)
+    return GST_READ_UINT16_LE (line + x * 2);
+  return line[x];
+}
+
+GST_START_TEST (test_video_convert_depth)
+{
+  static const struct
+  {
+    GstVideoFormat in, out;
+  } formats[] = {
+    {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_P010_10LE},
+    {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_I420_10LE},
+  };
+  static const GstVideoDitherMethod methods[] = {
+    GST_VIDEO_DITHER_NONE, GST_VIDEO_DITHER_BAYER
+  };
+  guint quantizer[GST_VIDEO_MAX_COMPONENTS] = { 256, 256, 256, 256 };
+  GstVideoDither *dither;
+  guint i, f, m, p;
+  gint x, y;
+
+  dither = gst_video_dither_new (GST_VIDEO_DITHER_BAYER,
+      GST_VIDEO_DITHER_FLAG_NONE, GST_VIDEO_FORMAT_AYUV64, quantizer, 16);
+
+  for (i = 0; i < G_N_ELEMENTS (formats) * G_N_ELEMENTS (methods); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstVideoFrame inframe, outframe;
+    GstBuffer *inbuffer, *outbuffer;
+    GstVideoConverter *convert;
+    gboolean to_8bit;
+
+    f = i / G_N_ELEMENTS (methods);
+    m = i % G_N_ELEMENTS (methods);
+
+    /* odd sizes to go through the leftover pixels of the vector loops */
+    gst_video_info_set_format (&ininfo, formats[f].in, 67, 31);
+    gst_video_info_set_format (&outinfo, formats[f].out, 67, 31);
+    to_8bit = GST_VIDEO_INFO_COMP_DEPTH (&outinfo, 0) == 8;
+
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+    fail_unless (gst_video_frame_map (&inframe, &ininfo, inbuffer,
+            GST_MAP_READWRITE));
+    fail_unless (gst_video_frame_map (&outframe, &outinfo, outbuffer,
+            GST_MAP_WRITE));
+
+    for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&inframe); p++) {
+      guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (&inframe, p);
+      gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, p);
+
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&inframe, p); y++)
+        for (x = 0; x < stride; x++)
+          data[y * stride + x] = x * 3 + y * 7 + p;
+    }
+
+    /* the expected values are those of the generic path, which does the
+     * ordered dither on the unpacked lines */
+    convert = gst_video_converter_new (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+            methods[m], NULL));
+    gst_video_converter_frame (convert, &inframe, &outframe);
+    gst_video_converter_free (convert);
+
+    for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&outframe); p++) {
+      /* the chroma plane of the semi-planar formats has U and V samples */
+      gint n_samples = GST_VIDEO_FRAME_N_PLANES (&outframe) == 2 && p == 1 ?
+          2 : 1;
+      gint n = GST_VIDEO_FRAME_COMP_WIDTH (&outframe, p) * n_samples;
+
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&outframe, p); y++) {
+        for (x = 0; x < n; x++) {
+          guint s = depth_sample (&inframe, p, x, y);
+          guint d = depth_sample (&outframe, p, x, y);
+          guint expected, v;
+
+          /* what the generic unpack and pack functions give */
+          if (to_8bit) {
+            v = formats[f].in == GST_VIDEO_FORMAT_P010_10LE ?
+                s : (s << 6) & 0xffff;
+            v |= v >> 10;
+            /* the chroma samples are dithered like their first luma pixel */
+            if (methods[m] == GST_VIDEO_DITHER_BAYER)
+              expected = depth_dither_sample (dither, v,
+                  (x / n_samples) << (p ? 1 : 0), y << (p ? 1 : 0));
+            else
+              expected = v >> 8;
+          } else {
+            expected = formats[f].out == GST_VIDEO_FORMAT_P010_10LE ?
+                (s << 8) | (s & 0xc0) : (s << 2) | (s >> 6);
+          }
+
+          fail_unless_equals_int (d, expected);
+        }
+      }
+    }
+
+    gst_video_frame_unmap (&outframe);
+    gst_video_frame_unmap (&inframe);
+    gst_buffer_unref (outbuffer);
+    gst_buffer_unref (inbuffer);
+  }
+
+  gst_video_dither_free (dither);
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+convert_matrix16_frame (GstVideoInfo * ininfo, GstVideoInfo * outinfo,
+    GstBuffer * inbuffer)
+{
+  GstVideoFrame inframe, outframe;
+  GstBuffer *outbuffer;
+  GstVideoConverter *convert;
+
+  outbuffer = gst_buffer_new_and_alloc (outinfo->size);
+  fail_unless (gst_video_frame_map (&inframe, ininfo, inbuffer,
+          GST_MAP_READ));
+  fail_unless (gst_video_frame_map (&outframe, outinfo, outbuffer,
+          GST_MAP_WRITE));
+
+  convert = gst_video_converter_new (ininfo, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_NONE, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+
+  return outbuffer;
+}
+
+/* The 16 bit matrix has SSE2 and NEON versions, ORC_CODE=backup selects
+ * the C version. Both must give the same output. */
+GST_START_TEST (test_video_convert_matrix16)
+{
+  static const struct
+  {
+    GstVideoFormat in, out;
+    const gchar *in_colorimetry, *out_colorimetry;
+  } formats[] = {
+    {GST_VIDEO_FORMAT_AYUV64, GST_VIDEO_FORMAT_ARGB64, "bt601", "sRGB"},
+    {GST_VIDEO_FORMAT_AYUV64, GST_VIDEO_FORMAT_ARGB64, "bt709", "sRGB"},
+    {GST_VIDEO_FORMAT_ARGB64, GST_VIDEO_FORMAT_AYUV64, "sRGB", "bt709"},
+    {GST_VIDEO_FORMAT_AYUV64, GST_VIDEO_FORMAT_AYUV64, "bt601", "bt709"},
+  };
+  gchar *orc_code;
+  guint i;
+
+  orc_code = g_strdup (g_getenv ("ORC_CODE"));
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstBuffer *inbuffer, *simd, *scalar;
+    GstMapInfo map, simd_map, scalar_map;
+    guint j;
+
+    /* odd sizes to go through the leftover pixels of the vector loops */
+    gst_video_info_set_format (&ininfo, formats[i].in, 67, 31);
+    gst_video_info_set_format (&outinfo, formats[i].out, 67, 31);
+    fail_unless (gst_video_colorimetry_from_string (&ininfo.colorimetry,
+            formats[i].in_colorimetry));
+    fail_unless (gst_video_colorimetry_from_string (&outinfo.colorimetry,
+            formats[i].out_colorimetry));
+    /* keep the transfer functions out of it, there's no vector gamma */
+    outinfo.colorimetry.transfer = ininfo.colorimetry.transfer;
+
+    /* the whole 16 bit range to also check the clamping */
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    fail_unless (gst_buffer_map (inbuffer, &map, GST_MAP_WRITE));
+    for (j = 0; j < map.size / 2; j++)
+      GST_WRITE_UINT16_LE (map.data + j * 2, (j * 2654435761u) >> 16);
+    gst_buffer_unmap (inbuffer, &map);
+
+    g_unsetenv ("ORC_CODE");
+    simd = convert_matrix16_frame (&ininfo, &outinfo, inbuffer);
+    g_setenv ("ORC_CODE", "backup", TRUE);
+    scalar = convert_matrix16_frame (&ininfo, &outinfo, inbuffer);
+
+    fail_unless (gst_buffer_map (simd, &simd_map, GST_MAP_READ));
+    fail_unless (gst_buffer_map (scalar, &scalar_map, GST_MAP_READ));
+    fail_unless_equals_int (simd_map.size, scalar_map.size);
+    for (j = 0; j < simd_map.size / 2; j++)
+      fail_unless_equals_int (GST_READ_UINT16_LE (simd_map.data + j * 2),
+          GST_READ_UINT16_LE (scalar_map.data + j * 2));
+    gst_buffer_unmap (scalar, &scalar_map);
+    gst_buffer_unmap (simd, &simd_map);
+
+    gst_buffer_unref (scalar);
+    gst_buffer_unref (simd);
+    gst_buffer_unref (inbuffer);
+  }
+
+  if (orc_code)
+    g_setenv ("ORC_CODE", orc_code, TRUE);
+  else
+    g_unsetenv ("ORC_CODE");
+  g_free (orc_code);
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+convert_gamma_frame (GstVideoInfo * ininfo, GstVideoInfo * outinfo,
+    GstBuffer * inbuffer)
+{
+  GstVideoFrame inframe, outframe;
+  GstBuffer *outbuffer;
+  GstVideoConverter *convert;
+
+  outbuffer = gst_buffer_new_and_alloc (outinfo->size);
+  fail_unless (gst_video_frame_map (&inframe, ininfo, inbuffer,
+          GST_MAP_READ));
+  fail_unless (gst_video_frame_map (&outframe, outinfo, outbuffer,
+          GST_MAP_WRITE));
+
+  convert = gst_video_converter_new (ininfo, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+          GST_VIDEO_GAMMA_MODE_REMAP,
+          GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE,
+          GST_TYPE_VIDEO_PRIMARIES_MODE, GST_VIDEO_PRIMARIES_MODE_FULL,
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_NONE, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+
+  return outbuffer;
+}
+
+GST_START_TEST (test_video_convert_gamma)
+{
+  static const GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_ARGB, GST_VIDEO_FORMAT_ARGB64
+  };
+  /* from bt709, the same primaries use the composed gamma table, other
+   * primaries are fused when the output has 16 bits */
+  static const struct
+  {
+    GstVideoFormat in, out;
+    const gchar *out_colorimetry;
+  } yuv_formats[] = {
+    {GST_VIDEO_FORMAT_AYUV, GST_VIDEO_FORMAT_AYUV, "bt709"},
+    {GST_VIDEO_FORMAT_AYUV64, GST_VIDEO_FORMAT_AYUV64, "bt709"},
+    {GST_VIDEO_FORMAT_AYUV64, GST_VIDEO_FORMAT_AYUV64, "bt2020"},
+    {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_AYUV64, "bt2020"},
+    {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_I420_10LE, "bt2020"},
+  };
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  guint8 *data;
+  guint i, x;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB, 256, 2);
+  fail_unless_equals_int (ininfo.colorimetry.transfer,
+      GST_VIDEO_TRANSFER_SRGB);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  fail_unless (gst_video_frame_map (&inframe, &ininfo, inbuffer,
+          GST_MAP_READWRITE));
+  data = GST_VIDEO_FRAME_PLANE_DATA (&inframe, 0);
+  for (x = 0; x < 256; x++) {
+    data[x * 4 + 0] = 255;
+    data[x * 4 + 1] = data[x * 4 + 2] = data[x * 4 + 3] = x;
+  }
+  memcpy (data + GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, 0), data, 256 * 4);
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    gint max = formats[i] == GST_VIDEO_FORMAT_ARGB ? 255 : 65535;
+
+    /* to linear light, the decode and the encode are done with one table */
+    gst_video_info_set_format (&outinfo, formats[i], 256, 2);
+    outinfo.colorimetry = ininfo.colorimetry;
+    outinfo.colorimetry.transfer = GST_VIDEO_TRANSFER_GAMMA10;
+    outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+    fail_unless (gst_video_frame_map (&outframe, &outinfo, outbuffer,
+            GST_MAP_WRITE));
+
+    convert = gst_video_converter_new (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+            GST_VIDEO_GAMMA_MODE_REMAP, NULL));
+    gst_video_converter_frame (convert, &inframe, &outframe);
+    gst_video_converter_free (convert);
+
+    data = GST_VIDEO_FRAME_PLANE_DATA (&outframe, 0);
+    for (x = 0; x < 256; x++) {
+      guint expected = rint (gst_video_color_transfer_decode
+          (GST_VIDEO_TRANSFER_SRGB, x / 255.0) * max);
+
+      if (max == 255) {
+        fail_unless_equals_int (data[x * 4 + 0], 255);
+        fail_unless_equals_int (data[x * 4 + 1], expected);
+        fail_unless_equals_int (data[x * 4 + 3], expected);
+      } else {
+        guint16 *p = (guint16 *) data;
+
+        fail_unless_equals_int (p[x * 4 + 0], 65535);
+        fail_unless_equals_int (p[x * 4 + 1], expected);
+        fail_unless_equals_int (p[x * 4 + 3], expected);
+      }
+    }
+
+    gst_video_frame_unmap (&outframe);
+    gst_buffer_unref (outbuffer);
+  }
+
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+
+  /* Y'CbCr in and out. Without scaling the conversion to R'G'B', the gamma
+   * and primaries conversions and the conversion back are done in one pass,
+   * compare with the separate passes a different output height gives. The
+   * lines of the input are all the same so the vertical scaling keeps them
+   * as they are. */
+  for (i = 0; i < G_N_ELEMENTS (yuv_formats); i++) {
+    GstVideoInfo fusedinfo, separateinfo;
+    GstVideoFrame fused, separate;
+    GstBuffer *fusedbuffer, *separatebuffer;
+    guint p, y, max_diff;
+
+    gst_video_info_set_format (&ininfo, yuv_formats[i].in, 256, 2);
+    gst_video_info_set_format (&fusedinfo, yuv_formats[i].out, 256, 2);
+    gst_video_info_set_format (&separateinfo, yuv_formats[i].out, 256, 3);
+    fail_unless (gst_video_colorimetry_from_string (&ininfo.colorimetry,
+            "bt709"));
+    fail_unless (gst_video_colorimetry_from_string (&fusedinfo.colorimetry,
+            yuv_formats[i].out_colorimetry));
+    fusedinfo.colorimetry.transfer = GST_VIDEO_TRANSFER_GAMMA22;
+    separateinfo.colorimetry = fusedinfo.colorimetry;
+
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    fail_unless (gst_video_frame_map (&inframe, &ininfo, inbuffer,
+            GST_MAP_WRITE));
+    for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&inframe); p++) {
+      gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, p);
+
+      data = GST_VIDEO_FRAME_PLANE_DATA (&inframe, p);
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&inframe, p); y++)
+        for (x = 0; x < stride; x++)
+          data[y * stride + x] = x * 7 + p * 50;
+    }
+    gst_video_frame_unmap (&inframe);
+
+    fusedbuffer = convert_gamma_frame (&ininfo, &fusedinfo, inbuffer);
+    separatebuffer = convert_gamma_frame (&ininfo, &separateinfo, inbuffer);
+
+    fail_unless (gst_video_frame_map (&fused, &fusedinfo, fusedbuffer,
+            GST_MAP_READ));
+    fail_unless (gst_video_frame_map (&separate, &separateinfo,
+            separatebuffer, GST_MAP_READ));
+
+    /* one step of 8 bits for the rounding of the vertical scaling */
+    max_diff = 1 << (GST_VIDEO_FRAME_COMP_DEPTH (&fused, 0) - 8);
+
+    for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&fused); p++) {
+      const guint8 *a = GST_VIDEO_FRAME_PLANE_DATA (&fused, p);
+      const guint8 *b = GST_VIDEO_FRAME_PLANE_DATA (&separate, p);
+      gint astride = GST_VIDEO_FRAME_PLANE_STRIDE (&fused, p);
+      gint bstride = GST_VIDEO_FRAME_PLANE_STRIDE (&separate, p);
+      gint n = GST_VIDEO_FRAME_COMP_WIDTH (&fused, p) *
+          GST_VIDEO_FRAME_COMP_PSTRIDE (&fused, p);
+
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&fused, p); y++) {
+        for (x = 0; x < n; x += max_diff > 1 ? 2 : 1) {
+          gint va, vb;
+
+          if (max_diff > 1) {
+            va = GST_READ_UINT16_LE (a + y * astride + x);
+            vb = GST_READ_UINT16_LE (b + y * bstride + x);
+          } else {
+            va = a[y * astride + x];
+            vb = b[y * bstride + x];
+          }
+          fail_unless (ABS (va - vb) <= max_diff,
+              "%s -> %s plane %u, %u,%u: %d != %d",
+              gst_video_format_to_string (yuv_formats[i].in),
+              gst_video_format_to_string (yuv_formats[i].out), p, x, y, va,
+              vb);
+        }
+      }
+    }
+
+    gst_video_frame_unmap (&separate);
+    gst_video_frame_unmap (&fused);
+    gst_buffer_unref (separatebuffer);
+    gst_buffer_unref (fusedbuffer);
+    gst_buffer_unref (inbuffer);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 video_suite (void)
 {
@@ -2864,6 +3471,12 @@ video_suite (void)
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
   tcase_add_test (tc_chain, test_overlay_composition_over_transparency);
+  tcase_add_test (tc_chain, test_video_pool_memfd);
+  tcase_add_test (tc_chain, test_video_frame_copy);
+  tcase_add_test (tc_chain, test_video_frame_crop);
+  tcase_add_test (tc_chain, test_video_convert_depth);
+  tcase_add_test (tc_chain, test_video_convert_matrix16);
+  tcase_add_test (tc_chain, test_video_convert_gamma);
 
   return s;
 }
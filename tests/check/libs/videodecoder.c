@@ -82,6 +82,9 @@ struct _GstVideoDecoderTester
   guint64 last_buf_num;
   guint64 last_kf_num;
   gboolean set_output_state;
+
+  /* handle_frame is called from the frame threads */
+  gboolean frame_threads;
 };
 
 struct _GstVideoDecoderTesterClass
@@ -150,7 +153,15 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
 
   input_num = *((guint64 *) map.data);
 
-  if ((input_num == dectester->last_buf_num + 1
+  if (dectester->frame_threads) {
+    /* no shared state here, and finish in a scrambled order */
+    g_usleep ((input_num * 7919) % 5 * 200);
+
+    frame->output_buffer = gst_video_decoder_allocate_output_buffer (dec);
+    gst_buffer_fill (frame->output_buffer, 0, map.data, sizeof (guint64));
+    frame->pts = GST_BUFFER_PTS (frame->input_buffer);
+    frame->duration = GST_BUFFER_DURATION (frame->input_buffer);
+  } else if ((input_num == dectester->last_buf_num + 1
           && dectester->last_buf_num != -1)
       || !GST_BUFFER_FLAG_IS_SET (frame->input_buffer,
           GST_BUFFER_FLAG_DELTA_UNIT)) {
@@ -344,6 +355,153 @@ GST_START_TEST (videodecoder_playback)
 
 GST_END_TEST;
 
+#define NUM_THREADED_BUFFERS 100
+GST_START_TEST (videodecoder_playback_frame_threads)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+
+  ((GstVideoDecoderTester *) dec)->frame_threads = TRUE;
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), 4);
+  fail_unless_equals_int (gst_video_decoder_get_frame_threads
+      (GST_VIDEO_DECODER (dec)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_THREADED_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* everything is pushed in order once drained */
+  fail_unless_equals_int (g_list_length (buffers), NUM_THREADED_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_extract (buffer, 0, &num, sizeof (guint64));
+    fail_unless (i == num);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (i,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+
+/* downstream with a pool of two buffers that doesn't keep the output */
+static GArray *bounded_nums;
+
+static GstFlowReturn
+_bounded_sinkpad_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  guint64 num;
+
+  gst_buffer_extract (buffer, 0, &num, sizeof (guint64));
+  g_array_append_val (bounded_nums, num);
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+_bounded_sinkpad_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  if (GST_QUERY_TYPE (query) == GST_QUERY_ALLOCATION) {
+    GstBufferPool *pool = gst_buffer_pool_new ();
+
+    gst_query_add_allocation_pool (query, pool,
+        TEST_VIDEO_WIDTH * TEST_VIDEO_HEIGHT, 1, 2);
+    gst_object_unref (pool);
+    return TRUE;
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+static void
+push_threaded_buffers (guint64 first, guint64 last)
+{
+  GstSegment segment;
+  guint64 i;
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  segment.start = gst_util_uint64_scale_round (first,
+      GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = first; i < last; i++)
+    fail_unless (gst_pad_push (mysrcpad, create_test_buffer (i)) ==
+        GST_FLOW_OK);
+}
+
+GST_START_TEST (videodecoder_frame_threads_bounded_pool_flush)
+{
+  guint i, n;
+
+  bounded_nums = g_array_new (FALSE, FALSE, sizeof (guint64));
+  setup_videodecodertester (NULL, NULL);
+  gst_pad_set_chain_function (mysinkpad, _bounded_sinkpad_chain);
+  gst_pad_set_query_function (mysinkpad, _bounded_sinkpad_query);
+
+  ((GstVideoDecoderTester *) dec)->frame_threads = TRUE;
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* more frames in flight than buffers in the pool doesn't block */
+  push_threaded_buffers (0, NUM_THREADED_BUFFERS);
+
+  /* seek back to the middle with frames still in flight */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_flush_start ()));
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_flush_stop (TRUE)));
+  n = bounded_nums->len;
+  push_threaded_buffers (NUM_THREADED_BUFFERS / 2, NUM_THREADED_BUFFERS);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* everything before the flush came in order, and everything after it */
+  fail_unless (n <= NUM_THREADED_BUFFERS);
+  for (i = 0; i < n; i++)
+    fail_unless_equals_uint64 (g_array_index (bounded_nums, guint64, i), i);
+  fail_unless_equals_int (bounded_nums->len - n, NUM_THREADED_BUFFERS / 2);
+  for (i = n; i < bounded_nums->len; i++)
+    fail_unless_equals_uint64 (g_array_index (bounded_nums, guint64, i),
+        NUM_THREADED_BUFFERS / 2 + i - n);
+
+  cleanup_videodecodertest ();
+  g_array_free (bounded_nums, TRUE);
+}
+
+GST_END_TEST;
+
 
 GST_START_TEST (videodecoder_playback_with_events)
 {
@@ -1267,6 +1425,8 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_query_caps_with_custom_getcaps);
 
   tcase_add_test (tc, videodecoder_playback);
+  tcase_add_test (tc, videodecoder_playback_frame_threads);
+  tcase_add_test (tc, videodecoder_frame_threads_bounded_pool_flush);
   tcase_add_test (tc, videodecoder_playback_with_events);
   tcase_add_test (tc, videodecoder_playback_first_frames_not_decoded);
   tcase_add_test (tc, videodecoder_buffer_after_segment);
@@ -48,6 +48,9 @@ struct _GstVideoEncoderTester
   GstVideoEncoder parent;
 
   GstFlowReturn pre_push_result;
+
+  /* handle_frame is called from the frame threads */
+  gboolean frame_threads;
 };
 
 struct _GstVideoEncoderTesterClass
@@ -102,6 +105,10 @@ gst_video_encoder_tester_handle_frame (GstVideoEncoder * enc,
   input_num = *((guint64 *) map.data);
   gst_buffer_unmap (frame->input_buffer, &map);
 
+  /* finish in a scrambled order */
+  if (((GstVideoEncoderTester *) enc)->frame_threads)
+    g_usleep ((input_num * 7919) % 5 * 200);
+
   data = g_malloc (sizeof (guint64));
   *(guint64 *) data = input_num;
 
@@ -302,6 +309,66 @@ GST_START_TEST (videoencoder_playback)
 
 GST_END_TEST;
 
+GST_START_TEST (videoencoder_playback_frame_threads)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+  guint n_threads, max_in_flight;
+
+  setup_videoencodertester ();
+
+  ((GstVideoEncoderTester *) enc)->frame_threads = TRUE;
+  gst_video_encoder_set_frame_threads (GST_VIDEO_ENCODER (enc), 4, 6);
+  gst_video_encoder_get_frame_threads (GST_VIDEO_ENCODER (enc), &n_threads,
+      &max_in_flight);
+  fail_unless_equals_int (n_threads, 4);
+  fail_unless_equals_int (max_in_flight, 6);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (enc, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+    /* never more than the window is held back */
+    fail_unless (i + 1 - g_list_length (buffers) <= max_in_flight);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* everything is pushed in order once drained */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_extract (buffer, 0, &num, sizeof (guint64));
+    fail_unless (i == num);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (i,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videoencodertest ();
+}
+
+GST_END_TEST;
+
 /* make sure tags sent right before eos are pushed */
 GST_START_TEST (videoencoder_tags_before_eos)
 {
@@ -604,6 +671,7 @@ gst_videoencoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, videoencoder_playback);
+  tcase_add_test (tc, videoencoder_playback_frame_threads);
 
   tcase_add_test (tc, videoencoder_tags_before_eos);
   tcase_add_test (tc, videoencoder_events_before_eos);
@@ -26,6 +26,11 @@
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstbufferstraw.h>
 #include <gio/gio.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
 
 static gboolean got_eos = FALSE;
 
@@ -153,6 +158,157 @@ GST_START_TEST (test_memory_stream)
 
 GST_END_TEST;
 
+GST_START_TEST (test_local_file_mmap)
+{
+  GstElement *src;
+  GstPad *srcpad;
+  GstBuffer *buf = NULL;
+  GstMapInfo map;
+  GError *err = NULL;
+  gchar *path, *uri;
+  guint8 *in_data;
+  guint64 offset;
+  gint fd, i;
+
+  in_data = g_new (guint8, 65536);
+  for (i = 0; i < 65536; i++)
+    in_data[i] = (i * 7) % 256;
+
+  fd = g_file_open_tmp ("gstgiomapXXXXXX", &path, &err);
+  fail_unless (fd >= 0, "failed to create temp file: %s",
+      err ? err->message : "");
+  close (fd);
+  fail_unless (g_file_set_contents (path, (const gchar *) in_data, 65536,
+          NULL));
+
+  uri = g_filename_to_uri (path, NULL, NULL);
+  src = gst_element_factory_make ("giosrc", "src");
+  fail_unless (src != NULL);
+  g_object_set (src, "location", uri, "use-mmap", TRUE, NULL);
+
+  srcpad = gst_element_get_static_pad (src, "src");
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, TRUE));
+
+  /* random access, including a range crossing the end of the file */
+  for (offset = 60000; offset > 0; offset -= 15000) {
+    fail_unless_equals_int (gst_pad_get_range (srcpad, offset, 8192, &buf),
+        GST_FLOW_OK);
+    fail_unless_equals_int (GST_BUFFER_OFFSET (buf), offset);
+    fail_unless_equals_int (gst_buffer_get_size (buf),
+        MIN (8192, 65536 - offset));
+
+    fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+    fail_unless (memcmp (map.data, in_data + offset, map.size) == 0);
+    gst_buffer_unmap (buf, &map);
+
+    /* the data points into the read-only mapping */
+    fail_unless (GST_MEMORY_IS_READONLY (gst_buffer_peek_memory (buf, 0)));
+    gst_buffer_unref (buf);
+    buf = NULL;
+  }
+
+  fail_unless_equals_int (gst_pad_get_range (srcpad, 65536, 4096, &buf),
+      GST_FLOW_EOS);
+
+  fail_unless (gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, FALSE));
+  gst_element_set_state (src, GST_STATE_NULL);
+  gst_object_unref (srcpad);
+  gst_object_unref (src);
+
+  g_unlink (path);
+  g_free (path);
+  g_free (uri);
+  g_free (in_data);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_local_file_read_ahead)
+{
+  GstElement *src;
+  GstPad *srcpad;
+  GstBuffer *buf = NULL;
+  GstQuery *query;
+  const GstStructure *stats;
+  GError *err = NULL;
+  gchar *path, *uri;
+  guint8 *in_data;
+  guint64 offset, hits, misses;
+  gint fd, i, n_reads = 0;
+  gboolean jumped = FALSE;
+
+  in_data = g_new (guint8, 1024 * 1024);
+  for (i = 0; i < 1024 * 1024; i++)
+    in_data[i] = (i * 13) % 251;
+
+  fd = g_file_open_tmp ("gstgioraXXXXXX", &path, &err);
+  fail_unless (fd >= 0, "failed to create temp file: %s",
+      err ? err->message : "");
+  close (fd);
+  fail_unless (g_file_set_contents (path, (const gchar *) in_data,
+          1024 * 1024, NULL));
+
+  uri = g_filename_to_uri (path, NULL, NULL);
+  src = gst_element_factory_make ("giosrc", "src");
+  fail_unless (src != NULL);
+  g_object_set (src, "location", uri, "read-ahead", 256 * 1024, NULL);
+
+  srcpad = gst_element_get_static_pad (src, "src");
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, TRUE));
+
+  /* sequential reads, with one jump back in the middle */
+  for (offset = 0; offset < 1024 * 1024; offset += 8500) {
+    GstMapInfo map;
+
+    if (offset == 8500 * 60 && !jumped) {
+      offset = 8500 * 10;
+      jumped = TRUE;
+    }
+
+    fail_unless_equals_int (gst_pad_get_range (srcpad, offset, 8500, &buf),
+        GST_FLOW_OK);
+    n_reads++;
+
+    fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+    fail_unless_equals_int (map.size, MIN (8500, 1024 * 1024 - offset));
+    fail_unless (memcmp (map.data, in_data + offset, map.size) == 0);
+    gst_buffer_unmap (buf, &map);
+    gst_buffer_unref (buf);
+    buf = NULL;
+
+    /* give the read-ahead thread a chance to get ahead of us */
+    g_usleep (G_USEC_PER_SEC / 1000);
+  }
+
+  query = gst_query_new_custom (GST_QUERY_CUSTOM,
+      gst_structure_new_empty ("GstGioReadAheadStats"));
+  fail_unless (gst_pad_query (srcpad, query));
+  stats = gst_query_get_structure (query);
+  fail_unless (gst_structure_get_uint64 (stats, "hits", &hits));
+  fail_unless (gst_structure_get_uint64 (stats, "misses", &misses));
+  fail_unless (gst_structure_has_field_typed (stats, "hit-rate",
+          G_TYPE_DOUBLE));
+  fail_unless_equals_int (hits + misses, n_reads);
+  fail_unless (hits > 0);
+  gst_query_unref (query);
+
+  fail_unless (gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, FALSE));
+  gst_element_set_state (src, GST_STATE_NULL);
+  gst_object_unref (srcpad);
+  gst_object_unref (src);
+
+  g_unlink (path);
+  g_free (path);
+  g_free (uri);
+  g_free (in_data);
+}
+
+GST_END_TEST;
+
 static Suite *
 gio_suite (void)
 {
@@ -161,6 +317,8 @@ gio_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_memory_stream);
+  tcase_add_test (tc_chain, test_local_file_mmap);
+  tcase_add_test (tc_chain, test_local_file_read_ahead);
 
   return s;
 }
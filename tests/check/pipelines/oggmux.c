@@ -157,10 +157,9 @@ check_chain_final_state (gpointer key, ChainState * state, gpointer data)
   return TRUE;
 }
 
-static GstPadProbeReturn
-eos_buffer_probe (GstPad * pad, GstPadProbeInfo * info, gpointer unused)
+static void
+check_ogg_buffer (GstBuffer * buffer)
 {
-  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
   gint ret;
   gint size;
   gchar *oggbuffer;
@@ -195,6 +194,24 @@ eos_buffer_probe (GstPad * pad, GstPadProbeInfo * info, gpointer unused)
             "Non-video buffer doesn't have DELTA_UNIT in stream with video");
     }
   }
+}
+
+static gboolean
+check_ogg_list_buffer (GstBuffer ** buffer, guint idx, gpointer unused)
+{
+  check_ogg_buffer (*buffer);
+
+  return TRUE;
+}
+
+static GstPadProbeReturn
+eos_buffer_probe (GstPad * pad, GstPadProbeInfo * info, gpointer unused)
+{
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+    gst_buffer_list_foreach (GST_PAD_PROBE_INFO_BUFFER_LIST (info),
+        check_ogg_list_buffer, NULL);
+  else
+    check_ogg_buffer (GST_PAD_PROBE_INFO_BUFFER (info));
 
   return GST_PAD_PROBE_OK;
 }
@@ -209,7 +226,8 @@ start_pipeline (GstElement * bin, GstPad * pad)
   eos_chain_states =
       g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
   probe_id =
-      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      gst_pad_add_probe (pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
       (GstPadProbeCallback) eos_buffer_probe, NULL, NULL);
 
   ret = gst_element_set_state (bin, GST_STATE_PLAYING);
@@ -321,6 +339,15 @@ GST_START_TEST (test_vorbis)
 
 GST_END_TEST;
 
+GST_START_TEST (test_vorbis_zero_copy)
+{
+  test_pipeline
+      ("audiotestsrc num-buffers=20 ! audioconvert ! vorbisenc ! "
+      ".audio_%u oggmux zero-copy=true buffer-list=true");
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_vorbis_oggmux_unlinked)
 {
   GstElement *pipe;
@@ -373,6 +400,17 @@ GST_START_TEST (test_vorbis_theora)
       "audiotestsrc num-buffers=10 ! audioconvert ! vorbisenc ! queue ! mux.audio_%u");
 }
 
+GST_END_TEST;
+
+GST_START_TEST (test_theora_vorbis_zero_copy)
+{
+  test_pipeline
+      ("videotestsrc num-buffers=10 ! videoconvert ! theoraenc ! queue ! "
+      ".video_%u oggmux name=mux zero-copy=true buffer-list=true "
+      "audiotestsrc num-buffers=10 ! audioconvert ! vorbisenc ! queue ! "
+      "mux.audio_%u");
+}
+
 GST_END_TEST;
 #endif
 
@@ -412,6 +450,7 @@ oggmux_suite (void)
   suite_add_tcase (s, tc_chain);
 #ifdef HAVE_VORBIS
   tcase_add_test (tc_chain, test_vorbis);
+  tcase_add_test (tc_chain, test_vorbis_zero_copy);
   tcase_add_test (tc_chain, test_vorbis_oggmux_unlinked);
 #endif
 
@@ -422,6 +461,7 @@ oggmux_suite (void)
 #if (defined (HAVE_THEORA) && defined (HAVE_VORBIS))
   tcase_add_test (tc_chain, test_vorbis_theora);
   tcase_add_test (tc_chain, test_theora_vorbis);
+  tcase_add_test (tc_chain, test_theora_vorbis_zero_copy);
 #endif
 
   tcase_add_test (tc_chain, test_simple_cleanup);
@@ -0,0 +1,227 @@
+/* GStreamer
+ *
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/allocators/allocators.h>
+#include <glib/gstdio.h>
+
+#include <unistd.h>
+
+#define TEST_CAPS "video/x-raw,format=GRAY8,width=16,height=16,framerate=30/1"
+#define FRAME_SIZE (16 * 16)
+#define N_BUFFERS 10
+
+typedef struct
+{
+  gchar *socket_path;
+
+  GstElement *sender;
+  GstElement *receiver;
+  GstAppSrc *appsrc;
+  GstAppSink *appsink;
+} UnixFdTest;
+
+static void
+unix_fd_test_setup (UnixFdTest * t, guint max_buffers)
+{
+  GstElement *sink, *src;
+
+  t->socket_path = g_strdup_printf ("%s/gst-unixfd-test-%d",
+      g_get_tmp_dir (), (gint) getpid ());
+
+  t->sender = gst_parse_launch ("appsrc name=src format=time caps="
+      TEST_CAPS " ! unixfdsink name=sink", NULL);
+  fail_unless (t->sender != NULL);
+  sink = gst_bin_get_by_name (GST_BIN (t->sender), "sink");
+  g_object_set (sink, "socket-path", t->socket_path, "max-buffers",
+      max_buffers, NULL);
+  gst_object_unref (sink);
+  t->appsrc = GST_APP_SRC (gst_bin_get_by_name (GST_BIN (t->sender), "src"));
+
+  t->receiver = gst_parse_launch ("unixfdsrc name=src ! "
+      "appsink name=sink sync=false", NULL);
+  fail_unless (t->receiver != NULL);
+  src = gst_bin_get_by_name (GST_BIN (t->receiver), "src");
+  g_object_set (src, "socket-path", t->socket_path, NULL);
+  gst_object_unref (src);
+  t->appsink =
+      GST_APP_SINK (gst_bin_get_by_name (GST_BIN (t->receiver), "sink"));
+
+  /* the sink listens once it is started */
+  fail_unless (gst_element_set_state (t->sender, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_set_state (t->receiver, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+}
+
+static void
+unix_fd_test_teardown (UnixFdTest * t)
+{
+  gst_element_set_state (t->receiver, GST_STATE_NULL);
+  gst_element_set_state (t->sender, GST_STATE_NULL);
+
+  gst_object_unref (t->appsrc);
+  gst_object_unref (t->appsink);
+  gst_object_unref (t->receiver);
+  gst_object_unref (t->sender);
+
+  fail_if (g_file_test (t->socket_path, G_FILE_TEST_EXISTS));
+  g_free (t->socket_path);
+}
+
+static void
+push_buffers (UnixFdTest * t, guint n_buffers)
+{
+  guint i;
+
+  for (i = 0; i < n_buffers; i++) {
+    GstBuffer *buf;
+
+    buf = gst_buffer_new_allocate (NULL, FRAME_SIZE, NULL);
+    gst_buffer_memset (buf, 0, i, FRAME_SIZE);
+    GST_BUFFER_PTS (buf) = i * GST_SECOND / 30;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 30;
+    fail_unless_equals_int (gst_app_src_push_buffer (t->appsrc, buf),
+        GST_FLOW_OK);
+  }
+  fail_unless_equals_int (gst_app_src_end_of_stream (t->appsrc), GST_FLOW_OK);
+}
+
+static void
+check_sample (GstSample * sample, guint i)
+{
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstMapInfo map;
+
+  fail_unless (sample != NULL);
+
+  caps = gst_caps_from_string (TEST_CAPS);
+  fail_unless (gst_caps_is_equal (gst_sample_get_caps (sample), caps));
+  gst_caps_unref (caps);
+
+  buf = gst_sample_get_buffer (sample);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), i * GST_SECOND / 30);
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (buf), GST_SECOND / 30);
+  fail_unless (gst_is_fd_memory (gst_buffer_peek_memory (buf, 0)));
+
+  fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+  fail_unless_equals_int (map.size, FRAME_SIZE);
+  fail_unless_equals_int (map.data[0], i);
+  fail_unless_equals_int (map.data[FRAME_SIZE - 1], i);
+  gst_buffer_unmap (buf, &map);
+}
+
+GST_START_TEST (test_transfer)
+{
+  UnixFdTest t;
+  GstSample *sample;
+  guint i;
+
+  unix_fd_test_setup (&t, 4);
+
+  /* more buffers than max-buffers, the sink has to wait for the releases */
+  push_buffers (&t, N_BUFFERS);
+
+  for (i = 0; i < N_BUFFERS; i++) {
+    sample = gst_app_sink_pull_sample (t.appsink);
+    check_sample (sample, i);
+    gst_sample_unref (sample);
+  }
+
+  fail_unless (gst_app_sink_pull_sample (t.appsink) == NULL);
+  fail_unless (gst_app_sink_is_eos (t.appsink));
+
+  unix_fd_test_teardown (&t);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_buffers_outlive_source)
+{
+  UnixFdTest t;
+  GstSample *samples[2];
+  guint i;
+
+  unix_fd_test_setup (&t, 0);
+  push_buffers (&t, 2);
+
+  for (i = 0; i < 2; i++)
+    samples[i] = gst_app_sink_pull_sample (t.appsink);
+
+  /* the memory stays valid after the source and the sender are gone */
+  unix_fd_test_teardown (&t);
+
+  for (i = 0; i < 2; i++) {
+    check_sample (samples[i], i);
+    gst_sample_unref (samples[i]);
+  }
+}
+
+GST_END_TEST;
+
+/* a path that isn't a socket is neither removed nor used */
+GST_START_TEST (test_path_not_a_socket)
+{
+  GstElement *sink;
+  gchar *path, *contents = NULL;
+
+  path = g_strdup_printf ("%s/gst-unixfd-file-%d", g_get_tmp_dir (),
+      (gint) getpid ());
+  fail_unless (g_file_set_contents (path, "data", -1, NULL));
+
+  sink = gst_element_factory_make ("unixfdsink", NULL);
+  fail_unless (sink != NULL);
+  g_object_set (sink, "socket-path", path, NULL);
+  fail_unless_equals_int (gst_element_set_state (sink, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_FAILURE);
+  gst_element_set_state (sink, GST_STATE_NULL);
+  gst_object_unref (sink);
+
+  fail_unless (g_file_get_contents (path, &contents, NULL, NULL));
+  fail_unless_equals_string (contents, "data");
+  g_free (contents);
+
+  g_unlink (path);
+  g_free (path);
+}
+
+GST_END_TEST;
+
+static Suite *
+unixfd_suite (void)
+{
+  Suite *s = suite_create ("unixfd");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_transfer);
+  tcase_add_test (tc_chain, test_buffers_outlive_source);
+  tcase_add_test (tc_chain, test_path_not_a_socket);
+
+  return s;
+}
+
+GST_CHECK_MAIN (unixfd);
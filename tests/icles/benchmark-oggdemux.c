@@ -0,0 +1,237 @@
+/* GStreamer oggdemux seek/resync benchmark
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Usage: benchmark-oggdemux FILE.ogg [NUM_SEEKS]
+ *
+ * Measures the time oggdemux needs to scan the file when going to PAUSED,
+ * the time of NUM_SEEKS random accurate seeks, and the time oggparse needs
+ * to sync to every page of the file. Use a large file to get meaningful
+ * numbers.
+ *
+ * It also syncs to every page of the file in memory with libogg's
+ * ogg_sync_pageout() and with the gst_ogg_sync_pageout() the elements use,
+ * once as is and once with a damaged byte every 64 KiB so that both have
+ * to search for the next page. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <gst/gst.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the page sync is internal to the ogg plugin, build it in */
+#include "../../ext/ogg/gstoggsync.c"
+
+#define DEFAULT_NUM_SEEKS 200
+#define SYNC_ROUNDS 10
+#define SYNC_CHUNK_SIZE 65536
+
+static void
+pad_added_cb (GstElement * demux, GstPad * pad, GstElement * pipeline)
+{
+  GstElement *sink;
+  GstPad *sinkpad;
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  gst_bin_add (GST_BIN (pipeline), sink);
+  gst_element_sync_state_with_parent (sink);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (sinkpad);
+}
+
+static gboolean
+wait_for_state (GstElement * pipeline)
+{
+  return gst_element_get_state (pipeline, NULL, NULL,
+      GST_CLOCK_TIME_NONE) != GST_STATE_CHANGE_FAILURE;
+}
+
+static void
+run_demux (const gchar * location, guint num_seeks)
+{
+  GstElement *pipeline, *src, *demux;
+  GstClockTime start, duration_ns;
+  gint64 duration = -1;
+  guint i;
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("filesrc", NULL);
+  demux = gst_element_factory_make ("oggdemux", NULL);
+  g_object_set (src, "location", location, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), src, demux, NULL);
+  gst_element_link (src, demux);
+  g_signal_connect (demux, "pad-added", G_CALLBACK (pad_added_cb), pipeline);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  if (!wait_for_state (pipeline)) {
+    g_printerr ("failed to preroll %s\n", location);
+    goto done;
+  }
+  g_print ("oggdemux: preroll (chain scan) %" GST_TIME_FORMAT "\n",
+      GST_TIME_ARGS (gst_util_get_timestamp () - start));
+
+  if (!gst_element_query_duration (pipeline, GST_FORMAT_TIME, &duration)
+      || duration <= 0) {
+    g_printerr ("no duration, skipping seeks\n");
+    goto done;
+  }
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < num_seeks; i++) {
+    gint64 pos = g_random_int_range (0, 1000) * (duration / 1000);
+
+    gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+        GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, pos);
+    wait_for_state (pipeline);
+  }
+  duration_ns = gst_util_get_timestamp () - start;
+  g_print ("oggdemux: %u seeks in %" GST_TIME_FORMAT " (%" G_GUINT64_FORMAT
+      " us per seek)\n", num_seeks, GST_TIME_ARGS (duration_ns),
+      duration_ns / (num_seeks * GST_USECOND));
+
+done:
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+static void
+run_parse (const gchar * location)
+{
+  GstElement *pipeline;
+  GstClockTime start;
+  GstMessage *msg;
+  gchar *desc;
+
+  desc = g_strdup_printf ("filesrc location=\"%s\" blocksize=1048576 ! "
+      "oggparse ! fakesink sync=false", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  if (pipeline == NULL)
+    return;
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  g_print ("oggparse: full file sync %" GST_TIME_FORMAT "%s\n",
+      GST_TIME_ARGS (gst_util_get_timestamp () - start),
+      GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR ? " (error)" : "");
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+typedef gint (*PageoutFunc) (ogg_sync_state * oy, ogg_page * og);
+
+static guint
+sync_all_pages (const guint8 * data, gsize size, PageoutFunc pageout)
+{
+  ogg_sync_state oy;
+  ogg_page og;
+  gsize offset, chunk;
+  guint pages = 0;
+  gint ret;
+
+  ogg_sync_init (&oy);
+  for (offset = 0; offset < size; offset += chunk) {
+    chunk = MIN (SYNC_CHUNK_SIZE, size - offset);
+    memcpy (ogg_sync_buffer (&oy, chunk), data + offset, chunk);
+    ogg_sync_wrote (&oy, chunk);
+
+    while ((ret = pageout (&oy, &og)) != 0)
+      if (ret > 0)
+        pages++;
+  }
+  ogg_sync_clear (&oy);
+
+  return pages;
+}
+
+static void
+run_sync_one (const gchar * what, const guint8 * data, gsize size)
+{
+  static const struct
+  {
+    const gchar *name;
+    PageoutFunc pageout;
+  } impls[] = {
+    {"libogg ogg_sync_pageout", ogg_sync_pageout},
+    {"gst_ogg_sync_pageout", gst_ogg_sync_pageout},
+  };
+  GstClockTime start, elapsed;
+  guint i, r, pages = 0;
+
+  for (i = 0; i < G_N_ELEMENTS (impls); i++) {
+    start = gst_util_get_timestamp ();
+    for (r = 0; r < SYNC_ROUNDS; r++)
+      pages = sync_all_pages (data, size, impls[i].pageout);
+    elapsed = (gst_util_get_timestamp () - start) / SYNC_ROUNDS;
+
+    g_print ("%s: %s: %u pages in %" GST_TIME_FORMAT " (%.1f MB/s)\n",
+        what, impls[i].name, pages, GST_TIME_ARGS (elapsed),
+        elapsed ? size * 1000.0 / elapsed : 0.0);
+  }
+}
+
+static void
+run_sync (const gchar * location)
+{
+  gchar *contents;
+  gsize size, i;
+
+  if (!g_file_get_contents (location, &contents, &size, NULL)) {
+    g_printerr ("failed to read %s\n", location);
+    return;
+  }
+
+  run_sync_one ("page sync", (const guint8 *) contents, size);
+
+  for (i = SYNC_CHUNK_SIZE / 2; i < size; i += SYNC_CHUNK_SIZE)
+    contents[i] ^= 0x5a;
+  run_sync_one ("page sync (damaged)", (const guint8 *) contents, size);
+
+  g_free (contents);
+}
+
+int
+main (int argc, char **argv)
+{
+  guint num_seeks = DEFAULT_NUM_SEEKS;
+
+  gst_init (&argc, &argv);
+
+  if (argc < 2) {
+    g_printerr ("Usage: %s FILE.ogg [NUM_SEEKS]\n", argv[0]);
+    return 1;
+  }
+  if (argc > 2)
+    num_seeks = MAX (1, atoi (argv[2]));
+
+  run_demux (argv[1], num_seeks);
+  run_parse (argv[1]);
+  run_sync (argv[1]);
+
+  return 0;
+}
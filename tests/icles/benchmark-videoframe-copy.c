@@ -0,0 +1,140 @@
+/* GStreamer video frame copy benchmark
+ * Copyright (C) 2026 LG Electronics, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Compares gst_video_frame_copy() with copying every row with memcpy(), which
+ * is what it used to do, for a few formats and sizes. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define NUM_COPIES 50
+
+static const struct
+{
+  GstVideoFormat format;
+  gint width, height;
+} tests[] = {
+  {GST_VIDEO_FORMAT_I420, 1920, 1080},
+  {GST_VIDEO_FORMAT_NV12, 1920, 1080},
+  {GST_VIDEO_FORMAT_BGRA, 1920, 1080},
+  {GST_VIDEO_FORMAT_I420, 3840, 2160},
+  {GST_VIDEO_FORMAT_NV12, 3840, 2160},
+  {GST_VIDEO_FORMAT_BGRA, 3840, 2160},
+  {GST_VIDEO_FORMAT_NV12, 7680, 4320},
+  {GST_VIDEO_FORMAT_P010_10LE, 7680, 4320},
+};
+
+static void
+copy_rows (GstVideoFrame * dest, const GstVideoFrame * src)
+{
+  guint i, j, w, h;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (src); i++) {
+    guint8 *dp = GST_VIDEO_FRAME_PLANE_DATA (dest, i);
+    const guint8 *sp = GST_VIDEO_FRAME_PLANE_DATA (src, i);
+    gint ds = GST_VIDEO_FRAME_PLANE_STRIDE (dest, i);
+    gint ss = GST_VIDEO_FRAME_PLANE_STRIDE (src, i);
+
+    w = GST_VIDEO_FRAME_COMP_WIDTH (dest, i) *
+        GST_VIDEO_FRAME_COMP_PSTRIDE (dest, i);
+    h = GST_VIDEO_FRAME_COMP_HEIGHT (dest, i);
+
+    for (j = 0; j < h; j++) {
+      memcpy (dp, sp, w);
+      dp += ds;
+      sp += ss;
+    }
+  }
+}
+
+static gdouble
+run (GstVideoFrame * dest, GstVideoFrame * src, gboolean reference)
+{
+  GTimer *timer;
+  gdouble elapsed;
+  gint i;
+
+  timer = g_timer_new ();
+  for (i = 0; i < NUM_COPIES; i++) {
+    if (reference)
+      copy_rows (dest, src);
+    else
+      gst_video_frame_copy (dest, src);
+  }
+  elapsed = g_timer_elapsed (timer, NULL);
+  g_timer_destroy (timer);
+
+  return elapsed * 1000.0 / NUM_COPIES;
+}
+
+int
+main (int argc, char **argv)
+{
+  guint i;
+
+  gst_init (&argc, &argv);
+
+  g_print ("%-12s %11s %10s %12s %12s %8s\n", "format", "size", "MB",
+      "memcpy rows", "frame copy", "speedup");
+
+  for (i = 0; i < G_N_ELEMENTS (tests); i++) {
+    GstVideoInfo info;
+    GstBuffer *sbuf, *dbuf;
+    GstVideoFrame src, dest;
+    gdouble ref, copy;
+    gchar *size;
+
+    gst_video_info_set_format (&info, tests[i].format, tests[i].width,
+        tests[i].height);
+
+    sbuf = gst_buffer_new_allocate (NULL, info.size, NULL);
+    dbuf = gst_buffer_new_allocate (NULL, info.size, NULL);
+    gst_buffer_memset (sbuf, 0, 0x80, info.size);
+    gst_buffer_memset (dbuf, 0, 0x00, info.size);
+
+    gst_video_frame_map (&src, &info, sbuf, GST_MAP_READ);
+    gst_video_frame_map (&dest, &info, dbuf, GST_MAP_WRITE);
+
+    /* warm up, fault in the pages */
+    copy_rows (&dest, &src);
+    gst_video_frame_copy (&dest, &src);
+
+    ref = run (&dest, &src, TRUE);
+    copy = run (&dest, &src, FALSE);
+
+    size = g_strdup_printf ("%dx%d", tests[i].width, tests[i].height);
+    g_print ("%-12s %11s %10.1f %9.3f ms %9.3f ms %7.2fx\n",
+        gst_video_format_to_string (tests[i].format), size,
+        info.size / (1024.0 * 1024.0), ref, copy, ref / copy);
+    g_free (size);
+
+    gst_video_frame_unmap (&dest);
+    gst_video_frame_unmap (&src);
+    gst_buffer_unref (dbuf);
+    gst_buffer_unref (sbuf);
+  }
+
+  return 0;
+}